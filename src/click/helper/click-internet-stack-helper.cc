@@ -296,7 +296,8 @@ ClickInternetStackHelper::EnablePcapIpv4Internal (std::string prefix, Ptr<Ipv4>
       filename = pcapHelper.GetFilenameFromInterfacePair (prefix, ipv4, interface);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_RAW);
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_RAW,
+                                                     ipv4->GetNetDevice (interface));
 
   //
   // However, we only hook the trace source once to avoid multiple trace sink
@@ -24,6 +24,8 @@
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "string.h"
+#include "trace-source-accessor.h"
 #include "log.h"
 
 #include <sstream>
@@ -94,33 +96,87 @@ void
 MatchContainer::Set (std::string name, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (this << name << &value);
+  // the attribute is looked up, and the value checked, once per run
+  // of objects of the same type, except the string values of the
+  // Pointer Attributes, which create a new object each time they are
+  // checked: each object gets its own.
+  TypeId tid;
+  struct TypeId::AttributeInformation info;
+  Ptr<AttributeValue> v;
+  bool perObject = false;
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->SetAttribute (name, value);
+      if (v == 0 || perObject || object->GetInstanceTypeId () != tid)
+        {
+          tid = object->GetInstanceTypeId ();
+          if (!tid.LookupAttributeByName (name, &info))
+            {
+              NS_FATAL_ERROR ("Attribute name="<<name<<" does not exist for this object: tid="<<tid.GetName ());
+            }
+          if (!(info.flags & TypeId::ATTR_SET) ||
+              !info.accessor->HasSetter ())
+            {
+              NS_FATAL_ERROR ("Attribute name="<<name<<" is not settable for this object: tid="<<tid.GetName ());
+            }
+          perObject = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0
+            && dynamic_cast<const StringValue *> (&value) != 0;
+          v = info.checker->CreateValidValue (value);
+          if (v == 0)
+            {
+              NS_FATAL_ERROR ("Attribute name="<<name<<" could not be set for this object: tid="<<tid.GetName ());
+            }
+        }
+      if (!info.accessor->Set (PeekPointer (object), *v))
+        {
+          NS_FATAL_ERROR ("Attribute name="<<name<<" could not be set for this object: tid="<<tid.GetName ());
+        }
     }
 }
+Ptr<const TraceSourceAccessor>
+MatchContainer::LookupTraceSource (Ptr<Object> object, std::string name,
+                                   TypeId *tid, Ptr<const TraceSourceAccessor> accessor) const
+{
+  NS_LOG_FUNCTION (this << object << name << tid << accessor);
+  if (accessor == 0 || object->GetInstanceTypeId () != *tid)
+    {
+      *tid = object->GetInstanceTypeId ();
+      accessor = tid->LookupTraceSourceByName (name);
+    }
+  return accessor;
+}
 void 
 MatchContainer::Connect (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
+  TypeId tid;
+  Ptr<const TraceSourceAccessor> accessor;
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
       Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      object->TraceConnect (name, ctx, cb);
+      accessor = LookupTraceSource (object, name, &tid, accessor);
+      if (accessor != 0)
+        {
+          std::string ctx = m_contexts[i] + name;
+          accessor->Connect (PeekPointer (object), ctx, cb);
+        }
     }
 }
 void 
 MatchContainer::ConnectWithoutContext (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
-
+  TypeId tid;
+  Ptr<const TraceSourceAccessor> accessor;
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->TraceConnectWithoutContext (name, cb);
+      accessor = LookupTraceSource (object, name, &tid, accessor);
+      if (accessor != 0)
+        {
+          accessor->ConnectWithoutContext (PeekPointer (object), cb);
+        }
     }
 }
 void 
@@ -128,21 +184,33 @@ MatchContainer::Disconnect (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
+  TypeId tid;
+  Ptr<const TraceSourceAccessor> accessor;
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
       Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      object->TraceDisconnect (name, ctx, cb);
+      accessor = LookupTraceSource (object, name, &tid, accessor);
+      if (accessor != 0)
+        {
+          std::string ctx = m_contexts[i] + name;
+          accessor->Disconnect (PeekPointer (object), ctx, cb);
+        }
     }
 }
 void 
 MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
+  TypeId tid;
+  Ptr<const TraceSourceAccessor> accessor;
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->TraceDisconnectWithoutContext (name, cb);
+      accessor = LookupTraceSource (object, name, &tid, accessor);
+      if (accessor != 0)
+        {
+          accessor->DisconnectWithoutContext (PeekPointer (object), cb);
+        }
     }
 }
 
@@ -150,6 +218,8 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, when the matcher is constructed.
  */
 class ArrayMatcher
 {
@@ -167,7 +237,20 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Test if the Config path specification is a single index.
+   *
+   * \param [out] i The index.
+   * \returns \c true if only the index \p i matches the Config Path.
+   */
+  bool GetIndex (std::size_t *i) const;
 private:
+  /**
+   * Parse a Config path specification.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -178,78 +261,94 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** Whether all the indices match. */
+  bool m_all;
+  /** The ranges of matching indices, bounds included. */
+  std::vector<std::pair<std::size_t, std::size_t> > m_ranges;
 
 };  // class ArrayMatcher
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      Parse (element.substr (0, tmp-0));
+      Parse (element.substr (tmp+1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      NS_LOG_DEBUG ("Array "<<i<<" matches *");
       return true;
     }
+  for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); j++)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
+bool
+ArrayMatcher::GetIndex (std::size_t *i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all || m_ranges.size () != 1 || m_ranges[0].first != m_ranges[0].second)
+    {
+      return false;
+    }
+  *i = m_ranges[0].first;
+  return true;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -261,6 +360,178 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * A Config path split into its segments.
+ *
+ * The TypeIds of the GetObject segments are looked up, and the array
+ * specifications parsed, once. The pointer and container attributes
+ * which match a segment are cached per TypeId of the objects the
+ * segment is resolved on.
+ */
+class CompiledPathImpl : public SimpleRefCount<CompiledPathImpl>
+{
+public:
+  /**
+   * Construct from a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  CompiledPathImpl (std::string path);
+
+  /** A pointer or container attribute matching a segment. */
+  struct Link
+  {
+    /** The attribute name. */
+    std::string name;
+    /** The attribute accessor. */
+    Ptr<const AttributeAccessor> accessor;
+    /** The container accessor, or zero for a pointer attribute. */
+    const ObjectPtrContainerAccessor *container;
+  };
+  /** The list of attributes matching a segment. */
+  typedef std::vector<struct Link> Links;
+
+  /** A segment of the Config path. */
+  struct Segment
+  {
+    /**
+     * Constructor.
+     *
+     * \param [in] item The segment of the Config path.
+     */
+    Segment (std::string item);
+    /** The segment of the Config path. */
+    std::string item;
+    /** Whether the segment starts the "/Names" namespace. */
+    bool names;
+    /** Whether the segment is a GetObject (i.e., starts with '$'). */
+    bool getObject;
+    /** Whether the TypeId of a GetObject segment exists. */
+    bool tidFound;
+    /** The TypeId of a GetObject segment. */
+    TypeId tid;
+    /** The segment as an array specification. */
+    ArrayMatcher matcher;
+    /** The attributes matching the segment, per TypeId uid. */
+    mutable std::vector<std::pair<uint16_t, Links> > links;
+  };
+
+  /**
+   * Get the pointer and container attributes of a TypeId, or of its
+   * parents, matching a segment.
+   *
+   * \param [in] segment The segment.
+   * \param [in] tid The TypeId of the object the segment is resolved on.
+   * \returns The matching attributes.
+   */
+  const Links & GetLinks (const struct Segment &segment, TypeId tid) const;
+
+  /** The Config path. */
+  std::string m_path;
+  /** The segments of the Config path. */
+  std::vector<struct Segment> m_segments;
+};
+
+CompiledPathImpl::Segment::Segment (std::string item)
+  : item (item),
+    names (item.compare (0, 5, "Names") == 0),
+    getObject (item.find ("$") == 0),
+    tidFound (false),
+    matcher (item)
+{
+  if (getObject)
+    {
+      tidFound = TypeId::LookupByNameFailSafe (item.substr (1, item.size () - 1), &tid);
+    }
+}
+
+CompiledPathImpl::CompiledPathImpl (std::string path)
+  : m_path (path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // ensure that we start and end with a '/'
+  std::string canonical = path;
+  std::string::size_type tmp = canonical.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      canonical = "/" + canonical;
+    }
+  tmp = canonical.find_last_of ("/");
+  if (tmp != (canonical.size () - 1))
+    {
+      // no slash at end
+      canonical = canonical + "/";
+    }
+
+  std::string::size_type cur = 0;
+  std::string::size_type next = canonical.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      m_segments.push_back (Segment (canonical.substr (cur + 1, next - (cur + 1))));
+      cur = next;
+      next = canonical.find ("/", cur + 1);
+    }
+}
+
+const CompiledPathImpl::Links &
+CompiledPathImpl::GetLinks (const struct Segment &segment, TypeId tid) const
+{
+  NS_LOG_FUNCTION (this << segment.item << tid);
+  uint16_t uid = tid.GetUid ();
+  for (std::vector<std::pair<uint16_t, Links> >::const_iterator i = segment.links.begin ();
+       i != segment.links.end (); i++)
+    {
+      if (i->first == uid)
+        {
+          return i->second;
+        }
+    }
+
+  Links links;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = tid.GetAttribute (i);
+          if (info.name != segment.item && segment.item != "*")
+            {
+              continue;
+            }
+          struct Link link;
+          link.name = info.name;
+          link.accessor = info.accessor;
+          link.container = 0;
+          // attempt to cast to a pointer checker.
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              links.push_back (link);
+              continue;
+            }
+          // attempt to cast to an object vector.
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              link.container = dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+              if (link.container != 0)
+                {
+                  links.push_back (link);
+                }
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+
+  segment.links.push_back (std::make_pair (uid, links));
+  return segment.links.back ().second;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -269,11 +540,11 @@ class Resolver
 {
 public:
   /**
-   * Construct from a base Config path.
+   * Construct from a compiled Config path.
    *
-   * \param [in] path The Config path.
+   * \param [in] path The compiled Config path.
    */
-  Resolver (std::string path);
+  Resolver (const CompiledPathImpl &path);
   /** Destructor. */
   virtual ~Resolver ();
 
@@ -287,23 +558,22 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] pos The index of the next segment of the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t pos, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] pos The index of the segment holding the index.
+   * \param [in] root The object holding the container.
+   * \param [in] container The accessor of the container.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t pos, Ptr<Object> root, const ObjectPtrContainerAccessor *container);
   /**
    * Handle one object found on the path.
    *
@@ -326,47 +596,27 @@ private:
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The compiled Config path. */
+  const CompiledPathImpl &m_path;
 
 };  // class Resolver
 
-Resolver::Resolver (std::string path)
+Resolver::Resolver (const CompiledPathImpl &path)
   : m_path (path)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << path.m_path);
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
-}
 
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -392,13 +642,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t pos, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << pos << root);
 
-  if (next == std::string::npos)
+  if (pos == m_path.m_segments.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -414,8 +662,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const CompiledPathImpl::Segment &segment = m_path.m_segments[pos];
+  const std::string &item = segment.item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -426,11 +674,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (segment.names)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (pos + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -447,7 +694,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (pos + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -463,83 +710,54 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (segment.getObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject="<<item<<" on path="<<GetResolvedPath ());
+      TypeId tid = segment.tidFound ? segment.tid : TypeId::LookupByName (item.substr (1, item.size () - 1));
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<item<<") failed on path="<<GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (pos + 1, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-      
-      do
+      const CompiledPathImpl::Links &links = m_path.GetLinks (segment, root->GetInstanceTypeId ());
+      for (CompiledPathImpl::Links::const_iterator i = links.begin (); i != links.end (); i++)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (i->container == 0)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue pValue;
+              i->accessor->Get (PeekPointer (root), pValue);
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer(info.checker));
-              if (pChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.push_back (i->name);
+              DoResolve (pos + 1, object);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              m_workStack.push_back (i->name);
+              DoArrayResolve (pos + 1, root, i->container);
+              m_workStack.pop_back ();
+            }
+        }
       
-      if (!foundMatch)
+      if (links.empty ())
         {
           NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
           return;
@@ -548,29 +766,42 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t pos, Ptr<Object> root, const ObjectPtrContainerAccessor *container)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << pos << root << container);
+  if (pos == m_path.m_segments.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const ArrayMatcher &matcher = m_path.m_segments[pos].matcher;
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  std::size_t index;
+  if (matcher.GetIndex (&index))
+    {
+      // look the single index up in the container, rather than scanning it
+      Ptr<Object> object = container->Find (PeekPointer (root), index);
+      if (object != 0)
+        {
+          std::ostringstream oss;
+          oss << index;
+          m_workStack.push_back (oss.str ());
+          DoResolve (pos + 1, object);
+          m_workStack.pop_back ();
+        }
+      return;
+    }
+
+  ObjectPtrContainerValue vector;
+  container->Get (PeekPointer (root), vector);
   ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  for (it = vector.Begin (); it != vector.End (); ++it)
     {
       if (matcher.Matches ((*it).first))
         {
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (pos + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -595,6 +826,13 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   MatchContainer LookupMatches (std::string path);
+  /**
+   * Find the objects matching a compiled Config path.
+   *
+   * \param [in] path The compiled Config path.
+   * \returns A container of the matching objects.
+   */
+  MatchContainer LookupMatches (const CompiledPathImpl &path);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -717,10 +955,17 @@ MatchContainer
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
+  return LookupMatches (CompiledPathImpl (path));
+}
+
+MatchContainer 
+ConfigImpl::LookupMatches (const CompiledPathImpl &path)
+{
+  NS_LOG_FUNCTION (this << path.m_path);
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
+    LookupMatchesResolver (const CompiledPathImpl &path)
       : Resolver (path)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path)
@@ -743,7 +988,7 @@ ConfigImpl::LookupMatches (std::string path)
   //
   resolver.Resolve (0);
 
-  return MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  return MatchContainer (resolver.m_objects, resolver.m_contexts, path.m_path);
 }
 
 void 
@@ -781,6 +1026,75 @@ ConfigImpl::GetRootNamespaceObject (std::size_t i) const
   return m_roots[i];
 }
 
+CompiledPath::CompiledPath ()
+  : m_impl (Create<CompiledPathImpl> (""))
+{
+  NS_LOG_FUNCTION (this);
+}
+CompiledPath::CompiledPath (std::string path)
+  : m_impl (Create<CompiledPathImpl> (path))
+{
+  NS_LOG_FUNCTION (this << path);
+}
+CompiledPath::CompiledPath (const CompiledPath &o)
+  : m_impl (o.m_impl)
+{
+  NS_LOG_FUNCTION (this << &o);
+}
+CompiledPath &
+CompiledPath::operator = (const CompiledPath &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_impl = o.m_impl;
+  return *this;
+}
+CompiledPath::~CompiledPath ()
+{
+  NS_LOG_FUNCTION (this);
+}
+std::string
+CompiledPath::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_impl->m_path;
+}
+MatchContainer
+CompiledPath::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return ConfigImpl::Get ()->LookupMatches (*m_impl);
+}
+void
+CompiledPath::Set (std::string name, const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << name << &value);
+  LookupMatches ().Set (name, value);
+}
+void
+CompiledPath::Connect (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  LookupMatches ().Connect (name, cb);
+}
+void
+CompiledPath::ConnectWithoutContext (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  LookupMatches ().ConnectWithoutContext (name, cb);
+}
+void
+CompiledPath::Disconnect (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  LookupMatches ().Disconnect (name, cb);
+}
+void
+CompiledPath::DisconnectWithoutContext (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  LookupMatches ().DisconnectWithoutContext (name, cb);
+}
+
 
 void Reset (void)
 {
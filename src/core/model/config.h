@@ -35,6 +35,8 @@ namespace ns3 {
 class AttributeValue;
 class Object;
 class CallbackBase;
+class TypeId;
+class TraceSourceAccessor;
 
 /**
  * \ingroup core
@@ -242,6 +244,19 @@ public:
   void DisconnectWithoutContext (std::string name, const CallbackBase &cb);
   
 private:
+  /**
+   * Look a trace source up on an object, unless the object has
+   * the same TypeId as the previous one.
+   *
+   * \param [in] object The object.
+   * \param [in] name The name of the trace source.
+   * \param [in,out] tid The TypeId of the previous object.
+   * \param [in] accessor The trace source of the previous object.
+   * \returns The trace source of the object, or zero if there is none.
+   */
+  Ptr<const TraceSourceAccessor> LookupTraceSource (Ptr<Object> object, std::string name,
+                                                    TypeId *tid, Ptr<const TraceSourceAccessor> accessor) const;
+
   /** The list of objects in this container. */
   std::vector<Ptr<Object> > m_objects;
   /** The context for each object. */
@@ -258,6 +273,112 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+class CompiledPathImpl;
+
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, to be resolved many times.
+ *
+ * The path is split into its segments when the CompiledPath is
+ * created: the TypeIds named by the "$" segments are looked up and
+ * the array specifications (e.g., "[0-3]|7") are parsed only once, and
+ * the attributes matching each segment are cached per TypeId of the
+ * objects on which the segment is resolved. In any Config path, an
+ * array specification which is a single index (e.g., "/NodeList/3/")
+ * is looked up directly in its container, without scanning it.
+ *
+ * As for LookupMatches(), the path matches objects, and the
+ * operations take the name of the attribute or trace source of the
+ * objects:
+ * \code
+ *   Config::CompiledPath path ("/NodeList/[0-9]/DeviceList/0/$ns3::PointToPointNetDevice");
+ *   path.Connect ("MacTx", MakeCallback (&MacTxTrace));
+ * \endcode
+ * Copies of a CompiledPath share its segments and caches.
+ */
+class CompiledPath
+{
+public:
+  /** Create an empty path. */
+  CompiledPath ();
+  /**
+   * Parse a path.
+   *
+   * \param [in] path The path of the objects to match.
+   */
+  CompiledPath (std::string path);
+  /**
+   * Copy constructor.
+   *
+   * \param [in] o The CompiledPath to copy.
+   */
+  CompiledPath (const CompiledPath &o);
+  /**
+   * Assignment operator.
+   *
+   * \param [in] o The CompiledPath to copy.
+   * \returns This CompiledPath.
+   */
+  CompiledPath & operator = (const CompiledPath &o);
+  /** Destructor. */
+  ~CompiledPath ();
+
+  /**
+   * \returns The path, as given to the constructor.
+   */
+  std::string GetPath (void) const;
+  /**
+   * \returns A container which contains all the objects which match
+   *          the path.
+   * \sa ns3::Config::LookupMatches
+   */
+  MatchContainer LookupMatches (void) const;
+  /**
+   * \param [in] name Name of attribute to set
+   * \param [in] value Value to set to the attribute
+   *
+   * Set the specified attribute value on all the objects matching the path.
+   * \sa ns3::Config::Set
+   */
+  void Set (std::string name, const AttributeValue &value) const;
+  /**
+   * \param [in] name The name of the trace source to connect to
+   * \param [in] cb The sink to connect to the trace source
+   *
+   * Connect the specified sink to all the objects matching the path.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (std::string name, const CallbackBase &cb) const;
+  /**
+   * \param [in] name The name of the trace source to connect to
+   * \param [in] cb The sink to connect to the trace source
+   *
+   * Connect the specified sink to all the objects matching the path.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (std::string name, const CallbackBase &cb) const;
+  /**
+   * \param [in] name The name of the trace source to disconnect from
+   * \param [in] cb The sink to disconnect from the trace source
+   *
+   * Disconnect the specified sink from all the objects matching the path.
+   * \sa ns3::Config::Disconnect
+   */
+  void Disconnect (std::string name, const CallbackBase &cb) const;
+  /**
+   * \param [in] name The name of the trace source to disconnect from
+   * \param [in] cb The sink to disconnect from the trace source
+   *
+   * Disconnect the specified sink from all the objects matching the path.
+   * \sa ns3::Config::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (std::string name, const CallbackBase &cb) const;
+
+private:
+  /** The parsed path. */
+  Ptr<CompiledPathImpl> m_impl;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -25,6 +25,9 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "boolean.h"
+#include "uinteger.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
@@ -53,6 +56,24 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EnableProfiler",
+                   "Profile the wall-clock time of the events, and write the "
+                   "profile at the end of each Run.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_profilerEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfilerSamplingPeriod",
+                   "Profile one event out of this number.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_profilerSamplingPeriod),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ProfilerOutput",
+                   "The prefix of the profile files: the flat profile is "
+                   "written to <prefix>.txt, and the folded stacks to "
+                   "<prefix>.folded.",
+                   StringValue ("simulator-profile"),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profilerOutput),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -74,6 +95,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_eventCount = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_profilerEnabled = false;
+  m_profilerSamplingPeriod = 1;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -93,6 +116,7 @@ DefaultSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+  m_profiler = 0;
   SimulatorImpl::DoDispose ();
 }
 void
@@ -148,7 +172,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiler == 0)
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      m_profiler->Invoke (next.impl, m_currentContext);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -198,12 +229,21 @@ DefaultSimulatorImpl::Run (void)
   m_main = SystemThread::Self();
   ProcessEventsWithContext ();
   m_stop = false;
+  if (m_profilerEnabled && m_profiler == 0)
+    {
+      m_profiler = Create<EventProfiler> (m_profilerSamplingPeriod);
+    }
 
   while (!m_events->IsEmpty () && !m_stop) 
     {
       ProcessOneEvent ();
     }
 
+  if (m_profiler != 0)
+    {
+      m_profiler->Write (m_profilerOutput);
+    }
+
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
@@ -28,8 +28,10 @@
 #include "system-mutex.h"
 
 #include "ptr.h"
+#include "event-profiler.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -135,6 +137,15 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** Whether to profile the events. */
+  bool m_profilerEnabled;
+  /** Profile one event out of this number. */
+  uint32_t m_profilerSamplingPeriod;
+  /** The prefix of the profile files. */
+  std::string m_profilerOutput;
+  /** The event profiler, if enabled. */
+  Ptr<EventProfiler> m_profiler;
 };
 
 } // namespace ns3
@@ -19,6 +19,7 @@
  */
 
 #include "event-impl.h"
+#include "memory-accounting.h"
 #include "log.h"
 
 /**
@@ -31,6 +32,10 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+/** The subsystem of the events, for MemoryAccounting. */
+static const MemoryAccounting::Subsystem g_eventSubsystem =
+  MemoryAccounting::GetSubsystem ("EventImpl");
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -66,4 +71,40 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+const void *
+EventImpl::GetFunction (std::size_t &size) const
+{
+  NS_LOG_FUNCTION (this);
+  size = 0;
+  return 0;
+}
+
+const void *
+EventImpl::GetBoundObject (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 0;
+}
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  void *event = ::operator new (size);
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (g_eventSubsystem, event, size);
+    }
+  return event;
+}
+
+void
+EventImpl::operator delete (void *event)
+{
+  if (MemoryAccounting::HasBlocks ())
+    {
+      MemoryAccounting::Free (event);
+    }
+  ::operator delete (event);
+}
+
 } // namespace ns3
@@ -20,6 +20,7 @@
 #ifndef EVENT_IMPL_H
 #define EVENT_IMPL_H
 
+#include <cstddef>
 #include <stdint.h>
 #include "simple-ref-count.h"
 
@@ -66,6 +67,42 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Get the function called by the event, to tell apart the events
+   * calling different functions of the same signature, e.g. when
+   * profiling them.
+   *
+   * \param [out] size The size of the function pointer, in bytes.
+   * \returns A pointer to the function pointer, or to the pointer to
+   *          member function, called by the event, or 0 if unknown.
+   */
+  virtual const void * GetFunction (std::size_t &size) const;
+
+  /**
+   * Get the object the member function called by the event is called
+   * on, e.g. to find which function a virtual member function calls
+   * when profiling the event.
+   *
+   * \returns A pointer to the object, converted to the class of the
+   *          member function, or 0 if the event does not call a member
+   *          function.
+   */
+  virtual const void * GetBoundObject (void) const;
+
+  /**
+   * Allocate an event, and account for it if MemoryAccounting is enabled.
+   *
+   * \param [in] size The size of the event.
+   * \returns The event.
+   */
+  static void *operator new (std::size_t size);
+  /**
+   * Free an event.
+   *
+   * \param [in] event The event.
+   */
+  static void operator delete (void *event);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,560 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "ns3/core-config.h"
+#include "simulator.h"
+#include "type-id.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/** The names of an event type. */
+struct EventName
+{
+  std::string function;  //!< The function called by the event.
+  std::string type;      //!< The TypeId of the class of the function.
+  std::string group;     //!< The group of the TypeId.
+};
+
+/**
+ * Demangle a name.
+ *
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or the mangled one if it can not be
+ *          demangled.
+ */
+std::string
+Demangle (const char *mangled)
+{
+  std::string name = mangled;
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0 && demangled != 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  return name;
+}
+
+/**
+ * Replace a pointer to member function by the address of the function
+ * it calls on an object.
+ *
+ * With the Itanium C++ ABI, used by GCC and Clang, a pointer to member
+ * function holds a pointer and the adjustment of \c this. For a virtual
+ * function, the pointer is one plus the offset of the function in the
+ * virtual table (on ARM, the pointer is the offset, and the lowest bit
+ * of the doubled adjustment tells a virtual function apart), hence the
+ * address of the function is read from the virtual table of the object.
+ * With other ABIs, the pointer to member function is left unchanged.
+ *
+ * \param [in,out] function The function.
+ * \param [in] object The object the function is called on, or 0.
+ */
+void
+ResolveMemberFunction (EventProfiler::Function &function, const void *object)
+{
+#if defined (__GXX_ABI_VERSION)
+  if (function.size != 2 * sizeof (uintptr_t))
+    {
+      return;
+    }
+#if defined (__arm__) || defined (__aarch64__)
+  bool isVirtual = function.pointer[1] & 1;
+  uintptr_t offset = function.pointer[0];
+  std::ptrdiff_t adjustment = static_cast<std::ptrdiff_t> (function.pointer[1]) >> 1;
+#else
+  bool isVirtual = function.pointer[0] & 1;
+  uintptr_t offset = function.pointer[0] - 1;
+  std::ptrdiff_t adjustment = static_cast<std::ptrdiff_t> (function.pointer[1]);
+#endif
+  uintptr_t address = function.pointer[0];
+  if (isVirtual)
+    {
+      if (object == 0)
+        {
+          return;
+        }
+      const char *self = static_cast<const char *> (object) + adjustment;
+      const char *vtable = *reinterpret_cast<const char * const *> (self);
+      address = *reinterpret_cast<const uintptr_t *> (vtable + offset);
+    }
+  function.size = sizeof (uintptr_t);
+  function.pointer[0] = address;
+  function.pointer[1] = 0;
+#endif
+}
+
+/**
+ * Get the location of the function called by an event.
+ *
+ * The function is looked up with dladdr, if available: its name is the
+ * demangled name of its symbol, if it has one, and its location is
+ * otherwise its offset in its shared object, which does not change
+ * from run to run, unlike its address.
+ *
+ * \param [in] function The function.
+ * \param [out] symbol The demangled name of the symbol of the function,
+ *              or an empty string if not found.
+ * \returns The location, e.g. "at libns3-dev-core-debug.so+0x4005d0",
+ *          "at 0x7f3c5e8a41b6" if the function can not be looked up, or
+ *          an empty string if the function is unknown.
+ */
+std::string
+GetFunctionLocation (const EventProfiler::Function &function, std::string &symbol)
+{
+  symbol = "";
+  std::ostringstream oss;
+  if (function.size == sizeof (uintptr_t))
+    {
+      uintptr_t address = function.pointer[0];
+#ifdef HAVE_DLFCN_H
+      Dl_info info;
+      if (dladdr (reinterpret_cast<void *> (address), &info) != 0)
+        {
+          if (info.dli_sname != 0
+              && reinterpret_cast<uintptr_t> (info.dli_saddr) == address)
+            {
+              symbol = Demangle (info.dli_sname);
+            }
+          if (info.dli_fname != 0)
+            {
+              const char *file = std::strrchr (info.dli_fname, '/');
+              oss << "at " << (file != 0 ? file + 1 : info.dli_fname)
+                  << "+0x" << std::hex << address - reinterpret_cast<uintptr_t> (info.dli_fbase);
+              return oss.str ();
+            }
+        }
+#endif
+      oss << "at 0x" << std::hex << address;
+    }
+  else if (function.size > sizeof (uintptr_t))
+    {
+      // unresolved pointer to member function
+      oss << "at 0x" << std::hex << function.pointer[0] << ":0x" << function.pointer[1];
+    }
+  return oss.str ();
+}
+
+/**
+ * Get the class of a function from the demangled name of its symbol,
+ * e.g. "ns3::Node" for "ns3::Node::DoDispose()".
+ *
+ * \param [in] symbol The demangled name of the symbol.
+ * \returns The class, or an empty string if the function is not a
+ *          member function of a class with a TypeId.
+ */
+std::string
+GetSymbolClass (const std::string &symbol)
+{
+  // the arguments start at the first parenthesis out of the template arguments
+  std::string::size_type end = 0;
+  int depth = 0;
+  for (; end < symbol.size (); end++)
+    {
+      if (symbol[end] == '<')
+        {
+          depth++;
+        }
+      else if (symbol[end] == '>' && depth > 0)
+        {
+          depth--;
+        }
+      else if (symbol[end] == '(' && depth == 0)
+        {
+          break;
+        }
+    }
+  std::string::size_type member = symbol.rfind ("::", end);
+  if (member == std::string::npos)
+    {
+      return "";
+    }
+  std::string type = symbol.substr (0, member);
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (type, &tid))
+    {
+      return "";
+    }
+  return type;
+}
+
+/**
+ * Get the names of the function called by an event, from the name of
+ * the event implementation and the function pointer.
+ *
+ * The events made by MakeEvent are local classes of MakeEvent,
+ * whose first argument is the function, e.g.
+ * "ns3::EventImpl* ns3::MakeEvent<void (ns3::Node::*)(), ns3::Node*>
+ * (void (ns3::Node::*)(), ns3::Node*)::EventMemberImpl0".
+ * The function is named by its symbol if found, e.g.
+ * "ns3::Node::DoDispose()", and otherwise by this signature followed
+ * by its location.
+ *
+ * \param [in] function The function called by the event.
+ * \returns The names of the function.
+ */
+struct EventName
+GetEventName (const EventProfiler::Function &function)
+{
+  struct EventName name;
+  name.function = Demangle (function.type->name ());
+
+  std::string::size_type pos = name.function.find ("MakeEvent");
+  if (pos != std::string::npos)
+    {
+      pos += 9;
+      // skip the template arguments, if any
+      if (pos < name.function.size () && name.function[pos] == '<')
+        {
+          int depth = 0;
+          for (; pos < name.function.size (); pos++)
+            {
+              if (name.function[pos] == '<')
+                {
+                  depth++;
+                }
+              else if (name.function[pos] == '>' && --depth == 0)
+                {
+                  pos++;
+                  break;
+                }
+            }
+        }
+      // the first argument of MakeEvent is the function
+      if (pos < name.function.size () && name.function[pos] == '(')
+        {
+          std::string::size_type start = pos + 1;
+          std::string::size_type end = start;
+          int depth = 0;
+          for (; end < name.function.size (); end++)
+            {
+              char c = name.function[end];
+              if (c == '(' || c == '<')
+                {
+                  depth++;
+                }
+              else if ((c == ')' || c == '>') && depth > 0)
+                {
+                  depth--;
+                }
+              else if ((c == ',' || c == ')') && depth == 0)
+                {
+                  break;
+                }
+            }
+          name.function = name.function.substr (start, end - start);
+        }
+    }
+
+  // the class of a member function, as in "void (ns3::Node::*)()"
+  std::string::size_type member = name.function.find ("::*)");
+  std::string::size_type open = member == std::string::npos
+    ? std::string::npos : name.function.rfind ('(', member);
+  if (open != std::string::npos)
+    {
+      name.type = name.function.substr (open + 1, member - open - 1);
+    }
+
+  // name the function by its symbol, if any, and the class by the class
+  // of this symbol, which is a subclass for an overridden virtual function
+  std::string symbol;
+  std::string location = GetFunctionLocation (function, symbol);
+  if (!symbol.empty ())
+    {
+      name.function = symbol;
+      std::string type = GetSymbolClass (symbol);
+      if (!type.empty ())
+        {
+          name.type = type;
+        }
+    }
+  else if (!location.empty ())
+    {
+      name.function += " " + location;
+    }
+
+  TypeId tid;
+  if (!name.type.empty () && TypeId::LookupByNameFailSafe (name.type, &tid))
+    {
+      name.group = tid.GetGroupName ();
+    }
+  if (name.type.empty ())
+    {
+      name.type = "(no class)";
+    }
+  if (name.group.empty ())
+    {
+      name.group = "(no group)";
+    }
+  return name;
+}
+
+/** Cache of the names of the functions. */
+typedef std::map<EventProfiler::Function, struct EventName> EventNames;
+
+/**
+ * Get the names of the function called by an event, from a cache.
+ *
+ * \param [in,out] names The cache.
+ * \param [in] function The function called by the event.
+ * \returns The names of the function.
+ */
+const struct EventName &
+LookupEventName (EventNames &names, const EventProfiler::Function &function)
+{
+  EventNames::iterator name = names.find (function);
+  if (name == names.end ())
+    {
+      name = names.insert (std::make_pair (function, GetEventName (function))).first;
+    }
+  return name->second;
+}
+
+/**
+ * Get the label of a context.
+ * \param [in] context The context.
+ * \returns The label.
+ */
+std::string
+GetContextName (uint32_t context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return "no node";
+    }
+  std::ostringstream oss;
+  oss << "node " << context;
+  return oss.str ();
+}
+
+/** The totals of a line of a flat profile. */
+struct Totals
+{
+  uint64_t count;  //!< The number of events.
+  uint64_t ns;     //!< The wall-clock time, in nanoseconds.
+};
+
+/** Sort the lines of a flat profile, most expensive first. */
+struct MoreExpensive
+{
+  /**
+   * \param [in] a The first line.
+   * \param [in] b The second line.
+   * \returns \c true if the first line is more expensive.
+   */
+  bool operator () (const std::pair<std::string, struct Totals> &a,
+                    const std::pair<std::string, struct Totals> &b) const
+  {
+    return a.second.ns > b.second.ns
+      || (a.second.ns == b.second.ns && a.first < b.first);
+  }
+};
+
+/**
+ * Print a section of a flat profile.
+ *
+ * \param [in,out] os The output stream.
+ * \param [in] title The title of the section.
+ * \param [in] lines The totals per line.
+ * \param [in] ns The total time, in nanoseconds.
+ */
+void
+PrintSection (std::ostream &os, std::string title,
+              const std::map<std::string, struct Totals> &lines, uint64_t ns)
+{
+  std::vector<std::pair<std::string, struct Totals> > sorted (lines.begin (), lines.end ());
+  std::sort (sorted.begin (), sorted.end (), MoreExpensive ());
+  os << std::endl << title << ":" << std::endl
+     << "  %time   time(ms)  mean(us)     events  " << title << std::endl;
+  for (std::vector<std::pair<std::string, struct Totals> >::const_iterator i = sorted.begin ();
+       i != sorted.end (); i++)
+    {
+      const struct Totals &totals = i->second;
+      os << std::fixed << std::setprecision (2)
+         << std::setw (7) << (ns > 0 ? 100.0 * totals.ns / ns : 0.0)
+         << std::setw (11) << totals.ns / 1e6
+         << std::setw (10) << (totals.count > 0 ? totals.ns / 1e3 / totals.count : 0.0)
+         << std::setw (11) << totals.count
+         << "  " << i->first << std::endl;
+    }
+}
+
+} // unnamed namespace
+
+
+EventProfiler::EventProfiler (uint32_t samplingPeriod)
+  : m_samplingPeriod (samplingPeriod > 0 ? samplingPeriod : 1),
+    m_events (0)
+{
+  NS_LOG_FUNCTION (this << samplingPeriod);
+}
+
+bool
+EventProfiler::Function::operator < (const Function &other) const
+{
+  if (type != other.type)
+    {
+      return std::less<const std::type_info *> () (type, other.type);
+    }
+  if (size != other.size)
+    {
+      return size < other.size;
+    }
+  if (pointer[0] != other.pointer[0])
+    {
+      return pointer[0] < other.pointer[0];
+    }
+  return pointer[1] < other.pointer[1];
+}
+
+void
+EventProfiler::DoInvoke (EventImpl *event, uint32_t context)
+{
+  Key key = { { &typeid (*event), 0, { 0, 0 } }, context };
+  const void *function = event->GetFunction (key.function.size);
+  if (function != 0)
+    {
+      std::memcpy (key.function.pointer, function,
+                   std::min (key.function.size, sizeof (key.function.pointer)));
+      ResolveMemberFunction (key.function, event->GetBoundObject ());
+    }
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  event->Invoke ();
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - start;
+  struct Samples &samples = m_samples[key];
+  samples.count++;
+  samples.ns += std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ();
+}
+
+void
+EventProfiler::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  EventNames names;
+  std::map<std::string, struct Totals> functions;
+  std::map<std::string, struct Totals> types;
+  std::map<std::string, struct Totals> nodes;
+  struct Totals total = { 0, 0 };
+  for (SamplesMap::const_iterator i = m_samples.begin (); i != m_samples.end (); i++)
+    {
+      const struct EventName &name = LookupEventName (names, i->first.function);
+      uint64_t count = i->second.count * m_samplingPeriod;
+      uint64_t ns = i->second.ns * m_samplingPeriod;
+      struct Totals &function = functions[name.function];
+      struct Totals &type = types[name.group + " " + name.type];
+      struct Totals &node = nodes[GetContextName (i->first.context)];
+      function.count += count;
+      function.ns += ns;
+      type.count += count;
+      type.ns += ns;
+      node.count += count;
+      node.ns += ns;
+      total.count += count;
+      total.ns += ns;
+    }
+
+  std::ios_base::fmtflags ff = os.flags ();
+  std::streamsize oldPrecision = os.precision ();
+  os << "Event profile: " << total.count << " events, "
+     << total.ns / 1e6 << " ms";
+  if (m_samplingPeriod > 1)
+    {
+      os << ", estimated from one event out of " << m_samplingPeriod;
+    }
+  os << std::endl;
+  PrintSection (os, "function", functions, total.ns);
+  PrintSection (os, "TypeId", types, total.ns);
+  PrintSection (os, "node", nodes, total.ns);
+  os.precision (oldPrecision);
+  os.flags (ff);
+}
+
+void
+EventProfiler::PrintStacks (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  EventNames names;
+  std::map<std::string, uint64_t> stacks;
+  for (SamplesMap::const_iterator i = m_samples.begin (); i != m_samples.end (); i++)
+    {
+      const struct EventName &name = LookupEventName (names, i->first.function);
+      std::string stack = name.group + ";" + name.type + ";"
+        + name.function + ";" + GetContextName (i->first.context);
+      stacks[stack] += i->second.ns * m_samplingPeriod / 1000;
+    }
+  for (std::map<std::string, uint64_t>::const_iterator i = stacks.begin (); i != stacks.end (); i++)
+    {
+      os << i->first << " " << i->second << std::endl;
+    }
+}
+
+void
+EventProfiler::Write (std::string prefix) const
+{
+  NS_LOG_FUNCTION (this << prefix);
+  std::ofstream profile ((prefix + ".txt").c_str ());
+  if (!profile.is_open ())
+    {
+      NS_LOG_WARN ("Could not open " << prefix << ".txt");
+      return;
+    }
+  Print (profile);
+  std::ofstream stacks ((prefix + ".folded").c_str ());
+  if (!stacks.is_open ())
+    {
+      NS_LOG_WARN ("Could not open " << prefix << ".folded");
+      return;
+    }
+  PrintStacks (stacks);
+}
+
+} // namespace ns3
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "simple-ref-count.h"
+#include "event-impl.h"
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * Measures the wall-clock time spent in the events, and attributes it
+ * to the function they call, to the TypeId of the class of this
+ * function, and to the context (the node id) of the events.
+ *
+ * An event is identified by the function it calls, as returned by
+ * EventImpl::GetFunction; for a virtual member function, this is the
+ * function of the class of the object the event is bound to, read from
+ * its virtual table. The events made by MakeEvent (hence by
+ * Simulator::Schedule) are named by the demangled symbol of this
+ * function, found with dladdr, e.g. "ns3::Node::DoDispose()".
+ * Otherwise, they are named by the signature of this function,
+ * including its class for the member functions, followed by its offset
+ * in its shared object. The module of an event is the group of the
+ * TypeId of the class of the function, if any.
+ *
+ * To bound the overhead, only one event out of \c samplingPeriod is
+ * timed and attributed, and the counts and times of the profile are
+ * those of the sampled events, multiplied by \c samplingPeriod.
+ *
+ * The profile can be printed as a flat profile, and as stacks folded
+ * for the flame graph tools, with one line per module, TypeId,
+ * function and node, e.g.:
+ * \verbatim
+   PointToPoint;ns3::PointToPointNetDevice;ns3::PointToPointNetDevice::TransmitComplete();node 2 1534
+   \endverbatim
+ * where the last number is the time, in microseconds.
+ */
+class EventProfiler : public SimpleRefCount<EventProfiler>
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] samplingPeriod Profile one event out of \c samplingPeriod.
+   */
+  EventProfiler (uint32_t samplingPeriod);
+
+  /**
+   * Invoke an event, and profile it if it is sampled.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context)
+  {
+    if (++m_events < m_samplingPeriod)
+      {
+        event->Invoke ();
+      }
+    else
+      {
+        m_events = 0;
+        DoInvoke (event, context);
+      }
+  }
+
+  /**
+   * Print the flat profile: the time and the number of events per
+   * function, per TypeId and per node, most expensive first.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void Print (std::ostream &os) const;
+
+  /**
+   * Print the profile as folded stacks.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void PrintStacks (std::ostream &os) const;
+
+  /**
+   * Print the flat profile to the file \c prefix.txt, and the folded
+   * stacks to the file \c prefix.folded.
+   *
+   * \param [in] prefix The prefix of the file names.
+   */
+  void Write (std::string prefix) const;
+
+  /** The function called by an event. */
+  struct Function
+  {
+    const std::type_info *type;  //!< The type of the event implementation.
+    std::size_t size;            //!< The size of the function pointer, 0 if unknown.
+    uintptr_t pointer[2];        //!< The function pointer, zero-padded, or the address of a resolved member function.
+    /**
+     * \param [in] other The other function.
+     * \returns \c true if both functions are equal.
+     */
+    bool operator == (const Function &other) const
+    {
+      return type == other.type && size == other.size
+        && pointer[0] == other.pointer[0] && pointer[1] == other.pointer[1];
+    }
+    /**
+     * \param [in] other The other function.
+     * \returns \c true if this function is ordered before the other one.
+     */
+    bool operator < (const Function &other) const;
+  };
+
+private:
+  /**
+   * Invoke and profile an event.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void DoInvoke (EventImpl *event, uint32_t context);
+
+  /** The functions and contexts profiled. */
+  struct Key
+  {
+    struct Function function;    //!< The function called by the events.
+    uint32_t context;            //!< The context.
+    /**
+     * \param [in] other The other key.
+     * \returns \c true if both keys are equal.
+     */
+    bool operator == (const Key &other) const
+    {
+      return function == other.function && context == other.context;
+    }
+  };
+  /** Hash the keys. */
+  struct KeyHash
+  {
+    /**
+     * \param [in] key The key.
+     * \returns The hash of the key.
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      return std::hash<const void *> () (key.function.type)
+        ^ std::hash<uintptr_t> () (key.function.pointer[0])
+        ^ (std::hash<uintptr_t> () (key.function.pointer[1]) * 31)
+        ^ (std::size_t (key.context) * 0x9e3779b9);
+    }
+  };
+  /** The samples of a function and a context. */
+  struct Samples
+  {
+    uint64_t count;  //!< The number of sampled events.
+    uint64_t ns;     //!< The wall-clock time of the sampled events, in nanoseconds.
+  };
+  /** Container of the samples. */
+  typedef std::unordered_map<Key, Samples, KeyHash> SamplesMap;
+
+  uint32_t m_samplingPeriod;  //!< The sampling period.
+  uint32_t m_events;          //!< The number of events since the last sampled one.
+  SamplesMap m_samples;       //!< The samples.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
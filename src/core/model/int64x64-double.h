@@ -52,9 +52,10 @@ class int64x64_t
    * We could make this a static and initialize in int64x64-double.cc or
    * int64x64.cc, but this requires handling static initialization order
    * when most of the implementation is inline.  Instead, we resort to
-   * this define.
+   * this define of the literal value, which is exact, rather than
+   * calling std::pow in each conversion.
    */
-#define HP_MAX_64    (std::pow (2.0L, 64))
+#define HP_MAX_64    (18446744073709551616.0L)
 
 public:
   /**
@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-record.h"
+#include "simulator.h"
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogRecorder implementation.
+ */
+
+namespace ns3 {
+
+namespace {
+
+/** The number of records of the buffers. */
+uint32_t g_capacity = 4096;
+/** What to do when a buffer is full. */
+enum LogRecorder::Mode g_mode = LogRecorder::FLUSH_WHEN_FULL;
+/** The stream the records are formatted to, or 0 for std::clog. */
+std::ostream *g_output = 0;
+
+/**
+ * Get the mutex which serializes the output of the threads.
+ * \returns The mutex.
+ */
+std::mutex &
+GetOutputMutex (void)
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+/**
+ * The buffer of records of a thread.
+ */
+class RecordBuffer
+{
+public:
+  RecordBuffer ();
+  /** Format the remaining records. */
+  ~RecordBuffer ();
+  /**
+   * Get the record to fill next.
+   * \returns The record.
+   */
+  struct LogRecorder::Entry &Next (void);
+  /** Format the records in order, and clear the buffer. */
+  void Flush (void);
+
+private:
+  std::vector<struct LogRecorder::Entry> m_records;  //!< The records.
+  uint32_t m_next;                                    //!< The index of the next record.
+  bool m_wrapped;                                     //!< Whether old records were overwritten.
+};
+
+RecordBuffer::RecordBuffer ()
+  : m_next (0),
+    m_wrapped (false)
+{
+}
+
+RecordBuffer::~RecordBuffer ()
+{
+  Flush ();
+}
+
+struct LogRecorder::Entry &
+RecordBuffer::Next (void)
+{
+  if (m_records.size () != g_capacity)
+    {
+      Flush ();
+      m_records.resize (g_capacity > 0 ? g_capacity : 1);
+    }
+  else if (m_next == m_records.size ())
+    {
+      if (g_mode == LogRecorder::FLUSH_WHEN_FULL)
+        {
+          Flush ();
+        }
+      else
+        {
+          m_next = 0;
+          m_wrapped = true;
+        }
+    }
+  return m_records[m_next++];
+}
+
+void
+RecordBuffer::Flush (void)
+{
+  if (m_next == 0 && !m_wrapped)
+    {
+      return;
+    }
+  std::lock_guard<std::mutex> lock (GetOutputMutex ());
+  std::ostream &os = g_output != 0 ? *g_output : std::clog;
+  if (m_wrapped)
+    {
+      for (uint32_t i = m_next; i < m_records.size (); i++)
+        {
+          LogRecorder::Format (os, m_records[i]);
+        }
+    }
+  for (uint32_t i = 0; i < m_next; i++)
+    {
+      LogRecorder::Format (os, m_records[i]);
+    }
+  os.flush ();
+  m_next = 0;
+  m_wrapped = false;
+}
+
+/**
+ * Get the buffer of the calling thread.
+ * \returns The buffer.
+ */
+RecordBuffer &
+GetBuffer (void)
+{
+  static thread_local RecordBuffer buffer;
+  return buffer;
+}
+
+} // unnamed namespace
+
+
+struct LogRecorder::Entry &
+LogRecorder::Begin (const LogRecordSite &site)
+{
+  struct Entry &record = GetBuffer ().Next ();
+  record.site = &site;
+  record.nArgs = 0;
+  record.prefixes = 0;
+  static const enum LogLevel prefixes[] = { LOG_PREFIX_FUNC, LOG_PREFIX_TIME, LOG_PREFIX_NODE, LOG_PREFIX_LEVEL };
+  for (uint32_t i = 0; i < sizeof (prefixes) / sizeof (prefixes[0]); i++)
+    {
+      if (site.component->IsEnabled (prefixes[i]))
+        {
+          record.prefixes |= prefixes[i];
+        }
+    }
+  // Simulator::Now is valid only when the simulator sets the time printer
+  if (LogGetTimePrinter () == 0)
+    {
+      record.prefixes &= ~(LOG_PREFIX_TIME | LOG_PREFIX_NODE);
+    }
+  if (record.prefixes & (LOG_PREFIX_TIME | LOG_PREFIX_NODE))
+    {
+      record.time = Simulator::Now ().GetTimeStep ();
+      record.context = Simulator::GetContext ();
+    }
+  return record;
+}
+
+void
+LogRecorder::SetString (struct Entry &record, const char *s)
+{
+  record.types[record.nArgs] = ARG_STRING;
+  char *dst = record.args[record.nArgs++].s;
+  std::strncpy (dst, s != 0 ? s : "(null)", STRING_SIZE - 1);
+  dst[STRING_SIZE - 1] = 0;
+}
+
+void
+LogRecorder::Flush (void)
+{
+  GetBuffer ().Flush ();
+}
+
+void
+LogRecorder::SetCapacity (uint32_t capacity)
+{
+  g_capacity = capacity;
+}
+
+void
+LogRecorder::SetMode (enum Mode mode)
+{
+  g_mode = mode;
+}
+
+void
+LogRecorder::SetOutput (std::ostream *os)
+{
+  std::lock_guard<std::mutex> lock (GetOutputMutex ());
+  g_output = os;
+}
+
+void
+LogRecorder::Format (std::ostream &os, const struct Entry &record)
+{
+  const LogRecordSite &site = *record.site;
+
+  // the prefixes enabled when the record was logged, in the order of NS_LOG
+  if (record.prefixes & LOG_PREFIX_TIME)
+    {
+      std::ios_base::fmtflags ff = os.flags ();
+      std::streamsize oldPrecision = os.precision ();
+      os << std::fixed;
+      switch (Time::GetResolution ())
+        {
+        case Time::US :    os << std::setprecision (6);   break;
+        case Time::NS :    os << std::setprecision (9);   break;
+        case Time::PS :    os << std::setprecision (12);  break;
+        case Time::FS :    os << std::setprecision (15);  break;
+        default :          os << std::setprecision (5);
+        }
+      os << Time (record.time).As (Time::S) << " ";
+      os << std::setprecision (oldPrecision);
+      os.flags (ff);
+    }
+  if (record.prefixes & LOG_PREFIX_NODE)
+    {
+      if (record.context == Simulator::NO_CONTEXT)
+        {
+          os << "-1 ";
+        }
+      else
+        {
+          os << record.context << " ";
+        }
+    }
+  if (record.prefixes & LOG_PREFIX_FUNC)
+    {
+      os << site.component->Name () << ":" << site.function << "(): ";
+    }
+  if (record.prefixes & LOG_PREFIX_LEVEL)
+    {
+      os << "[" << LogComponent::GetLevelLabel (site.level) << "] ";
+    }
+
+  // the message, with each {} replaced by the next argument
+  const char *text = site.format;
+  for (uint8_t arg = 0; arg < record.nArgs; arg++)
+    {
+      const char *next = std::strstr (text, "{}");
+      if (next == 0)
+        {
+          break;
+        }
+      os.write (text, next - text);
+      text = next + 2;
+      const union Argument &value = record.args[arg];
+      switch (record.types[arg])
+        {
+        case ARG_BOOL:    os << (value.i != 0);                        break;
+        case ARG_CHAR:    os << static_cast<char> (value.i);           break;
+        case ARG_INT:     os << value.i;                               break;
+        case ARG_UINT:    os << value.u;                               break;
+        case ARG_DOUBLE:  os << value.d;                               break;
+        case ARG_POINTER: os << value.p;                               break;
+        case ARG_TIME:    os << Time (value.i);                        break;
+        case ARG_STRING:  os << value.s;                               break;
+        }
+    }
+  os << text;
+  os << "\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,394 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LOG_RECORD_H
+#define NS3_LOG_RECORD_H
+
+#include "log.h"
+#include "nstime.h"
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+#include <type_traits>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogRecorder declaration, and the NS_LOG_RECORD macros.
+ */
+
+/**
+ * \ingroup logging
+ * The levels of the NS_LOG_RECORD statements compiled in a file.
+ *
+ * The statements of the other levels are removed by the compiler.
+ * Define it before including this header to compile in only some
+ * levels, e.g., in the hot paths of a model:
+ * \code
+ *   #define NS_LOG_RECORD_LEVELS (ns3::LOG_ERROR | ns3::LOG_WARN)
+ *   #include "ns3/log-record.h"
+ * \endcode
+ */
+#ifndef NS_LOG_RECORD_LEVELS
+#define NS_LOG_RECORD_LEVELS ns3::LOG_ALL
+#endif
+
+/**
+ * \ingroup logging
+ * Record a log message in the buffer of the calling thread, if the
+ * log component of the file is enabled at this level.
+ *
+ * Unlike NS_LOG, the message is not formatted when it is logged:
+ * the arguments are copied in a binary record, and the message is
+ * formatted when the buffer is flushed.  Each \c {} of the format is
+ * replaced by the next argument.  The arguments can be integers,
+ * floating-point numbers, booleans, enums, pointers, Time, strings
+ * (truncated to LogRecorder::STRING_SIZE - 1 characters) and, at the
+ * cost of formatting them when they are logged, any type with an
+ * output operator.  This macro is available in optimized builds too.
+ *
+ * \code
+ *   NS_LOG_RECORD (ns3::LOG_DEBUG, "dequeued packet {} of {} bytes", uid, size);
+ * \endcode
+ *
+ * \param [in] level The log level.
+ * \param [in] format The message format, a string literal.
+ * \param [in] ... The arguments of the message, at most LogRecorder::MAX_ARGS.
+ */
+#define NS_LOG_RECORD(level, format, ...)                               \
+  do                                                                    \
+    {                                                                   \
+      if (((level) & (NS_LOG_RECORD_LEVELS)) && g_log.IsEnabled (level)) \
+        {                                                               \
+          static const ns3::LogRecordSite ns3LogRecordSite =            \
+            { &g_log, level, __FUNCTION__, format };                    \
+          ns3::LogRecorder::Record (ns3LogRecordSite, ## __VA_ARGS__);  \
+        }                                                               \
+    }                                                                   \
+  while (false)
+
+/**
+ * \ingroup logging
+ * Record a LOG_ERROR message.
+ * \param [in] format The message format.
+ * \param [in] ... The arguments of the message.
+ */
+#define NS_LOG_RECORD_ERROR(format, ...) \
+  NS_LOG_RECORD (ns3::LOG_ERROR, format, ## __VA_ARGS__)
+/**
+ * \ingroup logging
+ * Record a LOG_WARN message.
+ * \param [in] format The message format.
+ * \param [in] ... The arguments of the message.
+ */
+#define NS_LOG_RECORD_WARN(format, ...) \
+  NS_LOG_RECORD (ns3::LOG_WARN, format, ## __VA_ARGS__)
+/**
+ * \ingroup logging
+ * Record a LOG_DEBUG message.
+ * \param [in] format The message format.
+ * \param [in] ... The arguments of the message.
+ */
+#define NS_LOG_RECORD_DEBUG(format, ...) \
+  NS_LOG_RECORD (ns3::LOG_DEBUG, format, ## __VA_ARGS__)
+/**
+ * \ingroup logging
+ * Record a LOG_INFO message.
+ * \param [in] format The message format.
+ * \param [in] ... The arguments of the message.
+ */
+#define NS_LOG_RECORD_INFO(format, ...) \
+  NS_LOG_RECORD (ns3::LOG_INFO, format, ## __VA_ARGS__)
+/**
+ * \ingroup logging
+ * Record a LOG_LOGIC message.
+ * \param [in] format The message format.
+ * \param [in] ... The arguments of the message.
+ */
+#define NS_LOG_RECORD_LOGIC(format, ...) \
+  NS_LOG_RECORD (ns3::LOG_LOGIC, format, ## __VA_ARGS__)
+
+namespace ns3 {
+
+/**
+ * \ingroup logging
+ * The static description of an NS_LOG_RECORD statement, shared by
+ * all its records.
+ */
+struct LogRecordSite
+{
+  const LogComponent *component;  //!< The log component.
+  enum LogLevel level;            //!< The log level.
+  const char *function;           //!< The function name.
+  const char *format;             //!< The message format.
+};
+
+/**
+ * \ingroup logging
+ * Records log messages in a buffer per thread, and formats them when
+ * the buffer is flushed.
+ *
+ * In the \c FLUSH_WHEN_FULL mode (the default), the records are
+ * formatted to the output stream when the buffer of the thread is
+ * full, when Flush is called, and when the thread exits.  In the
+ * \c KEEP_LAST mode, the buffer is a ring which keeps the last records
+ * until Flush is called or the thread exits, like a flight recorder.
+ */
+class LogRecorder
+{
+public:
+  /** The maximum number of arguments of a record. */
+  static const uint32_t MAX_ARGS = 8;
+  /** The size of a string argument, including its terminating null character. */
+  static const uint32_t STRING_SIZE = 32;
+
+  /** What to do when the buffer of a thread is full. */
+  enum Mode
+  {
+    FLUSH_WHEN_FULL,  //!< Format the records to the output stream.
+    KEEP_LAST         //!< Overwrite the oldest records.
+  };
+
+  /** The type of an argument. */
+  enum ArgumentType
+  {
+    ARG_BOOL,     //!< A boolean.
+    ARG_CHAR,     //!< A character.
+    ARG_INT,      //!< A signed integer or an enum.
+    ARG_UINT,     //!< An unsigned integer.
+    ARG_DOUBLE,   //!< A floating-point number.
+    ARG_POINTER,  //!< A pointer.
+    ARG_TIME,     //!< A Time.
+    ARG_STRING    //!< A string, possibly truncated.
+  };
+
+  /** An argument of a record. */
+  union Argument
+  {
+    int64_t i;                //!< ARG_BOOL, ARG_CHAR, ARG_INT and ARG_TIME value.
+    uint64_t u;               //!< ARG_UINT value.
+    double d;                 //!< ARG_DOUBLE value.
+    const void *p;            //!< ARG_POINTER value.
+    char s[STRING_SIZE];      //!< ARG_STRING value.
+  };
+
+  /** A record. */
+  struct Entry
+  {
+    const LogRecordSite *site;          //!< The statement which logged the record.
+    int64_t time;                       //!< The simulation time, in time steps.
+    uint32_t context;                   //!< The simulation context.
+    uint32_t prefixes;                  //!< The prefixes enabled when the record was logged.
+    uint8_t nArgs;                      //!< The number of arguments.
+    uint8_t types[MAX_ARGS];            //!< The types of the arguments.
+    union Argument args[MAX_ARGS];      //!< The arguments.
+  };
+
+  /**
+   * Record a message in the buffer of the calling thread.
+   *
+   * \tparam Ts \deduced The types of the arguments.
+   * \param [in] site The statement which logs the message.
+   * \param [in] args The arguments of the message.
+   */
+  template <typename... Ts>
+  static void Record (const LogRecordSite &site, const Ts &... args);
+
+  /**
+   * Format the records of the calling thread to the output stream,
+   * and clear its buffer.
+   */
+  static void Flush (void);
+
+  /**
+   * Set the number of records of the buffers of the threads which
+   * record their first message afterwards.  The default is 4096.
+   *
+   * \param [in] capacity The number of records.
+   */
+  static void SetCapacity (uint32_t capacity);
+
+  /**
+   * Set what to do when the buffer of a thread is full.
+   *
+   * \param [in] mode The mode.
+   */
+  static void SetMode (enum Mode mode);
+
+  /**
+   * Set the stream the records are formatted to.  The default is
+   * \c std::clog.
+   *
+   * \param [in] os The output stream, which must outlive the recorder.
+   */
+  static void SetOutput (std::ostream *os);
+
+  /**
+   * Format a record.
+   *
+   * \param [in] os The output stream.
+   * \param [in] record The record.
+   */
+  static void Format (std::ostream &os, const struct Entry &record);
+
+private:
+  /**
+   * Get the next record of the buffer of the calling thread, and set
+   * its site, time and context.
+   *
+   * \param [in] site The statement which logs the record.
+   * \returns The record.
+   */
+  static struct Entry &Begin (const LogRecordSite &site);
+
+  /**
+   * Set a string argument.
+   * \param [out] record The record.
+   * \param [in] s The string.
+   */
+  static void SetString (struct Entry &record, const char *s);
+
+  /**
+   * \name Set the next argument of a record.
+   * \param [out] record The record.
+   * \param [in] value The value of the argument.
+   */
+  /**@{*/
+  static void SetArgument (struct Entry &record, bool value)
+  {
+    record.types[record.nArgs] = ARG_BOOL;
+    record.args[record.nArgs++].i = value;
+  }
+  static void SetArgument (struct Entry &record, char value)
+  {
+    record.types[record.nArgs] = ARG_CHAR;
+    record.args[record.nArgs++].i = value;
+  }
+  static void SetArgument (struct Entry &record, const Time &value)
+  {
+    record.types[record.nArgs] = ARG_TIME;
+    record.args[record.nArgs++].i = value.GetTimeStep ();
+  }
+  static void SetArgument (struct Entry &record, const char *value)
+  {
+    SetString (record, value);
+  }
+  static void SetArgument (struct Entry &record, char *value)
+  {
+    SetString (record, value);
+  }
+  static void SetArgument (struct Entry &record, const std::string &value)
+  {
+    SetString (record, value.c_str ());
+  }
+  template <typename T>
+  static void SetArgument (struct Entry &record, const T &value);
+  /**@}*/
+
+  /**
+   * \name Set the next argument of a record, by category of type.
+   * \param [out] record The record.
+   * \param [in] value The value of the argument.
+   */
+  /**@{*/
+  template <typename T>
+  static void DoSetArgument (struct Entry &record, const T &value, std::true_type, std::false_type, std::false_type)
+  {
+    if (std::is_signed<T>::value)
+      {
+        record.types[record.nArgs] = ARG_INT;
+        record.args[record.nArgs++].i = static_cast<int64_t> (value);
+      }
+    else
+      {
+        record.types[record.nArgs] = ARG_UINT;
+        record.args[record.nArgs++].u = static_cast<uint64_t> (value);
+      }
+  }
+  template <typename T>
+  static void DoSetArgument (struct Entry &record, const T &value, std::false_type, std::true_type, std::false_type)
+  {
+    record.types[record.nArgs] = ARG_DOUBLE;
+    record.args[record.nArgs++].d = value;
+  }
+  template <typename T>
+  static void DoSetArgument (struct Entry &record, const T &value, std::false_type, std::false_type, std::true_type)
+  {
+    record.types[record.nArgs] = ARG_POINTER;
+    record.args[record.nArgs++].p = value;
+  }
+  template <typename T>
+  static void DoSetArgument (struct Entry &record, const T &value, std::false_type, std::false_type, std::false_type)
+  {
+    std::ostringstream oss;
+    oss << value;
+    SetString (record, oss.str ().c_str ());
+  }
+  /**@}*/
+
+  /**
+   * Set no argument: end of the recursion on the arguments.
+   * \param [in] record The record.
+   */
+  static void SetArguments (struct Entry &record)
+  {
+  }
+  /**
+   * Set the arguments of a record.
+   * \tparam T \deduced The type of the first argument.
+   * \tparam Ts \deduced The types of the next arguments.
+   * \param [out] record The record.
+   * \param [in] value The first argument.
+   * \param [in] values The next arguments.
+   */
+  template <typename T, typename... Ts>
+  static void SetArguments (struct Entry &record, const T &value, const Ts &... values)
+  {
+    SetArgument (record, value);
+    SetArguments (record, values...);
+  }
+};
+
+
+/*************************************************************************
+ *  Implementation of the templates declared above.
+ *************************************************************************/
+
+template <typename T>
+void
+LogRecorder::SetArgument (struct Entry &record, const T &value)
+{
+  // integers and enums, floating-point numbers, pointers, or other types
+  DoSetArgument (record, value,
+                 std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value> (),
+                 std::integral_constant<bool, std::is_floating_point<T>::value> (),
+                 std::integral_constant<bool, std::is_pointer<T>::value> ());
+}
+
+template <typename... Ts>
+void
+LogRecorder::Record (const LogRecordSite &site, const Ts &... args)
+{
+  static_assert (sizeof... (Ts) <= MAX_ARGS, "Too many arguments in a log record");
+  struct Entry &record = Begin (site);
+  SetArguments (record, args...);
+}
+
+} // namespace ns3
+
+#endif /* NS3_LOG_RECORD_H */
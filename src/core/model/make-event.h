@@ -316,6 +316,7 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
 
 #include "event-impl.h"
 #include "type-traits.h"
+#include <type_traits>
 
 namespace ns3 {
 
@@ -355,6 +356,35 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This helper gets the class of a pointer to member function (or to a
+ * callable data member).
+ *
+ * This is the generic template declaration (with empty body).
+ *
+ * \tparam MEM \explicit The pointer to member type.
+ */
+template <typename MEM>
+struct EventMemberImplClassTraits;
+
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This is the specialization for pointers to members.
+ *
+ * \tparam T \explicit The type of the member, e.g. a function type.
+ * \tparam C \explicit The class type.
+ */
+template <typename T, typename C>
+struct EventMemberImplClassTraits<T C::*>
+{
+  typedef C Class;  //!< The class of the member.
+};
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -375,6 +405,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -405,6 +454,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -436,6 +504,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -469,6 +556,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -504,6 +610,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -542,6 +667,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -582,6 +726,25 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          size = 0;
+          return 0;
+        }
+      size = sizeof (m_function);
+      return &m_function;
+    }
+    virtual const void * GetBoundObject (void) const
+    {
+      if (!std::is_member_function_pointer<MEM>::value)
+        {
+          return 0;
+        }
+      return static_cast<const typename EventMemberImplClassTraits<MEM>::Class *>
+               (&EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -617,6 +780,11 @@ private:
     {
       (*m_function)(m_a1);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -647,6 +815,11 @@ private:
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -680,6 +853,11 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -715,6 +893,11 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -752,6 +935,11 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -791,6 +979,11 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * GetFunction (std::size_t &size) const
+    {
+      size = sizeof (m_function);
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
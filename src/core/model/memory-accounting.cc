@@ -0,0 +1,310 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "memory-accounting.h"
+#include "simulator.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::MemoryAccounting implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MemoryAccounting");
+
+namespace {
+
+/** The memory used by a subsystem in a context. */
+typedef struct MemoryAccounting::Usage Usage;
+
+/** The memory used by a subsystem. */
+struct SubsystemUsage
+{
+  std::string name;            //!< The name of the subsystem.
+  Usage total;                 //!< The memory used in all the contexts.
+  Usage noContext;             //!< The memory used out of any context.
+  std::vector<Usage> contexts; //!< The memory used per context.
+};
+
+/** A block accounted for. */
+struct Block
+{
+  MemoryAccounting::Subsystem subsystem;  //!< The subsystem of the block.
+  uint32_t context;                       //!< The context of the block.
+  uint64_t bytes;                         //!< The size of the block.
+};
+
+/** The state of the accounting. */
+struct State
+{
+  std::vector<struct SubsystemUsage> subsystems;                         //!< The subsystems.
+  std::unordered_map<std::string, MemoryAccounting::Subsystem> names;    //!< The subsystems by name.
+  std::unordered_map<const void *, struct Block> blocks;                 //!< The blocks accounted for.
+};
+
+/**
+ * Get the state of the accounting.  It is never destroyed, since
+ * blocks can be freed by static destructors.
+ * \returns The state.
+ */
+struct State &
+GetState (void)
+{
+  static struct State *state = new struct State ();
+  return *state;
+}
+
+/**
+ * Get the usage of a subsystem in a context.
+ * \param [in,out] subsystem The subsystem.
+ * \param [in] context The context.
+ * \returns The usage.
+ */
+Usage &
+GetContextUsage (struct SubsystemUsage &subsystem, uint32_t context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return subsystem.noContext;
+    }
+  if (context >= subsystem.contexts.size ())
+    {
+      Usage empty = { 0, 0, 0 };
+      subsystem.contexts.resize (context + 1, empty);
+    }
+  return subsystem.contexts[context];
+}
+
+/**
+ * Print a line of usage.
+ * \param [in,out] os The output stream.
+ * \param [in] label The label of the line.
+ * \param [in] usage The usage.
+ */
+void
+PrintUsage (std::ostream &os, std::string label, const Usage &usage)
+{
+  os << "  " << std::left << std::setw (32) << label << std::right
+     << std::setw (10) << usage.count
+     << std::setw (14) << usage.bytes
+     << std::setw (14) << usage.peakBytes << std::endl;
+}
+
+} // unnamed namespace
+
+
+bool MemoryAccounting::m_enabled = false;
+uint64_t MemoryAccounting::m_nBlocks = 0;
+
+void
+MemoryAccounting::Enable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = true;
+}
+
+void
+MemoryAccounting::Disable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = false;
+}
+
+MemoryAccounting::Subsystem
+MemoryAccounting::GetSubsystem (std::string name)
+{
+  NS_LOG_FUNCTION (name);
+  struct State &state = GetState ();
+  std::unordered_map<std::string, Subsystem>::const_iterator i = state.names.find (name);
+  if (i != state.names.end ())
+    {
+      return i->second;
+    }
+  Subsystem subsystem = state.subsystems.size ();
+  struct SubsystemUsage usage;
+  usage.name = name;
+  usage.total.count = usage.total.bytes = usage.total.peakBytes = 0;
+  usage.noContext = usage.total;
+  state.subsystems.push_back (usage);
+  state.names[name] = subsystem;
+  return subsystem;
+}
+
+uint32_t
+MemoryAccounting::GetNSubsystems (void)
+{
+  return GetState ().subsystems.size ();
+}
+
+std::string
+MemoryAccounting::GetName (Subsystem subsystem)
+{
+  NS_ASSERT (subsystem < GetState ().subsystems.size ());
+  return GetState ().subsystems[subsystem].name;
+}
+
+void
+MemoryAccounting::Allocate (Subsystem subsystem, const void *block, uint64_t bytes)
+{
+  // the simulator sets the node printer while it exists: do not create it
+  uint32_t context = LogGetNodePrinter () != 0
+    ? Simulator::GetContext () : Simulator::NO_CONTEXT;
+  Allocate (subsystem, block, bytes, context);
+}
+
+void
+MemoryAccounting::Allocate (Subsystem subsystem, const void *block, uint64_t bytes, uint32_t context)
+{
+  struct State &state = GetState ();
+  NS_ASSERT (subsystem < state.subsystems.size ());
+  struct Block accounted = { subsystem, context, bytes };
+  if (!state.blocks.insert (std::make_pair (block, accounted)).second)
+    {
+      // accounted for again, e.g., moved from a free list
+      Free (block);
+      state.blocks.insert (std::make_pair (block, accounted));
+    }
+  m_nBlocks++;
+  struct SubsystemUsage &usage = state.subsystems[subsystem];
+  Usage *usages[2] = { &usage.total, &GetContextUsage (usage, context) };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      usages[i]->count++;
+      usages[i]->bytes += bytes;
+      usages[i]->peakBytes = std::max (usages[i]->peakBytes, usages[i]->bytes);
+    }
+}
+
+void
+MemoryAccounting::Free (const void *block)
+{
+  struct State &state = GetState ();
+  std::unordered_map<const void *, struct Block>::iterator i = state.blocks.find (block);
+  if (i == state.blocks.end ())
+    {
+      return;
+    }
+  struct SubsystemUsage &usage = state.subsystems[i->second.subsystem];
+  Usage *usages[2] = { &usage.total, &GetContextUsage (usage, i->second.context) };
+  for (uint32_t j = 0; j < 2; j++)
+    {
+      usages[j]->count--;
+      usages[j]->bytes -= i->second.bytes;
+    }
+  state.blocks.erase (i);
+  m_nBlocks--;
+}
+
+struct MemoryAccounting::Usage
+MemoryAccounting::GetUsage (Subsystem subsystem)
+{
+  NS_ASSERT (subsystem < GetState ().subsystems.size ());
+  return GetState ().subsystems[subsystem].total;
+}
+
+struct MemoryAccounting::Usage
+MemoryAccounting::GetUsage (Subsystem subsystem, uint32_t context)
+{
+  NS_ASSERT (subsystem < GetState ().subsystems.size ());
+  return GetContextUsage (GetState ().subsystems[subsystem], context);
+}
+
+void
+MemoryAccounting::Print (std::ostream &os)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  const struct State &state = GetState ();
+  std::ios_base::fmtflags ff = os.flags ();
+  os << "Memory accounting";
+  if (LogGetTimePrinter () != 0)
+    {
+      os << " at " << Simulator::Now ().GetSeconds () << "s";
+    }
+  os << ":" << std::endl;
+  os << "  " << std::left << std::setw (32) << "subsystem" << std::right
+     << std::setw (10) << "blocks"
+     << std::setw (14) << "bytes"
+     << std::setw (14) << "peak bytes" << std::endl;
+  uint32_t nContexts = 0;
+  for (std::vector<struct SubsystemUsage>::const_iterator i = state.subsystems.begin ();
+       i != state.subsystems.end (); i++)
+    {
+      if (i->total.count != 0 || i->total.peakBytes != 0)
+        {
+          PrintUsage (os, i->name, i->total);
+        }
+      nContexts = std::max<uint32_t> (nContexts, i->contexts.size ());
+    }
+  for (uint32_t context = 0; context <= nContexts; context++)
+    {
+      bool first = true;
+      for (std::vector<struct SubsystemUsage>::const_iterator i = state.subsystems.begin ();
+           i != state.subsystems.end (); i++)
+        {
+          const Usage *usage = context == nContexts ? &i->noContext
+            : context < i->contexts.size () ? &i->contexts[context] : 0;
+          if (usage == 0 || (usage->count == 0 && usage->peakBytes == 0))
+            {
+              continue;
+            }
+          if (first)
+            {
+              if (context == nContexts)
+                {
+                  os << "no node:" << std::endl;
+                }
+              else
+                {
+                  os << "node " << context << ":" << std::endl;
+                }
+              first = false;
+            }
+          PrintUsage (os, i->name, *usage);
+        }
+    }
+  os.flags (ff);
+}
+
+void
+MemoryAccounting::PrintEvery (Time interval, std::ostream &os)
+{
+  NS_LOG_FUNCTION (interval);
+  Simulator::ScheduleNow (&MemoryAccounting::PrintPeriodically, interval, &os);
+}
+
+void
+MemoryAccounting::PrintPeriodically (Time interval, std::ostream *os)
+{
+  Print (*os);
+  if (Simulator::IsFinished ())
+    {
+      // nothing else is scheduled: printing again would keep the
+      // simulation running forever
+      return;
+    }
+  Simulator::Schedule (interval, &MemoryAccounting::PrintPeriodically, interval, os);
+}
+
+} // namespace ns3
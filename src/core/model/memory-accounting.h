@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include "nstime.h"
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::MemoryAccounting declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * Accounts for the memory blocks allocated by the subsystems of the
+ * simulator, per subsystem and per node.
+ *
+ * The subsystems accounted are the packet buffers (Buffer::Data) and
+ * metadata (PacketMetadata::Data), including their free lists, the
+ * events (EventImpl), and the Objects, per TypeId.  Each block is
+ * attributed to the context (the node id) of the event which allocated
+ * it, until it is freed.
+ *
+ * The accounting is disabled by default, and costs a test of a flag
+ * per allocation and free while disabled.  When enabled, each block is
+ * recorded in a hash table, and the accounting is not thread-safe: it
+ * can be used with the default simulator implementation only.
+ *
+ * \code
+ *   MemoryAccounting::Enable ();
+ *   MemoryAccounting::PrintEvery (Seconds (1), std::cout);
+ *   Simulator::Stop (Seconds (10));
+ *   Simulator::Run ();
+ * \endcode
+ */
+class MemoryAccounting
+{
+public:
+  /** The id of a subsystem. */
+  typedef uint32_t Subsystem;
+
+  /** The memory used by a subsystem. */
+  struct Usage
+  {
+    uint64_t count;      //!< The number of live blocks.
+    uint64_t bytes;      //!< The number of bytes of the live blocks.
+    uint64_t peakBytes;  //!< The maximum of \c bytes.
+  };
+
+  /** Start accounting for the blocks allocated. */
+  static void Enable (void);
+  /**
+   * Stop accounting for the blocks allocated.  The blocks already
+   * accounted for are still released when they are freed.
+   */
+  static void Disable (void);
+  /**
+   * \returns \c true if the blocks allocated are accounted for.
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled;
+  }
+  /**
+   * \returns \c true if some blocks are accounted for, i.e., if the
+   * blocks freed must be released.
+   */
+  static bool HasBlocks (void)
+  {
+    return m_nBlocks != 0;
+  }
+
+  /**
+   * Get the id of a subsystem, and register it if needed.
+   *
+   * \param [in] name The name of the subsystem.
+   * \returns The id of the subsystem.
+   */
+  static Subsystem GetSubsystem (std::string name);
+  /**
+   * \returns The number of subsystems.
+   */
+  static uint32_t GetNSubsystems (void);
+  /**
+   * \param [in] subsystem The id of a subsystem.
+   * \returns The name of the subsystem.
+   */
+  static std::string GetName (Subsystem subsystem);
+
+  /**
+   * Account for a block allocated in the current context.  To be called
+   * only if IsEnabled.
+   *
+   * \param [in] subsystem The subsystem which allocated the block.
+   * \param [in] block The block.
+   * \param [in] bytes The size of the block.
+   */
+  static void Allocate (Subsystem subsystem, const void *block, uint64_t bytes);
+  /**
+   * Account for a block allocated in a given context.  To be called
+   * only if IsEnabled.
+   *
+   * \param [in] subsystem The subsystem which allocated the block.
+   * \param [in] block The block.
+   * \param [in] bytes The size of the block.
+   * \param [in] context The context, or Simulator::NO_CONTEXT.
+   */
+  static void Allocate (Subsystem subsystem, const void *block, uint64_t bytes, uint32_t context);
+  /**
+   * Release a block, if it is accounted for.  To be called only if
+   * HasBlocks.
+   *
+   * \param [in] block The block.
+   */
+  static void Free (const void *block);
+
+  /**
+   * \param [in] subsystem The id of a subsystem.
+   * \returns The memory used by the subsystem in all the contexts.
+   */
+  static struct Usage GetUsage (Subsystem subsystem);
+  /**
+   * \param [in] subsystem The id of a subsystem.
+   * \param [in] context The context, or Simulator::NO_CONTEXT.
+   * \returns The memory used by the subsystem in the context.
+   */
+  static struct Usage GetUsage (Subsystem subsystem, uint32_t context);
+
+  /**
+   * Print the memory used per subsystem, and per node and subsystem.
+   *
+   * \param [in,out] os The output stream.
+   */
+  static void Print (std::ostream &os);
+  /**
+   * Print the memory used periodically, from now on.  The prints stop
+   * after the one made when no other event is pending, so that they do
+   * not keep the simulation running; however, with other periodic
+   * events, they go on until Simulator::Stop.
+   *
+   * \param [in] interval The interval between two prints.
+   * \param [in,out] os The output stream, which must outlive the
+   *                    simulation.
+   */
+  static void PrintEvery (Time interval, std::ostream &os);
+
+private:
+  /**
+   * Print the memory used, and schedule the next print unless no
+   * other event is pending.
+   *
+   * \param [in] interval The interval between two prints.
+   * \param [in,out] os The output stream.
+   */
+  static void PrintPeriodically (Time interval, std::ostream *os);
+
+  static bool m_enabled;      //!< Whether the blocks allocated are accounted for.
+  static uint64_t m_nBlocks;  //!< The number of blocks accounted for.
+};
+
+} // namespace ns3
+
+#endif /* MEMORY_ACCOUNTING_H */
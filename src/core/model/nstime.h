@@ -455,11 +455,30 @@ public:
   }
   inline static Time FromDouble (double value, enum Unit unit)
   {
+    struct Information *info = PeekInformation (unit);
+    // integer values in a coarser unit are converted exactly by an
+    // integer multiplication, if the result fits
+    if (info->fromMul && std::fabs (value) <= info->maxFrom)
+      {
+        int64_t integer = static_cast<int64_t> (value);
+        if (integer == value)
+          {
+            return Time (integer * info->factor);
+          }
+      }
     return From (int64x64_t (value), unit);
   }
   inline static Time From (const int64x64_t & value, enum Unit unit)
   {
     struct Information *info = PeekInformation (unit);
+    if (info->fromMul && value.GetLow () == 0)
+      {
+        int64_t integer = value.GetHigh ();
+        if (integer <= info->maxFrom && integer >= -info->maxFrom)
+          {
+            return Time (integer * info->factor);
+          }
+      }
     // DO NOT REMOVE this temporary variable. It's here
     // to work around a compiler bug in gcc 3.4
     int64x64_t retval = value;
@@ -473,6 +492,17 @@ public:
       }
     return Time (retval);
   }
+  /**
+   *  Create a Time equal to \p numerator / \p denominator in unit \c unit,
+   *  rounded down to the resolution, with integer arithmetic only, e.g.,
+   *  the transmission time of a number of bits at a bit rate, in seconds.
+   *
+   *  \param [in] numerator The numerator of the value.
+   *  \param [in] denominator The denominator of the value, not zero.
+   *  \param [in] unit The unit of the value.
+   *  \return The Time representing the value in \c unit.
+   */
+  static Time FromRatio (uint64_t numerator, uint64_t denominator, enum Unit unit);
   /**@}*/
 
 
@@ -559,6 +589,7 @@ private:
     bool toMul;                     //!< Multiply when converting To, otherwise divide
     bool fromMul;                   //!< Multiple when converting From, otherwise divide
     int64_t factor;                 //!< Ratio of this unit / current unit
+    int64_t maxFrom;                //!< Maximum integer converted From this unit by an integer multiplication
     int64x64_t timeTo;              //!< Multiplier to convert to this unit
     int64x64_t timeFrom;            //!< Multiplier to convert from this unit
   };
@@ -882,6 +913,11 @@ operator * (const int64_t & lhs, const Time & rhs)
 inline Time
 operator * (const Time & lhs, const int64x64_t & rhs)
 {
+  if (rhs.GetLow () == 0)
+    {
+      // an integer factor: the product is exact
+      return lhs * rhs.GetHigh ();
+    }
   int64x64_t res = lhs.m_data;
   res *= rhs;
   return Time (res);
@@ -936,6 +972,18 @@ operator / (const Time & lhs, const int64_t & rhs)
 inline Time
 operator / (const Time & lhs, const int64x64_t & rhs)
 {
+  if (rhs.GetLow () == 0 && rhs.GetHigh () != 0)
+    {
+      // an integer divisor: round down, as int64x64_t does
+      int64_t divisor = rhs.GetHigh ();
+      Time res = lhs;
+      res.m_data /= divisor;
+      if (res.m_data * divisor != lhs.m_data && ((lhs.m_data < 0) != (divisor < 0)))
+        {
+          res.m_data--;
+        }
+      return res;
+    }
   int64x64_t res = lhs.m_data;
   res /= rhs;
   return Time (res);
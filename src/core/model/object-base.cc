@@ -22,10 +22,14 @@
 #include "trace-source-accessor.h"
 #include "attribute-construction-list.h"
 #include "string.h"
+#include "pointer.h"
+#include "simple-ref-count.h"
 #include "ns3/core-config.h"
 #ifdef HAVE_STDLIB_H
 #include <cstdlib>
 #endif
+#include <map>
+#include <vector>
 
 /**
  * \file
@@ -76,93 +80,223 @@ ObjectBase::NotifyConstructionCompleted (void)
   NS_LOG_FUNCTION (this);
 }
 
-void
-ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
+/**
+ * \ingroup object
+ * The Attributes set by ObjectBase::ConstructSelf on the objects of
+ * a TypeId.
+ *
+ * The plan lists the Attributes of the TypeId and of its parents, in
+ * the order they are set, with their initial values (or the values
+ * given by the \c NS_ATTRIBUTE_DEFAULT environment variable) already
+ * validated by their checkers, so that constructing an object does
+ * not look the TypeIds up nor parse string values.
+ */
+class ConstructionPlan : public SimpleRefCount<ConstructionPlan>
+{
+public:
+  /** An Attribute set at construction. */
+  struct Item
+  {
+    TypeId tid;                             //!< The TypeId which registered the Attribute.
+    std::string name;                       //!< The Attribute name.
+    uint32_t flags;                         //!< The Attribute flags.
+    Ptr<const AttributeAccessor> accessor;  //!< The Attribute accessor.
+    Ptr<const AttributeChecker> checker;    //!< The Attribute checker.
+    /**
+     * The value to set when none is given at construction, or zero
+     * if it is not valid.
+     */
+    Ptr<const AttributeValue> value;
+    /**
+     * The initial value of the Attribute, when \c value must be
+     * validated at each construction.
+     *
+     * This is the case of the string values of the Pointer Attributes,
+     * which create a new object each time they are validated.
+     */
+    Ptr<const AttributeValue> initialValue;
+  };
+
+  /**
+   * Build the plan of a TypeId.
+   *
+   * \param [in] tid The TypeId.
+   */
+  ConstructionPlan (TypeId tid);
+
+  /** The generation of the Attributes the plan was built from. */
+  uint32_t m_generation;
+  /** The Attributes, in the order they are set. */
+  std::vector<struct Item> m_items;
+};
+
+ConstructionPlan::ConstructionPlan (TypeId tid)
+  : m_generation (TypeId::GetAttributeGeneration ())
 {
+  NS_LOG_FUNCTION (this << tid.GetName ());
+  std::map<std::string, std::string> env;
+#ifdef HAVE_GETENV
+  char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0)
+    {
+      std::string tmp = std::string (envVar);
+      std::string::size_type cur = 0;
+      std::string::size_type next = 0;
+      while (next != std::string::npos)
+        {
+          next = tmp.find (";", cur);
+          std::string item = std::string (tmp, cur, next - cur);
+          std::string::size_type equal = item.find ("=");
+          if (equal != std::string::npos)
+            {
+              env[item.substr (0, equal)] = item.substr (equal + 1);
+            }
+          cur = next + 1;
+        }
+    }
+#endif /* HAVE_GETENV */
+
   // loop over the inheritance tree back to the Object base class.
-  NS_LOG_FUNCTION (this << &attributes);
-  TypeId tid = GetInstanceTypeId ();
   do {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
-          NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find(info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          struct Item item;
+          item.tid = tid;
+          item.name = info.name;
+          item.flags = info.flags;
+          item.accessor = info.accessor;
+          item.checker = info.checker;
+          bool pointer = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0;
+          std::map<std::string, std::string>::const_iterator it = env.find (tid.GetAttributeFullName (i));
+          if (it != env.end ())
             {
-              // Handle this attribute if it should not be 
-              // set here.
-              if (value == 0)
+              StringValue envValue (it->second);
+              if (pointer)
                 {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
-                }              
+                  item.value = envValue.Copy ();
+                }
               else
                 {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
+                  item.value = info.checker->CreateValidValue (envValue);
                 }
-            }
-
-          if (value != 0)
-            {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
+              if (item.value != 0)
                 {
-                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                info.name<<"\"");
-                  continue;
+                  NS_LOG_DEBUG ("plan \"" << tid.GetName () << "::" << info.name << "\" from env var");
                 }
             }
-
-#ifdef HAVE_GETENV
-          // No matching attribute value so we try to look at the env var.
-          char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-          if (envVar != 0)
+          if (pointer)
             {
-              std::string env = std::string (envVar);
-              std::string::size_type cur = 0;
-              std::string::size_type next = 0;
-              while (next != std::string::npos)
+              item.initialValue = info.initialValue;
+              if (item.value == 0)
                 {
-                  next = env.find (";", cur);
-                  std::string tmp = std::string (env, cur, next-cur);
-                  std::string::size_type equal = tmp.find ("=");
-                  if (equal != std::string::npos)
-                    {
-                      std::string name = tmp.substr (0, equal);
-                      std::string envval = tmp.substr (equal+1, tmp.size () - equal - 1);
-                      if (name == tid.GetAttributeFullName (i))
-                        {
-                          if (DoSet (info.accessor, info.checker, StringValue (envval)))
-                            {
-                              NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                            info.name <<"\" from env var");
-                              break;
-                            }
-                        }
-                    }
-                  cur = next + 1;
+                  item.value = info.initialValue;
                 }
             }
-#endif /* HAVE_GETENV */
-
-          // No matching attribute value so we try to set the default value.
-          DoSet (info.accessor, info.checker, *info.initialValue);
-          NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\" from initial value.");
+          else if (item.value == 0)
+            {
+              item.value = info.checker->CreateValidValue (*info.initialValue);
+            }
+          m_items.push_back (item);
         }
       tid = tid.GetParent ();
     } while (tid != ObjectBase::GetTypeId ());
+}
+
+/**
+ * \ingroup object
+ * Get the construction plan of a TypeId, building it unless the
+ * cached one is up to date.
+ *
+ * \param [in] tid The TypeId.
+ * \returns The construction plan.
+ */
+static Ptr<const ConstructionPlan>
+GetConstructionPlan (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid.GetName ());
+  static std::vector<Ptr<ConstructionPlan> > plans;
+  uint16_t uid = tid.GetUid ();
+  if (uid < plans.size () && plans[uid] != 0
+      && plans[uid]->m_generation == TypeId::GetAttributeGeneration ())
+    {
+      return plans[uid];
+    }
+  // validating the values may construct other objects, and so
+  // build other plans: the plan is stored once built.
+  Ptr<ConstructionPlan> plan = Create<ConstructionPlan> (tid);
+  if (uid >= plans.size ())
+    {
+      plans.resize (uid + 1);
+    }
+  plans[uid] = plan;
+  return plan;
+}
+
+void
+ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
+{
+  NS_LOG_FUNCTION (this << &attributes);
+  Ptr<const ConstructionPlan> plan = GetConstructionPlan (GetInstanceTypeId ());
+  bool empty = attributes.Begin () == attributes.End ();
+  for (std::vector<struct ConstructionPlan::Item>::const_iterator i = plan->m_items.begin ();
+       i != plan->m_items.end (); ++i)
+    {
+      NS_LOG_DEBUG ("try to construct \""<< i->tid.GetName ()<<"::"<<
+                    i->name <<"\"");
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value;
+      if (!empty)
+        {
+          value = attributes.Find (i->checker);
+        }
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!(i->flags & TypeId::ATTR_CONSTRUCT))
+        {
+          // Handle this attribute if it should not be 
+          // set here.
+          if (value == 0)
+            {
+              // Skip this attribute if it's not in the
+              // AttributeConstructionList.
+              continue;
+            }              
+          else
+            {
+              // This is an error because this attribute is not
+              // settable in its constructor but is present in
+              // the AttributeConstructionList.
+              NS_FATAL_ERROR ("Attribute name="<<i->name<<" tid="<<i->tid.GetName () << ": initial value cannot be set using attributes");
+            }
+        }
+
+      if (value != 0)
+        {
+          // We have a matching attribute value.
+          if (DoSet (i->accessor, i->checker, *value))
+            {
+              NS_LOG_DEBUG ("construct \""<< i->tid.GetName ()<<"::"<<
+                            i->name<<"\"");
+              continue;
+            }
+        }
+
+      // No matching attribute value so we set the default value.
+      if (i->initialValue != 0)
+        {
+          if (!DoSet (i->accessor, i->checker, *i->value) && i->value != i->initialValue)
+            {
+              DoSet (i->accessor, i->checker, *i->initialValue);
+            }
+        }
+      else if (i->value != 0)
+        {
+          i->accessor->Set (this, *i->value);
+        }
+      NS_LOG_DEBUG ("construct \""<< i->tid.GetName ()<<"::"<<
+                    i->name <<"\" from initial value.");
+    }
   NotifyConstructionCompleted ();
 }
 
@@ -220,7 +220,27 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the instance of the container with a given index, without
+   * getting all the instances of the container.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the requested instance.
+   * \returns The requested instance, or zero if there is none.
+   */
+  Ptr<Object> Find (const ObjectBase *object, std::size_t index) const;
 private:
+  /**
+   * Get the instance of the container with a given index.
+   *
+   * The default implementation looks for the index among all the
+   * instances of the container.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the requested instance.
+   * \returns The requested instance, or zero if there is none.
+   */
+  virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const;
   /**
    * Get the number of instances in the container.
    *
@@ -261,6 +281,15 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const {
+      std::size_t n;
+      if (!DoGetN (object, &n) || index >= n)
+        {
+          return 0;
+        }
+      const T *obj = static_cast<const T *> (object);
+      return (obj->*m_get)(index);
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
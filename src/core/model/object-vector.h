@@ -24,6 +24,7 @@
 #include "ptr.h"
 #include "attribute.h"
 #include "object-ptr-container.h"
+#include <iterator>
 
 /**
  * \file
@@ -93,21 +94,20 @@ MakeObjectVectorAccessor (U T::*memberVector)
     }
     virtual Ptr<Object> DoGet(const ObjectBase *object, std::size_t i, std::size_t *index) const {
       const T *obj = static_cast<const T *> (object);
-      typename U::const_iterator begin = (obj->*m_memberVector).begin ();
-      typename U::const_iterator end = (obj->*m_memberVector).end ();
-      std::size_t k = 0;
-      for (typename U::const_iterator j = begin; j != end; j++, k++)
+      NS_ASSERT (i < (obj->*m_memberVector).size ());
+      typename U::const_iterator j = (obj->*m_memberVector).begin ();
+      std::advance (j, i);
+      *index = i;
+      return *j;
+    }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const {
+      std::size_t n;
+      if (!DoGetN (object, &n) || index >= n)
         {
-          if (k == i)
-            {
-              *index = k;
-              return *j;
-              break;
-            }
+          return 0;
         }
-      NS_ASSERT (false);
-      // quiet compiler.
-      return 0;
+      std::size_t i;
+      return DoGet (object, index, &i);
     }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
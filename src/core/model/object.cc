@@ -24,6 +24,7 @@
 #include "assert.h"
 #include "attribute.h"
 #include "log.h"
+#include "memory-accounting.h"
 #include "string.h"
 #include <vector>
 #include <sstream>
@@ -93,21 +94,60 @@ Object::GetTypeId (void)
 }
 
 
+/**
+ * Account for an object in the subsystem of its TypeId, if
+ * MemoryAccounting is enabled.
+ *
+ * \param [in] object The object.
+ * \param [in] tid The TypeId of the object.
+ */
+static void
+AccountObject (const Object *object, TypeId tid)
+{
+  if (!MemoryAccounting::IsEnabled ())
+    {
+      return;
+    }
+  // the subsystems plus one, per TypeId uid, or zero if not registered yet
+  static std::vector<MemoryAccounting::Subsystem> subsystems;
+  uint16_t uid = tid.GetUid ();
+  if (uid >= subsystems.size ())
+    {
+      subsystems.resize (uid + 1, 0);
+    }
+  if (subsystems[uid] == 0)
+    {
+      subsystems[uid] = MemoryAccounting::GetSubsystem (tid.GetName ()) + 1;
+    }
+  // the size is unknown if the TypeId is not registered by NS_OBJECT_ENSURE_REGISTERED
+  std::size_t size = tid.GetSize ();
+  MemoryAccounting::Allocate (subsystems[uid] - 1, object,
+                              size != (std::size_t)(-1) ? size : 0);
+}
+
 Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->mask = 0;
+  m_aggregates->index = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
 {
   // remove this object from the aggregate list
   NS_LOG_FUNCTION (this);
+  if (MemoryAccounting::HasBlocks ())
+    {
+      MemoryAccounting::Free (this);
+    }
+  // the index may point to this object: the remaining objects (which are
+  // all being deleted, see DoDelete) fall back to a linear search.
+  FreeIndex (m_aggregates);
   uint32_t n = m_aggregates->n;
   for (uint32_t i = 0; i < n; i++)
     {
@@ -132,11 +172,13 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   m_aggregates->n = 1;
+  m_aggregates->mask = 0;
+  m_aggregates->index = 0;
   m_aggregates->buffer[0] = this;
+  AccountObject (this, m_tid);
 }
 void
 Object::Construct (const AttributeConstructionList &attributes)
@@ -145,17 +187,23 @@ Object::Construct (const AttributeConstructionList &attributes)
   ConstructSelf (attributes);
 }
 
-Ptr<Object>
+Object *
 Object::DoGetObject (TypeId tid) const
 {
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
-  uint32_t n = m_aggregates->n;
+  struct Aggregates *aggregates = m_aggregates;
+  if (aggregates->index != 0)
+    {
+      return LookupIndex (aggregates, tid.GetUid ());
+    }
+
+  uint32_t n = aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
     {
-      Object *current = m_aggregates->buffer[i];
+      Object *current = aggregates->buffer[i];
       TypeId cur = current->GetInstanceTypeId ();
       while (cur != tid && cur != objectTid)
         {
@@ -163,31 +211,84 @@ Object::DoGetObject (TypeId tid) const
         }
       if (cur == tid)
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          return current;
         }
     }
   return 0;
 }
 void
+Object::BuildIndex (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  FreeIndex (aggregates);
+  if (aggregates->n < 2)
+    {
+      return;
+    }
+  // count the TypeIds of the aggregates and of their parents
+  TypeId objectTid = Object::GetTypeId ();
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < aggregates->n; i++)
+    {
+      TypeId cur = aggregates->buffer[i]->GetInstanceTypeId ();
+      count++;
+      while (cur != objectTid)
+        {
+          cur = cur.GetParent ();
+          count++;
+        }
+    }
+  // keep the table at most half full
+  uint32_t size = 1;
+  while (size < 2 * count)
+    {
+      size <<= 1;
+    }
+  aggregates->index = (struct IndexEntry *) std::calloc (size, sizeof (struct IndexEntry));
+  aggregates->mask = size - 1;
+  // insert the aggregates in order, so that a TypeId shared by several
+  // aggregates (e.g., a common parent) is mapped to the first of them.
+  for (uint32_t i = 0; i < aggregates->n; i++)
+    {
+      Object *current = aggregates->buffer[i];
+      TypeId cur = current->GetInstanceTypeId ();
+      while (true)
+        {
+          uint16_t uid = cur.GetUid ();
+          uint32_t j = uid & aggregates->mask;
+          while (aggregates->index[j].uid != 0 && aggregates->index[j].uid != uid)
+            {
+              j = (j + 1) & aggregates->mask;
+            }
+          if (aggregates->index[j].uid == 0)
+            {
+              aggregates->index[j].uid = uid;
+              aggregates->index[j].object = current;
+            }
+          if (cur == objectTid)
+            {
+              break;
+            }
+          cur = cur.GetParent ();
+        }
+    }
+}
+void
+Object::FreeIndex (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  std::free (aggregates->index);
+  aggregates->index = 0;
+  aggregates->mask = 0;
+}
+void
 Object::Initialize (void)
 {
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoInitialize is called. The user's
-   * implementation of the DoInitialize method could call GetObject (which could
-   * reorder the array) and it could call AggregateObject which would add an 
-   * object at the end of the array. To be safe, we restart iteration over the 
+   * implementation of the DoInitialize method could call AggregateObject which
+   * would add an object at the end of the array. To be safe, we restart iteration over the 
    * array whenever we call some user code, just in case.
    */
   NS_LOG_FUNCTION (this);
@@ -216,8 +317,8 @@ Object::Dispose (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoDispose is called. The user's
-   * DoDispose implementation could call GetObject (which could reorder the array) 
-   * and it could call AggregateObject which would add an object at the end of the array.
+   * DoDispose implementation could call AggregateObject which would add an object
+   * at the end of the array.
    * So, to be safe, we restart the iteration over the array whenever we call some
    * user code.
    */
@@ -235,19 +336,6 @@ restart:
         }
     }
 }
-void
-Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
-{
-  NS_LOG_FUNCTION (this << aggregates << j);
-  while (j > 0 && 
-         aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j-1]->m_getObjectCount)
-    {
-      Object *tmp = aggregates->buffer[j-1];
-      aggregates->buffer[j-1] = aggregates->buffer[j];
-      aggregates->buffer[j] = tmp;
-      j--;
-    }
-}
 void 
 Object::AggregateObject (Ptr<Object> o)
 {
@@ -263,6 +351,8 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  aggregates->mask = 0;
+  aggregates->index = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -281,8 +371,8 @@ Object::AggregateObject (Ptr<Object> o)
                           other->GetInstanceTypeId () <<
                           " on objects of type " << typeId);
         }
-      UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
+  BuildIndex (aggregates);
 
   // keep track of the old aggregate buffers for the iteration
   // of NotifyNewAggregates
@@ -314,6 +404,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  FreeIndex (a);
+  FreeIndex (b);
   std::free (a);
   std::free (b);
 }
@@ -340,6 +432,11 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  AccountObject (this, tid);
+  if (m_aggregates->index != 0)
+    {
+      BuildIndex (m_aggregates);
+    }
 }
 
 void
@@ -320,6 +320,13 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /** An entry of the TypeId index of the aggregates. */
+  struct IndexEntry {
+    /** The TypeId uid, or zero if the entry is empty. */
+    uint16_t uid;
+    /** The first aggregated Object having (a subclass of) this TypeId. */
+    Object *object;
+  };
   /**
    * The list of Objects aggregated to this one.
    *
@@ -331,10 +338,19 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * \c n
+   *
+   * When more than one Object is aggregated, \c index maps the uid
+   * of the TypeId of each Object, and of all its parents up to
+   * ns3::Object, to the first Object in \c buffer with that TypeId,
+   * so that GetObject() is a hash table lookup.
    */
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /** The number of entries in \c index minus one, or zero if there is no index. */
+    uint32_t mask;
+    /** The open addressing table of the TypeId uids, or zero. */
+    struct IndexEntry *index;
     /** The array of Objects. */
     Object *buffer[1];
   };
@@ -345,7 +361,27 @@ private:
    * \param [in] tid The TypeId we're looking for
    * \return The matching Object, if it is found
    */
-  Ptr<Object> DoGetObject (TypeId tid) const;
+  Object * DoGetObject (TypeId tid) const;
+  /**
+   * Look a TypeId up in the index of a list of aggregates.
+   *
+   * \param [in] aggregates The list of aggregated Objects, which must have an index.
+   * \param [in] uid The uid of the TypeId we're looking for
+   * \return The matching Object, if it is found
+   */
+  inline static Object * LookupIndex (const struct Aggregates *aggregates, uint16_t uid);
+  /**
+   * Build the TypeId index of a list of aggregates.
+   *
+   * \param [in,out] aggregates The list of aggregated Objects.
+   */
+  static void BuildIndex (struct Aggregates *aggregates);
+  /**
+   * Release the TypeId index of a list of aggregates.
+   *
+   * \param [in,out] aggregates The list of aggregated Objects.
+   */
+  static void FreeIndex (struct Aggregates *aggregates);
   /**
    * Verify that this Object is still live, by checking it's reference count.
    * \return \c true if the reference count is non zero.
@@ -386,13 +422,6 @@ private:
   */
   void Construct (const AttributeConstructionList &attributes);
 
-  /**
-   * Keep the list of aggregates in most-recently-used order
-   *
-   * \param [in,out] aggregates The list of aggregated Objects.
-   * \param [in] i The most recently used entry in the list.
-   */
-  void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
   /**
    * Attempt to delete this Object.
    *
@@ -424,14 +453,6 @@ private:
    * so the size of the array is indirectly a reference count.
    */
   struct Aggregates * m_aggregates;
-  /**
-   * The number of times the Object was accessed with a
-   * call to GetObject().
-   *
-   * This integer is used to implement a heuristic to sort
-   * the array of aggregates in most-frequently accessed order.
-   */
-  uint32_t m_getObjectCount;
 };
 
 template <typename T>
@@ -454,22 +475,48 @@ ObjectDeleter::Delete (Object *object)
   object->DoDelete ();
 }
 
+Object *
+Object::LookupIndex (const struct Aggregates *aggregates, uint16_t uid)
+{
+  for (uint32_t i = uid & aggregates->mask; ; i = (i + 1) & aggregates->mask)
+    {
+      const struct IndexEntry *entry = &aggregates->index[i];
+      if (entry->uid == uid)
+        {
+          return entry->object;
+        }
+      if (entry->uid == 0)
+        {
+          return 0;
+        }
+    }
+}
+
 template <typename T>
 Ptr<T> 
 Object::GetObject () const
 {
-  // This is an optimization: if the cast works (which is likely),
-  // things will be pretty fast.
-  T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
-  if (result != 0)
+  Object *found;
+  if (m_aggregates->index != 0)
+    {
+      // This Object is aggregated: look the TypeId up in the index.
+      found = LookupIndex (m_aggregates, T::GetTypeId ().GetUid ());
+    }
+  else
     {
-      return Ptr<T> (result);
+      // This is an optimization: if the cast works (which is likely),
+      // things will be pretty fast.
+      T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
+      if (result != 0)
+        {
+          return Ptr<T> (result);
+        }
+      // if the cast does not work, we try to do a full type check.
+      found = DoGetObject (T::GetTypeId ());
     }
-  // if the cast does not work, we try to do a full type check.
-  Ptr<Object> found = DoGetObject (T::GetTypeId ());
   if (found != 0)
     {
-      return Ptr<T> (static_cast<T *> (PeekPointer (found)));
+      return Ptr<T> (static_cast<T *> (found));
     }
   return 0;
 }
@@ -478,10 +525,10 @@ template <typename T>
 Ptr<T> 
 Object::GetObject (TypeId tid) const
 {
-  Ptr<Object> found = DoGetObject (tid);
+  Object *found = DoGetObject (tid);
   if (found != 0)
     {
-      return Ptr<T> (static_cast<T *> (PeekPointer (found)));
+      return Ptr<T> (static_cast<T *> (found));
     }
   return 0;
 }
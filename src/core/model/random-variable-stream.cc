@@ -34,6 +34,7 @@
 #include "rng-stream.h"
 #include "rng-seed-manager.h"
 #include "unused.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -110,7 +111,8 @@ RandomVariableStream::SetStream (int64_t stream)
       NS_ASSERT(nextStream <= ((1ULL)<<63));
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
-                             RngSeedManager::GetRun ());
+                             RngSeedManager::GetRun (),
+                             RngSeedManager::GetGenerator ());
     }
   else
     {
@@ -120,7 +122,8 @@ RandomVariableStream::SetStream (int64_t stream)
       uint64_t target = base + stream;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
-                             RngSeedManager::GetRun ());
+                             RngSeedManager::GetRun (),
+                             RngSeedManager::GetGenerator ());
     }
   m_stream = stream;
 }
@@ -138,6 +141,16 @@ RandomVariableStream::Peek(void) const
   return m_rng;
 }
 
+void
+RandomVariableStream::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(UniformRandomVariable);
 
 TypeId 
@@ -208,6 +221,22 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  Peek ()->RandU01 (values, n);
+  bool isAntithetic = IsAntithetic ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double v = m_min + values[i] * (m_max - m_min);
+      if (isAntithetic)
+        {
+          v = m_min + (m_max - v);
+        }
+      values[i] = v;
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
@@ -445,6 +474,33 @@ ExponentialRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  bool isAntithetic = IsAntithetic ();
+  uint32_t i = 0;
+  while (i < n)
+    {
+      // Each uniform gives at most one value: draw no more uniforms
+      // than values missing, so that the stream continues as after
+      // as many calls to GetValue, and keep the accepted values.
+      Peek ()->RandU01 (values + i, n - i);
+      for (uint32_t j = i; j < n; j++)
+        {
+          double v = values[j];
+          if (isAntithetic)
+            {
+              v = (1 - v);
+            }
+          double r = -m_mean*std::log (v);
+          if (m_bound == 0 || r <= m_bound)
+            {
+              values[i++] = r;
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
@@ -564,6 +620,33 @@ ParetoRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_scale, m_shape, m_bound);
 }
+void
+ParetoRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  bool isAntithetic = IsAntithetic ();
+  double exponent = 1.0 / m_shape;
+  uint32_t i = 0;
+  while (i < n)
+    {
+      // As for the exponential distribution, draw no more uniforms
+      // than values missing, and keep the accepted values.
+      Peek ()->RandU01 (values + i, n - i);
+      for (uint32_t j = i; j < n; j++)
+        {
+          double v = values[j];
+          if (isAntithetic)
+            {
+              v = (1 - v);
+            }
+          double r = (m_scale * ( 1.0 / std::pow (v, exponent)));
+          if (m_bound == 0 || r <= m_bound)
+            {
+              values[i++] = r;
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(WeibullRandomVariable);
 
@@ -778,6 +861,65 @@ NormalRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_variance, m_bound);
 }
+void
+NormalRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  uint32_t i = 0;
+  if (n > 0 && m_nextValid)
+    { // use previously generated
+      m_nextValid = false;
+      values[i++] = m_next;
+    }
+  bool isAntithetic = IsAntithetic ();
+  double stdDev = std::sqrt (m_variance);
+  const uint32_t maxPairs = 128;
+  double u[2 * maxPairs];
+  while (i < n)
+    {
+      // Each pair of uniforms gives at most two values: draw no more
+      // pairs than half the values missing, so that the stream continues
+      // as after as many calls to GetValue, and only the last pair can
+      // leave a value for the next call.
+      uint32_t pairs = std::min ((n - i + 1) / 2, maxPairs);
+      Peek ()->RandU01 (u, 2 * pairs);
+      for (uint32_t j = 0; j < 2 * pairs; j += 2)
+        {
+          double u1 = u[j];
+          double u2 = u[j + 1];
+          if (isAntithetic)
+            {
+              u1 = (1 - u1);
+              u2 = (1 - u2);
+            }
+          double v1 = 2 * u1 - 1;
+          double v2 = 2 * u2 - 1;
+          double w = v1 * v1 + v2 * v2;
+          if (w <= 1.0)
+            {
+              double y = std::sqrt ((-2 * std::log (w)) / w);
+              double x1 = m_mean + v1 * y * stdDev;
+              double x2 = m_mean + v2 * y * stdDev;
+              if (std::fabs (x1 - m_mean) <= m_bound)
+                {
+                  values[i++] = x1;
+                }
+              if (std::fabs (x2 - m_mean) <= m_bound)
+                {
+                  if (i < n)
+                    {
+                      values[i++] = x2;
+                    }
+                  else
+                    {
+                      m_next = x2;
+                      m_nextValid = true;
+                    }
+                }
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(LogNormalRandomVariable);
 
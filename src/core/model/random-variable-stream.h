@@ -149,6 +149,18 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next random values drawn from the distribution.
+   *
+   * The values are the ones returned by as many calls to GetValue ().
+   * The uniform, exponential, Pareto and normal distributions draw
+   * their uniform numbers in batches from the underlying RngStream.
+   *
+   * \param [out] values The array of the random values.
+   * \param [in] n The number of random values.
+   */
+  virtual void GetValues (double *values, uint32_t n);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -294,6 +306,7 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, uint32_t n);
   
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -586,6 +599,7 @@ public:
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, uint32_t n);
 
 private:
   /** The mean value of the unbounded exponential distribution. */
@@ -792,6 +806,9 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  // Inherited from RandomVariableStream
+  virtual void GetValues (double *values, uint32_t n);
+
 private:
   /** The mean parameter for the Pareto distribution returned by this RNG stream. */
   double m_mean;
@@ -1234,6 +1251,9 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  // Inherited from RandomVariableStream
+  virtual void GetValues (double *values, uint32_t n);
+
 private:
   /** The mean value for the normal distribution returned by this RNG stream. */
   double m_mean;
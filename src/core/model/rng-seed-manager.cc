@@ -21,6 +21,7 @@
 #include "global-value.h"
 #include "attribute-helper.h"
 #include "uinteger.h"
+#include "enum.h"
 #include "config.h"
 #include "log.h"
 
@@ -66,6 +67,17 @@ static ns3::GlobalValue g_rngRun ("RngRun",
                                   "The substream index used for all streams",
                                   ns3::UintegerValue (1),
                                   ns3::MakeUintegerChecker<uint64_t> ());
+/**
+ * \relates RngSeedManager
+ * The random number generator of the streams created from now on.
+ *
+ * This is accessible as "--RngGenerator" from CommandLine.
+ */
+static ns3::GlobalValue g_rngGenerator ("RngGenerator",
+                                        "The random number generator of the streams",
+                                        ns3::EnumValue (RngStream::MRG32K3A),
+                                        ns3::MakeEnumChecker (RngStream::MRG32K3A, "MRG32k3a",
+                                                              RngStream::PHILOX, "Philox"));
 
 
 uint32_t RngSeedManager::GetSeed (void)
@@ -97,6 +109,22 @@ uint64_t RngSeedManager::GetRun ()
   return run;
 }
 
+void
+RngSeedManager::SetGenerator (enum RngStream::Generator generator)
+{
+  NS_LOG_FUNCTION (generator);
+  Config::SetGlobal ("RngGenerator", EnumValue (generator));
+}
+
+enum RngStream::Generator
+RngSeedManager::GetGenerator (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  EnumValue value;
+  g_rngGenerator.GetValue (value);
+  return static_cast<enum RngStream::Generator> (value.Get ());
+}
+
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -21,6 +21,7 @@
 #define RNG_SEED_MANAGER_H
 
 #include <stdint.h>
+#include "rng-stream.h"
 
 /**
  * \file
@@ -99,6 +100,26 @@ public:
    */
   static uint64_t GetRun (void);
 
+  /**
+   * \brief Set the random number generator of the
+   * RandomVariableStream objects instantiated from now on.
+   *
+   * The default generator is RngStream::MRG32K3A.  The counter-based
+   * RngStream::PHILOX generator is faster, in particular with
+   * RandomVariableStream::GetValues.  The stream numbers and the run
+   * number select the streams of both generators in the same way, but
+   * the two generators give different numbers.
+   *
+   * \param [in] generator The random number generator.
+   */
+  static void SetGenerator (enum RngStream::Generator generator);
+  /**
+   * \brief Get the current random number generator.
+   * \returns The current random number generator.
+   * \see SetGenerator
+   */
+  static enum RngStream::Generator GetGenerator (void);
+
   /**
    * Get the next automatically assigned stream index.
    * \returns The next stream index.
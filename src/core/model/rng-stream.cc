@@ -29,7 +29,7 @@
 /**
  * \file
  * \ingroup rngimpl
- * ns3::RngStream and MRG32k3a implementations.
+ * ns3::RngStream, MRG32k3a and Philox4x32-10 implementations.
  */
 
 namespace ns3 {
@@ -74,6 +74,12 @@ const double a21  =       527612.0;
 /** Second component multiplier of <i>n</i> - 3 value. */
 const double a23n =       1370589.0;
 
+/** Inverse of the first component modulus. */
+const double m1Inverse =  1.0 / m1;
+
+/** Inverse of the second component modulus. */
+const double m2Inverse =  1.0 / m2;
+
 /** Decomposition factor for computing a*s in less than 53 bits, 2<sup>17</sup> */
 const double two17 =      131072.0;
   
@@ -322,37 +328,48 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
     }
 }
 
-} // namespace MRG32k3a
-
-
-namespace ns3 {
-
-using namespace MRG32k3a;
-  
-double RngStream::RandU01 ()
+/**
+ * Advance the state of the generator, and compute the next random number.
+ *
+ * \param [in,out] state The state vector.
+ * \returns The next random.
+ */
+inline double NextU01 (double state[6])
 {
   int32_t k;
   double p1, p2, u;
 
+  // The products are exact, and the quotients computed with the
+  // inverses of the moduli can be one off: the remainders are
+  // corrected in both directions.
+
   /* Component 1 */
-  p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
-  k = static_cast<int32_t> (p1 / m1);
+  p1 = a12 * state[1] - a13n * state[0];
+  k = static_cast<int32_t> (p1 * m1Inverse);
   p1 -= k * m1;
   if (p1 < 0.0)
     {
       p1 += m1;
     }
-  m_currentState[0] = m_currentState[1]; m_currentState[1] = m_currentState[2]; m_currentState[2] = p1;
+  else if (p1 >= m1)
+    {
+      p1 -= m1;
+    }
+  state[0] = state[1]; state[1] = state[2]; state[2] = p1;
 
   /* Component 2 */
-  p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
-  k = static_cast<int32_t> (p2 / m2);
+  p2 = a21 * state[5] - a23n * state[3];
+  k = static_cast<int32_t> (p2 * m2Inverse);
   p2 -= k * m2;
   if (p2 < 0.0)
     {
       p2 += m2;
     }
-  m_currentState[3] = m_currentState[4]; m_currentState[4] = m_currentState[5]; m_currentState[5] = p2;
+  else if (p2 >= m2)
+    {
+      p2 -= m2;
+    }
+  state[3] = state[4]; state[4] = state[5]; state[5] = p2;
 
   /* Combination */
   u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
@@ -360,7 +377,143 @@ double RngStream::RandU01 ()
   return u;
 }
 
-RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
+} // namespace MRG32k3a
+
+
+/** Namespace for Philox4x32-10 implementation details. */
+namespace Philox
+{
+
+/** Multiplier of the first and third counter words. */
+const uint64_t m0 = 0xD2511F53;
+
+/** Multiplier of the second and fourth counter words. */
+const uint64_t m1 = 0xCD9E8D57;
+
+/** Increment of the first key word, the golden ratio. */
+const uint32_t w0 = 0x9E3779B9;
+
+/** Increment of the second key word, sqrt(3) - 1. */
+const uint32_t w1 = 0xBB67AE85;
+
+/** The number of rounds. */
+const int rounds = 10;
+
+/** Normalization to obtain randoms on (0,1), 2<sup>-32</sup>. */
+const double norm = 1.0 / 4294967296.0;
+
+/**
+ * Compute a round of the block cipher.
+ *
+ * \param [in,out] ctr The block.
+ * \param [in] key The round key.
+ */
+inline void Round (uint32_t ctr[4], const uint32_t key[2])
+{
+  uint64_t p0 = m0 * ctr[0];
+  uint64_t p1 = m1 * ctr[2];
+  uint32_t x0 = static_cast<uint32_t> (p1 >> 32) ^ ctr[1] ^ key[0];
+  uint32_t x2 = static_cast<uint32_t> (p0 >> 32) ^ ctr[3] ^ key[1];
+  ctr[0] = x0;
+  ctr[1] = static_cast<uint32_t> (p1);
+  ctr[2] = x2;
+  ctr[3] = static_cast<uint32_t> (p0);
+}
+
+/**
+ * Convert a 32-bit random number to a random on (0,1).
+ *
+ * \param [in] x The random number.
+ * \returns The random on (0,1).
+ */
+inline double ToU01 (uint32_t x)
+{
+  return (x + 0.5) * norm;
+}
+
+} // namespace Philox
+
+
+namespace ns3 {
+
+using namespace MRG32k3a;
+
+double RngStream::RandU01 ()
+{
+  if (m_generator == PHILOX)
+    {
+      if (m_index == 4)
+        {
+          PhiloxNextBlock ();
+        }
+      return Philox::ToU01 (m_block[m_index++]);
+    }
+  return NextU01 (m_currentState);
+}
+
+void
+RngStream::RandU01 (double *values, uint32_t n)
+{
+  if (m_generator == PHILOX)
+    {
+      uint32_t i = 0;
+      while (i < n)
+        {
+          if (m_index == 4)
+            {
+              PhiloxNextBlock ();
+            }
+          for (; m_index < 4 && i < n; m_index++, i++)
+            {
+              values[i] = Philox::ToU01 (m_block[m_index]);
+            }
+        }
+      return;
+    }
+  // work on a local copy of the state, which can be kept in registers
+  double state[6];
+  for (int i = 0; i < 6; ++i)
+    {
+      state[i] = m_currentState[i];
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      values[i] = NextU01 (state);
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+      m_currentState[i] = state[i];
+    }
+}
+
+void
+RngStream::PhiloxNextBlock (void)
+{
+  uint32_t key[2] = { m_key[0], m_key[1] };
+  for (int i = 0; i < 4; ++i)
+    {
+      m_block[i] = m_counter[i];
+    }
+  for (int round = 0; round < Philox::rounds; round++)
+    {
+      if (round > 0)
+        {
+          key[0] += Philox::w0;
+          key[1] += Philox::w1;
+        }
+      Philox::Round (m_block, key);
+    }
+  // the index of the block is the low 64 bits of the counter
+  if (++m_counter[0] == 0)
+    {
+      m_counter[1]++;
+    }
+  m_index = 0;
+}
+
+RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream,
+                      enum Generator generator)
+  : m_generator (generator)
 {
   if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
     {
@@ -370,16 +523,58 @@ RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
     {
       m_currentState[i] = seedNumber;
     }
-  AdvanceNthBy (stream, 127, m_currentState);
-  AdvanceNthBy (substream, 76, m_currentState);
+  if (m_generator == PHILOX)
+    {
+      // the streams and substreams need no computation: the seed 1
+      // leaves the counter of the first block of substream 0 at 0
+      m_key[0] = static_cast<uint32_t> (stream);
+      m_key[1] = static_cast<uint32_t> (stream >> 32);
+      m_counter[0] = 0;
+      m_counter[1] = 0;
+      m_counter[2] = static_cast<uint32_t> (substream);
+      m_counter[3] = static_cast<uint32_t> (substream >> 32) ^ (seedNumber - 1);
+    }
+  else
+    {
+      AdvanceNthBy (stream, 127, m_currentState);
+      AdvanceNthBy (substream, 76, m_currentState);
+      m_key[0] = m_key[1] = 0;
+      for (int i = 0; i < 4; ++i)
+        {
+          m_counter[i] = 0;
+        }
+    }
+  // the first call to RandU01 computes the first block
+  for (int i = 0; i < 4; ++i)
+    {
+      m_block[i] = 0;
+    }
+  m_index = 4;
 }
 
 RngStream::RngStream(const RngStream& r)
+  : m_generator (r.m_generator),
+    m_index (r.m_index)
 {
   for (int i = 0; i < 6; ++i)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  for (int i = 0; i < 2; ++i)
+    {
+      m_key[i] = r.m_key[i];
+    }
+  for (int i = 0; i < 4; ++i)
+    {
+      m_counter[i] = r.m_counter[i];
+      m_block[i] = r.m_block[i];
+    }
+}
+
+enum RngStream::Generator
+RngStream::GetGenerator (void) const
+{
+  return m_generator;
 }
 
 void 
@@ -38,25 +38,43 @@ namespace ns3 {
 /**
  * \ingroup rngimpl
  *
- * \brief Combined Multiple-Recursive Generator MRG32k3a
+ * \brief Combined Multiple-Recursive Generator MRG32k3a, or
+ * counter-based generator Philox4x32-10
  *
- * This class is the combined multiple-recursive random number
+ * By default, this class is the combined multiple-recursive random number
  * generator called MRG32k3a.  The ns3::RandomVariableBase class
  * holds a static instance of this class.  The details of this
  * class are explained in:
  * http://www.iro.umontreal.ca/~lecuyer/myftp/papers/streams00.pdf
+ *
+ * The stream can also be the counter-based generator Philox4x32-10,
+ * which encrypts a counter with a key:
+ * http://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+ * The key is the stream number, and the counter holds the seed, the
+ * substream number and the index of the block of four numbers, so
+ * that the streams and substreams are obtained without computation,
+ * and are distinct for substream numbers below 2<sup>32</sup>.
  */
 class RngStream
 {
 public:
+  /** The random number generators. */
+  enum Generator
+  {
+    MRG32K3A,  //!< Combined Multiple-Recursive Generator MRG32k3a.
+    PHILOX     //!< Counter-based generator Philox4x32-10.
+  };
+
   /**
    * Construct from explicit seed, stream and substream values.
    *
    * \param [in] seed The starting seed.
    * \param [in] stream The stream number.
    * \param [in] substream The sub-stream number.
+   * \param [in] generator The random number generator.
    */
-  RngStream (uint32_t seed, uint64_t stream, uint64_t substream);
+  RngStream (uint32_t seed, uint64_t stream, uint64_t substream,
+             enum Generator generator = MRG32K3A);
   /**
    * Copy constructor.
    *
@@ -70,8 +88,24 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next random numbers for this stream, which are the
+   * numbers returned by as many calls to RandU01().
+   * Uniformly distributed between 0 and 1.
+   *
+   * \param [out] values The array of the random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void RandU01 (double *values, uint32_t n);
+  /**
+   * \returns The random number generator of this stream.
+   */
+  enum Generator GetGenerator (void) const;
 
 private:
+  /** Compute the next block of four Philox numbers. */
+  void PhiloxNextBlock (void);
+
   /**
    * Advance \p state of the RNG by leaps and bounds.
    *
@@ -81,8 +115,18 @@ private:
    */
   void AdvanceNthBy (uint64_t nth, int by, double state[6]);
 
-  /** The RNG state vector. */
+  /** The random number generator. */
+  enum Generator m_generator;
+  /** The RNG state vector of MRG32k3a. */
   double m_currentState[6];
+  /** The Philox key. */
+  uint32_t m_key[2];
+  /** The Philox counter of the next block. */
+  uint32_t m_counter[4];
+  /** The current Philox block. */
+  uint32_t m_block[4];
+  /** The index of the next number in the Philox block. */
+  uint32_t m_index;
 };
 
 } // namespace ns3
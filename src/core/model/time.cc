@@ -23,6 +23,7 @@
 #include "abort.h"
 #include "system-mutex.h"
 #include "log.h"
+#include <algorithm>
 #include <cmath>
 #include <iomanip>  // showpos
 #include <sstream>
@@ -222,6 +223,9 @@ Time::SetResolution (enum Unit unit, struct Resolution *resolution,
       NS_LOG_DEBUG ("SetResolution factor " << factor << " real factor " << realFactor);
       struct Information *info = &resolution->info[i];
       info->factor = factor;
+      // bounded by 2^53, below which all the integers are doubles
+      info->maxFrom = std::min (std::numeric_limits<int64_t>::max () / factor,
+                                static_cast<int64_t> (1) << 53);
       // here we could equivalently check for realFactor == 1.0 but it's better
       // to avoid checking equality of doubles
       if (shift == 0 && quotient == 1)
@@ -383,6 +387,61 @@ Time::GetResolution (void)
   return PeekResolution ()->unit;
 }
 
+// static
+Time
+Time::FromRatio (uint64_t numerator, uint64_t denominator, enum Unit unit)
+{
+  NS_ASSERT_MSG (denominator != 0, "Time::FromRatio: null denominator");
+  struct Information *info = PeekInformation (unit);
+  uint64_t factor = info->factor;
+  if (!info->fromMul)
+    {
+      // floor (floor (n / d) / f) == floor (n / (d f))
+      return Time (static_cast<int64_t> (numerator / denominator / factor));
+    }
+  // floor (n f / d) == q f + floor (r f / d), with n == q d + r
+  uint64_t quotient = numerator / denominator;
+  uint64_t remainder = numerator % denominator;
+  uint64_t fraction;
+  if (remainder <= std::numeric_limits<uint64_t>::max () / factor)
+    {
+      fraction = remainder * factor / denominator;
+    }
+  else
+    {
+      // r f overflows: multiply one bit of f at a time, keeping
+      // r f == fraction d + partial, with partial < d
+      fraction = 0;
+      uint64_t partial = 0;
+      for (int bit = 63; bit >= 0; bit--)
+        {
+          fraction <<= 1;
+          if (partial >= denominator - partial)
+            {
+              partial -= denominator - partial;
+              fraction++;
+            }
+          else
+            {
+              partial += partial;
+            }
+          if ((factor >> bit) & 1)
+            {
+              if (partial >= denominator - remainder)
+                {
+                  partial -= denominator - remainder;
+                  fraction++;
+                }
+              else
+                {
+                  partial += remainder;
+                }
+            }
+        }
+    }
+  return Time (static_cast<int64_t> (quotient * factor + fraction));
+}
+
 
 TimeWithUnit
 Time::As (const enum Unit unit) const
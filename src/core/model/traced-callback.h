@@ -22,6 +22,7 @@
 #define TRACED_CALLBACK_H
 
 #include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -42,6 +43,12 @@ namespace ns3 {
  * of Callback.  Connect adds a Callback at the end of the chain
  * of callbacks.  Disconnect removes a Callback from the chain of callbacks.
  *
+ * The first Callback of the chain is stored inline and the next ones
+ * in a contiguous array, so that invoking a chain without Callbacks
+ * only checks a pointer. The arguments of the functors are however
+ * built by the caller: when they are costly to build, check IsEmpty
+ * before building them.
+ *
  * This is a functor: the chain of Callbacks is invoked by
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
@@ -93,6 +100,23 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check if the chain of Callbacks is empty.
+   *
+   * Trace sources whose arguments are costly to build can skip them
+   * when nothing is connected:
+   * \code
+   *   if (!m_txTrace.IsEmpty ())
+   *     {
+   *       Ptr<Packet> copy = packet->Copy ();
+   *       copy->AddHeader (header);
+   *       m_txTrace (copy);
+   *     }
+   * \endcode
+   *
+   * \returns \c true if no Callback is connected.
+   */
+  bool IsEmpty (void) const;
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -222,21 +246,23 @@ public:
 
   
 private:
+  /** Type of the Callbacks of the chain. */
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> CallbackType;
+  /** Container type for holding the Callbacks after the first one. */
+  typedef std::vector<CallbackType> CallbackList;
+  /**
+   * The first Callback of the chain, stored inline since most trace
+   * sources have at most one Callback, or a null Callback if the
+   * chain is empty.
+   */
+  CallbackType m_first;
   /**
-   * Container type for holding the chain of Callbacks.
+   * The next Callbacks of the chain.
    *
-   * \tparam T1 \deduced Type of the first argument to the functor.
-   * \tparam T2 \deduced Type of the second argument to the functor.
-   * \tparam T3 \deduced Type of the third argument to the functor.
-   * \tparam T4 \deduced Type of the fourth argument to the functor.
-   * \tparam T5 \deduced Type of the fifth argument to the functor.
-   * \tparam T6 \deduced Type of the sixth argument to the functor.
-   * \tparam T7 \deduced Type of the seventh argument to the functor.
-   * \tparam T8 \deduced Type of the eighth argument to the functor.
+   * The functors iterate on them by index, since a Callback can
+   * connect others to the chain while it is invoked.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  CallbackList m_next;
 };
 
 } // namespace ns3
@@ -253,22 +279,30 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_first (),
+    m_next ()
 {
 }
-template<typename T1, typename T2,
+template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
          typename T7, typename T8>
 void
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBase & callback)
 {
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+  CallbackType cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  if (m_first.IsNull ())
+    {
+      m_first = cb;
+    }
+  else
+    {
+      m_next.push_back (cb);
+    }
 }
-template<typename T1, typename T2,
+template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
          typename T7, typename T8>
@@ -278,8 +312,15 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  CallbackType realCb = cb.Bind (path);
+  if (m_first.IsNull ())
+    {
+      m_first = realCb;
+    }
+  else
+    {
+      m_next.push_back (realCb);
+    }
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -288,18 +329,30 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  for (typename CallbackList::iterator i = m_next.begin ();
+       i != m_next.end (); /* empty */)
     {
       if ((*i).IsEqual (callback))
         {
-          i = m_callbackList.erase (i);
+          i = m_next.erase (i);
         }
       else
         {
           i++;
         }
     }
+  if (!m_first.IsNull () && m_first.IsEqual (callback))
+    {
+      if (m_next.empty ())
+        {
+          m_first = CallbackType ();
+        }
+      else
+        {
+          m_first = m_next.front ();
+          m_next.erase (m_next.begin ());
+        }
+    }
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -311,9 +364,18 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when disconnecting from " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
+  CallbackType realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_first.IsNull ();
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -321,10 +383,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)();
+      return;
+    }
+  m_first ();
+  for (std::size_t i = 0; i < m_next.size (); i++)
+    {
+      m_next[i] ();
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +400,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1);
+  for (std::size_t i = 0; i < m_next.size (); i++)
     {
-      (*i)(a1);
+      m_next[i] (a1);
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +417,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)(a1, a2);
+      return;
+    }
+  m_first (a1, a2);
+  for (std::size_t i = 0; i < m_next.size (); i++)
+    {
+      m_next[i] (a1, a2);
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +434,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3);
+  for (std::size_t i = 0; i < m_next.size (); i++)
     {
-      (*i)(a1, a2, a3);
+      m_next[i] (a1, a2, a3);
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +451,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)(a1, a2, a3, a4);
+      return;
+    }
+  m_first (a1, a2, a3, a4);
+  for (std::size_t i = 0; i < m_next.size (); i++)
+    {
+      m_next[i] (a1, a2, a3, a4);
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +468,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5);
+  for (std::size_t i = 0; i < m_next.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5);
+      m_next[i] (a1, a2, a3, a4, a5);
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +485,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5, a6);
+  for (std::size_t i = 0; i < m_next.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      m_next[i] (a1, a2, a3, a4, a5, a6);
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +502,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5, a6, a7);
+  for (std::size_t i = 0; i < m_next.size (); i++)
+    {
+      m_next[i] (a1, a2, a3, a4, a5, a6, a7);
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +519,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_first.IsNull ())
+    {
+      return;
+    }
+  m_first (a1, a2, a3, a4, a5, a6, a7, a8);
+  for (std::size_t i = 0; i < m_next.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      m_next[i] (a1, a2, a3, a4, a5, a6, a7, a8);
     }
 }
 
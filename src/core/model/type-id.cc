@@ -24,6 +24,7 @@
 #include "trace-source-accessor.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -78,6 +79,8 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
 class IidManager : public Singleton<IidManager>
 {
 public:
+  /** Constructor. */
+  IidManager ();
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -182,6 +185,11 @@ public:
    * \returns The type id.
    */
   uint16_t GetRegistered (uint16_t i) const;
+  /**
+   * Get the generation of the Attributes.
+   * \returns The generation of the Attributes.
+   */
+  uint32_t GetAttributeGeneration (void) const;
   /**
    * Record a new attribute in a type id.
    * \param [in] uid The id.
@@ -229,6 +237,14 @@ public:
    * \returns The information associated to attribute whose index is \p i.
    */
   struct TypeId::AttributeInformation GetAttribute (uint16_t uid, std::size_t i) const;
+  /**
+   * Find an Attribute by name, in a TypeId or in its parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \returns The information associated to the Attribute, or zero
+   *          if there is no Attribute with this name.
+   */
+  const struct TypeId::AttributeInformation * LookupAttribute (uint16_t uid, const std::string &name) const;
   /**
    * Record a new TraceSource.
    * \param [in] uid The id.
@@ -264,6 +280,14 @@ public:
    * \returns Detailed information about the requested trace source.
    */
   struct TypeId::TraceSourceInformation GetTraceSource (uint16_t uid, std::size_t i) const;
+  /**
+   * Find a TraceSource by name, in a TypeId or in its parents.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \returns The information associated to the TraceSource, or zero
+   *          if there is no TraceSource with this name.
+   */
+  const struct TypeId::TraceSourceInformation * LookupTraceSource (uint16_t uid, const std::string &name) const;
   /**
    * Check if this TypeId should not be listed in documentation.
    * \param [in] uid The id.
@@ -293,6 +317,14 @@ private:
    */
   static TypeId::hash_t Hasher (const std::string name);
 
+  /**
+   * Location of an Attribute or TraceSource: the id of the type which
+   * registered it, and its index in that type.
+   */
+  typedef std::pair<uint16_t, std::size_t> location_t;
+  /** Type of the by-name indexes of the Attributes and TraceSources. */
+  typedef std::unordered_map<std::string, location_t> locationmap_t;
+
   /** The information record about a single type id. */
   struct IidInformation {
     /** The type id name. */
@@ -319,6 +351,12 @@ private:
     TypeId::SupportLevel supportLevel;
     /** Support message. */
     std::string supportMsg;
+    /** The index of the Attributes of this type and of its parents. */
+    locationmap_t attributeIndex;
+    /** The index of the TraceSources of this type and of its parents. */
+    locationmap_t traceSourceIndex;
+    /** The generation of the indexes, or zero if they are not built. */
+    uint32_t indexGeneration;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -329,20 +367,44 @@ private:
    * \returns The information record.
    */
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
+  /**
+   * Build the Attribute and TraceSource indexes of a type id, unless
+   * they are up to date.
+   *
+   * The indexes of a type id flatten the Attributes and TraceSources
+   * of its parents.
+   *
+   * \param [in] uid The id.
+   * \returns The information record of the type id.
+   */
+  struct IidManager::IidInformation *UpdateIndexes (uint16_t uid) const;
 
   /** The container of all type id records. */
   std::vector<struct IidInformation> m_information;
 
   /** Type of the by-name index. */
-  typedef std::map<std::string, uint16_t> namemap_t;
+  typedef std::unordered_map<std::string, uint16_t> namemap_t;
   /** The by-name index. */
   namemap_t m_namemap;
 
   /** Type of the by-hash index. */
-  typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+  typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /**
+   * The generation of the type ids, incremented when a parent,
+   * Attribute or TraceSource is added, which makes the Attribute
+   * and TraceSource indexes of all the type ids out of date.
+   */
+  uint32_t m_generation;
+
+  /**
+   * The generation of the Attributes, incremented when a parent or
+   * Attribute is added or the initial value of an Attribute is changed.
+   */
+  uint32_t m_attributeGeneration;
+
 
   /** IidManager constants. */
   enum {
@@ -357,6 +419,12 @@ private:
 };
 
 
+IidManager::IidManager ()
+  : m_generation (1),
+    m_attributeGeneration (1)
+{
+}
+
 //static
 TypeId::hash_t
 IidManager::Hasher (const std::string name)
@@ -439,6 +507,7 @@ IidManager::AllocateUid (std::string name)
   information.size = (std::size_t)(-1);
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
+  information.indexGeneration = 0;
   m_information.push_back (information);
   std::size_t tuid = m_information.size();
   NS_ASSERT (tuid <= 0xffff);
@@ -467,6 +536,8 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  m_generation++;
+  m_attributeGeneration++;
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -608,6 +679,13 @@ IidManager::GetRegistered (uint16_t i) const
   return i + 1;
 }
 
+uint32_t
+IidManager::GetAttributeGeneration (void) const
+{
+  NS_LOG_FUNCTION (IID);
+  return m_attributeGeneration;
+}
+
 bool
 IidManager::HasAttribute (uint16_t uid,
                           std::string name)
@@ -676,6 +754,8 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  m_generation++;
+  m_attributeGeneration++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void 
@@ -687,6 +767,7 @@ IidManager::SetAttributeInitialValue (uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  m_attributeGeneration++;
 }
 
 
@@ -710,6 +791,19 @@ IidManager::GetAttribute (uint16_t uid, std::size_t i) const
   return information->attributes[i];
 }
 
+const struct TypeId::AttributeInformation *
+IidManager::LookupAttribute (uint16_t uid, const std::string &name) const
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = UpdateIndexes (uid);
+  locationmap_t::const_iterator it = information->attributeIndex.find (name);
+  if (it == information->attributeIndex.end ())
+    {
+      return 0;
+    }
+  return &LookupInformation (it->second.first)->attributes[it->second.second];
+}
+
 bool
 IidManager::HasTraceSource (uint16_t uid,
                             std::string name)
@@ -767,6 +861,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
 std::size_t
@@ -787,6 +882,58 @@ IidManager::GetTraceSource (uint16_t uid, std::size_t i) const
   NS_LOG_LOGIC (IIDL << information->name);
   return information->traceSources[i];
 }
+const struct TypeId::TraceSourceInformation *
+IidManager::LookupTraceSource (uint16_t uid, const std::string &name) const
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = UpdateIndexes (uid);
+  locationmap_t::const_iterator it = information->traceSourceIndex.find (name);
+  if (it == information->traceSourceIndex.end ())
+    {
+      return 0;
+    }
+  return &LookupInformation (it->second.first)->traceSources[it->second.second];
+}
+
+struct IidManager::IidInformation *
+IidManager::UpdateIndexes (uint16_t uid) const
+{
+  NS_LOG_FUNCTION (IID << uid);
+  struct IidInformation *information = LookupInformation (uid);
+  if (information->indexGeneration == m_generation)
+    {
+      return information;
+    }
+  NS_LOG_LOGIC (IIDL << "building the indexes of " << information->name);
+  information->attributeIndex.clear ();
+  information->traceSourceIndex.clear ();
+  // walk up the inheritance tree: the names are unique along it, as
+  // AddAttribute and AddTraceSource check.
+  uint16_t cur = uid;
+  while (true)
+    {
+      struct IidInformation *current = LookupInformation (cur);
+      for (std::size_t i = 0; i < current->attributes.size (); i++)
+        {
+          information->attributeIndex.insert (std::make_pair (current->attributes[i].name,
+                                                              std::make_pair (cur, i)));
+        }
+      for (std::size_t i = 0; i < current->traceSources.size (); i++)
+        {
+          information->traceSourceIndex.insert (std::make_pair (current->traceSources[i].name,
+                                                                std::make_pair (cur, i)));
+        }
+      if (current->parent == cur || current->parent == 0)
+        {
+          // top of inheritance tree
+          break;
+        }
+      cur = current->parent;
+    }
+  information->indexGeneration = m_generation;
+  return information;
+}
+
 bool 
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
@@ -873,41 +1020,40 @@ TypeId::GetRegistered (uint16_t i)
   return TypeId (IidManager::Get ()->GetRegistered (i));
 }
 
+uint32_t
+TypeId::GetAttributeGeneration (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return IidManager::Get ()->GetAttributeGeneration ();
+}
+
 bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
+  const struct TypeId::AttributeInformation *tmp = IidManager::Get ()->LookupAttribute (m_tid, name);
+  if (tmp == 0)
+    {
+      return false;
+    }
+  if (tmp->supportLevel == TypeId::SUPPORTED)
+    {
+      *info = *tmp;
+      return true;
+    }
+  else if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "Attribute '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+      *info = *tmp;
+      return true;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("Attribute '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
   return false;
 }
 
@@ -1137,38 +1283,29 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
-  do {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                   return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else  if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
+  const struct TypeId::TraceSourceInformation *tmp = IidManager::Get ()->LookupTraceSource (m_tid, name);
+  if (tmp == 0)
+    {
+      return 0;
+    }
+  if (tmp->supportLevel == TypeId::SUPPORTED)
+    {
+      *info = *tmp;
+      return tmp->accessor;
+    }
+  else if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "TraceSource '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+      *info = *tmp;
+      return tmp->accessor;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("TraceSource '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
   return 0;
 }
 
@@ -164,6 +164,17 @@ public:
    * \returns The TypeId instance whose index is \c i.
    */
   static TypeId GetRegistered (uint16_t i);
+  /**
+   * Get the generation of the Attributes of the TypeIds.
+   *
+   * The generation changes each time a parent or an Attribute is
+   * added to a TypeId, or the initial value of an Attribute is
+   * changed (e.g., by Config::SetDefault), so that the Attributes
+   * can be cached by their users.
+   *
+   * \returns The generation of the Attributes.
+   */
+  static uint32_t GetAttributeGeneration (void);
 
   /**
    * Constructor.
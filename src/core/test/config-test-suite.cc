@@ -29,6 +29,7 @@
 #include "ns3/object-vector.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
+#include "ns3/string.h"
 #include "ns3/log.h"
 #include "ns3/unused.h"
 
@@ -114,6 +115,7 @@ ConfigTestObject::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ConfigTestObject")
     .SetParent<Object> ()
+    .AddConstructor<ConfigTestObject> ()
     .AddAttribute ("NodesA", "",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&ConfigTestObject::m_nodesA),
@@ -830,6 +832,170 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the compiled Config paths.
+ */
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CompiledPathConfigTestCase ();
+  /** Destructor. */
+  virtual ~CompiledPathConfigTestCase () {}
+
+  /**
+   * Trace callback with context path.
+   * \param path The context path.
+   * \param old The old value.
+   * \param newValue The new value.
+   */
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue)
+  { 
+    NS_UNUSED (old); 
+    m_newValue = newValue; 
+    m_path = path; 
+  }
+
+private:
+  virtual void DoRun (void);
+
+  int16_t m_newValue; //!< Flag to detect tracing result.
+  std::string m_path; //!< The context path.
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check the resolution of compiled paths")
+{
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // Create a root namespace object, an object under the root and
+  // four objects in the ObjectVector Attribute of the latter.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      a->AddNodeB (objects[i]);
+    }
+
+  //
+  // A single index is looked up in the vector.
+  //
+  Config::CompiledPath single ("/NodeA/NodesB/2");
+  Config::MatchContainer matches = single.LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[2], "Unexpected object matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/NodesB/2/", "Unexpected matched path");
+  NS_TEST_ASSERT_MSG_EQ (single.GetPath (), "/NodeA/NodesB/2", "Unexpected path");
+
+  //
+  // Set an Attribute through a compiled path with the OR and range syntax,
+  // twice, to use the cached attributes.
+  //
+  Config::CompiledPath some ("/NodeA/NodesB/[0-1]|3");
+  some.Set ("A", IntegerValue (-3));
+  some.Set ("A", IntegerValue (-4));
+  int64_t expected[] = {-4, -4, 10, -4};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objects[i]->GetAttribute ("A", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), expected[i], "Object Attribute \"A\" not set as expected");
+    }
+
+  //
+  // Connect through a compiled path and check the context.
+  //
+  Config::CompiledPath all ("/NodeA/NodesB/*");
+  all.Connect ("Source", MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  m_newValue = 0;
+  objects[3]->SetAttribute ("Source", IntegerValue (-5));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -5, "Trace 3 did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodesB/3/Source", "Trace 3 did not provide expected context");
+  all.Disconnect ("Source", MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  m_newValue = 0;
+  objects[3]->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, 0, "Trace 3 fired after being disconnected");
+
+  //
+  // A compiled path is resolved again on every use.
+  //
+  Config::CompiledPath next ("/NodeA/NodesB/4");
+  NS_TEST_ASSERT_MSG_EQ (next.LookupMatches ().GetN (), 0, "Unexpected match of a missing object");
+  objects.push_back (CreateObject<ConfigTestObject> ());
+  a->AddNodeB (objects[4]);
+  NS_TEST_ASSERT_MSG_EQ (next.LookupMatches ().GetN (), 1, "The new object was not matched");
+  NS_TEST_ASSERT_MSG_EQ (all.LookupMatches ().GetN (), 5, "Unexpected number of matches");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
+/**
+ * \ingroup config-tests
+ * Test that setting a Pointer Attribute from a string value through
+ * Config gives each matched object its own pointee.
+ */
+class PointerStringConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  PointerStringConfigTestCase ();
+  /** Destructor. */
+  virtual ~PointerStringConfigTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+PointerStringConfigTestCase::PointerStringConfigTestCase ()
+  : TestCase ("Check that Pointer Attributes set from strings get distinct objects")
+{
+}
+
+void
+PointerStringConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      a->AddNodeB (objects[i]);
+    }
+
+  Config::Set ("/NodeA/NodesB/*/NodeA", StringValue ("ConfigTestObject[A=3]"));
+
+  std::vector<Ptr<ConfigTestObject> > pointees;
+  for (uint32_t i = 0; i < objects.size (); i++)
+    {
+      PointerValue pointer;
+      objects[i]->GetAttribute ("NodeA", pointer);
+      Ptr<ConfigTestObject> pointee = pointer.Get<ConfigTestObject> ();
+      NS_TEST_ASSERT_MSG_NE (pointee, 0, "Pointer Attribute \"NodeA\" not set");
+      NS_TEST_ASSERT_MSG_EQ (static_cast<int> (pointee->GetA ()), 3, "Pointee not built from the string");
+      for (uint32_t j = 0; j < pointees.size (); j++)
+        {
+          NS_TEST_ASSERT_MSG_NE (pointee, pointees[j], "Objects " << i << " and " << j << " share their pointee");
+        }
+      pointees.push_back (pointee);
+    }
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -848,6 +1014,8 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new CompiledPathConfigTestCase);
+  AddTestCase (new PointerStringConfigTestCase);
 }
 
 /**
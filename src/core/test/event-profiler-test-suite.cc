@@ -0,0 +1,447 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/core-config.h"
+#include "ns3/event-profiler.h"
+#include "ns3/make-event.h"
+#include "ns3/object.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * EventProfiler test suite.
+ */
+
+using namespace ns3;
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * An object whose events are profiled.
+ */
+class ProfiledObject : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+  /** Handle an event. */
+  void Handle (void)
+  {
+    m_handled++;
+  }
+  /** Handle another event, with the same signature. */
+  void HandleOther (void)
+  {
+    m_handledOther++;
+  }
+  /** Handle an event, with a function overridden by the subclasses. */
+  virtual void HandleVirtual (void)
+  {
+    m_handled++;
+  }
+  /** The number of events handled. */
+  uint32_t m_handled = 0;
+  /** The number of other events handled. */
+  uint32_t m_handledOther = 0;
+};
+
+TypeId
+ProfiledObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfiledObject")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ProfiledObject> ()
+  ;
+  return tid;
+}
+
+/**
+ * \ingroup simulator
+ * An object overriding a function whose events are profiled.
+ */
+class ProfiledDerivedObject : public ProfiledObject
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+  virtual void HandleVirtual (void)
+  {
+    m_handledOther++;
+  }
+};
+
+TypeId
+ProfiledDerivedObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfiledDerivedObject")
+    .SetParent<ProfiledObject> ()
+    .SetGroupName ("Core")
+    .AddConstructor<ProfiledDerivedObject> ()
+  ;
+  return tid;
+}
+
+} // namespace ns3
+
+/**
+ * Get the name of a member function of ProfiledObject in the profiles.
+ * \param [in] function The name of the function, e.g. "Handle()".
+ * \returns The name of its symbol if it can be looked up, and
+ *          otherwise the start of the name of its signature.
+ */
+static std::string
+GetMemberName (std::string function)
+{
+#ifdef HAVE_DLFCN_H
+  return "ns3::ProfiledObject::" + function;
+#else
+  return "void (ns3::ProfiledObject::*)() at ";
+#endif
+}
+
+/**
+ * Handle an event of a free function.
+ * \param [in] n The number of events handled.
+ */
+static void
+HandleFunction (uint32_t *n)
+{
+  (*n)++;
+}
+
+/**
+ * \ingroup simulator
+ * Check the profile of the events invoked by an EventProfiler.
+ */
+class EventProfilerTestCase : public TestCase
+{
+public:
+  EventProfilerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check the profile of the events")
+{
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  Ptr<ProfiledObject> object = CreateObject<ProfiledObject> ();
+  uint32_t n = 0;
+  Ptr<EventProfiler> profiler = Create<EventProfiler> (1);
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      EventImpl *event = MakeEvent (&ProfiledObject::Handle, object);
+      profiler->Invoke (event, i % 2);
+      event->Unref ();
+    }
+  EventImpl *event = MakeEvent (&HandleFunction, &n);
+  profiler->Invoke (event, Simulator::NO_CONTEXT);
+  event->Unref ();
+  NS_TEST_EXPECT_MSG_EQ (object->m_handled, 6, "Member events not invoked");
+  NS_TEST_EXPECT_MSG_EQ (n, 1, "Function event not invoked");
+
+  std::ostringstream flat;
+  profiler->Print (flat);
+  NS_TEST_EXPECT_MSG_EQ (flat.str ().find ("Event profile: 7 events"), 0,
+                         "Bad event count in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("6  " + GetMemberName ("Handle()")), std::string::npos,
+                         "Member function not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("6  Core ns3::ProfiledObject"), std::string::npos,
+                         "TypeId not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("1  void (*)(unsigned int*)"), std::string::npos,
+                         "Function not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("3  node 1"), std::string::npos,
+                         "Node not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("1  no node"), std::string::npos,
+                         "Missing context not profiled in " << flat.str ());
+
+  std::ostringstream stacks;
+  profiler->PrintStacks (stacks);
+  std::istringstream lines (stacks.str ());
+  std::string line;
+  uint32_t nLines = 0;
+  while (std::getline (lines, line))
+    {
+      nLines++;
+      NS_TEST_EXPECT_MSG_EQ ((line.find ("Core;ns3::ProfiledObject;" + GetMemberName ("Handle()")) == 0
+                              || line.find ("(no group);(no class);void (*)(unsigned int*) at ") == 0),
+                             true, "Bad stack " << line);
+#ifdef HAVE_DLFCN_H
+      // a static function has no symbol, and is located in its library
+      NS_TEST_EXPECT_MSG_EQ ((line.find ("void (*)(unsigned int*)") == std::string::npos
+                              || line.find (".so+0x") != std::string::npos),
+                             true, "Function not located in its library in " << line);
+#endif
+      NS_TEST_EXPECT_MSG_EQ ((line.find (";node ") != std::string::npos
+                              || line.find (";no node ") != std::string::npos),
+                             true, "Bad stack " << line);
+    }
+  NS_TEST_EXPECT_MSG_EQ (nLines, 3, "Bad number of stacks in " << stacks.str ());
+}
+
+
+/**
+ * \ingroup simulator
+ * Check that the events calling different functions of the same
+ * signature are profiled separately.
+ */
+class EventProfilerFunctionsTestCase : public TestCase
+{
+public:
+  EventProfilerFunctionsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerFunctionsTestCase::EventProfilerFunctionsTestCase ()
+  : TestCase ("Check the profile of functions of the same signature")
+{
+}
+
+void
+EventProfilerFunctionsTestCase::DoRun (void)
+{
+  Ptr<ProfiledObject> object = CreateObject<ProfiledObject> ();
+  Ptr<EventProfiler> profiler = Create<EventProfiler> (1);
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      EventImpl *event = i < 2
+        ? MakeEvent (&ProfiledObject::Handle, object)
+        : MakeEvent (&ProfiledObject::HandleOther, object);
+      profiler->Invoke (event, 0);
+      event->Unref ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (object->m_handled, 2, "Events not invoked");
+  NS_TEST_EXPECT_MSG_EQ (object->m_handledOther, 3, "Other events not invoked");
+
+  std::ostringstream flat;
+  profiler->Print (flat);
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("2  " + GetMemberName ("Handle()")), std::string::npos,
+                         "First member function not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("3  " + GetMemberName ("HandleOther()")), std::string::npos,
+                         "Second member function not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("5  Core ns3::ProfiledObject"), std::string::npos,
+                         "TypeId not profiled in " << flat.str ());
+
+  std::ostringstream stacks;
+  profiler->PrintStacks (stacks);
+  std::istringstream lines (stacks.str ());
+  std::string line;
+  std::set<std::string> functions;
+  while (std::getline (lines, line))
+    {
+      functions.insert (line.substr (0, line.find (";node ")));
+    }
+  NS_TEST_EXPECT_MSG_EQ (functions.size (), 2, "Functions not told apart in " << stacks.str ());
+}
+
+
+/**
+ * \ingroup simulator
+ * Check that the events calling a virtual function are profiled by
+ * the function of the class of the object they are bound to.
+ */
+class EventProfilerVirtualTestCase : public TestCase
+{
+public:
+  EventProfilerVirtualTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerVirtualTestCase::EventProfilerVirtualTestCase ()
+  : TestCase ("Check the profile of virtual functions")
+{
+}
+
+void
+EventProfilerVirtualTestCase::DoRun (void)
+{
+  Ptr<ProfiledObject> object = CreateObject<ProfiledObject> ();
+  Ptr<ProfiledObject> derived = CreateObject<ProfiledDerivedObject> ();
+  Ptr<EventProfiler> profiler = Create<EventProfiler> (1);
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      EventImpl *event = MakeEvent (&ProfiledObject::HandleVirtual, i < 2 ? object : derived);
+      profiler->Invoke (event, 0);
+      event->Unref ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (object->m_handled, 2, "Base events not invoked");
+  NS_TEST_EXPECT_MSG_EQ (derived->m_handledOther, 3, "Derived events not invoked");
+
+  std::ostringstream stacks;
+  profiler->PrintStacks (stacks);
+  std::istringstream lines (stacks.str ());
+  std::string line;
+  std::set<std::string> functions;
+  while (std::getline (lines, line))
+    {
+      functions.insert (line.substr (0, line.find (";node ")));
+    }
+  NS_TEST_EXPECT_MSG_EQ (functions.size (), 2, "Functions not told apart in " << stacks.str ());
+
+#ifdef HAVE_DLFCN_H
+  std::ostringstream flat;
+  profiler->Print (flat);
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("2  ns3::ProfiledObject::HandleVirtual()"), std::string::npos,
+                         "Base function not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("3  ns3::ProfiledDerivedObject::HandleVirtual()"), std::string::npos,
+                         "Overriding function not profiled in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("3  Core ns3::ProfiledDerivedObject"), std::string::npos,
+                         "TypeId of the overriding function not profiled in " << flat.str ());
+#endif
+}
+
+
+/**
+ * \ingroup simulator
+ * Check the sampling of the events.
+ */
+class EventProfilerSamplingTestCase : public TestCase
+{
+public:
+  EventProfilerSamplingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerSamplingTestCase::EventProfilerSamplingTestCase ()
+  : TestCase ("Check the sampling of the events")
+{
+}
+
+void
+EventProfilerSamplingTestCase::DoRun (void)
+{
+  Ptr<ProfiledObject> object = CreateObject<ProfiledObject> ();
+  Ptr<EventProfiler> profiler = Create<EventProfiler> (4);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      EventImpl *event = MakeEvent (&ProfiledObject::Handle, object);
+      profiler->Invoke (event, 0);
+      event->Unref ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (object->m_handled, 10, "Events not invoked");
+  std::ostringstream flat;
+  profiler->Print (flat);
+  NS_TEST_EXPECT_MSG_EQ (flat.str ().find ("Event profile: 8 events"), 0,
+                         "Bad estimated event count in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("estimated from one event out of 4"), std::string::npos,
+                         "Sampling not reported in " << flat.str ());
+}
+
+
+/**
+ * \ingroup simulator
+ * Check the profile written by the default simulator implementation.
+ */
+class EventProfilerSimulatorTestCase : public TestCase
+{
+public:
+  EventProfilerSimulatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventProfilerSimulatorTestCase::EventProfilerSimulatorTestCase ()
+  : TestCase ("Check the profile of Simulator::Run")
+{
+}
+
+void
+EventProfilerSimulatorTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("event-profile");
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EnableProfiler", BooleanValue (true));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfilerOutput", StringValue (prefix));
+
+  Ptr<ProfiledObject> object = CreateObject<ProfiledObject> ();
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::ScheduleWithContext (7, Seconds (i), &ProfiledObject::Handle, object);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EnableProfiler", BooleanValue (false));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfilerOutput", StringValue ("simulator-profile"));
+
+  std::ifstream profile ((prefix + ".txt").c_str ());
+  std::ostringstream flat;
+  flat << profile.rdbuf ();
+  NS_TEST_EXPECT_MSG_EQ (flat.str ().find ("Event profile: 5 events"), 0,
+                         "Bad event count in " << flat.str ());
+  NS_TEST_EXPECT_MSG_NE (flat.str ().find ("5  node 7"), std::string::npos,
+                         "Node not profiled in " << flat.str ());
+
+  std::ifstream stacks ((prefix + ".folded").c_str ());
+  std::string line;
+  std::getline (stacks, line);
+  NS_TEST_EXPECT_MSG_EQ (line.find ("Core;ns3::ProfiledObject;" + GetMemberName ("Handle()")), 0,
+                         "Bad stack " << line);
+  NS_TEST_EXPECT_MSG_NE (line.find (";node 7 "), std::string::npos, "Bad stack " << line);
+}
+
+
+/**
+ * \ingroup simulator
+ * EventProfiler test suite.
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ();
+};
+
+EventProfilerTestSuite::EventProfilerTestSuite ()
+  : TestSuite ("event-profiler", UNIT)
+{
+  AddTestCase (new EventProfilerTestCase, TestCase::QUICK);
+  AddTestCase (new EventProfilerFunctionsTestCase, TestCase::QUICK);
+  AddTestCase (new EventProfilerVirtualTestCase, TestCase::QUICK);
+  AddTestCase (new EventProfilerSamplingTestCase, TestCase::QUICK);
+  AddTestCase (new EventProfilerSimulatorTestCase, TestCase::QUICK);
+}
+
+static EventProfilerTestSuite g_eventProfilerTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/log-record.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include <sstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * LogRecorder test suite.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogRecordTestSuite");
+
+/**
+ * \ingroup logging
+ * Base class of the LogRecorder test cases: captures the output of the
+ * recorder, and restores its settings.
+ */
+class LogRecordTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] name The name of the test case.
+   */
+  LogRecordTestCase (std::string name);
+
+protected:
+  /**
+   * Flush the records of the thread.
+   * \returns The formatted records.
+   */
+  std::string Flush (void);
+
+  std::ostringstream m_output;  //!< The output of the recorder.
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoTeardown (void);
+};
+
+LogRecordTestCase::LogRecordTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+LogRecordTestCase::DoSetup (void)
+{
+  LogRecorder::Flush ();
+  LogRecorder::SetOutput (&m_output);
+  g_log.Enable (LOG_LEVEL_ALL);
+}
+
+void
+LogRecordTestCase::DoTeardown (void)
+{
+  g_log.Disable ((enum LogLevel)(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+  LogRecorder::Flush ();
+  LogRecorder::SetOutput (0);
+  LogRecorder::SetCapacity (4096);
+  LogRecorder::SetMode (LogRecorder::FLUSH_WHEN_FULL);
+}
+
+std::string
+LogRecordTestCase::Flush (void)
+{
+  LogRecorder::Flush ();
+  std::string output = m_output.str ();
+  m_output.str ("");
+  return output;
+}
+
+
+/**
+ * \ingroup logging
+ * Check the formatting of the arguments and of the prefixes.
+ */
+class LogRecordFormatTestCase : public LogRecordTestCase
+{
+public:
+  LogRecordFormatTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogRecordFormatTestCase::LogRecordFormatTestCase ()
+  : LogRecordTestCase ("Check the formatting of the records")
+{
+}
+
+void
+LogRecordFormatTestCase::DoRun (void)
+{
+  std::string output;
+  NS_LOG_RECORD_DEBUG ("int {} uint {} double {} bool {} char {}",
+                       -3, 7u, 1.5, true, 'x');
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "int -3 uint 7 double 1.5 bool 1 char x\n",
+                         "Numbers badly formatted");
+
+  std::string name = "a name";
+  NS_LOG_RECORD_DEBUG ("{} {} {}", name, "literal", std::string (40, 'z'));
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "a name literal " + std::string (LogRecorder::STRING_SIZE - 1, 'z') + "\n",
+                         "Strings badly formatted or truncated");
+
+  std::ostringstream time;
+  time << Seconds (2);
+  NS_LOG_RECORD_INFO ("time {}, extra {} {}", Seconds (2), 1);
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "time " + time.str () + ", extra 1 {}\n",
+                         "Time or missing argument badly formatted");
+
+  NS_LOG_RECORD_WARN ("no argument");
+  g_log.Enable ((enum LogLevel)(LOG_PREFIX_FUNC | LOG_PREFIX_LEVEL));
+  NS_LOG_RECORD_WARN ("prefixed");
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "no argument\nLogRecordTestSuite:DoRun(): [WARN ] prefixed\n",
+                         "Prefixes badly formatted");
+
+  g_log.Disable (LOG_DEBUG);
+  NS_LOG_RECORD_DEBUG ("disabled {}", 1);
+  NS_LOG_RECORD_ERROR ("enabled");
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "LogRecordTestSuite:DoRun(): [ERROR] enabled\n",
+                         "Record of a disabled level");
+}
+
+
+/**
+ * \ingroup logging
+ * Check that the time and the context are those of the record, not
+ * those of the flush.
+ */
+class LogRecordTimeTestCase : public LogRecordTestCase
+{
+public:
+  LogRecordTimeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Record a message, and print the expected prefixes. */
+  void Record (void);
+
+  std::string m_expected;  //!< The expected output.
+};
+
+LogRecordTimeTestCase::LogRecordTimeTestCase ()
+  : LogRecordTestCase ("Check the time and node prefixes of the records")
+{
+}
+
+void
+LogRecordTimeTestCase::Record (void)
+{
+  std::ostringstream oss;
+  (*LogGetTimePrinter ()) (oss);
+  oss << " ";
+  (*LogGetNodePrinter ()) (oss);
+  oss << " event\n";
+  m_expected += oss.str ();
+  NS_LOG_RECORD_INFO ("event");
+}
+
+void
+LogRecordTimeTestCase::DoRun (void)
+{
+  std::string output;
+  g_log.Enable ((enum LogLevel)(LOG_PREFIX_TIME | LOG_PREFIX_NODE));
+  Simulator::ScheduleWithContext (3, Seconds (1), &LogRecordTimeTestCase::Record, this);
+  Simulator::ScheduleWithContext (5, MilliSeconds (2500), &LogRecordTimeTestCase::Record, this);
+  Simulator::Run ();
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, m_expected, "Time or node prefixes badly formatted");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup logging
+ * Check the modes of the recorder when its buffer is full.
+ */
+class LogRecordModeTestCase : public LogRecordTestCase
+{
+public:
+  LogRecordModeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogRecordModeTestCase::LogRecordModeTestCase ()
+  : LogRecordTestCase ("Check the flush and ring modes of the recorder")
+{
+}
+
+void
+LogRecordModeTestCase::DoRun (void)
+{
+  std::string output;
+  LogRecorder::SetCapacity (2);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_LOG_RECORD_INFO ("{}", i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_output.str (), "0\n1\n", "Full buffer not flushed");
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "0\n1\n2\n", "Records lost");
+
+  LogRecorder::SetMode (LogRecorder::KEEP_LAST);
+  LogRecorder::SetCapacity (4);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      NS_LOG_RECORD_INFO ("{}", i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_output.str (), "", "Ring flushed before Flush");
+  output = Flush ();
+  NS_TEST_EXPECT_MSG_EQ (output, "6\n7\n8\n9\n", "Last records not kept in order");
+}
+
+
+/**
+ * \ingroup logging
+ * LogRecorder test suite.
+ */
+class LogRecordTestSuite : public TestSuite
+{
+public:
+  LogRecordTestSuite ();
+};
+
+LogRecordTestSuite::LogRecordTestSuite ()
+  : TestSuite ("log-record", UNIT)
+{
+  AddTestCase (new LogRecordFormatTestCase, TestCase::QUICK);
+  AddTestCase (new LogRecordTimeTestCase, TestCase::QUICK);
+  AddTestCase (new LogRecordModeTestCase, TestCase::QUICK);
+}
+
+static LogRecordTestSuite g_logRecordTestSuite; //!< Static variable for test initialization
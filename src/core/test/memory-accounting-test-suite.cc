@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/object.h"
+#include "ns3/simulator.h"
+#include <sstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * MemoryAccounting test suite.
+ */
+
+using namespace ns3;
+
+namespace ns3 {
+
+/**
+ * \ingroup core-tests
+ * An object whose memory is accounted for.
+ */
+class AccountedObject : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+  /** Some data. */
+  uint8_t m_data[100];
+};
+
+NS_OBJECT_ENSURE_REGISTERED (AccountedObject);
+
+TypeId
+AccountedObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AccountedObject")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<AccountedObject> ()
+  ;
+  return tid;
+}
+
+} // namespace ns3
+
+/**
+ * \ingroup core-tests
+ * Check the accounting of blocks per subsystem and per context.
+ */
+class MemoryAccountingBlocksTestCase : public TestCase
+{
+public:
+  MemoryAccountingBlocksTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Allocate a block in the current context.
+   * \param [in] block The block.
+   */
+  void Allocate (const void *block);
+
+  MemoryAccounting::Subsystem m_subsystem;  //!< The subsystem tested.
+};
+
+MemoryAccountingBlocksTestCase::MemoryAccountingBlocksTestCase ()
+  : TestCase ("Check the accounting of blocks")
+{
+}
+
+void
+MemoryAccountingBlocksTestCase::Allocate (const void *block)
+{
+  MemoryAccounting::Allocate (m_subsystem, block, 10);
+}
+
+void
+MemoryAccountingBlocksTestCase::DoRun (void)
+{
+  m_subsystem = MemoryAccounting::GetSubsystem ("Test::Blocks");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetSubsystem ("Test::Blocks"), m_subsystem,
+                         "Subsystem registered twice");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetName (m_subsystem), "Test::Blocks",
+                         "Bad subsystem name");
+
+  int blocks[4];
+  MemoryAccounting::Enable ();
+  Simulator::ScheduleWithContext (1, Seconds (1), &MemoryAccountingBlocksTestCase::Allocate, this, &blocks[0]);
+  Simulator::ScheduleWithContext (1, Seconds (2), &MemoryAccountingBlocksTestCase::Allocate, this, &blocks[1]);
+  Simulator::ScheduleWithContext (4, Seconds (3), &MemoryAccountingBlocksTestCase::Allocate, this, &blocks[2]);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  MemoryAccounting::Allocate (m_subsystem, &blocks[3], 5, Simulator::NO_CONTEXT);
+
+  MemoryAccounting::Usage usage = MemoryAccounting::GetUsage (m_subsystem);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 4, "Bad number of blocks");
+  NS_TEST_EXPECT_MSG_EQ (usage.bytes, 35, "Bad number of bytes");
+  usage = MemoryAccounting::GetUsage (m_subsystem, 1);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 2, "Bad number of blocks of node 1");
+  NS_TEST_EXPECT_MSG_EQ (usage.bytes, 20, "Bad number of bytes of node 1");
+  usage = MemoryAccounting::GetUsage (m_subsystem, 4);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 1, "Bad number of blocks of node 4");
+  usage = MemoryAccounting::GetUsage (m_subsystem, Simulator::NO_CONTEXT);
+  NS_TEST_EXPECT_MSG_EQ (usage.bytes, 5, "Bad number of bytes out of any node");
+
+  std::ostringstream oss;
+  MemoryAccounting::Print (oss);
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("node 1:\n  Test::Blocks"), std::string::npos,
+                         "Node not printed in " << oss.str ());
+  NS_TEST_EXPECT_MSG_LT (oss.str ().find ("no node:\n"), oss.str ().rfind ("  Test::Blocks"),
+                         "Missing context not printed in " << oss.str ());
+
+  // the blocks accounted for are released after Disable
+  MemoryAccounting::Disable ();
+  MemoryAccounting::Free (&blocks[0]);
+  MemoryAccounting::Free (&blocks[3]);
+  usage = MemoryAccounting::GetUsage (m_subsystem, 1);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 1, "Block of node 1 not released");
+  NS_TEST_EXPECT_MSG_EQ (usage.peakBytes, 20, "Bad peak bytes of node 1");
+  MemoryAccounting::Free (&blocks[1]);
+  MemoryAccounting::Free (&blocks[2]);
+  usage = MemoryAccounting::GetUsage (m_subsystem);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 0, "Blocks not released");
+  NS_TEST_EXPECT_MSG_EQ (usage.bytes, 0, "Bytes not released");
+  NS_TEST_EXPECT_MSG_EQ (usage.peakBytes, 35, "Bad peak bytes");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::HasBlocks (), false, "Blocks left");
+}
+
+
+/**
+ * \ingroup core-tests
+ * Check the accounting of the Objects and of the events.
+ */
+class MemoryAccountingObjectsTestCase : public TestCase
+{
+public:
+  MemoryAccountingObjectsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Create an object and schedule an event in the current context. */
+  void CreateInNode (void);
+  /** Do nothing. */
+  void DoNothing (void)
+  {
+  }
+
+  Ptr<AccountedObject> m_object;  //!< The object created in a node.
+};
+
+MemoryAccountingObjectsTestCase::MemoryAccountingObjectsTestCase ()
+  : TestCase ("Check the accounting of Objects and events")
+{
+}
+
+void
+MemoryAccountingObjectsTestCase::CreateInNode (void)
+{
+  m_object = CreateObject<AccountedObject> ();
+  MemoryAccounting::Subsystem events = MemoryAccounting::GetSubsystem ("EventImpl");
+  uint64_t before = MemoryAccounting::GetUsage (events, 2).count;
+  Simulator::Schedule (Seconds (1), &MemoryAccountingObjectsTestCase::DoNothing, this);
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetUsage (events, 2).count, before + 1,
+                         "Event not accounted in its node");
+}
+
+void
+MemoryAccountingObjectsTestCase::DoRun (void)
+{
+  MemoryAccounting::Enable ();
+  MemoryAccounting::Subsystem objects = MemoryAccounting::GetSubsystem ("ns3::AccountedObject");
+  Ptr<AccountedObject> object = CreateObject<AccountedObject> ();
+  MemoryAccounting::Usage usage = MemoryAccounting::GetUsage (objects);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 1, "Object not accounted");
+  NS_TEST_EXPECT_MSG_EQ (usage.bytes, sizeof (AccountedObject), "Bad size of the object");
+  Ptr<AccountedObject> copy = CopyObject (object);
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetUsage (objects).count, 2, "Copy not accounted");
+  copy = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetUsage (objects).count, 1, "Copy not released");
+
+  Simulator::ScheduleWithContext (2, Seconds (1), &MemoryAccountingObjectsTestCase::CreateInNode, this);
+  Simulator::Run ();
+  usage = MemoryAccounting::GetUsage (objects, 2);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 1, "Object not accounted in its node");
+  Simulator::Destroy ();
+  MemoryAccounting::Disable ();
+
+  usage = MemoryAccounting::GetUsage (MemoryAccounting::GetSubsystem ("EventImpl"), 2);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 0, "Events not released");
+  object = 0;
+  m_object = 0;
+  usage = MemoryAccounting::GetUsage (objects);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 0, "Objects not released");
+  NS_TEST_EXPECT_MSG_EQ (usage.peakBytes, 2 * sizeof (AccountedObject), "Bad peak bytes");
+}
+
+
+/**
+ * \ingroup core-tests
+ * Check the periodic printing of the memory used.
+ */
+class MemoryAccountingPrintTestCase : public TestCase
+{
+public:
+  MemoryAccountingPrintTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MemoryAccountingPrintTestCase::MemoryAccountingPrintTestCase ()
+  : TestCase ("Check the periodic printing of the memory used")
+{
+}
+
+void
+MemoryAccountingPrintTestCase::DoRun (void)
+{
+  std::ostringstream oss;
+  MemoryAccounting::Enable ();
+  MemoryAccounting::PrintEvery (Seconds (1), oss);
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  MemoryAccounting::Disable ();
+
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("Memory accounting at 0s:"), std::string::npos,
+                         "First print missing in " << oss.str ());
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("Memory accounting at 2s:"), std::string::npos,
+                         "Last print missing in " << oss.str ());
+  NS_TEST_EXPECT_MSG_EQ (oss.str ().find ("Memory accounting at 3s:"), std::string::npos,
+                         "Print after the end in " << oss.str ());
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("  EventImpl"), std::string::npos,
+                         "Events not printed in " << oss.str ());
+}
+
+
+/**
+ * Do nothing.
+ */
+static void
+DoNothing (void)
+{
+}
+
+/**
+ * \ingroup core-tests
+ * Check that the periodic printing of the memory used stops with the
+ * other events.
+ */
+class MemoryAccountingPrintEndTestCase : public TestCase
+{
+public:
+  MemoryAccountingPrintEndTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MemoryAccountingPrintEndTestCase::MemoryAccountingPrintEndTestCase ()
+  : TestCase ("Check that the periodic printing stops with the other events")
+{
+}
+
+void
+MemoryAccountingPrintEndTestCase::DoRun (void)
+{
+  std::ostringstream oss;
+  MemoryAccounting::Enable ();
+  MemoryAccounting::PrintEvery (Seconds (1), oss);
+  Simulator::Schedule (Seconds (3.5), &DoNothing);
+  Simulator::Run ();
+  Time end = Simulator::Now ();
+  Simulator::Destroy ();
+  MemoryAccounting::Disable ();
+
+  NS_TEST_EXPECT_MSG_EQ (end, Seconds (4), "Simulation not ended by the last print");
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("Memory accounting at 4s:"), std::string::npos,
+                         "Last print missing in " << oss.str ());
+  NS_TEST_EXPECT_MSG_EQ (oss.str ().find ("Memory accounting at 5s:"), std::string::npos,
+                         "Print after the end in " << oss.str ());
+}
+
+
+/**
+ * \ingroup core-tests
+ * MemoryAccounting test suite.
+ */
+class MemoryAccountingTestSuite : public TestSuite
+{
+public:
+  MemoryAccountingTestSuite ();
+};
+
+MemoryAccountingTestSuite::MemoryAccountingTestSuite ()
+  : TestSuite ("memory-accounting", UNIT)
+{
+  AddTestCase (new MemoryAccountingBlocksTestCase, TestCase::QUICK);
+  AddTestCase (new MemoryAccountingObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new MemoryAccountingPrintTestCase, TestCase::QUICK);
+  AddTestCase (new MemoryAccountingPrintEndTestCase, TestCase::QUICK);
+}
+
+static MemoryAccountingTestSuite g_memoryAccountingTestSuite; //!< Static variable for test initialization
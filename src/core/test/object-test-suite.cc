@@ -22,6 +22,15 @@
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
 #include "ns3/assert.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_STDLIB_H
+#include <cstdlib>
+#endif
 
 /**
  * \file
@@ -143,10 +152,46 @@ protected:
   }
 };
 
+/**
+ * \ingroup object-tests
+ * Class with Attributes set at construction.
+ */
+class AttributeObject : public BaseA
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static ns3::TypeId GetTypeId (void)
+  {
+    static ns3::TypeId tid = ns3::TypeId ("ObjectTest:AttributeObject")
+      .SetParent<BaseA> ()
+      .SetGroupName ("Core")
+      .HideFromDocumentation ()
+      .AddConstructor<AttributeObject> ()
+      .AddAttribute ("Value", "A value.",
+                     ns3::UintegerValue (1),
+                     ns3::MakeUintegerAccessor (&AttributeObject::m_value),
+                     ns3::MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("Stream", "A random variable.",
+                     ns3::StringValue ("ns3::UniformRandomVariable"),
+                     ns3::MakePointerAccessor (&AttributeObject::m_stream),
+                     ns3::MakePointerChecker<ns3::RandomVariableStream> ());
+    return tid;
+  }
+  /** Constructor. */
+  AttributeObject () : m_value (0) {}
+
+  uint32_t m_value;                           //!< The Value Attribute.
+  ns3::Ptr<ns3::RandomVariableStream> m_stream; //!< The Stream Attribute.
+};
+
 NS_OBJECT_ENSURE_REGISTERED (BaseA);
 NS_OBJECT_ENSURE_REGISTERED (DerivedA);
 NS_OBJECT_ENSURE_REGISTERED (BaseB);
 NS_OBJECT_ENSURE_REGISTERED (DerivedB);
+NS_OBJECT_ENSURE_REGISTERED (AttributeObject);
 
 }  // unnamed namespace
 
@@ -396,6 +441,21 @@ AggregateObjectTestCase::DoRun (void)
 
   baseA = baseB->GetObject<BaseA> ();
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
+
+  //
+  // Merge two aggregations and make sure that the lookups return the
+  // aggregated objects themselves, whatever object they are done through.
+  //
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  derivedA->AggregateObject (derivedB);
+  Ptr<Object> object = CreateObject<Object> ();
+  object->AggregateObject (derivedA);
+  NS_TEST_ASSERT_MSG_EQ (object->GetObject<DerivedA> (), derivedA, "Wrong DerivedA found through object");
+  NS_TEST_ASSERT_MSG_EQ (object->GetObject<BaseB> (), derivedB, "Wrong BaseB found through object");
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), derivedA, "Wrong BaseA found through derivedB");
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (DerivedA::GetTypeId ()), derivedA, "Wrong DerivedA found by TypeId through derivedB");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<Object> (), object, "The first aggregated Object should be found through derivedA");
 }
 
 /**
@@ -473,6 +533,160 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+/**
+ * \ingroup object-tests
+ * Test that the Attributes set at construction follow the changes of
+ * their initial values, made after objects of the type were created.
+ */
+class ConstructionDefaultTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ConstructionDefaultTestCase ();
+  /** Destructor. */
+  virtual ~ConstructionDefaultTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ConstructionDefaultTestCase::ConstructionDefaultTestCase ()
+  : TestCase ("Check Config::SetDefault and Config::Reset after a construction")
+{
+}
+
+ConstructionDefaultTestCase::~ConstructionDefaultTestCase ()
+{
+}
+
+void
+ConstructionDefaultTestCase::DoRun (void)
+{
+  Ptr<AttributeObject> object = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_value, 1, "Initial value not set");
+
+  Config::SetDefault ("ObjectTest:AttributeObject::Value", UintegerValue (2));
+  object = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_value, 2, "Config::SetDefault ignored after a construction");
+
+  ObjectFactory factory;
+  factory.SetTypeId (AttributeObject::GetTypeId ());
+  factory.Set ("Value", UintegerValue (3));
+  object = factory.Create<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_value, 3, "Value given at construction not set");
+
+  Config::Reset ();
+  object = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_value, 1, "Config::Reset ignored after a construction");
+}
+
+/**
+ * \ingroup object-tests
+ * Test that the Pointer Attributes with a string initial value get
+ * a new object at each construction.
+ */
+class ConstructionPointerTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ConstructionPointerTestCase ();
+  /** Destructor. */
+  virtual ~ConstructionPointerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ConstructionPointerTestCase::ConstructionPointerTestCase ()
+  : TestCase ("Check Pointer Attributes with a string initial value")
+{
+}
+
+ConstructionPointerTestCase::~ConstructionPointerTestCase ()
+{
+}
+
+void
+ConstructionPointerTestCase::DoRun (void)
+{
+  Ptr<AttributeObject> a = CreateObject<AttributeObject> ();
+  Ptr<AttributeObject> b = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_NE (a->m_stream, 0, "Pointer Attribute not set");
+  NS_TEST_ASSERT_MSG_NE (b->m_stream, 0, "Pointer Attribute not set");
+  NS_TEST_ASSERT_MSG_NE (a->m_stream, b->m_stream, "Objects share the object of a Pointer Attribute");
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<UniformRandomVariable> (a->m_stream), 0, "Wrong type of Pointer Attribute");
+
+  // Config::SetDefault validates the value, hence the objects created
+  // afterwards share its object
+  Config::SetDefault ("ObjectTest:AttributeObject::Stream", StringValue ("ns3::ConstantRandomVariable"));
+  a = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<ConstantRandomVariable> (a->m_stream), 0, "Config::SetDefault ignored for a Pointer Attribute");
+
+  Config::Reset ();
+  a = CreateObject<AttributeObject> ();
+  b = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<UniformRandomVariable> (a->m_stream), 0, "Config::Reset ignored for a Pointer Attribute");
+  NS_TEST_ASSERT_MSG_NE (a->m_stream, b->m_stream, "Objects share the object of a Pointer Attribute");
+}
+
+#ifdef HAVE_GETENV
+/**
+ * \ingroup object-tests
+ * Test that the values of the \c NS_ATTRIBUTE_DEFAULT environment
+ * variable are used at construction.
+ */
+class ConstructionEnvironmentTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ConstructionEnvironmentTestCase ();
+  /** Destructor. */
+  virtual ~ConstructionEnvironmentTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ConstructionEnvironmentTestCase::ConstructionEnvironmentTestCase ()
+  : TestCase ("Check the NS_ATTRIBUTE_DEFAULT environment variable")
+{
+}
+
+ConstructionEnvironmentTestCase::~ConstructionEnvironmentTestCase ()
+{
+}
+
+void
+ConstructionEnvironmentTestCase::DoRun (void)
+{
+  char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  std::string saved = envVar != 0 ? envVar : "";
+
+  setenv ("NS_ATTRIBUTE_DEFAULT",
+          "ObjectTest:AttributeObject::Value=4;"
+          "ObjectTest:AttributeObject::Stream=ns3::ConstantRandomVariable", 1);
+  // the environment variable is read when the initial values change
+  Config::Reset ();
+  Ptr<AttributeObject> a = CreateObject<AttributeObject> ();
+  Ptr<AttributeObject> b = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_EQ (a->m_value, 4, "NS_ATTRIBUTE_DEFAULT value overwritten by the initial value");
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<ConstantRandomVariable> (a->m_stream), 0, "NS_ATTRIBUTE_DEFAULT ignored for a Pointer Attribute");
+  NS_TEST_ASSERT_MSG_NE (a->m_stream, b->m_stream, "Objects share the object of a Pointer Attribute");
+
+  if (envVar != 0)
+    {
+      setenv ("NS_ATTRIBUTE_DEFAULT", saved.c_str (), 1);
+    }
+  else
+    {
+      unsetenv ("NS_ATTRIBUTE_DEFAULT");
+    }
+  Config::Reset ();
+  a = CreateObject<AttributeObject> ();
+  NS_TEST_ASSERT_MSG_EQ (a->m_value, 1, "NS_ATTRIBUTE_DEFAULT value kept after being unset");
+}
+#endif /* HAVE_GETENV */
+
 /**
  * \ingroup object-tests
  * The Test Suite that glues the Test Cases together.
@@ -490,6 +704,11 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
   AddTestCase (new ObjectFactoryTestCase);
+  AddTestCase (new ConstructionDefaultTestCase);
+  AddTestCase (new ConstructionPointerTestCase);
+#ifdef HAVE_GETENV
+  AddTestCase (new ConstructionEnvironmentTestCase);
+#endif /* HAVE_GETENV */
 }
 
 /**
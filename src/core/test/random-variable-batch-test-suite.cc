@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Test for the batches of random numbers and of random values.
+ */
+
+namespace ns3 {
+
+  namespace tests {
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Test case for the batches of uniform random numbers of both generators
+ */
+class RngStreamBatchTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RngStreamBatchTestCase ();
+  /** Destructor. */
+  virtual ~RngStreamBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngStreamBatchTestCase::RngStreamBatchTestCase ()
+  : TestCase ("Batches of uniform random numbers")
+{
+}
+
+RngStreamBatchTestCase::~RngStreamBatchTestCase ()
+{
+}
+
+void
+RngStreamBatchTestCase::DoRun (void)
+{
+  RngStream::Generator generators[2] = { RngStream::MRG32K3A, RngStream::PHILOX };
+  uint32_t sizes[5] = { 1, 3, 0, 100, 6 };
+  for (uint32_t g = 0; g < 2; ++g)
+    {
+      RngStream sequential (3, 5, 7, generators[g]);
+      RngStream batch (sequential);
+      NS_TEST_ASSERT_MSG_EQ (batch.GetGenerator (), generators[g], "Generator not copied");
+      for (uint32_t i = 0; i < 5; ++i)
+        {
+          double values[100];
+          batch.RandU01 (values, sizes[i]);
+          for (uint32_t j = 0; j < sizes[i]; ++j)
+            {
+              double value = sequential.RandU01 ();
+              NS_TEST_ASSERT_MSG_EQ (values[j], value, "Batch " << i << " differs at " << j);
+              NS_TEST_ASSERT_MSG_EQ ((value > 0 && value < 1), true, "Random out of (0,1)");
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (batch.RandU01 (), sequential.RandU01 (), "Streams differ after the batches");
+    }
+
+  // Known answer of Philox4x32-10 for a null key and counter, which
+  // are those of stream 0 and substream 0 with the seed 1.
+  RngStream philox (1, 0, 0, RngStream::PHILOX);
+  uint32_t expected[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (philox.RandU01 (), (expected[i] + 0.5) / 4294967296.0, "Bad Philox number " << i);
+    }
+
+  // The streams, substreams and seeds give different numbers.
+  double first = RngStream (1, 0, 0, RngStream::PHILOX).RandU01 ();
+  NS_TEST_ASSERT_MSG_NE (RngStream (1, 1, 0, RngStream::PHILOX).RandU01 (), first, "Same stream");
+  NS_TEST_ASSERT_MSG_NE (RngStream (1, 0, 1, RngStream::PHILOX).RandU01 (), first, "Same substream");
+  NS_TEST_ASSERT_MSG_NE (RngStream (2, 0, 0, RngStream::PHILOX).RandU01 (), first, "Same seed");
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Test case for the batches of values of the random variables
+ */
+class RandomVariableStreamGetValuesTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RandomVariableStreamGetValuesTestCase ();
+  /** Destructor. */
+  virtual ~RandomVariableStreamGetValuesTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that batches of values are the values returned one at a time.
+   * \param [in] factory The factory of the random variable.
+   */
+  void CheckValues (ObjectFactory factory);
+};
+
+RandomVariableStreamGetValuesTestCase::RandomVariableStreamGetValuesTestCase ()
+  : TestCase ("Batches of values of the random variables")
+{
+}
+
+RandomVariableStreamGetValuesTestCase::~RandomVariableStreamGetValuesTestCase ()
+{
+}
+
+void
+RandomVariableStreamGetValuesTestCase::CheckValues (ObjectFactory factory)
+{
+  // both variables use the same stream
+  factory.Set ("Stream", IntegerValue (11));
+  Ptr<RandomVariableStream> sequential = factory.Create<RandomVariableStream> ();
+  Ptr<RandomVariableStream> batch = factory.Create<RandomVariableStream> ();
+
+  // odd sizes, to check the values kept by the normal distribution
+  // between the batches and the single values
+  uint32_t sizes[8] = { 1, 2, 0, 1, 5, 300, 1, 7 };
+  double values[300];
+  for (uint32_t i = 0; i < 8; ++i)
+    {
+      if (sizes[i] == 1)
+        {
+          values[0] = batch->GetValue ();
+        }
+      else
+        {
+          batch->GetValues (values, sizes[i]);
+        }
+      for (uint32_t j = 0; j < sizes[i]; ++j)
+        {
+          double value = sequential->GetValue ();
+          NS_TEST_ASSERT_MSG_EQ (values[j], value,
+                                 factory.GetTypeId ().GetName () << " batch " << i << " differs at " << j);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (batch->GetValue (), sequential->GetValue (),
+                         factory.GetTypeId ().GetName () << " differs after the batches");
+}
+
+void
+RandomVariableStreamGetValuesTestCase::DoRun (void)
+{
+  RngStream::Generator generators[2] = { RngStream::MRG32K3A, RngStream::PHILOX };
+  for (uint32_t g = 0; g < 2; ++g)
+    {
+      RngSeedManager::SetGenerator (generators[g]);
+      NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetGenerator (), generators[g], "Generator not set");
+
+      ObjectFactory factory;
+      factory.SetTypeId ("ns3::UniformRandomVariable");
+      factory.Set ("Min", DoubleValue (2));
+      factory.Set ("Max", DoubleValue (5));
+      CheckValues (factory);
+      factory.Set ("Antithetic", BooleanValue (true));
+      CheckValues (factory);
+
+      // the bounds reject some values
+      factory = ObjectFactory ();
+      factory.SetTypeId ("ns3::ExponentialRandomVariable");
+      factory.Set ("Mean", DoubleValue (2));
+      factory.Set ("Bound", DoubleValue (3));
+      CheckValues (factory);
+      factory.Set ("Antithetic", BooleanValue (true));
+      CheckValues (factory);
+
+      factory = ObjectFactory ();
+      factory.SetTypeId ("ns3::ParetoRandomVariable");
+      factory.Set ("Scale", DoubleValue (1));
+      factory.Set ("Shape", DoubleValue (2));
+      factory.Set ("Bound", DoubleValue (4));
+      CheckValues (factory);
+
+      factory = ObjectFactory ();
+      factory.SetTypeId ("ns3::NormalRandomVariable");
+      factory.Set ("Mean", DoubleValue (1));
+      factory.Set ("Variance", DoubleValue (4));
+      CheckValues (factory);
+      factory.Set ("Bound", DoubleValue (2));
+      CheckValues (factory);
+      factory.Set ("Antithetic", BooleanValue (true));
+      CheckValues (factory);
+
+      // the default implementation
+      factory = ObjectFactory ();
+      factory.SetTypeId ("ns3::WeibullRandomVariable");
+      CheckValues (factory);
+    }
+  RngSeedManager::SetGenerator (RngStream::MRG32K3A);
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Test suite for the batches of random numbers and of random values
+ */
+class RandomVariableBatchTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RandomVariableBatchTestSuite ();
+};
+
+RandomVariableBatchTestSuite::RandomVariableBatchTestSuite ()
+  : TestSuite ("random-variable-batches", UNIT)
+{
+  AddTestCase (new RngStreamBatchTestCase, TestCase::QUICK);
+  AddTestCase (new RandomVariableStreamGetValuesTestCase, TestCase::QUICK);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableBatchTestSuite instance variable.
+ */
+static RandomVariableBatchTestSuite g_randomVariableBatchTestSuite;
+
+
+  }  // namespace tests
+
+}  // namespace ns3
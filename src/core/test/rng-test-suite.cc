@@ -418,6 +418,86 @@ RngParetoTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_LT (sum, maxStatistic, "Chi-squared statistic out of range");
 }
 
+// ===========================================================================
+// Test case for the uniform distribution of the Philox generator
+// ===========================================================================
+class RngPhiloxTestCase : public TestCase
+{
+public:
+  static const uint32_t N_RUNS = 5;
+  static const uint32_t N_BINS = 50;
+  static const uint32_t N_MEASUREMENTS = 1000000;
+
+  RngPhiloxTestCase ();
+  virtual ~RngPhiloxTestCase ();
+
+  double ChiSquaredTest (Ptr<UniformRandomVariable> u);
+
+private:
+  virtual void DoRun (void);
+};
+
+RngPhiloxTestCase::RngPhiloxTestCase ()
+  : TestCase ("Philox Uniform Random Number Generator")
+{
+}
+
+RngPhiloxTestCase::~RngPhiloxTestCase ()
+{
+}
+
+double
+RngPhiloxTestCase::ChiSquaredTest (Ptr<UniformRandomVariable> u)
+{
+  gsl_histogram * h = gsl_histogram_alloc (N_BINS);
+  gsl_histogram_set_ranges_uniform (h, 0., 1.);
+
+  double values[1000];
+  for (uint32_t i = 0; i < N_MEASUREMENTS; i += 1000)
+    {
+      u->GetValues (values, 1000);
+      for (uint32_t j = 0; j < 1000; ++j)
+        {
+          gsl_histogram_increment (h, values[j]);
+        }
+    }
+
+  double expected = ((double)N_MEASUREMENTS / (double)N_BINS);
+  double chiSquared = 0;
+
+  for (uint32_t i = 0; i < N_BINS; ++i)
+    {
+      double tmp = gsl_histogram_get (h, i) - expected;
+      chiSquared += tmp * tmp / expected;
+    }
+
+  gsl_histogram_free (h);
+
+  return chiSquared;
+}
+
+void
+RngPhiloxTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (static_cast<uint32_t> (time (0)));
+  RngSeedManager::SetGenerator (RngStream::PHILOX);
+
+  double sum = 0.;
+  double maxStatistic = gsl_cdf_chisq_Qinv (0.05, N_BINS);
+
+  for (uint32_t i = 0; i < N_RUNS; ++i)
+    {
+      Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+      double result = ChiSquaredTest (u);
+      sum += result;
+    }
+
+  sum /= (double)N_RUNS;
+  RngSeedManager::SetGenerator (RngStream::MRG32K3A);
+
+  NS_TEST_ASSERT_MSG_LT (sum, maxStatistic, "Chi-squared statistic out of range");
+}
+
 class RngTestSuite : public TestSuite
 {
 public:
@@ -431,6 +511,7 @@ RngTestSuite::RngTestSuite ()
   AddTestCase (new RngNormalTestCase, TestCase::QUICK);
   AddTestCase (new RngExponentialTestCase, TestCase::QUICK);
   AddTestCase (new RngParetoTestCase, TestCase::QUICK);
+  AddTestCase (new RngPhiloxTestCase, TestCase::QUICK);
 }
 
 static RngTestSuite rngTestSuite;
@@ -158,6 +158,62 @@ TimeWithSignTestCase::DoTeardown (void)
 }
 
 
+/**
+ * Checks the integer arithmetic of the conversions and operators.
+ */
+class TimeIntegerArithmeticTestCase : public TestCase
+{
+public:
+  TimeIntegerArithmeticTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+TimeIntegerArithmeticTestCase::TimeIntegerArithmeticTestCase ()
+  : TestCase ("Checks the integer arithmetic of Times")
+{
+}
+
+void
+TimeIntegerArithmeticTestCase::DoRun (void)
+{
+  // the integer conversions agree with int64x64_t
+  double values[] = { 0, 1, -3, 2.5, -0.25, 1e6, 123456789 };
+  for (uint32_t i = 0; i < sizeof (values) / sizeof (values[0]); i++)
+    {
+      Time expected = Time (int64x64_t (values[i]) * int64x64_t (1000000000));
+      NS_TEST_EXPECT_MSG_EQ (Seconds (values[i]), expected,
+                             "Bad conversion of " << values[i] << "s");
+      NS_TEST_EXPECT_MSG_EQ (Seconds (int64x64_t (values[i])), expected,
+                             "Bad conversion of int64x64_t " << values[i] << "s");
+    }
+  NS_TEST_EXPECT_MSG_EQ (Minutes (int64x64_t (-7)), Seconds (-420),
+                         "Bad conversion of minutes");
+
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (10) * int64x64_t (3), NanoSeconds (30), "Bad product");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (10) * int64x64_t (1.5), NanoSeconds (15), "Bad fractional product");
+  // the quotients are rounded down, as with int64x64_t
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (7) / int64x64_t (2), NanoSeconds (3), "Bad quotient");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (-7) / int64x64_t (2), NanoSeconds (-4), "Bad negative quotient");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (7) / int64x64_t (-2), NanoSeconds (-4), "Bad negative quotient");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (-7) / int64x64_t (-2), NanoSeconds (3), "Bad quotient");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (-8) / int64x64_t (2), NanoSeconds (-4), "Bad exact quotient");
+
+  NS_TEST_EXPECT_MSG_EQ (Time::FromRatio (8000, 5000000, Time::S), NanoSeconds (1600000),
+                         "Bad exact ratio");
+  NS_TEST_EXPECT_MSG_EQ (Time::FromRatio (1, 3, Time::S), NanoSeconds (333333333),
+                         "Bad ratio");
+  NS_TEST_EXPECT_MSG_EQ (Time::FromRatio (10, 3, Time::MS), NanoSeconds (3333333),
+                         "Bad ratio in ms");
+  NS_TEST_EXPECT_MSG_EQ (Time::FromRatio (7000, 2, Time::PS), NanoSeconds (3),
+                         "Bad ratio in a finer unit");
+  // the remainder times the factor overflows
+  NS_TEST_EXPECT_MSG_EQ (Time::FromRatio (50000000001ULL, 100000000000ULL, Time::S),
+                         NanoSeconds (500000000), "Bad ratio of large values");
+  NS_TEST_EXPECT_MSG_EQ (Time::FromRatio (99999999999ULL, 100000000000ULL, Time::S),
+                         NanoSeconds (999999999), "Bad ratio of large values");
+}
+
 class TimeInputOutputTestCase : public TestCase
 {
 public:
@@ -237,6 +293,7 @@ public:
     : TestSuite ("time", UNIT)
   {
     AddTestCase (new TimeWithSignTestCase (), TestCase::QUICK);
+    AddTestCase (new TimeIntegerArithmeticTestCase (), TestCase::QUICK);
     AddTestCase (new TimeInputOutputTestCase (), TestCase::QUICK);
     // This should be last, since it changes the resolution
     AddTestCase (new TimeSimpleTestCase (), TestCase::QUICK);
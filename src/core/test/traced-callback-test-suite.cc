@@ -19,6 +19,7 @@
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
 #include "ns3/unused.h"
+#include <string>
 
 using namespace ns3;
 
@@ -113,6 +114,99 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ChainTracedCallbackTestCase : public TestCase
+{
+public:
+  ChainTracedCallbackTestCase ();
+  virtual ~ChainTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint8_t a);
+  void CbTwo (uint8_t a);
+  void CbThree (uint8_t a);
+  void CbConnect (uint8_t a);
+
+  std::string m_calls;
+  TracedCallback<uint8_t> m_trace;
+};
+
+ChainTracedCallbackTestCase::ChainTracedCallbackTestCase ()
+  : TestCase ("Check the order and emptiness of the TracedCallback chain")
+{
+}
+
+void
+ChainTracedCallbackTestCase::CbOne (uint8_t a)
+{
+  NS_UNUSED (a);
+  m_calls += "1";
+}
+
+void
+ChainTracedCallbackTestCase::CbTwo (uint8_t a)
+{
+  NS_UNUSED (a);
+  m_calls += "2";
+}
+
+void
+ChainTracedCallbackTestCase::CbThree (uint8_t a)
+{
+  NS_UNUSED (a);
+  m_calls += "3";
+}
+
+void
+ChainTracedCallbackTestCase::CbConnect (uint8_t a)
+{
+  NS_UNUSED (a);
+  m_calls += "c";
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbThree, this));
+    }
+}
+
+void
+ChainTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback not empty");
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "", "Callback unexpectedly called");
+
+  //
+  // The callbacks are called in the order they were connected.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback empty after a connection");
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbThree, this));
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "123", "Callbacks not called in order");
+
+  //
+  // Disconnecting the first callback keeps the order of the others.
+  //
+  m_calls = "";
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "23", "Callbacks not called in order after a disconnection");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbTwo, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbThree, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "TracedCallback not empty after the disconnections");
+
+  //
+  // A callback can connect others while it is called; they are called too.
+  //
+  m_calls = "";
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbConnect, this));
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "c3333333333", "Callbacks connected by a callback not called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +217,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChainTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -325,6 +325,111 @@ DeprecatedAttributeTestCase::DoRun (void)
        << endl;
 }
 
+
+//----------------------------
+//
+// Inherited Attribute test
+
+class InheritedAttribute : public DeprecatedAttribute
+{
+private:
+  int m_attr;
+  TracedValue<double> m_trace;
+
+public:
+  InheritedAttribute () : m_attr (0) { NS_UNUSED (m_attr); };
+  virtual ~InheritedAttribute () { };
+
+  // Register a type with Attributes and TraceSources of its own
+  // and inherited from its parents
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("InheritedAttribute")
+      .SetParent<DeprecatedAttribute> ()
+      .AddAttribute ("derivedAttribute",
+                     "the Attribute of the derived type",
+                     IntegerValue (2),
+                     MakeIntegerAccessor (&InheritedAttribute::m_attr),
+                     MakeIntegerChecker<int> ())
+      .AddTraceSource ("derivedTrace",
+                       "the TraceSource of the derived type",
+                       MakeTraceSourceAccessor (&InheritedAttribute::m_trace),
+                       "ns3::TracedValueCallback::Double");
+    return tid;
+  }
+
+};
+
+
+class InheritedAttributeTestCase : public TestCase
+{
+public:
+  InheritedAttributeTestCase ();
+  virtual ~InheritedAttributeTestCase ();
+private:
+  virtual void DoRun (void);
+
+};
+
+InheritedAttributeTestCase::InheritedAttributeTestCase ()
+  : TestCase ("Check the lookups of inherited Attributes and TraceSources")
+{
+}
+
+InheritedAttributeTestCase::~InheritedAttributeTestCase ()
+{
+}
+
+void
+InheritedAttributeTestCase::DoRun (void)
+{
+  TypeId tid = InheritedAttribute::GetTypeId ();
+
+  struct TypeId::AttributeInformation ainfo;
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("derivedAttribute", &ainfo), true,
+                         "lookup attribute of the derived type");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.help, "the Attribute of the derived type",
+                         "wrong attribute of the derived type");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.originalInitialValue->SerializeToString (ainfo.checker), "2",
+                         "wrong initial value of the attribute of the derived type");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("attribute", &ainfo), true,
+                         "lookup attribute of the parent");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.help, "the Attribute",
+                         "wrong attribute of the parent");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("noSuchAttribute", &ainfo), false,
+                         "lookup missing attribute");
+  NS_TEST_ASSERT_MSG_EQ (DeprecatedAttribute::GetTypeId ().LookupAttributeByName ("derivedAttribute", &ainfo), false,
+                         "the parent type should not see the attributes of the derived type");
+
+  struct TypeId::TraceSourceInformation tinfo;
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("derivedTrace", &tinfo), 0,
+                         "lookup trace source of the derived type");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.help, "the TraceSource of the derived type",
+                         "wrong trace source of the derived type");
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("trace", &tinfo), 0,
+                         "lookup trace source of the parent");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.help, "the TraceSource",
+                         "wrong trace source of the parent");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName ("noSuchTrace", &tinfo), 0,
+                         "lookup missing trace source");
+
+  // the indexes of the derived types follow the registrations in
+  // the parents after a first lookup
+  TypeId parent = TypeId ("InheritedAttributeParent")
+    .SetParent<Object> ();
+  TypeId child = TypeId ("InheritedAttributeChild")
+    .SetParent (parent);
+  NS_TEST_ASSERT_MSG_EQ (child.LookupAttributeByName ("lateAttribute", &ainfo), false,
+                         "lookup attribute before its registration");
+  parent.AddAttribute ("lateAttribute",
+                       "an attribute registered after a lookup",
+                       EmptyAttributeValue (),
+                       MakeEmptyAttributeAccessor (),
+                       MakeEmptyAttributeChecker ());
+  NS_TEST_ASSERT_MSG_EQ (child.LookupAttributeByName ("lateAttribute", &ainfo), true,
+                         "lookup attribute after its registration");
+}
+
   
 //----------------------------
 //
@@ -383,6 +488,39 @@ LookupTimeTestCase::DoRun (void)
   }
   stop = clock ();
   Report ("hash", stop - start);
+
+  uint32_t nattrs = 0;
+  start = clock ();
+  for (uint32_t j = 0; j < REPETITIONS / 100; ++j)
+    {
+      for (uint16_t i = 0; i < nids; ++i)
+        {
+          const TypeId tid = TypeId::GetRegistered (i);
+          for (TypeId cur = tid; ; cur = cur.GetParent ())
+            {
+              for (std::size_t k = 0; k < cur.GetAttributeN (); ++k)
+                {
+                  struct TypeId::AttributeInformation info = cur.GetAttribute (k);
+                  if (info.supportLevel != TypeId::SUPPORTED)
+                    {
+                      continue;
+                    }
+                  tid.LookupAttributeByName (info.name, &info);
+                  ++nattrs;
+                }
+              if (cur.GetParent () == cur)
+                {
+                  break;
+                }
+            }
+        }
+    }
+  stop = clock ();
+  cout << suite << "Lookup time: by attribute name: "
+       << "ticks: " << stop - start
+       << "\tper: " << 1E6 * double (stop - start) / (nattrs * double (CLOCKS_PER_SEC))
+       << " microsec/lookup"
+       << endl;
   
 }
 
@@ -437,6 +575,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new InheritedAttributeTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
@@ -24,6 +24,7 @@
 #include "ns3/object-factory.h"
 #include "ns3/queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
 #include "ns3/csma-net-device.h"
 #include "ns3/csma-channel.h"
 #include "ns3/config.h"
@@ -40,6 +41,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("CsmaHelper");
 
 CsmaHelper::CsmaHelper ()
+  : m_nTxQueues (1)
 {
   m_queueFactory.SetTypeId ("ns3::DropTailQueue<Packet>");
   m_deviceFactory.SetTypeId ("ns3::CsmaNetDevice");
@@ -74,6 +76,13 @@ CsmaHelper::SetChannelAttribute (std::string n1, const AttributeValue &v1)
   m_channelFactory.Set (n1, v1);
 }
 
+void
+CsmaHelper::SetNTxQueues (std::size_t nTxQueues)
+{
+  NS_ASSERT_MSG (nTxQueues > 0, "A device needs a transmission queue");
+  m_nTxQueues = nTxQueues;
+}
+
 void 
 CsmaHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -102,7 +111,7 @@ CsmaHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool prom
     }
 
   Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, 
-                                                     PcapHelper::DLT_EN10MB);
+                                                     PcapHelper::DLT_EN10MB, device);
   if (promiscuous)
     {
       pcapHelper.HookDefaultSink<CsmaNetDevice> (device, "PromiscSniffer", file);
@@ -307,12 +316,29 @@ CsmaHelper::InstallPriv (Ptr<Node> node, Ptr<CsmaChannel> channel) const
   Ptr<CsmaNetDevice> device = m_deviceFactory.Create<CsmaNetDevice> ();
   device->SetAddress (Mac48Address::Allocate ());
   node->AddDevice (device);
-  Ptr<Queue<Packet> > queue = m_queueFactory.Create<Queue<Packet> > ();
-  device->SetQueue (queue);
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObjectWithAttributes<NetDeviceQueueInterface> ("NTxQueues",
+                                                                                           UintegerValue (m_nTxQueues));
+  for (std::size_t i = 0; i < m_nTxQueues; i++)
+    {
+      Ptr<Queue<Packet> > queue = m_queueFactory.Create<Queue<Packet> > ();
+      if (i == 0)
+        {
+          device->SetQueue (queue);
+        }
+      else
+        {
+          device->AddQueue (queue);
+        }
+      ndqi->GetTxQueue (i)->ConnectQueueTraces (queue);
+    }
   device->Attach (channel);
   // Aggregate a NetDeviceQueueInterface object
-  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
-  ndqi->GetTxQueue (0)->ConnectQueueTraces (queue);
+  if (m_nTxQueues > 1)
+    {
+      // the ndqi is aggregated to the device, hence it does not outlive it
+      CsmaNetDevice *dev = PeekPointer (device);
+      ndqi->SetSelectQueueCallback ([dev] (Ptr<QueueItem> item) { return dev->SelectQueue (item); });
+    }
   device->AggregateObject (ndqi);
 
   return device;
@@ -90,6 +90,19 @@ public:
    */
   void SetChannelAttribute (std::string n1, const AttributeValue &v1);
 
+  /**
+   * \param nTxQueues the number of transmission queues
+   *
+   * Set the number of transmission queues of each ns3::CsmaNetDevice
+   * created by CsmaHelper::Install. The devices get this number of queues,
+   * of the type set by SetQueue, and spread the flows over them by hashing
+   * (see CsmaNetDevice::AddQueue). The NetDeviceQueueInterface aggregated
+   * to the devices has as many transmission queues, so that the traffic
+   * control layer installs a multi-queue root queue disc with a child queue
+   * disc per queue.
+   */
+  void SetNTxQueues (std::size_t nTxQueues);
+
   /**
    * This method creates an ns3::CsmaChannel with the attributes configured by
    * CsmaHelper::SetChannelAttribute, an ns3::CsmaNetDevice with the attributes
@@ -250,6 +263,7 @@ private:
   ObjectFactory m_queueFactory;   //!< factory for the queues
   ObjectFactory m_deviceFactory;  //!< factory for the NetDevices
   ObjectFactory m_channelFactory; //!< factory for the channel
+  std::size_t m_nTxQueues;        //!< number of transmission queues of the NetDevices
 };
 
 } // namespace ns3
@@ -30,6 +30,8 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/queue-item.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
 
@@ -87,6 +89,15 @@ CsmaNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&CsmaNetDevice::m_queue),
                    MakePointerChecker<Queue<Packet> > ())
+    .AddAttribute ("FlowHashPerturbation",
+                   "The salt of the flow hash selecting the transmission queue "
+                   "of a packet, when the device has several transmission queues. "
+                   "It should differ from the perturbation of the queue discs "
+                   "hashing the flows, so that the flows of a transmission queue "
+                   "are spread over all their buckets.",
+                   UintegerValue (0x9e3779b9),
+                   MakeUintegerAccessor (&CsmaNetDevice::m_flowHashPerturbation),
+                   MakeUintegerChecker<uint32_t> ())
 
     //
     // Trace sources at the "top" of the net device, where packets transition
@@ -184,7 +195,8 @@ CsmaNetDevice::GetTypeId (void)
 }
 
 CsmaNetDevice::CsmaNetDevice ()
-  : m_linkUp (false)
+  : m_nextQueue (0),
+    m_linkUp (false)
 {
   NS_LOG_FUNCTION (this);
   m_txMachineState = READY;
@@ -218,6 +230,7 @@ CsmaNetDevice::DoDispose ()
   m_channel = 0;
   m_node = 0;
   m_queue = 0;
+  m_queues.clear ();
   NetDevice::DoDispose ();
 }
 
@@ -559,14 +572,13 @@ CsmaNetDevice::TransmitAbort (void)
   // get that out.  If the queue is empty we just wait until someone puts one
   // in.
   //
-  if (m_queue->IsEmpty ())
+  Ptr<Packet> packet = DequeueTxPacket ();
+  if (packet == 0)
     {
       return;
     }
   else
     {
-      Ptr<Packet> packet = m_queue->Dequeue ();
-      NS_ASSERT_MSG (packet != 0, "CsmaNetDevice::TransmitAbort(): IsEmpty false but no Packet on queue?");
       m_currentPkt = packet;
       m_snifferTrace (m_currentPkt);
       m_promiscSnifferTrace (m_currentPkt);
@@ -628,14 +640,13 @@ CsmaNetDevice::TransmitReadyEvent (void)
   //
   // Get the next packet from the queue for transmitting
   //
-  if (m_queue->IsEmpty ())
+  Ptr<Packet> packet = DequeueTxPacket ();
+  if (packet == 0)
     {
       return;
     }
   else
     {
-      Ptr<Packet> packet = m_queue->Dequeue ();
-      NS_ASSERT_MSG (packet != 0, "CsmaNetDevice::TransmitReadyEvent(): IsEmpty false but no Packet on queue?");
       m_currentPkt = packet;
       m_snifferTrace (m_currentPkt);
       m_promiscSnifferTrace (m_currentPkt);
@@ -643,6 +654,28 @@ CsmaNetDevice::TransmitReadyEvent (void)
     }
 }
 
+Ptr<Packet>
+CsmaNetDevice::DequeueTxPacket (void)
+{
+  if (m_queues.empty ())
+    {
+      return m_queue->Dequeue ();
+    }
+
+  std::size_t nQueues = m_queues.size () + 1;
+  for (std::size_t k = 0; k < nQueues; k++)
+    {
+      std::size_t i = (m_nextQueue + k) % nQueues;
+      Ptr<Queue<Packet> > queue = (i == 0 ? m_queue : m_queues[i - 1]);
+      if (!queue->IsEmpty ())
+        {
+          m_nextQueue = (i + 1) % nQueues;
+          return queue->Dequeue ();
+        }
+    }
+  return 0;
+}
+
 bool
 CsmaNetDevice::Attach (Ptr<CsmaChannel> ch)
 {
@@ -827,6 +860,40 @@ CsmaNetDevice::GetQueue (void) const
   return m_queue;
 }
 
+std::size_t
+CsmaNetDevice::AddQueue (Ptr<Queue<Packet> > q)
+{
+  NS_LOG_FUNCTION (q);
+  NS_ASSERT_MSG (m_queue != 0, "The first transmission queue is set by SetQueue");
+  m_queues.push_back (q);
+  return m_queues.size ();
+}
+
+std::size_t
+CsmaNetDevice::GetNQueues (void) const
+{
+  return m_queues.size () + 1;
+}
+
+Ptr<Queue<Packet> >
+CsmaNetDevice::GetQueue (std::size_t i) const
+{
+  NS_ASSERT_MSG (i <= m_queues.size (), "Invalid transmission queue " << i);
+  return (i == 0 ? m_queue : m_queues[i - 1]);
+}
+
+std::size_t
+CsmaNetDevice::SelectQueue (Ptr<QueueItem> item) const
+{
+  Ptr<QueueDiscItem> qdItem = DynamicCast<QueueDiscItem> (item);
+  if (m_queues.empty () || qdItem == 0)
+    {
+      return 0;
+    }
+  // same as the selection of the queue of the packet in SendFrom
+  return qdItem->Hash (m_flowHashPerturbation) % (m_queues.size () + 1);
+}
+
 void
 CsmaNetDevice::NotifyLinkUp (void)
 {
@@ -961,6 +1028,18 @@ CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address&
       return false;
     }
 
+  //
+  // With several transmission queues, select the queue of the packet by
+  // hashing its flow, before the network header is hidden.
+  //
+  Ptr<Queue<Packet> > queue = m_queue;
+  if (!m_queues.empty ())
+    {
+      uint32_t hash = NetDeviceQueueInterface::GetFlowHash (packet, protocolNumber, m_flowHashPerturbation);
+      std::size_t i = hash % (m_queues.size () + 1);
+      queue = (i == 0 ? m_queue : m_queues[i - 1]);
+    }
+
   Mac48Address destination = Mac48Address::ConvertFrom (dest);
   Mac48Address source = Mac48Address::ConvertFrom (src);
   AddHeader (packet, source, destination, protocolNumber);
@@ -971,7 +1050,7 @@ CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address&
   // Place the packet to be sent on the send queue.  Note that the 
   // queue may fire a drop trace, but we will too.
   //
-  if (m_queue->Enqueue (packet) == false)
+  if (queue->Enqueue (packet) == false)
     {
       m_macTxDropTrace (packet);
       return false;
@@ -984,10 +1063,9 @@ CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address&
   //
   if (m_txMachineState == READY) 
     {
-      if (m_queue->IsEmpty () == false)
+      packet = DequeueTxPacket ();
+      if (packet != 0)
         {
-          Ptr<Packet> packet = m_queue->Dequeue ();
-          NS_ASSERT_MSG (packet != 0, "CsmaNetDevice::SendFrom(): IsEmpty false but no Packet on queue?");
           m_currentPkt = packet;
           m_promiscSnifferTrace (m_currentPkt);
           m_snifferTrace (m_currentPkt);
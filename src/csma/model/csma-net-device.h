@@ -22,6 +22,7 @@
 #define CSMA_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/node.h"
 #include "ns3/backoff.h"
 #include "ns3/address.h"
@@ -37,6 +38,7 @@
 namespace ns3 {
 
 template <typename Item> class Queue;
+class QueueItem;
 class CsmaChannel;
 class ErrorModel;
 
@@ -143,6 +145,43 @@ public:
    */
   Ptr<Queue<Packet> > GetQueue (void) const;
 
+  /**
+   * Add a transmission queue to the CsmaNetDevice.
+   *
+   * The queue set by SetQueue is the first transmission queue. With several
+   * transmission queues, the device selects the queue of each packet by
+   * hashing its flow (see NetDeviceQueueInterface::GetFlowHash), as the
+   * receive side scaling of multi-queue network cards, and the packets of
+   * the queues are transmitted in round robin.
+   *
+   * \param queue a Ptr to the queue.
+   * \return the index of the queue.
+   */
+  std::size_t AddQueue (Ptr<Queue<Packet> > queue);
+
+  /**
+   * \return the number of transmission queues.
+   */
+  std::size_t GetNQueues (void) const;
+
+  /**
+   * \param i the index of a transmission queue.
+   * \return a pointer to the queue.
+   */
+  Ptr<Queue<Packet> > GetQueue (std::size_t i) const;
+
+  /**
+   * Select the transmission queue of a queue disc item.
+   *
+   * This method returns the queue in which the device enqueues the packet
+   * built from the item, and is meant to be the select queue callback of the
+   * NetDeviceQueueInterface aggregated to the device.
+   *
+   * \param item the item.
+   * \return the index of the transmission queue.
+   */
+  std::size_t SelectQueue (Ptr<QueueItem> item) const;
+
   /**
    * Attach a receive ErrorModel to the CsmaNetDevice.
    *
@@ -433,6 +472,13 @@ private:
    */
   void TransmitReadyEvent (void);
 
+  /**
+   * Dequeue a packet from the transmission queues, in round robin.
+   *
+   * \return the packet dequeued, or 0 if all the queues are empty
+   */
+  Ptr<Packet> DequeueTxPacket (void);
+
   /**
    * Aborts the transmission of the current packet
    *
@@ -532,6 +578,21 @@ private:
    */
   Ptr<Queue<Packet> > m_queue;
 
+  /**
+   * The additional transmission queues, after m_queue.
+   */
+  std::vector<Ptr<Queue<Packet> > > m_queues;
+
+  /**
+   * The next transmission queue served.
+   */
+  std::size_t m_nextQueue;
+
+  /**
+   * The salt of the flow hash selecting the transmission queue of a packet.
+   */
+  uint32_t m_flowHashPerturbation;
+
   /**
    * Error model for receive packet events.  When active this model will be
    * used to model transmission errors by marking some of the packets 
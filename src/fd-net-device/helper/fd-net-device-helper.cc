@@ -76,7 +76,7 @@ FdNetDeviceHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
       filename = pcapHelper.GetFilenameFromDevice (prefix, device);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_EN10MB);
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_EN10MB, device);
   if (promiscuous)
     {
       pcapHelper.HookDefaultSink<FdNetDevice> (device, "PromiscSniffer", file);
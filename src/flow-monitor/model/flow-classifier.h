@@ -71,6 +71,12 @@ public:
   /// \param indent number of spaces to use as base indentation level
   virtual void SerializeToXmlStream (std::ostream &os, uint16_t indent) const = 0;
 
+  /// Forgets a flow, e.g., because it is finished: its identifier is
+  /// not returned again, and a later packet matching the flow starts
+  /// a new flow.  The default implementation does nothing.
+  /// \param flowId the FlowId of the flow
+  virtual void RemoveFlow (FlowId flowId);
+
 protected:
   /// Returns a new, unique Flow Identifier
   /// \returns a new FlowId
@@ -22,6 +22,11 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/abort.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -69,6 +74,46 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("SamplingMode", ("How the packets monitored are sampled: all of them, one in SamplingRate "
+                                    "packets (chosen by their flow and packet ids, so that all the probes agree), "
+                                    "or all the packets of one in SamplingRate flows (chosen by their flow id)."),
+                   EnumValue (FlowMonitor::SAMPLE_ALL),
+                   MakeEnumAccessor (&FlowMonitor::m_samplingMode),
+                   MakeEnumChecker (FlowMonitor::SAMPLE_ALL, "All",
+                                    FlowMonitor::SAMPLE_PACKETS, "Packets",
+                                    FlowMonitor::SAMPLE_FLOWS, "Flows"))
+    .AddAttribute ("SamplingRate", ("The inverse of the probability that a packet or flow is sampled."),
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FlowMonitor::m_samplingRate),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("EnableSketches", ("Replace the per-flow statistics by fixed-size sketches: a count-min sketch "
+                                      "of the bytes sent per flow, which gives the heaviest flows, and a DDSketch "
+                                      "of the delays, which gives their quantiles."),
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FlowMonitor::m_sketchesEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SketchWidth", ("The number of counters per row of the count-min sketch."),
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&FlowMonitor::m_sketchWidth),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SketchDepth", ("The number of rows of the count-min sketch."),
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&FlowMonitor::m_sketchDepth),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("HeavyHitters", ("The number of heaviest flows reported with the sketches."),
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&FlowMonitor::m_nHeavyHitters),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DelaySketchAccuracy", ("The relative accuracy of the delay quantiles of the sketches."),
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&FlowMonitor::m_delaySketchAccuracy),
+                   MakeDoubleChecker <double> (0.0001, 0.5))
+    .AddAttribute ("FlowIdleTimeout", ("With the periodic export, the time after which a flow without packets "
+                                       "sent or received, nor packets in flight, is finished: its last changes "
+                                       "are exported and it is removed from the statistics."),
+                   TimeValue (Seconds (30.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_flowIdleTimeout),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -80,9 +125,16 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_enabled (false),
+    m_exportFormat (EXPORT_CSV)
 {
   NS_LOG_FUNCTION (this);
+  m_sketchTotals.txBytes = 0;
+  m_sketchTotals.rxBytes = 0;
+  m_sketchTotals.txPackets = 0;
+  m_sketchTotals.rxPackets = 0;
+  m_sketchTotals.lostPackets = 0;
+  m_sketchTotals.timesForwarded = 0;
 }
 
 void
@@ -91,6 +143,11 @@ FlowMonitor::DoDispose (void)
   NS_LOG_FUNCTION (this);
   Simulator::Cancel (m_startEvent);
   Simulator::Cancel (m_stopEvent);
+  Simulator::Cancel (m_exportEvent);
+  if (m_exportFile.is_open ())
+    {
+      m_exportFile.close ();
+    }
   for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
       iter != m_classifiers.end ();
       iter ++)
@@ -109,11 +166,18 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
   NS_LOG_FUNCTION (this);
-  FlowStatsContainerI iter;
-  iter = m_flowStats.find (flowId);
-  if (iter == m_flowStats.end ())
+  if (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0)
+    {
+      return *m_flowStatsIndex[flowId];
+    }
+  else
     {
       FlowMonitor::FlowStats &ref = m_flowStats[flowId];
+      if (flowId >= m_flowStatsIndex.size ())
+        {
+          m_flowStatsIndex.resize (flowId + 1, 0);
+        }
+      m_flowStatsIndex[flowId] = &ref;
       ref.delaySum = Seconds (0);
       ref.jitterSum = Seconds (0);
       ref.lastDelay = Seconds (0);
@@ -129,10 +193,6 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
       ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
       return ref;
     }
-  else
-    {
-      return iter->second;
-    }
 }
 
 
@@ -145,14 +205,26 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
+  if (!IsSampled (flowId, packetId))
+    {
+      return;
+    }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  TrackedPacket &tracked = m_trackedPackets[GetTrackedPacketKey (flowId, packetId)];
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
+  if (m_sketchesEnabled)
+    {
+      m_sketchTotals.txBytes += packetSize;
+      m_sketchTotals.txPackets++;
+      UpdateHeavyHitters (flowId, m_flowBytesSketch.Update (flowId, packetSize));
+      return;
+    }
+
   probe->AddPacketStats (flowId, packetSize, Seconds (0));
 
   FlowStats &stats = GetStatsForFlow (flowId);
@@ -175,8 +247,11 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
+  if (!IsSampled (flowId, packetId))
+    {
+      return;
+    }
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
@@ -186,6 +261,10 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 
   tracked->second.timesForwarded++;
   tracked->second.lastSeenTime = Simulator::Now ();
+  if (m_sketchesEnabled)
+    {
+      return;
+    }
 
   Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
@@ -201,7 +280,11 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  if (!IsSampled (flowId, packetId))
+    {
+      return;
+    }
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked == m_trackedPackets.end ())
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
@@ -211,6 +294,16 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
 
   Time now = Simulator::Now ();
   Time delay = (now - tracked->second.firstSeenTime);
+  if (m_sketchesEnabled)
+    {
+      m_sketchTotals.delaySum += delay;
+      m_sketchTotals.rxBytes += packetSize;
+      m_sketchTotals.rxPackets++;
+      m_sketchTotals.timesForwarded += tracked->second.timesForwarded;
+      m_delaySketch.AddValue (delay.GetSeconds ());
+      m_trackedPackets.erase (tracked);
+      return;
+    }
   probe->AddPacketStats (flowId, packetSize, delay);
 
   FlowStats &stats = GetStatsForFlow (flowId);
@@ -267,10 +360,17 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
       NS_LOG_DEBUG ("FlowMonitor not enabled; returning");
       return;
     }
+  if (!IsSampled (flowId, packetId))
+    {
+      return;
+    }
 
-  probe->AddPacketDropStats (flowId, packetSize, reasonCode);
+  if (!m_sketchesEnabled)
+    {
+      probe->AddPacketDropStats (flowId, packetSize, reasonCode);
+    }
 
-  FlowStats &stats = GetStatsForFlow (flowId);
+  FlowStats &stats = m_sketchesEnabled ? m_sketchTotals : GetStatsForFlow (flowId);
   stats.lostPackets++;
   if (stats.packetsDropped.size () < reasonCode + 1)
     {
@@ -281,7 +381,7 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  TrackedPacketMap::iterator tracked = m_trackedPackets.find (GetTrackedPacketKey (flowId, packetId));
   if (tracked != m_trackedPackets.end ())
     {
       // we don't need to track this packet anymore
@@ -311,12 +411,19 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
       if (now - iter->second.lastSeenTime >= maxDelay)
         {
           // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+          FlowId flowId = iter->first >> 32;
+          if (m_sketchesEnabled)
+            {
+              m_sketchTotals.lostPackets++;
+            }
+          else
+            {
+              NS_ASSERT (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0);
+              m_flowStatsIndex[flowId]->lostPackets++;
+            }
 
           // we won't track it anymore
-          m_trackedPackets.erase (iter++);
+          iter = m_trackedPackets.erase (iter);
         }
       else
         {
@@ -358,6 +465,94 @@ FlowMonitor::GetAllProbes () const
   return m_flowProbes;
 }
 
+bool
+FlowMonitor::IsSampled (FlowId flowId, FlowPacketId packetId) const
+{
+  if (m_samplingRate <= 1)
+    {
+      return true;
+    }
+  uint64_t key;
+  switch (m_samplingMode)
+    {
+    case SAMPLE_PACKETS:
+      key = GetTrackedPacketKey (flowId, packetId);
+      break;
+    case SAMPLE_FLOWS:
+      key = flowId;
+      break;
+    default:
+      return true;
+    }
+  // the decision only depends on the ids, so that all the probes agree
+  uint64_t h = (key + 1) * 0x9e3779b97f4a7c15ULL;
+  return ((h >> 32) % m_samplingRate) == 0;
+}
+
+void
+FlowMonitor::UpdateHeavyHitters (FlowId flowId, uint64_t bytes)
+{
+  std::vector<std::pair<FlowId, uint64_t> >::iterator lightest = m_heavyHitters.end ();
+  for (std::vector<std::pair<FlowId, uint64_t> >::iterator iter = m_heavyHitters.begin ();
+       iter != m_heavyHitters.end (); iter++)
+    {
+      if (iter->first == flowId)
+        {
+          iter->second = bytes;
+          return;
+        }
+      if (lightest == m_heavyHitters.end () || iter->second < lightest->second)
+        {
+          lightest = iter;
+        }
+    }
+  if (m_heavyHitters.size () < m_nHeavyHitters)
+    {
+      m_heavyHitters.push_back (std::make_pair (flowId, bytes));
+    }
+  else if (lightest != m_heavyHitters.end () && bytes > lightest->second)
+    {
+      *lightest = std::make_pair (flowId, bytes);
+    }
+}
+
+/**
+ * \param a a (FlowId, bytes) pair
+ * \param b a (FlowId, bytes) pair
+ * \return true if a is heavier than b (or as heavy, with a smaller FlowId)
+ */
+static bool
+IsHeavier (const std::pair<FlowId, uint64_t> &a, const std::pair<FlowId, uint64_t> &b)
+{
+  return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+
+std::vector<std::pair<FlowId, uint64_t> >
+FlowMonitor::GetHeavyHitters () const
+{
+  std::vector<std::pair<FlowId, uint64_t> > heavyHitters = m_heavyHitters;
+  std::sort (heavyHitters.begin (), heavyHitters.end (), IsHeavier);
+  return heavyHitters;
+}
+
+uint64_t
+FlowMonitor::EstimateFlowBytes (FlowId flowId) const
+{
+  return m_flowBytesSketch.Estimate (flowId);
+}
+
+const FlowMonitor::FlowStats&
+FlowMonitor::GetSketchTotals () const
+{
+  return m_sketchTotals;
+}
+
+const DdSketch&
+FlowMonitor::GetDelaySketch () const
+{
+  return m_delaySketch;
+}
+
 
 void
 FlowMonitor::Start (const Time &time)
@@ -393,6 +588,11 @@ FlowMonitor::StartRightNow ()
       return;
     }
   m_enabled = true;
+  if (m_sketchesEnabled && m_flowBytesSketch.GetDepth () == 0)
+    {
+      m_flowBytesSketch = CountMinSketch (m_sketchWidth, m_sketchDepth);
+      m_delaySketch = DdSketch (m_delaySketchAccuracy);
+    }
 }
 
 
@@ -407,6 +607,7 @@ FlowMonitor::StopRightNow ()
     }
   m_enabled = false;
   CheckForLostPackets ();
+  ExportNow ();
 }
 
 void
@@ -421,7 +622,13 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, uint16_t indent, bool enabl
   NS_LOG_FUNCTION (this << indent << enableHistograms << enableProbes);
   CheckForLostPackets ();
 
-  os << std::string ( indent, ' ' ) << "<FlowMonitor>\n";
+  os << std::string ( indent, ' ' ) << "<FlowMonitor";
+  if (m_samplingMode != SAMPLE_ALL && m_samplingRate > 1)
+    {
+      os << " samplingMode=\"" << (m_samplingMode == SAMPLE_PACKETS ? "Packets" : "Flows") << "\""
+         << " samplingRate=\"" << m_samplingRate << "\"";
+    }
+  os << ">\n";
   indent += 2;
   os << std::string ( indent, ' ' ) << "<FlowStats>\n";
   indent += 2;
@@ -476,6 +683,46 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, uint16_t indent, bool enabl
   indent -= 2;
   os << std::string ( indent, ' ' ) << "</FlowStats>\n";
 
+  if (m_sketchesEnabled)
+    {
+      os << std::string ( indent, ' ' );
+#define ATTRIB(name) << " " # name "=\"" << m_sketchTotals.name << "\""
+      os << "<FlowSketches"
+      ATTRIB (delaySum)
+      ATTRIB (txBytes)
+      ATTRIB (rxBytes)
+      ATTRIB (txPackets)
+      ATTRIB (rxPackets)
+      ATTRIB (lostPackets)
+      ATTRIB (timesForwarded)
+      << ">\n";
+#undef ATTRIB
+      indent += 2;
+      for (uint32_t reasonCode = 0; reasonCode < m_sketchTotals.packetsDropped.size (); reasonCode++)
+        {
+          os << std::string ( indent, ' ' );
+          os << "<packetsDropped reasonCode=\"" << reasonCode << "\""
+          << " number=\"" << m_sketchTotals.packetsDropped[reasonCode]
+          << "\" bytes=\"" << m_sketchTotals.bytesDropped[reasonCode]
+          << "\" />\n";
+        }
+      os << std::string ( indent, ' ' ) << "<HeavyHitters"
+         << " sketchWidth=\"" << m_flowBytesSketch.GetWidth () << "\""
+         << " sketchDepth=\"" << m_flowBytesSketch.GetDepth () << "\""
+         << ">\n";
+      std::vector<std::pair<FlowId, uint64_t> > heavyHitters = GetHeavyHitters ();
+      for (uint32_t i = 0; i < heavyHitters.size (); i++)
+        {
+          os << std::string ( indent + 2, ' ' )
+             << "<Flow flowId=\"" << heavyHitters[i].first << "\""
+             << " txBytes=\"" << heavyHitters[i].second << "\" />\n";
+        }
+      os << std::string ( indent, ' ' ) << "</HeavyHitters>\n";
+      m_delaySketch.SerializeToXmlStream (os, indent, "delaySketch");
+      indent -= 2;
+      os << std::string ( indent, ' ' ) << "</FlowSketches>\n";
+    }
+
   for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
       iter != m_classifiers.end ();
       iter ++)
@@ -521,5 +768,176 @@ FlowMonitor::SerializeToXmlFile (std::string fileName, bool enableHistograms, bo
 }
 
 
-} // namespace ns3
+void
+FlowMonitor::EnablePeriodicExport (std::string fileName, Time interval, ExportFormat format)
+{
+  NS_LOG_FUNCTION (this << fileName << interval.GetSeconds () << format);
+  NS_ABORT_MSG_UNLESS (interval.IsStrictlyPositive (), "Invalid export interval " << interval);
+  if (m_exportFile.is_open ())
+    {
+      ExportNow ();
+      m_exportFile.close ();
+    }
+  m_exported.clear ();
+  m_exportFile.open (fileName.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (m_exportFile.is_open (), "Unable to open " << fileName);
+  m_exportFormat = format;
+  m_exportInterval = interval;
+  if (m_exportFormat == EXPORT_BINARY)
+    {
+      uint32_t header[2] = { EXPORT_MAGIC, sizeof (ExportRecord) };
+      m_exportFile.write ((const char *)header, sizeof (header));
+    }
+  else
+    {
+      m_exportFile << "time,flowId,finished,txBytes,rxBytes,txPackets,rxPackets,lostPackets,"
+                   << "droppedPackets,droppedBytes,timesForwarded,delaySum,jitterSum\n";
+    }
+  Simulator::Cancel (m_exportEvent);
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+void
+FlowMonitor::PeriodicExport ()
+{
+  ExportNow ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+bool
+FlowMonitor::ExportFlow (FlowId flowId, const FlowStats &stats, bool finished)
+{
+  ExportRecord current;
+  current.time = Simulator::Now ().GetNanoSeconds ();
+  current.flowId = flowId;
+  current.flags = finished ? EXPORT_FINISHED : 0;
+  current.txBytes = stats.txBytes;
+  current.rxBytes = stats.rxBytes;
+  current.droppedBytes = 0;
+  current.delaySum = stats.delaySum.GetNanoSeconds ();
+  current.jitterSum = stats.jitterSum.GetNanoSeconds ();
+  current.txPackets = stats.txPackets;
+  current.rxPackets = stats.rxPackets;
+  current.lostPackets = stats.lostPackets;
+  current.droppedPackets = 0;
+  current.timesForwarded = stats.timesForwarded;
+  current.reserved = 0;
+  for (uint32_t reasonCode = 0; reasonCode < stats.packetsDropped.size (); reasonCode++)
+    {
+      current.droppedPackets += stats.packetsDropped[reasonCode];
+      current.droppedBytes += stats.bytesDropped[reasonCode];
+    }
+
+  ExportRecord delta = current;
+  std::unordered_map<FlowId, ExportRecord>::iterator previous = m_exported.find (flowId);
+  if (previous != m_exported.end ())
+    {
+      const ExportRecord &p = previous->second;
+      delta.txBytes -= p.txBytes;
+      delta.rxBytes -= p.rxBytes;
+      delta.droppedBytes -= p.droppedBytes;
+      delta.delaySum -= p.delaySum;
+      delta.jitterSum -= p.jitterSum;
+      delta.txPackets -= p.txPackets;
+      delta.rxPackets -= p.rxPackets;
+      delta.lostPackets -= p.lostPackets;
+      delta.droppedPackets -= p.droppedPackets;
+      delta.timesForwarded -= p.timesForwarded;
+    }
+  if (finished)
+    {
+      if (previous != m_exported.end ())
+        {
+          m_exported.erase (previous);
+        }
+    }
+  else if (delta.txPackets == 0 && delta.rxPackets == 0 && delta.lostPackets == 0
+           && delta.droppedPackets == 0)
+    {
+      // nothing changed since the previous record
+      return false;
+    }
+  else
+    {
+      m_exported[flowId] = current;
+    }
 
+  if (m_exportFormat == EXPORT_BINARY)
+    {
+      m_exportFile.write ((const char *)&delta, sizeof (delta));
+    }
+  else
+    {
+      m_exportFile << delta.time << ',' << delta.flowId << ',' << (finished ? 1 : 0)
+                   << ',' << delta.txBytes << ',' << delta.rxBytes
+                   << ',' << delta.txPackets << ',' << delta.rxPackets
+                   << ',' << delta.lostPackets << ',' << delta.droppedPackets
+                   << ',' << delta.droppedBytes << ',' << delta.timesForwarded
+                   << ',' << delta.delaySum << ',' << delta.jitterSum << '\n';
+    }
+  return true;
+}
+
+void
+FlowMonitor::ExportNow ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_exportFile.is_open ())
+    {
+      return;
+    }
+  CheckForLostPackets ();
+  Time now = Simulator::Now ();
+
+  if (m_sketchesEnabled)
+    {
+      ExportFlow (0, m_sketchTotals, false);
+    }
+
+  // a flow with packets in flight is not finished, however long ago it
+  // sent its last packet
+  std::vector<bool> inFlight (m_flowStatsIndex.size (), false);
+  for (TrackedPacketMap::const_iterator iter = m_trackedPackets.begin ();
+       iter != m_trackedPackets.end (); iter++)
+    {
+      FlowId flowId = iter->first >> 32;
+      if (flowId < inFlight.size ())
+        {
+          inFlight[flowId] = true;
+        }
+    }
+
+  uint32_t nFinished = 0;
+  for (FlowStatsContainerI flowI = m_flowStats.begin (); flowI != m_flowStats.end (); )
+    {
+      const FlowStats &stats = flowI->second;
+      Time lastSeen = std::max (stats.timeLastTxPacket, stats.timeLastRxPacket);
+      bool finished = !inFlight[flowI->first] && now - lastSeen >= m_flowIdleTimeout;
+      ExportFlow (flowI->first, stats, finished);
+      if (finished)
+        {
+          m_flowStatsIndex[flowI->first] = 0;
+          for (uint32_t i = 0; i < m_flowProbes.size (); i++)
+            {
+              m_flowProbes[i]->RemoveFlowStats (flowI->first);
+            }
+          for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
+               iter != m_classifiers.end (); iter++)
+            {
+              (*iter)->RemoveFlow (flowI->first);
+            }
+          m_flowStats.erase (flowI++);
+          nFinished++;
+        }
+      else
+        {
+          flowI++;
+        }
+    }
+  NS_LOG_DEBUG ("Exported at " << now.GetSeconds () << "s, " << nFinished << " flows finished, "
+                << m_flowStats.size () << " flows left");
+  m_exportFile.flush ();
+}
+
+
+} // namespace ns3
@@ -23,12 +23,15 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <fstream>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/flow-probe.h"
 #include "ns3/flow-classifier.h"
 #include "ns3/histogram.h"
+#include "ns3/flow-sketch.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
@@ -46,6 +49,14 @@ namespace ns3 {
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * For large studies, the packets monitored can be sampled (see the
+ * SamplingMode attribute), and the per-flow statistics can be replaced by
+ * fixed-size sketches (see the EnableSketches attribute), so that the
+ * memory and time spent monitoring do not depend on the number of flows.
+ *
+ * For long simulations, the statistics can also be exported periodically
+ * (see EnablePeriodicExport), the flows being dropped from memory once
+ * they are finished.
  */
 class FlowMonitor : public Object
 {
@@ -137,6 +148,50 @@ public:
     Histogram flowInterruptionsHistogram; //!< histogram of durations of flow interruptions
   };
 
+  /// How the packets monitored are sampled
+  enum SamplingMode
+  {
+    SAMPLE_ALL,      //!< All the packets are monitored
+    SAMPLE_PACKETS,  //!< One in SamplingRate packets, chosen by their flow and packet ids
+    SAMPLE_FLOWS     //!< All the packets of one in SamplingRate flows, chosen by their flow id
+  };
+
+  /// Format of the periodic export
+  enum ExportFormat
+  {
+    EXPORT_CSV,      //!< One line of comma-separated values per record
+    EXPORT_BINARY    //!< One fixed-size binary record (ExportRecord) per record
+  };
+
+  /**
+   * \brief A record of the binary periodic export
+   *
+   * The file starts with the magic EXPORT_MAGIC and the size of the
+   * records (two uint32_t), then holds the records, all in the byte order
+   * of the host that wrote them.  A record holds the changes of the
+   * statistics of a flow since the previous record of the flow.
+   */
+  struct ExportRecord
+  {
+    int64_t time;              //!< Time of the export, in nanoseconds
+    uint32_t flowId;           //!< Flow (0 for the totals, with the sketches)
+    uint32_t flags;            //!< EXPORT_FINISHED if the flow is finished
+    uint64_t txBytes;          //!< Bytes transmitted
+    uint64_t rxBytes;          //!< Bytes received
+    uint64_t droppedBytes;     //!< Bytes dropped, for all the reasons
+    int64_t delaySum;          //!< Sum of the delays, in nanoseconds
+    int64_t jitterSum;         //!< Sum of the jitters, in nanoseconds
+    uint32_t txPackets;        //!< Packets transmitted
+    uint32_t rxPackets;        //!< Packets received
+    uint32_t lostPackets;      //!< Packets lost
+    uint32_t droppedPackets;   //!< Packets dropped, for all the reasons
+    uint32_t timesForwarded;   //!< Times the packets received were forwarded
+    uint32_t reserved;         //!< Padding, zero
+  };
+
+  static const uint32_t EXPORT_MAGIC = 0x464d4e33;  /**< Magic of the binary export ("3NMF") */
+  static const uint32_t EXPORT_FINISHED = 1;        /**< Flag of the last record of a finished flow */
+
   // --- basic methods ---
   /**
    * \brief Get the type ID.
@@ -238,6 +293,25 @@ public:
   /// \returns a list of all the probes
   const FlowProbeContainer& GetAllProbes () const;
 
+  /// Get the statistics of all the flows together, which are the only
+  /// ones collected when the sketches are enabled
+  /// \returns the statistics (only the counters, delaySum and the drops are set)
+  const FlowStats& GetSketchTotals () const;
+
+  /// Get the heaviest flows, by bytes sent, when the sketches are enabled
+  /// \returns the (FlowId, estimated bytes) pairs, heaviest first
+  std::vector<std::pair<FlowId, uint64_t> > GetHeavyHitters () const;
+
+  /// Estimate the bytes sent by a flow, when the sketches are enabled
+  /// \param flowId the Flow identification
+  /// \returns the estimate, never below the bytes sent
+  uint64_t EstimateFlowBytes (FlowId flowId) const;
+
+  /// Get the sketch of the delays of the packets received, when the
+  /// sketches are enabled
+  /// \returns the delay sketch, in seconds
+  const DdSketch& GetDelaySketch () const;
+
   /// Serializes the results to an std::ostream in XML format
   /// \param os the output stream
   /// \param indent number of spaces to use as base indentation level
@@ -258,6 +332,25 @@ public:
   /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /// Export the statistics periodically to a file, as they are
+  /// collected.  Each export writes, for each flow whose statistics
+  /// changed, a record of the changes since its previous record; the
+  /// flows finished (see the FlowIdleTimeout attribute) are then
+  /// removed from the statistics of the monitor, of its probes and of
+  /// its classifiers (see FlowClassifier::RemoveFlow), so that the
+  /// memory used does not grow with the number of flows.  The finished
+  /// flows are therefore missing from the XML output, and can no
+  /// longer be looked up in the classifiers.
+  /// The file is flushed after each export.
+  /// \param fileName name or path of the output file that will be created
+  /// \param interval the time between two exports
+  /// \param format the format of the file
+  void EnablePeriodicExport (std::string fileName, Time interval, ExportFormat format = EXPORT_CSV);
+
+  /// Export the changes of the statistics right now, if the periodic
+  /// export is enabled; this is done when the monitoring stops
+  void ExportNow ();
+
 
 protected:
 
@@ -276,9 +369,12 @@ private:
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
+  /// FlowId --> FlowStats in m_flowStats (null if the flow is not known yet);
+  /// the flow ids being allocated sequentially, the flows are found by index
+  std::vector<FlowStats *> m_flowStatsIndex;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// (FlowId,PacketId) --> TrackedPacket, keyed by GetTrackedPacketKey
+  typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
@@ -300,8 +396,58 @@ private:
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// Get the key of a packet in the tracked packets
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the key of the packet
+  static uint64_t GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId)
+  {
+    return (static_cast<uint64_t> (flowId) << 32) | packetId;
+  }
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Periodic function to export the statistics
+  void PeriodicExport ();
+
+  /// Write an export record of the changes of the statistics of a flow
+  /// \param flowId the Flow identification (0 for the totals)
+  /// \param stats the statistics of the flow
+  /// \param finished true if the flow is finished
+  /// \returns false if the statistics did not change
+  bool ExportFlow (FlowId flowId, const FlowStats &stats, bool finished);
+
+  /// Check whether a packet is sampled
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns true if the packet is to be monitored
+  bool IsSampled (FlowId flowId, FlowPacketId packetId) const;
+
+  /// Update the heaviest flows
+  /// \param flowId the Flow identification
+  /// \param bytes the estimate of the bytes sent by the flow
+  void UpdateHeavyHitters (FlowId flowId, uint64_t bytes);
+
+  SamplingMode m_samplingMode;    //!< How the packets are sampled
+  uint32_t m_samplingRate;        //!< One in m_samplingRate packets or flows is sampled
+  bool m_sketchesEnabled;         //!< Sketches instead of per-flow statistics
+  uint32_t m_sketchWidth;         //!< Width of the count-min sketch
+  uint32_t m_sketchDepth;         //!< Depth of the count-min sketch
+  uint32_t m_nHeavyHitters;       //!< Number of heaviest flows reported
+  double m_delaySketchAccuracy;   //!< Relative accuracy of the delay sketch
+  FlowStats m_sketchTotals;       //!< Statistics of all the flows together
+  CountMinSketch m_flowBytesSketch;  //!< Bytes sent per flow
+  DdSketch m_delaySketch;         //!< Delays of the packets received
+  std::vector<std::pair<FlowId, uint64_t> > m_heavyHitters; //!< Heaviest flows (unsorted)
+
+  std::ofstream m_exportFile;     //!< Periodic export file
+  ExportFormat m_exportFormat;    //!< Format of the export file
+  Time m_exportInterval;          //!< Time between two exports
+  EventId m_exportEvent;          //!< Next periodic export
+  Time m_flowIdleTimeout;         //!< Idle time after which a flow is finished
+  /// FlowId --> statistics at the previous export of the flow
+  std::unordered_map<FlowId, ExportRecord> m_exported;
 };
 
 
@@ -53,10 +53,25 @@ FlowProbe::DoDispose (void)
   Object::DoDispose ();
 }
 
+FlowProbe::FlowStats&
+FlowProbe::GetStatsForFlow (FlowId flowId)
+{
+  if (flowId < m_statsIndex.size () && m_statsIndex[flowId] != 0)
+    {
+      return *m_statsIndex[flowId];
+    }
+  if (flowId >= m_statsIndex.size ())
+    {
+      m_statsIndex.resize (flowId + 1, 0);
+    }
+  m_statsIndex[flowId] = &m_stats[flowId];
+  return *m_statsIndex[flowId];
+}
+
 void
 FlowProbe::AddPacketStats (FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe)
 {
-  FlowStats &flow = m_stats[flowId];
+  FlowStats &flow = GetStatsForFlow (flowId);
   flow.delayFromFirstProbeSum += delayFromFirstProbe;
   flow.bytes += packetSize;
   ++flow.packets;
@@ -65,7 +80,7 @@ FlowProbe::AddPacketStats (FlowId flowId, uint32_t packetSize, Time delayFromFir
 void
 FlowProbe::AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reasonCode)
 {
-  FlowStats &flow = m_stats[flowId];
+  FlowStats &flow = GetStatsForFlow (flowId);
 
   if (flow.packetsDropped.size () < reasonCode + 1)
     {
@@ -75,6 +90,16 @@ FlowProbe::AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reas
   ++flow.packetsDropped[reasonCode];
   flow.bytesDropped[reasonCode] += packetSize;
 }
+
+void
+FlowProbe::RemoveFlowStats (FlowId flowId)
+{
+  if (flowId < m_statsIndex.size () && m_statsIndex[flowId] != 0)
+    {
+      m_stats.erase (flowId);
+      m_statsIndex[flowId] = 0;
+    }
+}
  
 FlowProbe::Stats
 FlowProbe::GetStats () const 
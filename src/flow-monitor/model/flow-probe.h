@@ -89,6 +89,9 @@ public:
   /// \param packetSize the packet size
   /// \param reasonCode reason code for the drop
   void AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reasonCode);
+  /// Remove the statistics of a flow, once it is finished
+  /// \param flowId the flow Identifier
+  void RemoveFlowStats (FlowId flowId);
 
   /// Get the partial flow statistics stored in this probe.  With this
   /// information you can, for example, find out what is the delay
@@ -106,6 +109,14 @@ protected:
   Ptr<FlowMonitor> m_flowMonitor; //!< the FlowMonitor instance
   Stats m_stats; //!< The flow stats
 
+private:
+  /// Get the stats of a flow, adding the flow if not known yet
+  /// \param flowId the flow Identifier
+  /// \returns the stats of the flow
+  FlowStats& GetStatsForFlow (FlowId flowId);
+
+  /// FlowId --> FlowStats in m_stats (null if the flow is not known yet)
+  std::vector<FlowStats *> m_statsIndex;
 };
 
 
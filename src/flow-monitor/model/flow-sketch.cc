@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cmath>
+#include <algorithm>
+
+#include "flow-sketch.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowSketch");
+
+CountMinSketch::CountMinSketch (uint32_t width, uint32_t depth)
+  : m_width (width),
+    m_depth (depth),
+    m_total (0),
+    m_counters (static_cast<std::size_t> (width) * depth, 0)
+{
+  NS_LOG_FUNCTION (this << width << depth);
+  NS_ASSERT_MSG (width > 0 && depth > 0, "Empty count-min sketch");
+}
+
+CountMinSketch::CountMinSketch ()
+  : m_width (0),
+    m_depth (0),
+    m_total (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+CountMinSketch::GetIndex (uint64_t key, uint32_t row) const
+{
+  // a 64-bit mix of the key, seeded differently for each row
+  uint64_t h = (key + 1) * 0x9e3779b97f4a7c15ULL + row * 0xc2b2ae3d27d4eb4fULL;
+  h ^= h >> 31;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 29;
+  return row * m_width + static_cast<uint32_t> (h % m_width);
+}
+
+uint64_t
+CountMinSketch::Update (uint64_t key, uint64_t count)
+{
+  NS_ASSERT_MSG (m_depth > 0, "Empty count-min sketch");
+  m_total += count;
+  uint64_t estimate = ~static_cast<uint64_t> (0);
+  for (uint32_t row = 0; row < m_depth; row++)
+    {
+      uint64_t &counter = m_counters[GetIndex (key, row)];
+      counter += count;
+      estimate = std::min (estimate, counter);
+    }
+  return estimate;
+}
+
+uint64_t
+CountMinSketch::Estimate (uint64_t key) const
+{
+  if (m_depth == 0)
+    {
+      return 0;
+    }
+  uint64_t estimate = ~static_cast<uint64_t> (0);
+  for (uint32_t row = 0; row < m_depth; row++)
+    {
+      estimate = std::min (estimate, m_counters[GetIndex (key, row)]);
+    }
+  return estimate;
+}
+
+uint64_t
+CountMinSketch::GetTotal (void) const
+{
+  return m_total;
+}
+
+uint32_t
+CountMinSketch::GetWidth (void) const
+{
+  return m_width;
+}
+
+uint32_t
+CountMinSketch::GetDepth (void) const
+{
+  return m_depth;
+}
+
+
+DdSketch::DdSketch (double relativeAccuracy, uint32_t maxBins)
+  : m_relativeAccuracy (relativeAccuracy),
+    m_logGamma (std::log ((1 + relativeAccuracy) / (1 - relativeAccuracy))),
+    // 1 ps when the values are seconds: smaller delays are counted as zero
+    m_minValue (1e-12),
+    m_maxBins (maxBins),
+    m_offset (0),
+    m_zeroCount (0),
+    m_count (0),
+    m_sum (0)
+{
+  NS_LOG_FUNCTION (this << relativeAccuracy << maxBins);
+  NS_ASSERT_MSG (relativeAccuracy > 0 && relativeAccuracy < 1, "Invalid relative accuracy " << relativeAccuracy);
+  NS_ASSERT_MSG (maxBins > 0, "DDSketch without bins");
+}
+
+DdSketch::DdSketch ()
+  : m_relativeAccuracy (0.01),
+    m_logGamma (std::log (1.01 / 0.99)),
+    m_minValue (1e-12),
+    m_maxBins (2048),
+    m_offset (0),
+    m_zeroCount (0),
+    m_count (0),
+    m_sum (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+int32_t
+DdSketch::GetBinIndex (double value) const
+{
+  return static_cast<int32_t> (std::ceil (std::log (value) / m_logGamma));
+}
+
+double
+DdSketch::GetBinValue (int32_t index) const
+{
+  // the bin holds the values in (gamma^(index-1), gamma^index]; this value
+  // is within the relative accuracy of all of them
+  double gamma = std::exp (m_logGamma);
+  return 2 * std::exp (index * m_logGamma) / (1 + gamma);
+}
+
+void
+DdSketch::AddValue (double value)
+{
+  m_count++;
+  if (value < m_minValue)
+    {
+      m_zeroCount++;
+      return;
+    }
+  m_sum += value;
+
+  int32_t index = GetBinIndex (value);
+  if (m_bins.empty ())
+    {
+      m_offset = index;
+      m_bins.push_back (1);
+      return;
+    }
+  if (index < m_offset)
+    {
+      // grow downwards, as long as there is room; the values below the
+      // lowest bin kept are counted in it
+      uint32_t grow = std::min<uint32_t> (m_offset - index, m_maxBins - std::min<uint32_t> (m_maxBins, m_bins.size ()));
+      m_bins.insert (m_bins.begin (), grow, 0);
+      m_offset -= grow;
+      index = std::max (index, m_offset);
+    }
+  else if (index >= m_offset + static_cast<int32_t> (m_bins.size ()))
+    {
+      m_bins.resize (index - m_offset + 1, 0);
+      if (m_bins.size () > m_maxBins)
+        {
+          // merge the lowest bins into the lowest bin kept
+          uint32_t merged = m_bins.size () - m_maxBins;
+          uint64_t count = 0;
+          for (uint32_t i = 0; i <= merged; i++)
+            {
+              count += m_bins[i];
+            }
+          m_bins.erase (m_bins.begin (), m_bins.begin () + merged);
+          m_bins[0] = count;
+          m_offset += merged;
+        }
+    }
+  m_bins[index - m_offset]++;
+}
+
+double
+DdSketch::GetQuantile (double quantile) const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  double rank = quantile * (m_count - 1);
+  if (rank < m_zeroCount)
+    {
+      return 0;
+    }
+  uint64_t cumulated = m_zeroCount;
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      cumulated += m_bins[i];
+      if (cumulated > rank)
+        {
+          return GetBinValue (m_offset + i);
+        }
+    }
+  return GetBinValue (m_offset + m_bins.size () - 1);
+}
+
+uint64_t
+DdSketch::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+DdSketch::GetSum (void) const
+{
+  return m_sum;
+}
+
+double
+DdSketch::GetRelativeAccuracy (void) const
+{
+  return m_relativeAccuracy;
+}
+
+void
+DdSketch::SerializeToXmlStream (std::ostream &os, uint16_t indent, std::string elementName) const
+{
+  os << std::string (indent, ' ') << "<" << elementName
+     << " relativeAccuracy=\"" << m_relativeAccuracy << "\""
+     << " count=\"" << m_count << "\""
+     << " sum=\"" << m_sum << "\""
+     << " zeroCount=\"" << m_zeroCount << "\""
+     << " nBins=\"" << m_bins.size () << "\""
+     << " >\n";
+  indent += 2;
+
+  const double quantiles[] = { 0.5, 0.9, 0.95, 0.99, 0.999 };
+  for (uint32_t i = 0; i < sizeof (quantiles) / sizeof (quantiles[0]); i++)
+    {
+      os << std::string (indent, ' ')
+         << "<quantile q=\"" << quantiles[i] << "\""
+         << " value=\"" << GetQuantile (quantiles[i]) << "\""
+         << " />\n";
+    }
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      if (m_bins[i])
+        {
+          os << std::string (indent, ' ')
+             << "<bin index=\"" << (m_offset + static_cast<int32_t> (i)) << "\""
+             << " value=\"" << GetBinValue (m_offset + i) << "\""
+             << " count=\"" << m_bins[i] << "\""
+             << " />\n";
+        }
+    }
+
+  indent -= 2;
+  os << std::string (indent, ' ') << "</" << elementName << ">\n";
+}
+
+} // namespace ns3
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef NS3_FLOW_SKETCH_H
+#define NS3_FLOW_SKETCH_H
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \brief Count-min sketch: approximate counters for a large set of keys in
+ * a fixed amount of memory.
+ *
+ * The sketch is a table of depth rows of width counters; a key is counted
+ * in one counter of each row, chosen by a hash function per row.  The
+ * estimate of a key is the smallest of its counters: it is never below the
+ * true count, and it exceeds it by at most e/width times the total count
+ * with probability 1 - exp(-depth).
+ */
+class CountMinSketch
+{
+public:
+  /**
+   * \brief Constructor
+   * \param width the number of counters per row
+   * \param depth the number of rows
+   */
+  CountMinSketch (uint32_t width, uint32_t depth);
+  CountMinSketch ();
+
+  /**
+   * \brief Add to the count of a key
+   * \param key the key
+   * \param count the amount added
+   * \return the new estimate of the count of the key
+   */
+  uint64_t Update (uint64_t key, uint64_t count);
+
+  /**
+   * \brief Estimate the count of a key
+   * \param key the key
+   * \return the estimate, never below the true count
+   */
+  uint64_t Estimate (uint64_t key) const;
+
+  /**
+   * \return the sum of the counts added
+   */
+  uint64_t GetTotal (void) const;
+
+  /**
+   * \return the number of counters per row
+   */
+  uint32_t GetWidth (void) const;
+
+  /**
+   * \return the number of rows
+   */
+  uint32_t GetDepth (void) const;
+
+private:
+  /**
+   * \brief Get the counter of a key in a row
+   * \param key the key
+   * \param row the row
+   * \return the index of the counter in m_counters
+   */
+  uint32_t GetIndex (uint64_t key, uint32_t row) const;
+
+  uint32_t m_width;                 //!< Counters per row
+  uint32_t m_depth;                 //!< Rows
+  uint64_t m_total;                 //!< Sum of the counts
+  std::vector<uint64_t> m_counters; //!< The rows, one after the other
+};
+
+/**
+ * \brief DDSketch: quantiles of a distribution of positive values with a
+ * bounded relative error, in a bounded amount of memory.
+ *
+ * The values are counted in bins whose bounds grow geometrically, by a
+ * factor gamma = (1 + alpha) / (1 - alpha) where alpha is the relative
+ * accuracy: every quantile is returned with a relative error of at most
+ * alpha.  Values too small to be binned (including zero) are counted
+ * apart.  When the number of bins exceeds the maximum, the lowest bins are
+ * merged, which only affects the accuracy of the lowest quantiles.
+ *
+ * See C. Masson, J. E. Rim and H. K. Lee, "DDSketch: a fast and
+ * fully-mergeable quantile sketch with relative-error guarantees",
+ * PVLDB 12(12), 2019.
+ */
+class DdSketch
+{
+public:
+  /**
+   * \brief Constructor
+   * \param relativeAccuracy the relative accuracy of the quantiles
+   * \param maxBins the maximum number of bins
+   */
+  DdSketch (double relativeAccuracy, uint32_t maxBins = 2048);
+  DdSketch ();
+
+  /**
+   * \brief Add a value to the sketch
+   * \param value the value (negative values are counted as zero)
+   */
+  void AddValue (double value);
+
+  /**
+   * \brief Get a quantile of the values added
+   * \param quantile the quantile, between 0 and 1
+   * \return the value of the quantile, 0 if the sketch is empty
+   */
+  double GetQuantile (double quantile) const;
+
+  /**
+   * \return the number of values added
+   */
+  uint64_t GetCount (void) const;
+
+  /**
+   * \return the sum of the values added
+   */
+  double GetSum (void) const;
+
+  /**
+   * \return the relative accuracy of the quantiles
+   */
+  double GetRelativeAccuracy (void) const;
+
+  /**
+   * \brief Serializes the sketch and its main quantiles to an std::ostream
+   * in XML format.
+   * \param os the output stream
+   * \param indent number of spaces to use as base indentation level
+   * \param elementName name of the element to serialize.
+   */
+  void SerializeToXmlStream (std::ostream &os, uint16_t indent, std::string elementName) const;
+
+private:
+  /**
+   * \param value a value large enough to be binned
+   * \return the index of the bin of the value
+   */
+  int32_t GetBinIndex (double value) const;
+
+  /**
+   * \param index the index of a bin
+   * \return the value representing the bin
+   */
+  double GetBinValue (int32_t index) const;
+
+  double m_relativeAccuracy;     //!< Relative accuracy (alpha)
+  double m_logGamma;             //!< log (gamma)
+  double m_minValue;             //!< Smallest value binned
+  uint32_t m_maxBins;            //!< Maximum number of bins
+  std::vector<uint64_t> m_bins;  //!< Bin counts
+  int32_t m_offset;              //!< Index of the first bin of m_bins
+  uint64_t m_zeroCount;          //!< Number of values too small to be binned
+  uint64_t m_count;              //!< Number of values
+  double m_sum;                  //!< Sum of the values
+};
+
+} // namespace ns3
+
+#endif /* NS3_FLOW_SKETCH_H */
@@ -100,6 +100,29 @@ Ipv4FlowClassifier::Ipv4FlowClassifier ()
 {
 }
 
+size_t
+Ipv4FlowClassifier::FiveTupleHash::operator() (const FiveTuple &tuple) const
+{
+  uint64_t addresses = (static_cast<uint64_t> (tuple.sourceAddress.Get ()) << 32)
+    | tuple.destinationAddress.Get ();
+  uint64_t rest = (static_cast<uint64_t> (tuple.sourcePort) << 24)
+    | (static_cast<uint64_t> (tuple.destinationPort) << 8) | tuple.protocol;
+  uint64_t h = addresses * 0x9e3779b97f4a7c15ULL;
+  h = ((h ^ (h >> 29)) + rest) * 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+const Ipv4FlowClassifier::Flow&
+Ipv4FlowClassifier::GetFlow (FlowId flowId) const
+{
+  std::unordered_map<FlowId, Flow>::const_iterator iter = m_flows.find (flowId);
+  if (iter == m_flows.end ())
+    {
+      NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
+    }
+  return iter->second;
+}
+
 bool
 Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPayload,
                               uint32_t *out_flowId, uint32_t *out_packetId)
@@ -148,7 +171,7 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
+  std::pair<std::unordered_map<FiveTuple, FlowId, FiveTupleHash>::iterator, bool> insert
     = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
@@ -156,27 +179,22 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
     {
       FlowId newFlowId = GetNewFlowId ();
       insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
-      m_flowDscpMap[newFlowId];
+      Flow flow;
+      flow.tuple = tuple;
+      flow.lastPacketId = 0;
+      m_flows[newFlowId] = flow;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      m_flows[insert.first->second].lastPacketId++;
     }
 
   // increment the counter of packets with the same DSCP value
-  Ipv4Header::DscpType dscp = ipHeader.GetDscp ();
-  std::pair<std::map<Ipv4Header::DscpType, uint32_t>::iterator, bool> dscpInserter
-    = m_flowDscpMap[insert.first->second].insert (std::pair<Ipv4Header::DscpType, uint32_t> (dscp, 1));
-
-  // if the insertion did not succeed, we need to increment the counter
-  if (!dscpInserter.second)
-    {
-      m_flowDscpMap[insert.first->second][dscp] ++;
-    }
+  Flow &flow = m_flows[insert.first->second];
+  flow.dscpCounts[ipHeader.GetDscp ()]++;
 
   *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_packetId = flow.lastPacketId;
 
   return true;
 }
@@ -185,17 +203,7 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
-    {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
-    }
-  NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
-  FiveTuple retval = { Ipv4Address::GetZero (), Ipv4Address::GetZero (), 0, 0, 0 };
-  return retval;
+  return GetFlow (flowId).tuple;
 }
 
 bool
@@ -208,17 +216,21 @@ Ipv4FlowClassifier::SortByCount::operator() (std::pair<Ipv4Header::DscpType, uin
 std::vector<std::pair<Ipv4Header::DscpType, uint32_t> >
 Ipv4FlowClassifier::GetDscpCounts (FlowId flowId) const
 {
-  std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t> >::const_iterator flow
-    = m_flowDscpMap.find (flowId);
+  const Flow &flow = GetFlow (flowId);
+  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > v (flow.dscpCounts.begin (), flow.dscpCounts.end ());
+  std::sort (v.begin (), v.end (), SortByCount ());
+  return v;
+}
 
-  if (flow == m_flowDscpMap.end ())
+void
+Ipv4FlowClassifier::RemoveFlow (FlowId flowId)
+{
+  std::unordered_map<FlowId, Flow>::iterator iter = m_flows.find (flowId);
+  if (iter != m_flows.end ())
     {
-      NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
+      m_flowMap.erase (iter->second.tuple);
+      m_flows.erase (iter);
     }
-
-  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > v (flow->second.begin (), flow->second.end ());
-  std::sort (v.begin (), v.end (), SortByCount ());
-  return v;
 }
 
 void
@@ -226,9 +238,19 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, uint16_t indent) con
 {
   Indent (os, indent); os << "<Ipv4FlowClassifier>\n";
 
+  // the flows are written in the order of their five-tuples
+  std::vector<std::pair<FiveTuple, FlowId> > flows;
+  flows.reserve (m_flows.size ());
+  for (std::unordered_map<FlowId, Flow>::const_iterator iter = m_flows.begin ();
+       iter != m_flows.end (); iter++)
+    {
+      flows.push_back (std::make_pair (iter->second.tuple, iter->first));
+    }
+  std::sort (flows.begin (), flows.end ());
+
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (std::vector<std::pair<FiveTuple, FlowId> >::const_iterator
+       iter = flows.begin (); iter != flows.end (); iter++)
     {
       Indent (os, indent);
       os << "<Flow flowId=\"" << iter->second << "\""
@@ -239,17 +261,12 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, uint16_t indent) con
          << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
 
       indent += 2;
-      std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t> >::const_iterator flow
-        = m_flowDscpMap.find (iter->second);
-
-      if (flow != m_flowDscpMap.end ())
+      const Flow &flow = GetFlow (iter->second);
+      for (std::map<Ipv4Header::DscpType, uint32_t>::const_iterator i = flow.dscpCounts.begin (); i != flow.dscpCounts.end (); i++)
         {
-          for (std::map<Ipv4Header::DscpType, uint32_t>::const_iterator i = flow->second.begin (); i != flow->second.end (); i++)
-            {
-              Indent (os, indent);
-              os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t> (i->first) << "\""
-                 << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+          Indent (os, indent);
+          os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t> (i->first) << "\""
+             << " packets=\"" << std::dec << i->second << "\" />\n";
         }
 
       indent -= 2;
@@ -24,6 +24,8 @@
 
 #include <stdint.h>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "ns3/ipv6-header.h"
 #include "ns3/flow-classifier.h"
@@ -91,14 +93,36 @@ public:
 
   virtual void SerializeToXmlStream (std::ostream &os, uint16_t indent) const;
 
+  virtual void RemoveFlow (FlowId flowId);
+
 private:
 
+  /// Hash function of the five-tuples
+  struct FiveTupleHash
+  {
+    /// \param tuple the five-tuple
+    /// \return the hash of the five-tuple
+    size_t operator() (const FiveTuple &tuple) const;
+  };
+
+  /// A flow found by the classifier
+  struct Flow
+  {
+    FiveTuple tuple;            //!< Five-tuple of the flow
+    FlowPacketId lastPacketId;  //!< Identifier of the last packet of the flow
+    /// (DSCP value, packet count) pairs
+    std::map<Ipv6Header::DscpType, uint32_t> dscpCounts;
+  };
+
+  /// Get a flow from its identifier
+  /// \param flowId the FlowId
+  /// \returns the flow
+  const Flow& GetFlow (FlowId flowId) const;
+
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-  /// Map FlowIds to (DSCP value, packet count) pairs
-  std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t> > m_flowDscpMap;
+  std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+  /// The flows, by FlowId
+  std::unordered_map<FlowId, Flow> m_flows;
 
 };
 
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-header.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief A probe used to report packets directly to the FlowMonitor
+ */
+class FlowClassifierTestProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor
+   */
+  FlowClassifierTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Ipv4FlowClassifier and FlowMonitor flow tables Test
+ */
+class Ipv4FlowClassifierTestCase : public TestCase
+{
+public:
+  Ipv4FlowClassifierTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Classify a UDP packet
+   * \param classifier the classifier
+   * \param src the source address
+   * \param dst the destination address
+   * \param srcPort the source port
+   * \param dscp the DSCP value
+   * \param flowId the flow id (output)
+   * \param packetId the packet id (output)
+   * \return true if the packet was classified
+   */
+  bool Classify (Ptr<Ipv4FlowClassifier> classifier, Ipv4Address src, Ipv4Address dst,
+                 uint16_t srcPort, Ipv4Header::DscpType dscp, FlowId &flowId, FlowPacketId &packetId);
+};
+
+Ipv4FlowClassifierTestCase::Ipv4FlowClassifierTestCase ()
+  : TestCase ("Check the flow and packet ids of the classifier and the flow tables of the monitor")
+{
+}
+
+bool
+Ipv4FlowClassifierTestCase::Classify (Ptr<Ipv4FlowClassifier> classifier, Ipv4Address src, Ipv4Address dst,
+                                      uint16_t srcPort, Ipv4Header::DscpType dscp, FlowId &flowId, FlowPacketId &packetId)
+{
+  Ipv4Header header;
+  header.SetSource (src);
+  header.SetDestination (dst);
+  header.SetProtocol (17);
+  header.SetDscp (dscp);
+  UdpHeader udp;
+  udp.SetSourcePort (srcPort);
+  udp.SetDestinationPort (9);
+  Ptr<Packet> payload = Create<Packet> (100);
+  payload->AddHeader (udp);
+  return classifier->Classify (header, payload, &flowId, &packetId);
+}
+
+void
+Ipv4FlowClassifierTestCase::DoRun (void)
+{
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  monitor->AddFlowClassifier (classifier);
+  Ptr<FlowProbe> probe = Create<FlowClassifierTestProbe> (monitor);
+  monitor->StartRightNow ();
+
+  // 1000 flows, from 1000 sources in decreasing order, 3 packets each
+  for (uint32_t n = 0; n < 3; n++)
+    {
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          FlowId flowId;
+          FlowPacketId packetId;
+          bool classified = Classify (classifier, Ipv4Address (0x0a0003e8 - i), Ipv4Address ("10.1.0.1"), 1000 + i % 7,
+                                      n == 2 ? Ipv4Header::DSCP_EF : Ipv4Header::DscpDefault, flowId, packetId);
+          NS_TEST_ASSERT_MSG_EQ (classified, true, "Packet not classified");
+          NS_TEST_EXPECT_MSG_EQ (flowId, i + 1, "Wrong flow id");
+          NS_TEST_EXPECT_MSG_EQ (packetId, n, "Wrong packet id");
+          monitor->ReportFirstTx (probe, flowId, packetId, 128);
+          if (n < 2 || i % 2 == 0)
+            {
+              monitor->ReportForwarding (probe, flowId, packetId, 128);
+              monitor->ReportLastRx (probe, flowId, packetId, 128);
+            }
+        }
+    }
+
+  Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow (10);
+  NS_TEST_EXPECT_MSG_EQ (tuple.sourceAddress, Ipv4Address (0x0a0003e8 - 9), "Wrong source address");
+  NS_TEST_EXPECT_MSG_EQ (tuple.sourcePort, 1000 + 9 % 7, "Wrong source port");
+  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > dscp = classifier->GetDscpCounts (10);
+  NS_TEST_ASSERT_MSG_EQ (dscp.size (), 2, "Wrong number of DSCP values");
+  NS_TEST_EXPECT_MSG_EQ (dscp[0].first, Ipv4Header::DscpDefault, "Wrong most frequent DSCP value");
+  NS_TEST_EXPECT_MSG_EQ (dscp[0].second, 2, "Wrong DSCP count");
+
+  // the packets still tracked are lost
+  monitor->CheckForLostPackets (Seconds (0));
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), 1000, "Wrong number of flows");
+  for (FlowMonitor::FlowStatsContainerCI it = stats.begin (); it != stats.end (); it++)
+    {
+      uint32_t i = it->first - 1;
+      NS_TEST_EXPECT_MSG_EQ (it->second.txPackets, 3, "Wrong number of packets sent");
+      NS_TEST_EXPECT_MSG_EQ (it->second.rxPackets, (i % 2 == 0 ? 3 : 2), "Wrong number of packets received");
+      NS_TEST_EXPECT_MSG_EQ (it->second.lostPackets, (i % 2 == 0 ? 0 : 1), "Wrong number of packets lost");
+      NS_TEST_EXPECT_MSG_EQ (it->second.timesForwarded, it->second.rxPackets, "Wrong number of forwardings");
+    }
+  FlowProbe::Stats probeStats = probe->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (probeStats.size (), 1000, "Wrong number of flows in the probe");
+  NS_TEST_EXPECT_MSG_EQ (probeStats[1].packets, 3 + 2 * 3, "Wrong number of packets seen by the probe");
+
+  // the flows are serialized in the order of their five-tuples
+  std::string xml = monitor->SerializeToXmlString (0, false, false);
+  std::string::size_type first = xml.find ("<Flow flowId=\"1000\" sourceAddress");
+  std::string::size_type last = xml.find ("<Flow flowId=\"1\" sourceAddress");
+  NS_TEST_EXPECT_MSG_NE (first, std::string::npos, "Flow 1000 not serialized");
+  NS_TEST_EXPECT_MSG_LT (first, last, "Flows not sorted by five-tuple");
+
+  monitor->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor flow classifier TestSuite
+ */
+class FlowClassifierTestSuite : public TestSuite
+{
+public:
+  FlowClassifierTestSuite ();
+};
+
+FlowClassifierTestSuite::FlowClassifierTestSuite ()
+  : TestSuite ("flow-monitor-classifier", UNIT)
+{
+  AddTestCase (new Ipv4FlowClassifierTestCase, TestCase::QUICK);
+}
+
+static FlowClassifierTestSuite g_flowClassifierTestSuite; //!< Static variable for test initialization
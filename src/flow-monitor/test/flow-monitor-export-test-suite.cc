@@ -0,0 +1,304 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief A probe used to report packets directly to the FlowMonitor
+ */
+class FlowExportTestProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor
+   */
+  FlowExportTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor periodic export Test
+ */
+class FlowMonitorExportTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param format the format of the export
+   */
+  FlowMonitorExportTestCase (FlowMonitor::ExportFormat format);
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a packet of 100 bytes, received 10 ms later or dropped
+   * \param flowId the flow
+   * \param packetId the packet
+   * \param drop true if the packet is dropped
+   */
+  void SendPacket (FlowId flowId, FlowPacketId packetId, bool drop);
+
+  /**
+   * Classify a UDP packet from 10.0.0.1 to 10.0.0.2
+   * \param port the source and destination port
+   * \return the flow of the packet
+   */
+  FlowId Classify (uint16_t port);
+
+  /**
+   * Check the flows resident in the monitor, its probe and its classifier
+   * \param nFlows the number of flows expected
+   */
+  void CheckResidentFlows (uint32_t nFlows);
+
+  /**
+   * Read the export records
+   * \param fileName the name of the export file
+   * \return the records
+   */
+  std::vector<FlowMonitor::ExportRecord> ReadRecords (std::string fileName);
+
+  FlowMonitor::ExportFormat m_format;  //!< Format of the export
+  Ptr<FlowMonitor> m_monitor;          //!< Monitor
+  Ptr<FlowProbe> m_probe;              //!< Probe
+  Ptr<Ipv4FlowClassifier> m_classifier; //!< Classifier
+};
+
+FlowMonitorExportTestCase::FlowMonitorExportTestCase (FlowMonitor::ExportFormat format)
+  : TestCase (std::string ("Check the periodic export of the FlowMonitor in ")
+              + (format == FlowMonitor::EXPORT_CSV ? "CSV" : "binary") + " format"),
+    m_format (format)
+{
+}
+
+void
+FlowMonitorExportTestCase::SendPacket (FlowId flowId, FlowPacketId packetId, bool drop)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100);
+  if (drop)
+    {
+      m_monitor->ReportDrop (m_probe, flowId, packetId, 100, 1);
+    }
+  else
+    {
+      Simulator::Schedule (MilliSeconds (10), &FlowMonitor::ReportLastRx, m_monitor, m_probe, flowId, packetId, 100);
+    }
+}
+
+FlowId
+FlowMonitorExportTestCase::Classify (uint16_t port)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (17);
+  uint8_t ports[4] = { static_cast<uint8_t> (port >> 8), static_cast<uint8_t> (port),
+                       static_cast<uint8_t> (port >> 8), static_cast<uint8_t> (port) };
+  Ptr<Packet> payload = Create<Packet> (ports, sizeof (ports));
+  uint32_t flowId = 0;
+  uint32_t packetId = 0;
+  bool classified = m_classifier->Classify (ipHeader, payload, &flowId, &packetId);
+  NS_TEST_EXPECT_MSG_EQ (classified, true, "Packet not classified");
+  return flowId;
+}
+
+void
+FlowMonitorExportTestCase::CheckResidentFlows (uint32_t nFlows)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_monitor->GetFlowStats ().size (), nFlows,
+                         "Wrong number of flows at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (m_probe->GetStats ().size (), nFlows,
+                         "Wrong number of probe flows at " << Simulator::Now ().GetSeconds ());
+  std::ostringstream xml;
+  m_classifier->SerializeToXmlStream (xml, 0);
+  uint32_t classifierFlows = 0;
+  for (std::string::size_type pos = xml.str ().find ("<Flow "); pos != std::string::npos;
+       pos = xml.str ().find ("<Flow ", pos + 1))
+    {
+      classifierFlows++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (classifierFlows, nFlows,
+                         "Wrong number of classifier flows at " << Simulator::Now ().GetSeconds ());
+}
+
+std::vector<FlowMonitor::ExportRecord>
+FlowMonitorExportTestCase::ReadRecords (std::string fileName)
+{
+  std::vector<FlowMonitor::ExportRecord> records;
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (m_format == FlowMonitor::EXPORT_BINARY)
+    {
+      uint32_t header[2];
+      file.read ((char *)header, sizeof (header));
+      NS_TEST_EXPECT_MSG_EQ (header[0], FlowMonitor::EXPORT_MAGIC, "Wrong magic");
+      NS_TEST_EXPECT_MSG_EQ (header[1], sizeof (FlowMonitor::ExportRecord), "Wrong record size");
+      FlowMonitor::ExportRecord record;
+      while (file.read ((char *)&record, sizeof (record)))
+        {
+          records.push_back (record);
+        }
+      return records;
+    }
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_EXPECT_MSG_EQ (line.substr (0, 12), "time,flowId,", "Wrong CSV header");
+  while (std::getline (file, line))
+    {
+      std::istringstream fields (line);
+      FlowMonitor::ExportRecord record;
+      uint32_t finished;
+      char c;
+      fields >> record.time >> c >> record.flowId >> c >> finished
+      >> c >> record.txBytes >> c >> record.rxBytes
+      >> c >> record.txPackets >> c >> record.rxPackets
+      >> c >> record.lostPackets >> c >> record.droppedPackets
+      >> c >> record.droppedBytes >> c >> record.timesForwarded
+      >> c >> record.delaySum >> c >> record.jitterSum;
+      NS_TEST_EXPECT_MSG_EQ (bool (fields), true, "Invalid CSV line " << line);
+      record.flags = finished ? FlowMonitor::EXPORT_FINISHED : 0;
+      records.push_back (record);
+    }
+  return records;
+}
+
+void
+FlowMonitorExportTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flow-export");
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("FlowIdleTimeout", TimeValue (Seconds (2)));
+  m_probe = Create<FlowExportTestProbe> (m_monitor);
+  m_classifier = Create<Ipv4FlowClassifier> ();
+  m_monitor->AddFlowClassifier (m_classifier);
+  for (uint16_t port = 1; port <= 3; port++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (Classify (port), port, "Wrong flow allocated by the classifier");
+    }
+  m_monitor->StartRightNow ();
+  m_monitor->EnablePeriodicExport (fileName, Seconds (1), m_format);
+
+  // flow 1 sends 10 packets during the first second, flow 2 50 packets
+  // during 5 s, flow 3 one packet dropped at 0.5 s
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      if (i < 10)
+        {
+          Simulator::Schedule (MilliSeconds (100 * i), &FlowMonitorExportTestCase::SendPacket, this, 1, i, false);
+        }
+      Simulator::Schedule (MilliSeconds (100 * i), &FlowMonitorExportTestCase::SendPacket, this, 2, i, false);
+    }
+  Simulator::Schedule (MilliSeconds (500), &FlowMonitorExportTestCase::SendPacket, this, 3, 0, true);
+
+  // flows 1 and 3 are finished at the export of 3 s, flow 2 at 7 s
+  Simulator::Schedule (MilliSeconds (2500), &FlowMonitorExportTestCase::CheckResidentFlows, this, 3);
+  Simulator::Schedule (MilliSeconds (3500), &FlowMonitorExportTestCase::CheckResidentFlows, this, 1);
+  Simulator::Schedule (MilliSeconds (7500), &FlowMonitorExportTestCase::CheckResidentFlows, this, 0);
+  Simulator::Stop (Seconds (8));
+  Simulator::Run ();
+  m_monitor->StopRightNow ();
+  Simulator::Destroy ();
+
+  // a packet of a finished flow starts a new flow
+  NS_TEST_EXPECT_MSG_EQ (Classify (1), 4, "Finished flow not removed from the classifier");
+
+  std::vector<FlowMonitor::ExportRecord> records = ReadRecords (fileName);
+  std::map<FlowId, FlowMonitor::ExportRecord> totals;
+  std::map<FlowId, int64_t> finishTimes;
+  int64_t lastTime = 0;
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      const FlowMonitor::ExportRecord &r = records[i];
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (r.time, lastTime, "Records not in time order");
+      lastTime = r.time;
+      NS_TEST_EXPECT_MSG_EQ (finishTimes.count (r.flowId), 0, "Record after the end of flow " << r.flowId);
+      FlowMonitor::ExportRecord &t = totals[r.flowId];
+      t.txPackets += r.txPackets;
+      t.rxPackets += r.rxPackets;
+      t.rxBytes += r.rxBytes;
+      t.droppedPackets += r.droppedPackets;
+      t.delaySum += r.delaySum;
+      if (r.flags & FlowMonitor::EXPORT_FINISHED)
+        {
+          finishTimes[r.flowId] = r.time;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (totals.size (), 3, "Wrong number of flows exported");
+  NS_TEST_EXPECT_MSG_EQ (totals[1].txPackets, 10, "Wrong packets sent by flow 1");
+  NS_TEST_EXPECT_MSG_EQ (totals[1].rxBytes, 1000, "Wrong bytes received by flow 1");
+  NS_TEST_EXPECT_MSG_EQ (totals[1].delaySum, 10 * MilliSeconds (10).GetNanoSeconds (), "Wrong delays of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (totals[2].txPackets, 50, "Wrong packets sent by flow 2");
+  NS_TEST_EXPECT_MSG_EQ (totals[2].rxPackets, 50, "Wrong packets received by flow 2");
+  NS_TEST_EXPECT_MSG_EQ (totals[3].droppedPackets, 1, "Wrong packets dropped by flow 3");
+  NS_TEST_EXPECT_MSG_EQ (finishTimes[1], Seconds (3).GetNanoSeconds (), "Flow 1 not finished at 3 s");
+  NS_TEST_EXPECT_MSG_EQ (finishTimes[3], Seconds (3).GetNanoSeconds (), "Flow 3 not finished at 3 s");
+  NS_TEST_EXPECT_MSG_EQ (finishTimes[2], Seconds (7).GetNanoSeconds (), "Flow 2 not finished at 7 s");
+  // flow 2 changes every second until it ends, and is finished 2 s later
+  uint32_t flow2Records = 0;
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      flow2Records += (records[i].flowId == 2);
+    }
+  NS_TEST_EXPECT_MSG_EQ (flow2Records, 6, "Unchanged flow exported");
+
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  m_probe = 0;
+  m_classifier = 0;
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor periodic export TestSuite
+ */
+class FlowMonitorExportTestSuite : public TestSuite
+{
+public:
+  FlowMonitorExportTestSuite ();
+};
+
+FlowMonitorExportTestSuite::FlowMonitorExportTestSuite ()
+  : TestSuite ("flow-monitor-export", UNIT)
+{
+  AddTestCase (new FlowMonitorExportTestCase (FlowMonitor::EXPORT_CSV), TestCase::QUICK);
+  AddTestCase (new FlowMonitorExportTestCase (FlowMonitor::EXPORT_BINARY), TestCase::QUICK);
+}
+
+static FlowMonitorExportTestSuite g_flowMonitorExportTestSuite; //!< Static variable for test initialization
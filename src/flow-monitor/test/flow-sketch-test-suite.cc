@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/flow-sketch.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief A probe used to report packets directly to the FlowMonitor
+ */
+class FlowSketchTestProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor
+   */
+  FlowSketchTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief CountMinSketch and DdSketch Test
+ */
+class FlowSketchTestCase : public TestCase
+{
+public:
+  FlowSketchTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowSketchTestCase::FlowSketchTestCase ()
+  : TestCase ("Check the estimates of the count-min sketch and the quantiles of the DDSketch")
+{
+}
+
+void
+FlowSketchTestCase::DoRun (void)
+{
+  // 10000 keys, key k counted 1 + 100000 / (k + 1) times (heavy-tailed)
+  CountMinSketch sketch (2048, 4);
+  std::vector<uint64_t> counts (10000);
+  for (uint32_t k = 0; k < counts.size (); k++)
+    {
+      counts[k] = 1 + 100000 / (k + 1);
+      sketch.Update (k, counts[k]);
+    }
+  uint64_t total = sketch.GetTotal ();
+  uint32_t beyondBound = 0;
+  for (uint32_t k = 0; k < counts.size (); k++)
+    {
+      uint64_t estimate = sketch.Estimate (k);
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (estimate, counts[k], "Count of key " << k << " underestimated");
+      beyondBound += (estimate - counts[k] > std::exp (1.0) * total / 2048);
+    }
+  NS_TEST_EXPECT_MSG_LT (beyondBound, 10000 / 50, "Too many estimates beyond the error bound");
+  NS_TEST_EXPECT_MSG_EQ_TOL (sketch.Estimate (0), counts[0], counts[0] / 1000, "Heaviest key not accurate");
+
+  // 1 ms to 10 s, uniform in log scale, plus zeros
+  DdSketch delays (0.01);
+  std::vector<double> values;
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      values.push_back (0.001 * std::pow (10000.0, i / 10000.0));
+      delays.AddValue (values.back ());
+    }
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      values.push_back (0);
+      delays.AddValue (0);
+    }
+  std::sort (values.begin (), values.end ());
+  NS_TEST_EXPECT_MSG_EQ (delays.GetCount (), values.size (), "Wrong number of values");
+  NS_TEST_EXPECT_MSG_EQ (delays.GetQuantile (0.005), 0, "Zeros not counted");
+  const double quantiles[] = { 0.1, 0.5, 0.9, 0.99, 0.999, 1 };
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      double exact = values[static_cast<uint32_t> (quantiles[i] * (values.size () - 1))];
+      NS_TEST_EXPECT_MSG_EQ_TOL (delays.GetQuantile (quantiles[i]), exact, exact * 0.0101,
+                                 "Wrong quantile " << quantiles[i]);
+    }
+
+  // with few bins, the lowest values are merged but the highest quantiles are kept
+  DdSketch bounded (0.01, 100);
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      bounded.AddValue (values[i]);
+    }
+  double exact = values[static_cast<uint32_t> (0.99 * (values.size () - 1))];
+  NS_TEST_EXPECT_MSG_EQ_TOL (bounded.GetQuantile (0.99), exact, exact * 0.0101, "Wrong quantile with merged bins");
+  NS_TEST_EXPECT_MSG_LT (bounded.GetQuantile (0.1), values[static_cast<uint32_t> (0.99 * (values.size () - 1)) - 1],
+                         "Merged bins above the quantile");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor sampling and sketches Test
+ */
+class FlowMonitorSamplingTestCase : public TestCase
+{
+public:
+  FlowMonitorSamplingTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send packets through a monitor: flow f (1 to nFlows) sends f packets
+   * of 100 bytes, received after f ms.
+   * \param monitor the monitor
+   * \param nFlows the number of flows
+   */
+  void SendPackets (Ptr<FlowMonitor> monitor, uint32_t nFlows);
+};
+
+FlowMonitorSamplingTestCase::FlowMonitorSamplingTestCase ()
+  : TestCase ("Check the sampling of the packets and flows and the sketches of the FlowMonitor")
+{
+}
+
+void
+FlowMonitorSamplingTestCase::SendPackets (Ptr<FlowMonitor> monitor, uint32_t nFlows)
+{
+  Ptr<FlowProbe> probe = Create<FlowSketchTestProbe> (monitor);
+  monitor->StartRightNow ();
+  for (FlowId flowId = 1; flowId <= nFlows; flowId++)
+    {
+      for (FlowPacketId packetId = 0; packetId < flowId; packetId++)
+        {
+          monitor->ReportFirstTx (probe, flowId, packetId, 100);
+          Simulator::Schedule (MilliSeconds (flowId), &FlowMonitor::ReportLastRx, monitor, probe, flowId, packetId, 100);
+        }
+    }
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+FlowMonitorSamplingTestCase::DoRun (void)
+{
+  // one packet in 10
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("SamplingMode", EnumValue (FlowMonitor::SAMPLE_PACKETS));
+  monitor->SetAttribute ("SamplingRate", UintegerValue (10));
+  SendPackets (monitor, 200);
+  uint64_t txPackets = 0, rxPackets = 0;
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI it = stats.begin (); it != stats.end (); it++)
+    {
+      txPackets += it->second.txPackets;
+      rxPackets += it->second.rxPackets;
+      NS_TEST_EXPECT_MSG_EQ (it->second.lostPackets, 0, "Sampled packet lost");
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (txPackets, 200 * 201 / 2 / 10, 200 * 201 / 2 / 10 / 10, "Wrong number of packets sampled");
+  NS_TEST_EXPECT_MSG_EQ (rxPackets, txPackets, "Sampled packets not received");
+  NS_TEST_EXPECT_MSG_NE (monitor->SerializeToXmlString (0, false, false).find ("samplingRate=\"10\""), std::string::npos,
+                         "Sampling not serialized");
+  monitor->Dispose ();
+
+  // one flow in 4
+  monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("SamplingMode", EnumValue (FlowMonitor::SAMPLE_FLOWS));
+  monitor->SetAttribute ("SamplingRate", UintegerValue (4));
+  SendPackets (monitor, 200);
+  const FlowMonitor::FlowStatsContainer &flowStats = monitor->GetFlowStats ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (flowStats.size (), 50, 15, "Wrong number of flows sampled");
+  for (FlowMonitor::FlowStatsContainerCI it = flowStats.begin (); it != flowStats.end (); it++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (it->second.txPackets, it->first, "Packets of a sampled flow not all sampled");
+    }
+  monitor->Dispose ();
+
+  // sketches only
+  monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("EnableSketches", BooleanValue (true));
+  monitor->SetAttribute ("SketchWidth", UintegerValue (1024));
+  monitor->SetAttribute ("HeavyHitters", UintegerValue (5));
+  SendPackets (monitor, 200);
+  NS_TEST_EXPECT_MSG_EQ (monitor->GetFlowStats ().size (), 0, "Per-flow statistics kept with the sketches");
+  const FlowMonitor::FlowStats &totals = monitor->GetSketchTotals ();
+  NS_TEST_EXPECT_MSG_EQ (totals.txPackets, 200 * 201 / 2, "Wrong number of packets sent");
+  NS_TEST_EXPECT_MSG_EQ (totals.rxBytes, 100 * 200 * 201 / 2, "Wrong number of bytes received");
+  std::vector<std::pair<FlowId, uint64_t> > heavyHitters = monitor->GetHeavyHitters ();
+  NS_TEST_ASSERT_MSG_EQ (heavyHitters.size (), 5, "Wrong number of heavy hitters");
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (heavyHitters[i].first, 200 - i, "Wrong heavy hitter " << i);
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (heavyHitters[i].second, 100 * (200 - i), "Heavy hitter bytes underestimated");
+    }
+  // the delay of the median packet is 141 or 142 ms
+  double median = monitor->GetDelaySketch ().GetQuantile (0.5);
+  NS_TEST_EXPECT_MSG_EQ_TOL (median, 0.1415, 0.0025, "Wrong median delay");
+  std::string xml = monitor->SerializeToXmlString (0, false, false);
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<Flow flowId=\"200\" txBytes=\"20000\" />"), std::string::npos,
+                         "Heaviest flow not serialized");
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<delaySketch"), std::string::npos, "Delay sketch not serialized");
+  monitor->Dispose ();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor sketches TestSuite
+ */
+class FlowSketchTestSuite : public TestSuite
+{
+public:
+  FlowSketchTestSuite ();
+};
+
+FlowSketchTestSuite::FlowSketchTestSuite ()
+  : TestSuite ("flow-monitor-sketch", UNIT)
+{
+  AddTestCase (new FlowSketchTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorSamplingTestCase, TestCase::QUICK);
+}
+
+static FlowSketchTestSuite g_flowSketchTestSuite; //!< Static variable for test initialization
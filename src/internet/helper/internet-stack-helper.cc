@@ -439,7 +439,8 @@ InternetStackHelper::EnablePcapIpv4Internal (std::string prefix, Ptr<Ipv4> ipv4,
       filename = pcapHelper.GetFilenameFromInterfacePair (prefix, ipv4, interface);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_RAW);
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_RAW,
+                                                     ipv4->GetNetDevice (interface));
 
   //
   // However, we only hook the trace source once to avoid multiple trace sink
@@ -537,7 +538,8 @@ InternetStackHelper::EnablePcapIpv6Internal (std::string prefix, Ptr<Ipv6> ipv6,
       filename = pcapHelper.GetFilenameFromInterfacePair (prefix, ipv6, interface);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_RAW);
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_RAW,
+                                                     ipv6->GetNetDevice (interface));
 
   //
   // However, we only hook the trace source once to avoid multiple trace sink
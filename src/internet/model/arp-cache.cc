@@ -57,8 +57,8 @@ ArpCache::GetTypeId (void)
                    MakeTimeChecker ())
     .AddAttribute ("WaitReplyTimeout",
                    "When this timeout expires, "
-                   "the cache entries will be scanned and "
-                   "entries in WaitReply state will resend ArpRequest "
+                   "the matching cache entry in WaitReply state "
+                   "will resend ArpRequest "
                    "unless MaxRetries has been exceeded, "
                    "in which case the entry is marked dead",
                    TimeValue (Seconds (1)),
@@ -182,73 +182,76 @@ void
 ArpCache::StartWaitReplyTimer (void)
 {
   NS_LOG_FUNCTION (this);
-  if (!m_waitReplyTimer.IsRunning ())
+  Time deadline;
+  if (!m_arpCache.GetNextDeadline (deadline))
     {
-      NS_LOG_LOGIC ("Starting WaitReplyTimer at " << Simulator::Now () << " for " <<
-                    m_waitReplyTimeout);
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
+      m_waitReplyTimer.Cancel ();
+      return;
     }
+  if (m_waitReplyTimer.IsRunning ()
+      && m_waitReplyTimer.GetTs () == static_cast<uint64_t> (deadline.GetTimeStep ()))
+    {
+      return;
+    }
+  m_waitReplyTimer.Cancel ();
+  NS_LOG_LOGIC ("Starting WaitReplyTimer at " << Simulator::Now () << " for " <<
+                deadline - Simulator::Now ());
+  m_waitReplyTimer = Simulator::Schedule (deadline - Simulator::Now (),
+                                          &ArpCache::HandleWaitReplyTimeout, this);
 }
 
 void
 ArpCache::HandleWaitReplyTimeout (void)
 {
   NS_LOG_FUNCTION (this);
-  ArpCache::Entry* entry;
-  bool restartWaitReplyTimer = false;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  Ipv4Address address;
+  while (m_arpCache.PopExpired (Simulator::Now (), address))
     {
-      entry = (*i).second;
-      if (entry != 0 && entry->IsWaitReply ())
+      ArpCache::Entry* entry = m_arpCache.Find (address);
+      if (!entry->IsWaitReply ())
         {
-          if (entry->GetRetries () < m_maxRetries)
-            {
-              NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
-                            ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
-                            " expired -- retransmitting arp request since retries = " <<
-                            entry->GetRetries ());
-              m_arpRequestCallback (this, entry->GetIpv4Address ());
-              restartWaitReplyTimer = true;
-              entry->IncrementRetries ();
-            }
-          else
+          continue;
+        }
+      if (entry->GetRetries () < m_maxRetries)
+        {
+          NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
+                        ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
+                        " expired -- retransmitting arp request since retries = " <<
+                        entry->GetRetries ());
+          m_arpRequestCallback (this, entry->GetIpv4Address ());
+          entry->IncrementRetries ();
+          m_arpCache.SetDeadline (address, Simulator::Now () + m_waitReplyTimeout);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
+                        ", wait reply for " << entry->GetIpv4Address () <<
+                        " expired -- drop since max retries exceeded: " <<
+                        entry->GetRetries ());
+          entry->MarkDead ();
+          entry->ClearRetries ();
+          Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
+          while (pending.first != 0)
             {
-              NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
-                            ", wait reply for " << entry->GetIpv4Address () <<
-                            " expired -- drop since max retries exceeded: " <<
-                            entry->GetRetries ());
-              entry->MarkDead ();
-              entry->ClearRetries ();
-              Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
-              while (pending.first != 0)
-                {
-                  // add the Ipv4 header for tracing purposes
-                  pending.first->AddHeader (pending.second);
-                  m_dropTrace (pending.first);
-                  pending = entry->DequeuePending ();
-                }
+              // add the Ipv4 header for tracing purposes
+              pending.first->AddHeader (pending.second);
+              m_dropTrace (pending.first);
+              pending = entry->DequeuePending ();
             }
         }
-
-    }
-  if (restartWaitReplyTimer)
-    {
-      NS_LOG_LOGIC ("Restarting WaitReplyTimer at " << Simulator::Now ().GetSeconds ());
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
     }
+  StartWaitReplyTimer ();
 }
 
 void 
 ArpCache::Flush (void)
 {
   NS_LOG_FUNCTION (this);
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  for (CacheI i = m_arpCache.Begin (); i != m_arpCache.End (); i++) 
     {
       delete (*i).second;
     }
-  m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
+  m_arpCache.Clear ();
   if (m_waitReplyTimer.IsRunning ())
     {
       NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
@@ -262,7 +265,7 @@ ArpCache::PrintArpCache (Ptr<OutputStreamWrapper> stream)
   NS_LOG_FUNCTION (this << stream);
   std::ostream* os = stream->GetStream ();
 
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++)
+  for (CacheI i = m_arpCache.Begin (); i != m_arpCache.End (); i++)
     {
       *os << i->first << " dev ";
       std::string found = Names::FindName (m_device);
@@ -302,7 +305,7 @@ ArpCache::LookupInverse (Address to)
   NS_LOG_FUNCTION (this << to);
 
   std::list<ArpCache::Entry *> entryList;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++)
+  for (CacheI i = m_arpCache.Begin (); i != m_arpCache.End (); i++)
     {
       ArpCache::Entry *entry = (*i).second;
       if (entry->GetMacAddress () == to)
@@ -318,22 +321,17 @@ ArpCache::Entry *
 ArpCache::Lookup (Ipv4Address to)
 {
   NS_LOG_FUNCTION (this << to);
-  CacheI it = m_arpCache.find (to);
-  if (it != m_arpCache.end ())
-    {
-      return it->second;
-    }
-  return 0;
+  return m_arpCache.Find (to);
 }
 
 ArpCache::Entry *
 ArpCache::Add (Ipv4Address to)
 {
   NS_LOG_FUNCTION (this << to);
-  NS_ASSERT (m_arpCache.find (to) == m_arpCache.end ());
+  NS_ASSERT (m_arpCache.Find (to) == 0);
 
   ArpCache::Entry *entry = new ArpCache::Entry (this);
-  m_arpCache[to] = entry;
+  m_arpCache.Insert (to, entry);
   entry->SetIpv4Address (to);
   return entry;
 }
@@ -343,15 +341,12 @@ ArpCache::Remove (ArpCache::Entry *entry)
 {
   NS_LOG_FUNCTION (this << entry);
   
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++)
+  if (m_arpCache.Find (entry->GetIpv4Address ()) == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_arpCache.erase (i);
-          entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
-          delete entry;
-          return;
-        }
+      m_arpCache.Erase (entry->GetIpv4Address ());
+      entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
+      delete entry;
+      return;
     }
   NS_LOG_WARN ("Entry not found in this ARP Cache");
 }
@@ -447,6 +442,7 @@ ArpCache::Entry::MarkWaitReply (Ipv4PayloadHeaderPair waiting)
   m_state = WAIT_REPLY;
   m_pending.push_back (waiting);
   UpdateSeen ();
+  m_arp->m_arpCache.SetDeadline (m_ipv4Address, Simulator::Now () + m_arp->m_waitReplyTimeout);
   m_arp->StartWaitReplyTimer ();
 }
 
@@ -32,8 +32,8 @@
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
-#include "ns3/sgi-hashmap.h"
 #include "ns3/output-stream-wrapper.h"
+#include "neighbor-cache-table.h"
 
 namespace ns3 {
 
@@ -135,9 +135,9 @@ public:
   void SetArpRequestCallback (Callback<void, Ptr<const ArpCache>, 
                                        Ipv4Address> arpRequestCallback);
   /**
-   * This method will schedule a timeout at WaitReplyTimeout interval
-   * in the future, unless a timer is already running for the cache,
-   * in which case this method does nothing.
+   * This method will schedule the cache timer to expire at the earliest
+   * WaitReply deadline of the cache entries, unless the timer is already
+   * running for that deadline, in which case this method does nothing.
    */
   void StartWaitReplyTimer (void);
   /**
@@ -313,11 +313,11 @@ private:
   /**
    * \brief ARP Cache container
    */
-  typedef sgi::hash_map<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash> Cache;
+  typedef NeighborCacheTable<Ipv4Address, ArpCache::Entry, Ipv4AddressHash> Cache;
   /**
    * \brief ARP Cache container iterator
    */
-  typedef sgi::hash_map<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash>::iterator CacheI;
+  typedef Cache::Iterator CacheI;
 
   virtual void DoDispose (void);
 
@@ -331,8 +331,9 @@ private:
   uint32_t m_maxRetries; //!< max retries for a resolution
 
   /**
-   * This function is an event handler for the event that the
-   * ArpCache wants to check whether it must retry any Arp requests.
+   * This function is an event handler for the event that the WaitReply
+   * deadline of some entries has expired: those entries (and only those)
+   * retry their Arp request or are marked dead.
    * If there are no Arp requests pending, this event is not scheduled.
    */
   void HandleWaitReplyTimeout (void);
@@ -24,11 +24,13 @@
 #include "ipv4-queue-disc-item.h"
 #include "arp-l3-protocol.h"
 #include "arp-cache.h"
+#include "ipv4-receive-coalescer.h"
 #include "ns3/net-device.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/node.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/traffic-control-layer.h"
 
 
@@ -50,7 +52,13 @@ Ipv4Interface::GetTypeId (void)
                    MakePointerAccessor (&Ipv4Interface::SetArpCache, 
                                         &Ipv4Interface::GetArpCache),
                    MakePointerChecker<ArpCache> ())
-  ;
+    .AddAttribute ("ReceiveCoalescing",
+                   "Coalesce consecutive in-order TCP segments of the same flow "
+                   "received on this interface before delivering them to L4. "
+                   "See Ipv4ReceiveCoalescer for the coalescing parameters.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4Interface::m_receiveCoalescing),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -67,7 +75,9 @@ Ipv4Interface::Ipv4Interface ()
     m_node (0), 
     m_device (0),
     m_tc (0),
-    m_cache (0)
+    m_cache (0),
+    m_receiveCoalescing (false),
+    m_coalescer (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -85,6 +95,11 @@ Ipv4Interface::DoDispose (void)
   m_device = 0;
   m_tc = 0;
   m_cache = 0;
+  if (m_coalescer != 0)
+    {
+      m_coalescer->Dispose ();
+      m_coalescer = 0;
+    }
   Object::DoDispose ();
 }
 
@@ -162,6 +177,27 @@ Ipv4Interface::GetArpCache () const
   return m_cache;
 }
 
+bool
+Ipv4Interface::IsReceiveCoalescing (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_receiveCoalescing;
+}
+
+void
+Ipv4Interface::SetReceiveCoalescer (Ptr<Ipv4ReceiveCoalescer> coalescer)
+{
+  NS_LOG_FUNCTION (this << coalescer);
+  m_coalescer = coalescer;
+}
+
+Ptr<Ipv4ReceiveCoalescer>
+Ipv4Interface::GetReceiveCoalescer (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_coalescer;
+}
+
 /**
  * These are IP interface states and may be distinct from 
  * NetDevice states, such as found in real implementations
@@ -32,6 +32,7 @@ class NetDevice;
 class Packet;
 class Node;
 class ArpCache;
+class Ipv4ReceiveCoalescer;
 class Ipv4InterfaceAddress;
 class Ipv4Address;
 class Ipv4Header;
@@ -93,6 +94,24 @@ public:
    */
   Ptr<ArpCache> GetArpCache () const;
 
+  /**
+   * \returns true if receive-side coalescing of TCP segments is enabled
+   * on this interface
+   */
+  bool IsReceiveCoalescing (void) const;
+
+  /**
+   * \brief Set the object coalescing the TCP segments received on this interface
+   * \param coalescer the receive coalescer
+   */
+  void SetReceiveCoalescer (Ptr<Ipv4ReceiveCoalescer> coalescer);
+
+  /**
+   * \returns the object coalescing the TCP segments received on this
+   * interface, or 0 if none has been set yet
+   */
+  Ptr<Ipv4ReceiveCoalescer> GetReceiveCoalescer (void) const;
+
   /**
    * \param metric configured routing metric (cost) of this interface
    *
@@ -239,6 +258,8 @@ private:
   Ptr<NetDevice> m_device; //!< The associated NetDevice
   Ptr<TrafficControlLayer> m_tc; //!< The associated TrafficControlLayer
   Ptr<ArpCache> m_cache; //!< ARP cache
+  bool m_receiveCoalescing; //!< Receive-side coalescing of TCP segments
+  Ptr<Ipv4ReceiveCoalescer> m_coalescer; //!< Receive coalescer
 };
 
 } // namespace ns3
@@ -43,6 +43,8 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-segmentation-offload.h"
+#include "ipv4-receive-coalescer.h"
 
 namespace ns3 {
 
@@ -310,6 +312,10 @@ Ipv4L3Protocol::DoDispose (void)
 
   for (Ipv4InterfaceList::iterator i = m_interfaces.begin (); i != m_interfaces.end (); ++i)
     {
+      if ((*i)->GetReceiveCoalescer () != 0)
+        {
+          (*i)->GetReceiveCoalescer ()->Dispose ();
+        }
       *i = 0;
     }
   m_interfaces.clear ();
@@ -584,7 +590,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+        }
     }
   else
     {
@@ -740,6 +749,10 @@ void
 Ipv4L3Protocol::CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet,
                                     Ptr<Ipv4> ipv4, uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
   m_txTrace (packetCopy, ipv4, interface);
@@ -772,6 +785,10 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
       tos = ipTosTag.GetTos ();
     }
 
+  // A TCP super-segment is sent as one datagram per segment, numbered from
+  // the identification of the super-segment: reserve all of them.
+  uint32_t nIdentifications = TcpSegmentationOffload::GetNSegments (packet);
+
   // Handle a few cases:
   // 1) packet is destined to limited broadcast address
   // 2) packet is destined to a subnet-directed broadcast address
@@ -783,7 +800,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
   if (destination.IsBroadcast () || destination.IsLocalMulticast ())
     {
       NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 1:  limited broadcast");
-      ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+      ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment, nIdentifications);
       uint32_t ifaceIndex = 0;
       for (Ipv4InterfaceList::iterator ifaceIter = m_interfaces.begin ();
            ifaceIter != m_interfaces.end (); ifaceIter++, ifaceIndex++)
@@ -829,7 +846,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
               destination.CombineMask (ifAddr.GetMask ()) == ifAddr.GetLocal ().CombineMask (ifAddr.GetMask ())   )
             {
               NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 2:  subnet directed bcast to " << ifAddr.GetLocal ());
-              ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+              ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment, nIdentifications);
               Ptr<Packet> packetCopy = packet->Copy ();
               m_sendOutgoingTrace (ipHeader, packetCopy, ifaceIndex);
               CallTxTrace (ipHeader, packetCopy, m_node->GetObject<Ipv4> (), ifaceIndex);
@@ -844,7 +861,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
   if (route && route->GetGateway () != Ipv4Address ())
     {
       NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 3:  passed in with route");
-      ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+      ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment, nIdentifications);
       int32_t interface = GetInterfaceForDevice (route->GetOutputDevice ());
       m_sendOutgoingTrace (ipHeader, packet, interface);
       SendRealOut (route, packet->Copy (), ipHeader);
@@ -863,7 +880,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
   NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 5:  passed in with no route " << destination);
   Socket::SocketErrno errno_; 
   Ptr<NetDevice> oif (0); // unused for now
-  ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+  ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment, nIdentifications);
   Ptr<Ipv4Route> newRoute;
   if (m_routingProtocol != 0)
     {
@@ -897,9 +914,10 @@ Ipv4L3Protocol::BuildHeader (
   uint16_t payloadSize,
   uint8_t ttl,
   uint8_t tos,
-  bool mayFragment)
+  bool mayFragment,
+  uint32_t nIdentifications)
 {
-  NS_LOG_FUNCTION (this << source << destination << (uint16_t)protocol << payloadSize << (uint16_t)ttl << (uint16_t)tos << mayFragment);
+  NS_LOG_FUNCTION (this << source << destination << (uint16_t)protocol << payloadSize << (uint16_t)ttl << (uint16_t)tos << mayFragment << nIdentifications);
   Ipv4Header ipHeader;
   ipHeader.SetSource (source);
   ipHeader.SetDestination (destination);
@@ -917,7 +935,7 @@ Ipv4L3Protocol::BuildHeader (
     {
       ipHeader.SetMayFragment ();
       ipHeader.SetIdentification (m_identification[key]);
-      m_identification[key]++;
+      m_identification[key] += nIdentifications;
     }
   else
     {
@@ -927,7 +945,7 @@ Ipv4L3Protocol::BuildHeader (
       // >> Originating sources MAY set the IPv4 ID field of atomic datagrams
       //    to any value.
       ipHeader.SetIdentification (m_identification[key]);
-      m_identification[key]++;
+      m_identification[key] += nIdentifications;
     }
   if (Node::ChecksumEnabled ())
     {
@@ -954,12 +972,38 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
+  // TCP super-segments are not fragmented: they are either handed down whole
+  // to a device that segments them itself, or segmented here in software.
+  TcpSegmentationOffloadTag tsoTag;
+  bool offloaded = packet->PeekPacketTag (tsoTag);
+  if (offloaded && !outDev->SupportsSegmentationOffload ())
+    {
+      Ptr<SegmentationOffload> segmenter = m_node->GetObject<SegmentationOffload> ();
+      Ptr<Packet> superSegment = packet->Copy ();
+      superSegment->AddHeader (ipHeader);
+      std::list<Ptr<Packet> > segments;
+      if (segmenter != 0 && segmenter->Segment (superSegment, segments))
+        {
+          NS_LOG_LOGIC ("Segmenting super-segment of size " << packet->GetSize () << " in software");
+          for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+            {
+              Ipv4Header segmentHeader;
+              (*it)->RemoveHeader (segmentHeader);
+              SendRealOut (route, *it, segmentHeader);
+            }
+          return;
+        }
+      NS_LOG_WARN ("No segmentation offload object aggregated to the node");
+      packet->RemovePacketTag (tsoTag);
+      offloaded = false;
+    }
+
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!offloaded && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ())
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -986,7 +1030,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!offloaded && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ())
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -1108,6 +1152,31 @@ Ipv4L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv4Header const&ip, uin
 
   m_localDeliverTrace (ipHeader, p, iif);
 
+  Ptr<Ipv4Interface> ipv4Interface = GetInterface (iif);
+  if (ipv4Interface->IsReceiveCoalescing ())
+    {
+      Ptr<Ipv4ReceiveCoalescer> coalescer = ipv4Interface->GetReceiveCoalescer ();
+      if (coalescer == 0)
+        {
+          coalescer = CreateObject<Ipv4ReceiveCoalescer> ();
+          coalescer->SetDeliverCallback (MakeCallback (&Ipv4L3Protocol::DeliverToL4, this).Bind (iif));
+          ipv4Interface->SetReceiveCoalescer (coalescer);
+        }
+      if (coalescer->Receive (p, ipHeader))
+        {
+          NS_LOG_LOGIC ("Packet held by the receive coalescer");
+          return;
+        }
+    }
+
+  DeliverToL4 (iif, p, ipHeader);
+}
+
+void
+Ipv4L3Protocol::DeliverToL4 (uint32_t iif, Ptr<Packet> p, const Ipv4Header &ipHeader)
+{
+  NS_LOG_FUNCTION (this << iif << p << ipHeader);
+
   Ptr<IpL4Protocol> protocol = GetProtocol (ipHeader.GetProtocol (), iif);
   if (protocol != 0)
     {
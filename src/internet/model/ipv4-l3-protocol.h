@@ -306,6 +306,8 @@ private:
    * \param ttl Time to Live
    * \param tos Type of Service
    * \param mayFragment true if the packet can be fragmented
+   * \param nIdentifications number of identifications reserved from the
+   *        header's one, i.e., the number of segments of a TCP super-segment
    * \return newly created IPv4 header
    */
   Ipv4Header BuildHeader (
@@ -315,7 +317,8 @@ private:
     uint16_t payloadSize,
     uint8_t ttl,
     uint8_t tos,
-    bool mayFragment);
+    bool mayFragment,
+    uint32_t nIdentifications = 1);
 
   /**
    * \brief Send packet with route.
@@ -358,6 +361,14 @@ private:
    */
   void LocalDeliver (Ptr<const Packet> p, Ipv4Header const&ip, uint32_t iif);
 
+  /**
+   * \brief Deliver a reassembled (and possibly coalesced) packet to its L4 protocol.
+   * \param iif input interface packet was received
+   * \param p packet delivered
+   * \param ipHeader IPv4 header
+   */
+  void DeliverToL4 (uint32_t iif, Ptr<Packet> p, const Ipv4Header &ipHeader);
+
   /**
    * \brief Fallback when no route is found.
    * \param p packet
@@ -0,0 +1,337 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ipv4-receive-coalescer.h"
+#include "tcp-l4-protocol.h"
+#include "tcp-option-ts.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4ReceiveCoalescer");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpCoalescingTag);
+NS_OBJECT_ENSURE_REGISTERED (Ipv4ReceiveCoalescer);
+
+TypeId
+TcpCoalescingTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpCoalescingTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpCoalescingTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpCoalescingTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+TcpCoalescingTag::TcpCoalescingTag ()
+  : m_segments (1),
+    m_segmentSize (0)
+{
+}
+
+TcpCoalescingTag::TcpCoalescingTag (uint32_t segments, uint32_t segmentSize)
+  : m_segments (segments),
+    m_segmentSize (segmentSize)
+{
+}
+
+void
+TcpCoalescingTag::SetSegments (uint32_t segments)
+{
+  m_segments = segments;
+}
+
+uint32_t
+TcpCoalescingTag::GetSegments (void) const
+{
+  return m_segments;
+}
+
+void
+TcpCoalescingTag::SetSegmentSize (uint32_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+uint32_t
+TcpCoalescingTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+uint32_t
+TcpCoalescingTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+
+void
+TcpCoalescingTag::Serialize (TagBuffer i) const
+{
+  i.WriteU32 (m_segments);
+  i.WriteU32 (m_segmentSize);
+}
+
+void
+TcpCoalescingTag::Deserialize (TagBuffer i)
+{
+  m_segments = i.ReadU32 ();
+  m_segmentSize = i.ReadU32 ();
+}
+
+void
+TcpCoalescingTag::Print (std::ostream &os) const
+{
+  os << "Segments=" << m_segments << " SegmentSize=" << m_segmentSize;
+}
+
+bool
+Ipv4ReceiveCoalescer::FlowKey::operator < (const FlowKey &other) const
+{
+  if (m_source != other.m_source)
+    {
+      return m_source < other.m_source;
+    }
+  if (m_destination != other.m_destination)
+    {
+      return m_destination < other.m_destination;
+    }
+  if (m_sourcePort != other.m_sourcePort)
+    {
+      return m_sourcePort < other.m_sourcePort;
+    }
+  return m_destinationPort < other.m_destinationPort;
+}
+
+TypeId
+Ipv4ReceiveCoalescer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv4ReceiveCoalescer")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<Ipv4ReceiveCoalescer> ()
+    .AddAttribute ("Timeout",
+                   "Maximum time a segment is held waiting for the next segments of its flow",
+                   TimeValue (MicroSeconds (50)),
+                   MakeTimeAccessor (&Ipv4ReceiveCoalescer::m_timeout),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxSegments",
+                   "Maximum number of segments merged in a single segment",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&Ipv4ReceiveCoalescer::m_maxSegments),
+                   MakeUintegerChecker<uint32_t> (2))
+  ;
+  return tid;
+}
+
+Ipv4ReceiveCoalescer::Ipv4ReceiveCoalescer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4ReceiveCoalescer::~Ipv4ReceiveCoalescer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+Ipv4ReceiveCoalescer::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (FlowMap::iterator it = m_flows.begin (); it != m_flows.end (); it++)
+    {
+      it->second.m_timer.Cancel ();
+    }
+  m_flows.clear ();
+  m_deliver = MakeNullCallback<void, Ptr<Packet>, const Ipv4Header &> ();
+  Object::DoDispose ();
+}
+
+void
+Ipv4ReceiveCoalescer::SetDeliverCallback (DeliverCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_deliver = cb;
+}
+
+uint32_t
+Ipv4ReceiveCoalescer::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+bool
+Ipv4ReceiveCoalescer::CanMerge (const Flow &flow, const Ipv4Header &ipHeader,
+                                const TcpHeader &tcpHeader, uint32_t payloadSize) const
+{
+  const TcpHeader &held = flow.m_tcpHeader;
+  if (tcpHeader.GetSequenceNumber () != held.GetSequenceNumber () + flow.m_payload->GetSize ()
+      || tcpHeader.GetAckNumber () != held.GetAckNumber ()
+      || tcpHeader.GetWindowSize () != held.GetWindowSize ()
+      || tcpHeader.GetLength () != held.GetLength ()
+      || ipHeader.GetTos () != flow.m_ipHeader.GetTos ()
+      || payloadSize > flow.m_segmentSize
+      || flow.m_payload->GetSize () + payloadSize + held.GetSerializedSize ()
+         + flow.m_ipHeader.GetSerializedSize () > 65535)
+    {
+      return false;
+    }
+
+  Ptr<const TcpOptionTS> ts = DynamicCast<const TcpOptionTS> (tcpHeader.GetOption (TcpOption::TS));
+  Ptr<const TcpOptionTS> heldTs = DynamicCast<const TcpOptionTS> (held.GetOption (TcpOption::TS));
+  if ((ts == 0) != (heldTs == 0))
+    {
+      return false;
+    }
+  if (ts != 0 && (ts->GetTimestamp () != heldTs->GetTimestamp () || ts->GetEcho () != heldTs->GetEcho ()))
+    {
+      return false;
+    }
+  return true;
+}
+
+bool
+Ipv4ReceiveCoalescer::Receive (Ptr<Packet> packet, const Ipv4Header &ipHeader)
+{
+  NS_LOG_FUNCTION (this << packet << ipHeader);
+
+  if (ipHeader.GetProtocol () != TcpL4Protocol::PROT_NUMBER
+      || !ipHeader.IsLastFragment () || ipHeader.GetFragmentOffset () != 0)
+    {
+      return false;
+    }
+
+  TcpHeader tcpHeader;
+  if (Node::ChecksumEnabled ())
+    {
+      tcpHeader.EnableChecksums ();
+      tcpHeader.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (),
+                                    TcpL4Protocol::PROT_NUMBER);
+    }
+  packet->PeekHeader (tcpHeader);
+  if (!tcpHeader.IsChecksumOk ())
+    {
+      // Let TcpL4Protocol drop it
+      return false;
+    }
+  // From now on the segment is delivered with a TcpCoalescingTag, so that
+  // TcpL4Protocol does not verify its checksum again
+
+  uint32_t payloadSize = packet->GetSize () - tcpHeader.GetSerializedSize ();
+  uint8_t flags = tcpHeader.GetFlags ();
+  bool mergeable = payloadSize > 0
+    && (flags & TcpHeader::ACK)
+    && (flags & ~(TcpHeader::ACK | TcpHeader::PSH)) == 0
+    && ipHeader.GetEcn () != Ipv4Header::ECN_CE
+    && !tcpHeader.HasOption (TcpOption::SACK);
+
+  FlowKey key;
+  key.m_source = ipHeader.GetSource ();
+  key.m_destination = ipHeader.GetDestination ();
+  key.m_sourcePort = tcpHeader.GetSourcePort ();
+  key.m_destinationPort = tcpHeader.GetDestinationPort ();
+
+  FlowMap::iterator it = m_flows.find (key);
+  if (it != m_flows.end ())
+    {
+      Flow &flow = it->second;
+      if (mergeable && CanMerge (flow, ipHeader, tcpHeader, payloadSize))
+        {
+          packet->RemoveAtStart (tcpHeader.GetSerializedSize ());
+          flow.m_payload->AddAtEnd (packet);
+          flow.m_tcpHeader.SetFlags (flow.m_tcpHeader.GetFlags () | flags);
+          ++flow.m_segments;
+          NS_LOG_LOGIC ("Merged segment " << tcpHeader.GetSequenceNumber () <<
+                        ", flow now holds " << flow.m_segments << " segments");
+          if ((flags & TcpHeader::PSH) || payloadSize < flow.m_segmentSize
+              || flow.m_segments >= m_maxSegments)
+            {
+              Flush (key);
+            }
+          return true;
+        }
+      // Deliver the held data first, so that ordering is preserved
+      Flush (key);
+    }
+
+  if (!mergeable || (flags & TcpHeader::PSH))
+    {
+      packet->AddPacketTag (TcpCoalescingTag (1, payloadSize));
+      return false;
+    }
+
+  Flow flow;
+  flow.m_ipHeader = ipHeader;
+  packet->RemoveHeader (flow.m_tcpHeader);
+  flow.m_payload = packet;
+  flow.m_segments = 1;
+  flow.m_segmentSize = payloadSize;
+  flow.m_timer = Simulator::Schedule (m_timeout, &Ipv4ReceiveCoalescer::Flush, this, key);
+  m_flows.insert (std::make_pair (key, flow));
+  NS_LOG_LOGIC ("Holding segment " << tcpHeader.GetSequenceNumber () << " of size " << payloadSize);
+  return true;
+}
+
+void
+Ipv4ReceiveCoalescer::Flush (FlowKey key)
+{
+  NS_LOG_FUNCTION (this);
+
+  FlowMap::iterator it = m_flows.find (key);
+  if (it == m_flows.end ())
+    {
+      return;
+    }
+  Flow flow = it->second;
+  m_flows.erase (it);
+  flow.m_timer.Cancel ();
+
+  Ptr<Packet> packet = flow.m_payload;
+  const TcpHeader &tcpHeader = flow.m_tcpHeader;
+  // The checksum of every merged segment has been verified on arrival, so
+  // the checksum of the coalesced segment is neither computed nor verified
+  packet->AddPacketTag (TcpCoalescingTag (flow.m_segments, flow.m_segmentSize));
+  packet->AddHeader (tcpHeader);
+
+  Ipv4Header ipHeader = flow.m_ipHeader;
+  ipHeader.SetPayloadSize (packet->GetSize ());
+
+  NS_LOG_LOGIC ("Delivering " << flow.m_segments << " coalesced segments starting at " <<
+                tcpHeader.GetSequenceNumber ());
+  m_deliver (packet, ipHeader);
+}
+
+void
+Ipv4ReceiveCoalescer::FlushAll (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_flows.empty ())
+    {
+      Flush (m_flows.begin ()->first);
+    }
+}
+
+} // namespace ns3
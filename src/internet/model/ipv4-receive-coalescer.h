@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_RECEIVE_COALESCER_H
+#define IPV4_RECEIVE_COALESCER_H
+
+#include <map>
+#include "ns3/object.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
+#include "ns3/ipv4-address.h"
+#include "ipv4-header.h"
+#include "tcp-header.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Packet tag carried by TCP segments built by coalescing
+ *
+ * The tag records how many received segments have been merged and their
+ * size, so that the receiving socket can send the ACKs that the original
+ * segments would have triggered. It also tells TcpL4Protocol that the
+ * checksum of the segment has already been verified.
+ */
+class TcpCoalescingTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpCoalescingTag ();
+
+  /**
+   * \brief Constructor
+   * \param segments number of coalesced segments
+   * \param segmentSize payload size of the coalesced segments
+   */
+  TcpCoalescingTag (uint32_t segments, uint32_t segmentSize);
+
+  /**
+   * \brief Set the number of coalesced segments
+   * \param segments number of coalesced segments
+   */
+  void SetSegments (uint32_t segments);
+
+  /**
+   * \brief Get the number of coalesced segments
+   * \return the number of coalesced segments
+   */
+  uint32_t GetSegments (void) const;
+
+  /**
+   * \brief Set the payload size of the coalesced segments
+   * \param segmentSize payload size of the coalesced segments
+   */
+  void SetSegmentSize (uint32_t segmentSize);
+
+  /**
+   * \brief Get the payload size of the coalesced segments
+   *
+   * All the coalesced segments but the last one have this payload size.
+   *
+   * \return the payload size of the coalesced segments
+   */
+  uint32_t GetSegmentSize (void) const;
+
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+private:
+  uint32_t m_segments;    //!< Number of coalesced segments
+  uint32_t m_segmentSize; //!< Payload size of the coalesced segments
+};
+
+/**
+ * \ingroup ipv4
+ *
+ * \brief Receive-side coalescing of TCP segments (GRO-style)
+ *
+ * An Ipv4ReceiveCoalescer is used by an Ipv4Interface whose
+ * ReceiveCoalescing attribute is set. Consecutive in-order TCP data
+ * segments of the same flow arriving within the Timeout window are merged
+ * into a single segment before being delivered to L4, thus processing them
+ * with a single traversal of the TCP receive path. Only packets that the
+ * routing protocol delivers locally are coalesced: forwarded packets, as
+ * well as the copies passed to raw sockets, are left untouched.
+ *
+ * Only pure data segments (ACK flag, optionally PSH) with identical ACK
+ * number, advertised window, header length and timestamps are merged; a
+ * segment with PSH, a short segment, or MaxSegments merged segments end the
+ * coalescing of a flow. Any other segment of a flow being coalesced (e.g.
+ * a retransmission, a segment with other flags or marked with ECN CE) first
+ * flushes the held data, so ordering is preserved.
+ *
+ * Coalesced segments carry a TcpCoalescingTag with the number and the size
+ * of the merged segments, which TcpSocketBase uses for its delayed ACK
+ * accounting. The coalescer verifies the checksum of every TCP segment it
+ * looks at; the segments it delivers, coalesced or not, carry the tag, and
+ * TcpL4Protocol does not verify their checksum again.
+ */
+class Ipv4ReceiveCoalescer : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Ipv4ReceiveCoalescer ();
+  virtual ~Ipv4ReceiveCoalescer ();
+
+  /**
+   * \brief Callback to deliver packets: packet (without IPv4 header) and IPv4 header
+   */
+  typedef Callback<void, Ptr<Packet>, const Ipv4Header &> DeliverCallback;
+
+  /**
+   * \brief Set the callback used to deliver held packets when they are flushed
+   * \param cb the callback
+   */
+  void SetDeliverCallback (DeliverCallback cb);
+
+  /**
+   * \brief Offer a received packet to the coalescer
+   *
+   * If the packet belongs to a flow being coalesced but cannot be merged,
+   * the held data is delivered through the deliver callback before
+   * returning.
+   *
+   * \param packet the received packet, without IPv4 header
+   * \param ipHeader the IPv4 header of the packet
+   * \return true if the packet has been held (and will be delivered later
+   *         through the deliver callback), false if the caller has to
+   *         process it
+   */
+  bool Receive (Ptr<Packet> packet, const Ipv4Header &ipHeader);
+
+  /**
+   * \brief Deliver all the held packets
+   */
+  void FlushAll (void);
+
+  /**
+   * \brief Get the number of flows being coalesced
+   * \return the number of flows with held data
+   */
+  uint32_t GetNFlows (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Flow identifier: addresses and ports
+   */
+  struct FlowKey
+  {
+    Ipv4Address m_source;       //!< Source address
+    Ipv4Address m_destination;  //!< Destination address
+    uint16_t m_sourcePort;      //!< Source port
+    uint16_t m_destinationPort; //!< Destination port
+
+    /**
+     * \brief Less-than operator
+     * \param other the other key
+     * \return true if this key is less than the other key
+     */
+    bool operator < (const FlowKey &other) const;
+  };
+
+  /**
+   * \brief Data held for a flow
+   */
+  struct Flow
+  {
+    Ptr<Packet> m_payload;     //!< Coalesced payload
+    Ipv4Header m_ipHeader;     //!< IPv4 header of the first segment
+    TcpHeader m_tcpHeader;     //!< TCP header of the first segment
+    uint32_t m_segments;       //!< Number of coalesced segments
+    uint32_t m_segmentSize;    //!< Payload size of the first segment
+    EventId m_timer;           //!< Flush timer
+  };
+
+  /// Container of the flows being coalesced
+  typedef std::map<FlowKey, Flow> FlowMap;
+
+  /**
+   * \brief Check whether a segment can be appended to a flow
+   * \param flow the flow
+   * \param ipHeader IPv4 header of the segment
+   * \param tcpHeader TCP header of the segment
+   * \param payloadSize payload size of the segment
+   * \return true if the segment can be appended
+   */
+  bool CanMerge (const Flow &flow, const Ipv4Header &ipHeader,
+                 const TcpHeader &tcpHeader, uint32_t payloadSize) const;
+
+  /**
+   * \brief Deliver the data held for a flow and forget the flow
+   * \param key the flow
+   */
+  void Flush (FlowKey key);
+
+  FlowMap m_flows;            //!< Flows being coalesced
+  DeliverCallback m_deliver;  //!< Deliver callback
+  Time m_timeout;             //!< Coalescing window
+  uint32_t m_maxSegments;     //!< Maximum number of segments to merge
+};
+
+} // namespace ns3
+
+#endif /* IPV4_RECEIVE_COALESCER_H */
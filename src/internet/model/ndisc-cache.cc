@@ -22,6 +22,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/node.h"
 #include "ns3/names.h"
+#include "ns3/simulator.h"
 
 #include "ipv6-l3-protocol.h" 
 #include "icmpv6-l4-protocol.h"
@@ -94,9 +95,9 @@ NdiscCache::Entry* NdiscCache::Lookup (Ipv6Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
 
-  if (m_ndCache.find (dst) != m_ndCache.end ())
+  NdiscCache::Entry* entry = m_ndCache.Find (dst);
+  if (entry != 0)
     {
-      NdiscCache::Entry* entry = m_ndCache[dst];
       NS_LOG_LOGIC ("Found an entry:" << dst << " to " << entry->GetMacAddress ());
       return entry;
     }
@@ -109,7 +110,7 @@ std::list<NdiscCache::Entry*> NdiscCache::LookupInverse (Address dst)
   NS_LOG_FUNCTION (this << dst);
 
   std::list<NdiscCache::Entry *> entryList;
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  for (CacheI i = m_ndCache.Begin (); i != m_ndCache.End (); i++)
     {
       NdiscCache::Entry *entry = (*i).second;
       if (entry->GetMacAddress () == dst)
@@ -125,11 +126,11 @@ std::list<NdiscCache::Entry*> NdiscCache::LookupInverse (Address dst)
 NdiscCache::Entry* NdiscCache::Add (Ipv6Address to)
 {
   NS_LOG_FUNCTION (this << to);
-  NS_ASSERT (m_ndCache.find (to) == m_ndCache.end ());
+  NS_ASSERT (m_ndCache.Find (to) == 0);
 
   NdiscCache::Entry* entry = new NdiscCache::Entry (this);
   entry->SetIpv6Address (to);
-  m_ndCache[to] = entry;
+  m_ndCache.Insert (to, entry);
   return entry;
 }
 
@@ -137,15 +138,11 @@ void NdiscCache::Remove (NdiscCache::Entry* entry)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  if (m_ndCache.Find (entry->GetIpv6Address ()) == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_ndCache.erase (i);
-          entry->ClearWaitingPacket ();
-          delete entry;
-          return;
-        }
+      m_ndCache.Erase (entry->GetIpv6Address ());
+      entry->ClearWaitingPacket ();
+      delete entry;
     }
 }
 
@@ -153,12 +150,44 @@ void NdiscCache::Flush ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  for (CacheI i = m_ndCache.Begin (); i != m_ndCache.End (); i++)
     {
       delete (*i).second; /* delete the pointer NdiscCache::Entry */
     }
 
-  m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
+  m_ndCache.Clear ();
+  m_nudTimer.Cancel ();
+}
+
+void NdiscCache::StartNudTimer ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Time deadline;
+  if (!m_ndCache.GetNextDeadline (deadline))
+    {
+      m_nudTimer.Cancel ();
+      return;
+    }
+  if (m_nudTimer.IsRunning ()
+      && m_nudTimer.GetTs () == static_cast<uint64_t> (deadline.GetTimeStep ()))
+    {
+      return;
+    }
+  m_nudTimer.Cancel ();
+  m_nudTimer = Simulator::Schedule (deadline - Simulator::Now (), &NdiscCache::HandleNudTimeout, this);
+}
+
+void NdiscCache::HandleNudTimeout ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ipv6Address address;
+  while (m_ndCache.PopExpired (Simulator::Now (), address))
+    {
+      NdiscCache::Entry* entry = m_ndCache.Find (address);
+      NS_LOG_LOGIC ("NUD timeout for " << address);
+      (entry->*(entry->m_nudFunction)) ();
+    }
+  StartNudTimer ();
 }
 
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
@@ -178,7 +207,7 @@ void NdiscCache::PrintNdiscCache (Ptr<OutputStreamWrapper> stream)
   NS_LOG_FUNCTION (this << stream);
   std::ostream* os = stream->GetStream ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  for (CacheI i = m_ndCache.Begin (); i != m_ndCache.End (); i++)
     {
       *os << i->first << " dev ";
       std::string found = Names::FindName (m_device);
@@ -228,7 +257,7 @@ NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_nudTimer (Timer::CANCEL_ON_DESTROY),
+    m_nudFunction (0),
     m_lastReachabilityConfirmation (Seconds (0.0)),
     m_nsRetransmit (0)
 {
@@ -408,84 +437,73 @@ void NdiscCache::Entry::SetIpv6Address (Ipv6Address ipv6Address)
   m_ipv6Address = ipv6Address;
 }
 
+Ipv6Address NdiscCache::Entry::GetIpv6Address () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return m_ipv6Address;
+}
+
 Time NdiscCache::Entry::GetLastReachabilityConfirmation () const
 {
   NS_LOG_FUNCTION_NOARGS ();
   return m_lastReachabilityConfirmation;
 }
 
-void NdiscCache::Entry::StartReachableTimer ()
+void NdiscCache::Entry::ArmNudTimer (void (NdiscCache::Entry::*function) (), Time delay)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
+  NS_LOG_FUNCTION (this << delay);
+  m_nudFunction = function;
+  m_nudDelay = delay;
+  if (m_ndCache->m_ndCache.SetDeadline (m_ipv6Address, Simulator::Now () + delay))
     {
-      m_nudTimer.Cancel ();
+      m_ndCache->StartNudTimer ();
     }
+  // else the deadline has been postponed: the cache timer fires at the
+  // previous deadline and is then re-armed at the next one
+}
 
+void NdiscCache::Entry::StartReachableTimer ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
   m_lastReachabilityConfirmation = Simulator::Now ();
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetReachableTime ());
-  m_nudTimer.Schedule ();
+  ArmNudTimer (&NdiscCache::Entry::FunctionReachableTimeout, m_ndCache->m_icmpv6->GetReachableTime ());
 }
 
 void NdiscCache::Entry::UpdateReachableTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  if (m_state == REACHABLE)
+  if (m_state == REACHABLE && m_nudFunction != 0)
     {
       m_lastReachabilityConfirmation = Simulator::Now ();
-      if (m_nudTimer.IsRunning ())
-        {
-          m_nudTimer.Cancel ();
-        }
-      m_nudTimer.Schedule ();
+      // postponing the deadline neither touches the heap of deadlines nor
+      // reschedules the cache timer
+      ArmNudTimer (m_nudFunction, m_nudDelay);
     }
 }
 
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetRetransmissionTime ());
-  m_nudTimer.Schedule ();
+  ArmNudTimer (&NdiscCache::Entry::FunctionProbeTimeout, m_ndCache->m_icmpv6->GetRetransmissionTime ());
 }
 
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetDelayFirstProbe ());
-  m_nudTimer.Schedule ();
+  ArmNudTimer (&NdiscCache::Entry::FunctionDelayTimeout, m_ndCache->m_icmpv6->GetDelayFirstProbe ());
 }
 
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_nudTimer.SetDelay (m_ndCache->m_icmpv6->GetRetransmissionTime ());
-  m_nudTimer.Schedule ();
+  ArmNudTimer (&NdiscCache::Entry::FunctionRetransmitTimeout, m_ndCache->m_icmpv6->GetRetransmissionTime ());
 }
 
 void NdiscCache::Entry::StopNudTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_nudTimer.Cancel ();
+  m_ndCache->m_ndCache.ClearDeadline (m_ipv6Address);
   m_nsRetransmit = 0;
 }
 
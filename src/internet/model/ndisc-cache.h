@@ -29,9 +29,9 @@
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
-#include "ns3/sgi-hashmap.h"
+#include "ns3/simulator.h"
 #include "ns3/output-stream-wrapper.h"
+#include "neighbor-cache-table.h"
 
 namespace ns3
 {
@@ -342,7 +342,29 @@ public:
      */
     void SetIpv6Address (Ipv6Address ipv6Address);
 
+    /**
+     * \brief Get the IPv6 address.
+     * \return IPv6 address
+     */
+    Ipv6Address GetIpv6Address () const;
+
 private:
+    /// The cache runs the NUD timers of its entries
+    friend class NdiscCache;
+
+    /**
+     * \brief Arm the NUD timer.
+     *
+     * The deadline is held by the cache, which runs a single timer for all
+     * of its entries. The cache timer is rescheduled only if the deadline
+     * can be earlier than the next one; a postponed deadline lets the timer
+     * fire early and re-arm itself.
+     *
+     * \param function function to call when the timer expires
+     * \param delay timer delay
+     */
+    void ArmNudTimer (void (NdiscCache::Entry::*function) (), Time delay);
+
     /**
      * \brief The IPv6 address.
      */
@@ -387,9 +409,14 @@ private:
     bool m_router;
 
     /**
-     * \brief Timer (used for NUD).
+     * \brief Function called when the NUD timer expires.
+     */
+    void (NdiscCache::Entry::*m_nudFunction) ();
+
+    /**
+     * \brief Delay of the NUD timer.
      */
-    Timer m_nudTimer;
+    Time m_nudDelay;
 
     /**
      * \brief Last time we see a reachability confirmation.
@@ -406,11 +433,11 @@ private:
   /**
    * \brief Neighbor Discovery Cache container
    */
-  typedef sgi::hash_map<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash> Cache;
+  typedef NeighborCacheTable<Ipv6Address, NdiscCache::Entry, Ipv6AddressHash> Cache;
   /**
    * \brief Neighbor Discovery Cache container iterator
    */
-  typedef sgi::hash_map<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash>::iterator CacheI;
+  typedef Cache::Iterator CacheI;
 
   /**
    * \brief Copy constructor.
@@ -432,6 +459,16 @@ private:
    */
   void DoDispose ();
 
+  /**
+   * \brief Schedule the cache timer at the earliest NUD deadline.
+   */
+  void StartNudTimer ();
+
+  /**
+   * \brief Handle the NUD timeout of the entries whose deadline expired.
+   */
+  void HandleNudTimeout ();
+
   /**
    * \brief The NetDevice.
    */
@@ -452,6 +489,11 @@ private:
    */
   Cache m_ndCache;
 
+  /**
+   * \brief Timer for the NUD deadlines of all the entries.
+   */
+  EventId m_nudTimer;
+
   /**
    * \brief Max number of packet stored in m_waiting.
    */
@@ -0,0 +1,503 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NEIGHBOR_CACHE_TABLE_H
+#define NEIGHBOR_CACHE_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <functional>
+#include "ns3/assert.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Flat table of neighbor cache entries with per-entry deadlines
+ *
+ * The table maps an address to an entry pointer with open addressing
+ * (linear probing over a power-of-two array, backward-shift deletion), so
+ * that lookups, insertions and removals never allocate nor walk the table.
+ * The table does not own the entries.
+ *
+ * Each entry may also have a deadline. Deadlines are kept in a min-heap
+ * whose stale items are discarded lazily: moving a deadline later (e.g.,
+ * refreshing a reachability timer) is O(1), and only the entries whose
+ * deadline has expired are returned by PopExpired. The owner of the table
+ * is expected to schedule a single event at GetNextDeadline.
+ *
+ * \tparam Key the address type
+ * \tparam Value the entry type
+ * \tparam Hash the hash functor of the address type
+ */
+template <typename Key, typename Value, typename Hash>
+class NeighborCacheTable
+{
+public:
+  /**
+   * \brief A slot of the table
+   *
+   * The first and second members mimic a std::pair, so that the table can
+   * be iterated like a map. A slot is empty when second is null.
+   */
+  struct Slot
+  {
+    Key first;              //!< Address
+    Value *second;          //!< Entry
+    Time m_deadline;        //!< Entry deadline
+    uint64_t m_queuedId;    //!< Id of the heap item representing the deadline
+    Time m_queuedDeadline;  //!< Time of the heap item representing the deadline
+    bool m_armed;           //!< True if the deadline is set
+    bool m_queued;          //!< True if a heap item represents the deadline
+
+    Slot ()
+      : second (0),
+        m_queuedId (0),
+        m_armed (false),
+        m_queued (false)
+    {
+    }
+  };
+
+  /**
+   * \brief Iterator over the non-empty slots
+   */
+  class Iterator
+  {
+public:
+    /**
+     * \brief Constructor
+     * \param slots the slots
+     * \param index the first slot to consider
+     * \param capacity the number of slots
+     */
+    Iterator (Slot *slots, uint32_t index, uint32_t capacity)
+      : m_slots (slots),
+        m_index (index),
+        m_capacity (capacity)
+    {
+      Skip ();
+    }
+    /**
+     * \brief Dereference operator
+     * \return the slot
+     */
+    Slot & operator* (void) const
+    {
+      return m_slots[m_index];
+    }
+    /**
+     * \brief Member access operator
+     * \return the slot
+     */
+    Slot * operator-> (void) const
+    {
+      return &m_slots[m_index];
+    }
+    /**
+     * \brief Increment operator (postfix)
+     * \return the iterator before the increment
+     */
+    Iterator operator++ (int)
+    {
+      Iterator tmp = *this;
+      m_index++;
+      Skip ();
+      return tmp;
+    }
+    /**
+     * \brief Increment operator (prefix)
+     * \return the incremented iterator
+     */
+    Iterator & operator++ (void)
+    {
+      m_index++;
+      Skip ();
+      return *this;
+    }
+    /**
+     * \brief Equality operator
+     * \param o the other iterator
+     * \return true if the iterators point to the same slot
+     */
+    bool operator== (const Iterator &o) const
+    {
+      return m_index == o.m_index;
+    }
+    /**
+     * \brief Inequality operator
+     * \param o the other iterator
+     * \return true if the iterators point to different slots
+     */
+    bool operator!= (const Iterator &o) const
+    {
+      return m_index != o.m_index;
+    }
+private:
+    /// Move to the next non-empty slot
+    void Skip (void)
+    {
+      while (m_index < m_capacity && m_slots[m_index].second == 0)
+        {
+          m_index++;
+        }
+    }
+    Slot *m_slots;        //!< Slots
+    uint32_t m_index;     //!< Current slot
+    uint32_t m_capacity;  //!< Number of slots
+  };
+
+  NeighborCacheTable ()
+    : m_size (0),
+      m_bits (0),
+      m_nextId (0)
+  {
+  }
+
+  /**
+   * \return an iterator to the first entry
+   */
+  Iterator Begin (void)
+  {
+    return Iterator (m_slots.empty () ? 0 : &m_slots[0], 0, m_slots.size ());
+  }
+
+  /**
+   * \return an iterator past the last entry
+   */
+  Iterator End (void)
+  {
+    return Iterator (m_slots.empty () ? 0 : &m_slots[0], m_slots.size (), m_slots.size ());
+  }
+
+  /**
+   * \return the number of entries
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_size;
+  }
+
+  /**
+   * \return the number of slots
+   */
+  uint32_t GetCapacity (void) const
+  {
+    return m_slots.size ();
+  }
+
+  /**
+   * \brief Look up an entry
+   * \param key the address
+   * \return the entry, or null if not found
+   */
+  Value * Find (const Key &key) const
+  {
+    const Slot *slot = FindSlot (key);
+    return slot == 0 ? 0 : slot->second;
+  }
+
+  /**
+   * \brief Add an entry
+   *
+   * The address must not be in the table already.
+   *
+   * \param key the address
+   * \param value the entry
+   */
+  void Insert (const Key &key, Value *value)
+  {
+    NS_ASSERT (value != 0);
+    NS_ASSERT (FindSlot (key) == 0);
+    if (4 * (m_size + 1) > 3 * m_slots.size ())
+      {
+        Grow ();
+      }
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t i = GetHome (key);
+    while (m_slots[i].second != 0)
+      {
+        i = (i + 1) & mask;
+      }
+    m_slots[i] = Slot ();
+    m_slots[i].first = key;
+    m_slots[i].second = value;
+    m_size++;
+  }
+
+  /**
+   * \brief Remove an entry and its deadline
+   * \param key the address
+   * \return true if the entry was found
+   */
+  bool Erase (const Key &key)
+  {
+    Slot *slot = FindSlot (key);
+    if (slot == 0)
+      {
+        return false;
+      }
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t hole = slot - &m_slots[0];
+    uint32_t j = hole;
+    while (true)
+      {
+        j = (j + 1) & mask;
+        if (m_slots[j].second == 0)
+          {
+            break;
+          }
+        uint32_t home = GetHome (m_slots[j].first);
+        // move the slot back if its home is not cyclically in (hole, j]
+        bool inRange = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!inRange)
+          {
+            m_slots[hole] = m_slots[j];
+            hole = j;
+          }
+      }
+    m_slots[hole] = Slot ();
+    m_size--;
+    return true;
+  }
+
+  /**
+   * \brief Remove all the entries and deadlines
+   */
+  void Clear (void)
+  {
+    m_slots.clear ();
+    m_size = 0;
+    m_bits = 0;
+    m_deadlines = DeadlineQueue ();
+  }
+
+  /**
+   * \brief Set (or move) the deadline of an entry
+   *
+   * Postponing a queued deadline only updates the entry: the earlier heap
+   * item is met first, and GetNextDeadline re-queues the entry then. The
+   * event scheduled by the owner at the previous earliest deadline is still
+   * early enough, and does not need to be moved.
+   *
+   * \param key the address of the entry
+   * \param deadline the absolute deadline
+   * \return true if the deadline has been queued, i.e., if it can be
+   * earlier than the next deadline returned before
+   */
+  bool SetDeadline (const Key &key, Time deadline)
+  {
+    Slot *slot = FindSlot (key);
+    NS_ASSERT_MSG (slot != 0, "No entry for the deadline");
+    slot->m_deadline = deadline;
+    slot->m_armed = true;
+    if (!slot->m_queued || deadline < slot->m_queuedDeadline)
+      {
+        Enqueue (*slot);
+        return true;
+      }
+    return false;
+  }
+
+  /**
+   * \brief Clear the deadline of an entry
+   * \param key the address of the entry
+   */
+  void ClearDeadline (const Key &key)
+  {
+    Slot *slot = FindSlot (key);
+    if (slot != 0)
+      {
+        slot->m_armed = false;
+      }
+  }
+
+  /**
+   * \brief Get the earliest deadline
+   * \param [out] deadline the earliest deadline
+   * \return false if no entry has a deadline
+   */
+  bool GetNextDeadline (Time &deadline)
+  {
+    while (!m_deadlines.empty ())
+      {
+        const QueueItem &top = m_deadlines.top ();
+        Slot *slot = FindSlot (top.m_key);
+        if (slot == 0 || !slot->m_queued || slot->m_queuedId != top.m_id)
+          {
+            // stale item
+            m_deadlines.pop ();
+            continue;
+          }
+        if (!slot->m_armed || slot->m_deadline > top.m_deadline)
+          {
+            // cleared or postponed deadline
+            m_deadlines.pop ();
+            slot->m_queued = false;
+            if (slot->m_armed)
+              {
+                Enqueue (*slot);
+              }
+            continue;
+          }
+        deadline = top.m_deadline;
+        return true;
+      }
+    return false;
+  }
+
+  /**
+   * \brief Remove the deadline of the next expired entry
+   * \param now the current time
+   * \param [out] key the address of the expired entry
+   * \return false if no deadline has expired
+   */
+  bool PopExpired (Time now, Key &key)
+  {
+    Time deadline;
+    if (!GetNextDeadline (deadline) || deadline > now)
+      {
+        return false;
+      }
+    key = m_deadlines.top ().m_key;
+    m_deadlines.pop ();
+    Slot *slot = FindSlot (key);
+    slot->m_queued = false;
+    slot->m_armed = false;
+    return true;
+  }
+
+private:
+  /**
+   * \brief Heap item: a deadline of an entry
+   */
+  struct QueueItem
+  {
+    Time m_deadline;  //!< Deadline
+    uint64_t m_id;    //!< Unique id, also breaks ties in insertion order
+    Key m_key;        //!< Address of the entry
+
+    /**
+     * \brief Greater-than operator
+     * \param o the other item
+     * \return true if this item expires after the other one
+     */
+    bool operator> (const QueueItem &o) const
+    {
+      if (m_deadline != o.m_deadline)
+        {
+          return m_deadline > o.m_deadline;
+        }
+      return m_id > o.m_id;
+    }
+  };
+
+  /// Min-heap of deadlines
+  typedef std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > DeadlineQueue;
+
+  /**
+   * \brief Queue the deadline of a slot
+   * \param slot the slot
+   */
+  void Enqueue (Slot &slot)
+  {
+    QueueItem item;
+    item.m_deadline = slot.m_deadline;
+    item.m_id = m_nextId++;
+    item.m_key = slot.first;
+    m_deadlines.push (item);
+    slot.m_queued = true;
+    slot.m_queuedId = item.m_id;
+    slot.m_queuedDeadline = item.m_deadline;
+  }
+
+  /**
+   * \brief Get the home slot of an address (Fibonacci hashing)
+   * \param key the address
+   * \return the index of the home slot
+   */
+  uint32_t GetHome (const Key &key) const
+  {
+    uint64_t h = static_cast<uint64_t> (Hash () (key)) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<uint32_t> (h >> (64 - m_bits));
+  }
+
+  /**
+   * \brief Find the slot of an address
+   * \param key the address
+   * \return the slot, or null if not found
+   */
+  Slot * FindSlot (const Key &key)
+  {
+    return const_cast<Slot *> (static_cast<const NeighborCacheTable *> (this)->FindSlot (key));
+  }
+
+  /**
+   * \brief Find the slot of an address
+   * \param key the address
+   * \return the slot, or null if not found
+   */
+  const Slot * FindSlot (const Key &key) const
+  {
+    if (m_size == 0)
+      {
+        return 0;
+      }
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t i = GetHome (key); m_slots[i].second != 0; i = (i + 1) & mask)
+      {
+        if (m_slots[i].first == key)
+          {
+            return &m_slots[i];
+          }
+      }
+    return 0;
+  }
+
+  /// Double the number of slots and rehash
+  void Grow (void)
+  {
+    std::vector<Slot> old;
+    old.swap (m_slots);
+    m_bits = m_bits == 0 ? 4 : m_bits + 1;
+    m_slots.resize (1u << m_bits);
+    uint32_t mask = m_slots.size () - 1;
+    for (typename std::vector<Slot>::const_iterator it = old.begin (); it != old.end (); it++)
+      {
+        if (it->second != 0)
+          {
+            uint32_t i = GetHome (it->first);
+            while (m_slots[i].second != 0)
+              {
+                i = (i + 1) & mask;
+              }
+            m_slots[i] = *it;
+          }
+      }
+  }
+
+  std::vector<Slot> m_slots;   //!< Slots
+  uint32_t m_size;             //!< Number of entries
+  uint32_t m_bits;             //!< Log2 of the number of slots
+  DeadlineQueue m_deadlines;   //!< Deadlines
+  uint64_t m_nextId;           //!< Id of the next heap item
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_CACHE_TABLE_H */
@@ -37,9 +37,11 @@
 #include "ipv4-end-point.h"
 #include "ipv6-end-point.h"
 #include "ipv4-l3-protocol.h"
+#include "ipv4-receive-coalescer.h"
 #include "ipv6-l3-protocol.h"
 #include "ipv6-routing-protocol.h"
 #include "tcp-socket-factory-impl.h"
+#include "tcp-segmentation-offload.h"
 #include "tcp-socket-base.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-recovery-ops.h"
@@ -129,6 +131,7 @@ TcpL4Protocol::NotifyNewAggregate ()
           Ptr<TcpSocketFactoryImpl> tcpFactory = CreateObject<TcpSocketFactoryImpl> ();
           tcpFactory->SetTcp (this);
           node->AggregateObject (tcpFactory);
+          node->AggregateObject (CreateObject<TcpSegmentationOffload> ());
         }
     }
 
@@ -370,7 +373,10 @@ TcpL4Protocol::PacketReceived (Ptr<Packet> packet, TcpHeader &incomingTcpHeader,
 {
   NS_LOG_FUNCTION (this << packet << incomingTcpHeader << source << destination);
 
-  if (Node::ChecksumEnabled ())
+  // The receive coalescer has already verified the checksum of the
+  // segments it tags
+  TcpCoalescingTag coalescingTag;
+  if (Node::ChecksumEnabled () && !packet->PeekPacketTag (coalescingTag))
     {
       incomingTcpHeader.EnableChecksums ();
       incomingTcpHeader.InitializeChecksum (source, destination, PROT_NUMBER);
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-segmentation-offload.h"
+#include "tcp-header.h"
+#include "tcp-l4-protocol.h"
+#include "ipv4-header.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSegmentationOffload");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSegmentationOffloadTag);
+NS_OBJECT_ENSURE_REGISTERED (TcpSegmentationOffload);
+
+TypeId
+TcpSegmentationOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSegmentationOffloadTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpSegmentationOffloadTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpSegmentationOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+TcpSegmentationOffloadTag::TcpSegmentationOffloadTag ()
+  : m_segmentSize (0)
+{
+}
+
+TcpSegmentationOffloadTag::TcpSegmentationOffloadTag (uint16_t segmentSize)
+  : m_segmentSize (segmentSize)
+{
+}
+
+void
+TcpSegmentationOffloadTag::SetSegmentSize (uint16_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+uint16_t
+TcpSegmentationOffloadTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+uint32_t
+TcpSegmentationOffloadTag::GetSerializedSize (void) const
+{
+  return 2;
+}
+
+void
+TcpSegmentationOffloadTag::Serialize (TagBuffer i) const
+{
+  i.WriteU16 (m_segmentSize);
+}
+
+void
+TcpSegmentationOffloadTag::Deserialize (TagBuffer i)
+{
+  m_segmentSize = i.ReadU16 ();
+}
+
+void
+TcpSegmentationOffloadTag::Print (std::ostream &os) const
+{
+  os << "SegmentSize=" << m_segmentSize;
+}
+
+TypeId
+TcpSegmentationOffload::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSegmentationOffload")
+    .SetParent<SegmentationOffload> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpSegmentationOffload> ()
+  ;
+  return tid;
+}
+
+TcpSegmentationOffload::TcpSegmentationOffload ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpSegmentationOffload::~TcpSegmentationOffload ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+TcpSegmentationOffload::Segment (Ptr<const Packet> packet, std::list<Ptr<Packet> > &segments)
+{
+  NS_LOG_FUNCTION (this << packet);
+
+  TcpSegmentationOffloadTag tag;
+  if (!packet->PeekPacketTag (tag) || tag.GetSegmentSize () == 0)
+    {
+      return false;
+    }
+
+  Ptr<Packet> p = packet->Copy ();
+  p->RemovePacketTag (tag);
+
+  Ipv4Header ipHeader;
+  p->RemoveHeader (ipHeader);
+  NS_ASSERT (ipHeader.GetProtocol () == TcpL4Protocol::PROT_NUMBER);
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+
+  uint32_t payloadSize = p->GetSize ();
+  uint32_t segmentSize = tag.GetSegmentSize ();
+  uint8_t flags = tcpHeader.GetFlags ();
+  uint16_t identification = ipHeader.GetIdentification ();
+
+  NS_LOG_LOGIC ("Splitting " << payloadSize << " bytes starting at seq " <<
+                tcpHeader.GetSequenceNumber () << " in segments of " << segmentSize);
+
+  for (uint32_t offset = 0; offset < payloadSize; offset += segmentSize)
+    {
+      uint32_t size = std::min (segmentSize, payloadSize - offset);
+      Ptr<Packet> segment = p->CreateFragment (offset, size);
+
+      TcpHeader segmentTcpHeader = tcpHeader;
+      uint8_t segmentFlags = flags;
+      if (offset != 0)
+        {
+          segmentFlags &= ~TcpHeader::CWR;
+        }
+      if (offset + size < payloadSize)
+        {
+          segmentFlags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+        }
+      segmentTcpHeader.SetFlags (segmentFlags);
+      segmentTcpHeader.SetSequenceNumber (tcpHeader.GetSequenceNumber () + offset);
+      if (Node::ChecksumEnabled ())
+        {
+          segmentTcpHeader.EnableChecksums ();
+        }
+      segmentTcpHeader.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (),
+                                           TcpL4Protocol::PROT_NUMBER);
+      segment->AddHeader (segmentTcpHeader);
+
+      Ipv4Header segmentIpHeader = ipHeader;
+      segmentIpHeader.SetPayloadSize (segment->GetSize ());
+      segmentIpHeader.SetIdentification (identification++);
+      if (Node::ChecksumEnabled ())
+        {
+          segmentIpHeader.EnableChecksum ();
+        }
+      segment->AddHeader (segmentIpHeader);
+
+      segments.push_back (segment);
+    }
+  return true;
+}
+
+uint32_t
+TcpSegmentationOffload::GetNSegments (Ptr<const Packet> packet)
+{
+  TcpSegmentationOffloadTag tag;
+  if (!packet->PeekPacketTag (tag) || tag.GetSegmentSize () == 0)
+    {
+      return 1;
+    }
+  TcpHeader tcpHeader;
+  packet->PeekHeader (tcpHeader);
+  uint32_t payloadSize = packet->GetSize () - tcpHeader.GetSerializedSize ();
+  uint32_t segmentSize = tag.GetSegmentSize ();
+  return std::max<uint32_t> (1, (payloadSize + segmentSize - 1) / segmentSize);
+}
+
+} // namespace ns3
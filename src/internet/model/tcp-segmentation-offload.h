@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_SEGMENTATION_OFFLOAD_H
+#define TCP_SEGMENTATION_OFFLOAD_H
+
+#include "ns3/tag.h"
+#include "ns3/segmentation-offload.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Packet tag marking a TCP super-segment.
+ *
+ * TcpSocketBase adds this tag to data packets carrying more than one
+ * segment worth of payload when segmentation offload is enabled. The tag
+ * records the segment size to use when the super-segment is split.
+ */
+class TcpSegmentationOffloadTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpSegmentationOffloadTag ();
+
+  /**
+   * \brief Constructor
+   * \param segmentSize the segment size (MSS) of the resulting segments
+   */
+  TcpSegmentationOffloadTag (uint16_t segmentSize);
+
+  /**
+   * \brief Set the segment size of the resulting segments
+   * \param segmentSize the segment size (MSS)
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+
+  /**
+   * \brief Get the segment size of the resulting segments
+   * \return the segment size (MSS)
+   */
+  uint16_t GetSegmentSize (void) const;
+
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+private:
+  uint16_t m_segmentSize; //!< Segment size of the resulting segments
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Splits IPv4 TCP super-segments into MSS-sized segments.
+ *
+ * Each resulting segment carries a copy of the original TCP header with
+ * its sequence number advanced by the payload offset. CWR is kept on the
+ * first segment only, PSH and FIN on the last one. The IPv4 identification
+ * is incremented per segment, from the identification of the super-segment:
+ * Ipv4L3Protocol reserves GetNSegments () identifications when it builds
+ * the header of the super-segment. Both checksums are recomputed.
+ *
+ * An instance is aggregated to the node by TcpL4Protocol. It is used by
+ * NetDevices supporting segmentation offload, and by Ipv4L3Protocol as
+ * software fallback for devices that do not.
+ */
+class TcpSegmentationOffload : public SegmentationOffload
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpSegmentationOffload ();
+  virtual ~TcpSegmentationOffload ();
+
+  virtual bool Segment (Ptr<const Packet> packet, std::list<Ptr<Packet> > &segments);
+
+  /**
+   * \brief Get the number of segments a TCP packet is split into.
+   * \param packet the packet, starting with its TCP header
+   * \return the number of segments of a super-segment, or 1 for another packet
+   */
+  static uint32_t GetNSegments (Ptr<const Packet> packet);
+};
+
+} // namespace ns3
+
+#endif /* TCP_SEGMENTATION_OFFLOAD_H */
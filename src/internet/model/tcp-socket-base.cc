@@ -44,6 +44,8 @@
 #include "ns3/data-rate.h"
 #include "ns3/object.h"
 #include "tcp-socket-base.h"
+#include "tcp-segmentation-offload.h"
+#include "ipv4-receive-coalescer.h"
 #include "tcp-l4-protocol.h"
 #include "ipv4-end-point.h"
 #include "ipv6-end-point.h"
@@ -69,6 +71,9 @@ NS_LOG_COMPONENT_DEFINE ("TcpSocketBase");
 
 NS_OBJECT_ENSURE_REGISTERED (TcpSocketBase);
 
+/// Largest super-segment payload: an IPv4 datagram with maximum-size headers
+static const uint32_t MAX_TSO_SIZE = 65535 - 20 - 60;
+
 TypeId
 TcpSocketBase::GetTypeId (void)
 {
@@ -142,6 +147,19 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_limitedTx),
                    MakeBooleanChecker ())
+    .AddAttribute ("SegmentationOffload",
+                   "Enable segmentation offload: new data is handed down as "
+                   "super-segments of several MSS that are split by the NetDevice "
+                   "(or by IPv4 in software) right before transmission. "
+                   "Only used for IPv4 connections without pacing.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_tso),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxOffloadSegments",
+                   "Maximum number of MSS-sized segments in a super-segment",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&TcpSocketBase::m_tsoMaxSegments),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("EcnMode", "Determines the mode of ECN",
                    EnumValue (EcnMode_t::NoEcn),
                    MakeEnumAccessor (&TcpSocketBase::m_ecnMode),
@@ -331,6 +349,8 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
+    m_tso (sock.m_tso),
+    m_tsoMaxSegments (sock.m_tsoMaxSegments),
     m_isFirstPartialAck (sock.m_isFirstPartialAck),
     m_txTrace (sock.m_txTrace),
     m_rxTrace (sock.m_rxTrace),
@@ -2504,6 +2524,13 @@ void
 TcpSocketBase::SendEmptyPacket (uint8_t flags)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (flags));
+  DoSendEmptyPacket (flags, m_rxBuffer->NextRxSequence ());
+}
+
+void
+TcpSocketBase::DoSendEmptyPacket (uint8_t flags, SequenceNumber32 ackNumber)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (flags) << ackNumber);
 
   if (m_endPoint == nullptr && m_endPoint6 == nullptr)
     {
@@ -2528,7 +2555,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
 
   header.SetFlags (flags);
   header.SetSequenceNumber (s);
-  header.SetAckNumber (m_rxBuffer->NextRxSequence ());
+  header.SetAckNumber (ackNumber);
   if (m_endPoint != nullptr)
     {
       header.SetSourcePort (m_endPoint->GetLocalPort ());
@@ -2545,6 +2572,13 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
   m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
 
   uint16_t windowSize = AdvertisedWindowSize ();
+  if (ackNumber < m_rxBuffer->NextRxSequence () && !m_rxBuffer->GotFin ())
+    {
+      // Acknowledging only part of the received data: keep the right edge
+      // of the window where the full acknowledgment would put it
+      uint32_t w = static_cast<uint32_t> (m_rxBuffer->MaxRxSequence () - ackNumber) >> m_rcvWindShift;
+      windowSize = static_cast<uint16_t> (std::min<uint32_t> (w, m_maxWinSize));
+    }
   bool hasSyn = flags & TcpHeader::SYN;
   bool hasFin = flags & TcpHeader::FIN;
   bool isAck = flags == TcpHeader::ACK;
@@ -2599,7 +2633,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
         {
           AddOptionSack (header);
         }
-      NS_LOG_INFO ("Sending a pure ACK, acking seq " << m_rxBuffer->NextRxSequence ());
+      NS_LOG_INFO ("Sending a pure ACK, acking seq " << ackNumber);
     }
 
   m_txTrace (p, header, this);
@@ -2878,12 +2912,24 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
   NS_LOG_FUNCTION (this << seq << maxSize << withAck);
 
   bool isStartOfTransmission = BytesInFlight () == 0U;
-  TcpTxItem *outItem = m_txBuffer->CopyFromSequence (maxSize, seq);
+  TcpTxItem *outItem = m_txBuffer->CopyFromSequence (std::min (maxSize, m_tcb->m_segmentSize), seq);
 
   m_rateOps->SkbSent(outItem, isStartOfTransmission);
 
   bool isRetransmission = outItem->IsRetrans ();
   Ptr<Packet> p = outItem->GetPacketCopy ();
+
+  // A super-segment is assembled from MSS-sized items, so that the
+  // scoreboard keeps the same granularity as without segmentation offload
+  while (!isRetransmission && p->GetSize () < maxSize
+         && m_txBuffer->SizeFromSequence (seq + SequenceNumber32 (p->GetSize ())) > 0)
+    {
+      uint32_t remaining = std::min (maxSize - p->GetSize (), m_tcb->m_segmentSize);
+      outItem = m_txBuffer->CopyFromSequence (remaining, seq + SequenceNumber32 (p->GetSize ()));
+      m_rateOps->SkbSent (outItem, false);
+      p->AddAtEnd (outItem->GetPacketCopy ());
+    }
+
   uint32_t sz = p->GetSize (); // Size of packet
   uint8_t flags = withAck ? TcpHeader::ACK : 0;
   uint32_t remainingData = m_txBuffer->SizeFromSequence (seq + SequenceNumber32 (sz));
@@ -2931,6 +2977,13 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   AddSocketTags (p);
 
+  if (sz > m_tcb->m_segmentSize)
+    {
+      NS_LOG_LOGIC ("Super-segment of " << sz << " bytes, to be split in segments of " <<
+                    m_tcb->m_segmentSize);
+      p->AddPacketTag (TcpSegmentationOffloadTag (static_cast<uint16_t> (m_tcb->m_segmentSize)));
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -3120,6 +3173,20 @@ TcpSocketBase::SendPendingData (bool withAck)
 
           uint32_t s = std::min (availableWindow, m_tcb->m_segmentSize);
 
+          // With segmentation offload, new data is sent as a super-segment
+          // made of as many whole segments as the window allows
+          if (m_tso && m_endPoint != nullptr && !m_tcb->m_pacing
+              && next == m_tcb->m_highTxMark.Get ())
+            {
+              uint32_t segments = std::min (availableWindow, availableData) / m_tcb->m_segmentSize;
+              segments = std::min (segments, m_tsoMaxSegments);
+              segments = std::min (segments, MAX_TSO_SIZE / m_tcb->m_segmentSize);
+              if (segments > 1)
+                {
+                  s = segments * m_tcb->m_segmentSize;
+                }
+            }
+
           // (C.2) If any of the data octets sent in (C.1) are below HighData,
           //       HighRxt MUST be set to the highest sequence number of the
           //       retransmitted segment unless NextSeg () rule (4) was
@@ -3273,6 +3340,17 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
   NS_LOG_DEBUG ("Data segment, seq=" << tcpHeader.GetSequenceNumber () <<
                 " pkt size=" << p->GetSize () );
 
+  // A segment built by receive-side coalescing accounts for all the
+  // segments it is made of when deciding whether to delay the ACK
+  uint32_t segments = 1;
+  uint32_t segmentSize = p->GetSize ();
+  TcpCoalescingTag coalescingTag;
+  if (p->RemovePacketTag (coalescingTag))
+    {
+      segments = coalescingTag.GetSegments ();
+      segmentSize = coalescingTag.GetSegmentSize ();
+    }
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer->NextRxSequence ();
   if (!m_rxBuffer->Add (p, tcpHeader))
@@ -3325,25 +3403,54 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
         }
     }
   else
-    { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+    { // In-sequence packet: ACK if delayed ack count allows. The segments
+      // merged by receive-side coalescing trigger the ACKs they would have
+      // triggered if received one by one, each one acknowledging the data
+      // up to the end of the segment triggering it.
+      uint32_t delAckMaxCount = std::max<uint32_t> (m_delAckMaxCount, 1);
+      // m_delAckCount may have been set to m_delAckMaxCount to force the
+      // next segment to be acknowledged
+      uint32_t delAckCount = std::min (m_delAckCount, delAckMaxCount - 1);
+      uint32_t acks = (delAckCount + segments) / delAckMaxCount;
+      uint32_t pending = (delAckCount + segments) % delAckMaxCount;
+      if (acks > 0)
         {
           m_delAckEvent.Cancel ();
-          m_delAckCount = 0;
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_NON_DELAYED_ACK);
+        }
+      for (uint32_t i = 1; i <= acks; ++i)
+        {
+          uint8_t flags = TcpHeader::ACK;
           if (m_tcb->m_ecnState == TcpSocketState::ECN_CE_RCVD || m_tcb->m_ecnState == TcpSocketState::ECN_SENDING_ECE)
             {
               NS_LOG_DEBUG("Congestion algo " << m_congestionControl->GetName ());
-              SendEmptyPacket (TcpHeader::ACK | TcpHeader::ECE);
-              NS_LOG_DEBUG (TcpSocketState::EcnStateName[m_tcb->m_ecnState] << " -> ECN_SENDING_ECE");
-              m_tcb->m_ecnState = TcpSocketState::ECN_SENDING_ECE;
+              flags |= TcpHeader::ECE;
+            }
+          if (i < acks || pending > 0)
+            {
+              uint32_t segment = i * delAckMaxCount - delAckCount;
+              SequenceNumber32 ackNumber = std::min (m_rxBuffer->NextRxSequence (),
+                                                     tcpHeader.GetSequenceNumber () + segment * segmentSize);
+              if (ackNumber <= m_highTxAck)
+                {
+                  continue;
+                }
+              DoSendEmptyPacket (flags, ackNumber);
             }
           else
             {
-              SendEmptyPacket (TcpHeader::ACK);
+              SendEmptyPacket (flags);
+            }
+          if (flags & TcpHeader::ECE)
+            {
+              NS_LOG_DEBUG (TcpSocketState::EcnStateName[m_tcb->m_ecnState] << " -> ECN_SENDING_ECE");
+              m_tcb->m_ecnState = TcpSocketState::ECN_SENDING_ECE;
             }
         }
-      else if (m_delAckEvent.IsExpired ())
+      // Sending an ACK resets the counter: keep the segments received after
+      // the last one that triggered an ACK
+      m_delAckCount = pending;
+      if (m_delAckCount > 0 && m_delAckEvent.IsExpired ())
         {
           m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
                                                &TcpSocketBase::DelAckTimeout, this);
@@ -751,6 +751,21 @@ protected:
    */
   virtual void SendEmptyPacket (uint8_t flags);
 
+  /**
+   * \brief Send a empty packet that carries a flag, e.g., ACK, and a given
+   * acknowledgment number
+   *
+   * SendEmptyPacket acknowledges all the data received in sequence; the ACKs
+   * of the segments merged by receive coalescing acknowledge only part of it,
+   * and are sent directly through this method. The advertised window is
+   * relative to ackNumber, so that its right edge does not depend on the
+   * acknowledgment number.
+   *
+   * \param flags the packet's flags
+   * \param ackNumber the acknowledgment number
+   */
+  virtual void DoSendEmptyPacket (uint8_t flags, SequenceNumber32 ackNumber);
+
   /**
    * \brief Send reset and tear down this socket
    */
@@ -1255,6 +1270,10 @@ protected:
   uint32_t               m_retxThresh {3};   //!< Fast Retransmit threshold
   bool                   m_limitedTx  {true}; //!< perform limited transmit
 
+  // Segmentation offload
+  bool     m_tso            {false}; //!< Hand super-segments down to be segmented by the device
+  uint32_t m_tsoMaxSegments {16};    //!< Maximum number of segments in a super-segment
+
   // Transmission Control Block
   Ptr<TcpSocketState>    m_tcb;               //!< Congestion control information
   Ptr<TcpCongestionOps>  m_congestionControl; //!< Congestion control
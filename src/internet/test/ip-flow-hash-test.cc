@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv6-queue-disc-item.h"
+#include "ns3/udp-header.h"
+#include "ns3/tcp-header.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Flow hash of the packets handed to the devices Test
+ *
+ * Checks that NetDeviceQueueInterface::GetFlowHash, which multi-queue
+ * devices use to select the transmission queue of a packet, returns the
+ * same hash as the Hash method of the queue disc item the packet is built
+ * from.
+ */
+class IpFlowHashTest : public TestCase
+{
+public:
+  IpFlowHashTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check the hash of an item
+   * \param item the queue disc item
+   * \param protocol the protocol number of the network header
+   * \param perturbation the hash perturbation
+   */
+  void CheckHash (Ptr<QueueDiscItem> item, uint16_t protocol, uint32_t perturbation);
+};
+
+IpFlowHashTest::IpFlowHashTest ()
+  : TestCase ("Check that the device flow hash matches the queue disc item hash")
+{
+}
+
+void
+IpFlowHashTest::CheckHash (Ptr<QueueDiscItem> item, uint16_t protocol, uint32_t perturbation)
+{
+  uint32_t expected = item->Hash (perturbation);
+  item->AddHeader ();
+  NS_TEST_EXPECT_MSG_EQ (NetDeviceQueueInterface::GetFlowHash (item->GetPacket (), protocol, perturbation),
+                         expected, "Device flow hash differs from the item hash");
+}
+
+void
+IpFlowHashTest::DoRun (void)
+{
+  UdpHeader udp;
+  udp.SetSourcePort (49153);
+  udp.SetDestinationPort (9);
+  TcpHeader tcp;
+  tcp.SetSourcePort (50000);
+  tcp.SetDestinationPort (80);
+
+  for (uint32_t perturbation = 0; perturbation < 3; perturbation++)
+    {
+      Ipv4Header ipv4;
+      ipv4.SetSource (Ipv4Address ("10.1.2.3"));
+      ipv4.SetDestination (Ipv4Address ("10.4.5.6"));
+      ipv4.SetProtocol (17);
+      Ptr<Packet> p = Create<Packet> (100);
+      p->AddHeader (udp);
+      ipv4.SetPayloadSize (p->GetSize ());
+      CheckHash (Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipv4), 0x0800, perturbation);
+
+      ipv4.SetProtocol (6);
+      p = Create<Packet> (100);
+      p->AddHeader (tcp);
+      ipv4.SetPayloadSize (p->GetSize ());
+      CheckHash (Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipv4), 0x0800, perturbation);
+
+      // a non-first fragment has no ports
+      ipv4.SetProtocol (17);
+      ipv4.SetMoreFragments ();
+      ipv4.SetFragmentOffset (1480);
+      p = Create<Packet> (100);
+      ipv4.SetPayloadSize (p->GetSize ());
+      CheckHash (Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipv4), 0x0800, perturbation);
+
+      Ipv6Header ipv6;
+      ipv6.SetSourceAddress (Ipv6Address ("2001:db8::1"));
+      ipv6.SetDestinationAddress (Ipv6Address ("2001:db8::2"));
+      ipv6.SetNextHeader (17);
+      p = Create<Packet> (100);
+      p->AddHeader (udp);
+      ipv6.SetPayloadLength (p->GetSize ());
+      CheckHash (Create<Ipv6QueueDiscItem> (p, Address (), 0x86dd, ipv6), 0x86dd, perturbation);
+    }
+
+  // not an IP packet
+  NS_TEST_EXPECT_MSG_EQ (NetDeviceQueueInterface::GetFlowHash (Create<Packet> (100), 0x0806, 0), 0,
+                         "Non-IP packet hashed");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Flow hash of the packets handed to the devices TestSuite
+ */
+class IpFlowHashTestSuite : public TestSuite
+{
+public:
+  IpFlowHashTestSuite () : TestSuite ("ip-flow-hash", UNIT)
+  {
+    AddTestCase (new IpFlowHashTest, TestCase::QUICK);
+  }
+};
+
+static IpFlowHashTestSuite g_ipFlowHashTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/neighbor-cache-table.h"
+
+using namespace ns3;
+
+/// Table used by the tests
+typedef NeighborCacheTable<Ipv4Address, uint32_t, Ipv4AddressHash> TestTable;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief NeighborCacheTable insertion, lookup and removal Test
+ */
+class NeighborCacheTableLookupTestCase : public TestCase
+{
+public:
+  NeighborCacheTableLookupTestCase ();
+  virtual void DoRun (void);
+};
+
+NeighborCacheTableLookupTestCase::NeighborCacheTableLookupTestCase ()
+  : TestCase ("Check insertion, lookup and removal of entries in the neighbor cache table")
+{
+}
+
+void
+NeighborCacheTableLookupTestCase::DoRun (void)
+{
+  const uint32_t n = 5000;
+  std::vector<uint32_t> values (n);
+  TestTable table;
+
+  NS_TEST_EXPECT_MSG_EQ (table.Find (Ipv4Address ("10.0.0.1")), 0, "Empty table lookup");
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      values[i] = i;
+      table.Insert (Ipv4Address (0x0a000000 + i), &values[i]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), n, "Wrong number of entries");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (4 * table.GetSize (), 3 * table.GetCapacity (), "Table too loaded");
+
+  // remove the even entries, the odd ones must still be found
+  for (uint32_t i = 0; i < n; i += 2)
+    {
+      NS_TEST_EXPECT_MSG_EQ (table.Erase (Ipv4Address (0x0a000000 + i)), true, "Entry not removed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (table.Erase (Ipv4Address (0x0a000000)), false, "Entry removed twice");
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), n / 2, "Wrong number of entries");
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t *found = table.Find (Ipv4Address (0x0a000000 + i));
+      if (i % 2)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((found != 0 && *found == i), true, "Entry " << i << " not found");
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (found, 0, "Entry " << i << " found after removal");
+        }
+    }
+
+  uint32_t count = 0;
+  for (TestTable::Iterator it = table.Begin (); it != table.End (); it++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (it->first, Ipv4Address (0x0a000000 + *it->second), "Wrong key");
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, n / 2, "Wrong number of iterated entries");
+
+  table.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "Table not empty after Clear");
+  NS_TEST_EXPECT_MSG_EQ ((table.Begin () == table.End ()), true, "Iterating an empty table");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief NeighborCacheTable deadlines Test
+ */
+class NeighborCacheTableDeadlineTestCase : public TestCase
+{
+public:
+  NeighborCacheTableDeadlineTestCase ();
+  virtual void DoRun (void);
+};
+
+NeighborCacheTableDeadlineTestCase::NeighborCacheTableDeadlineTestCase ()
+  : TestCase ("Check that only the entries whose deadline expired are returned")
+{
+}
+
+void
+NeighborCacheTableDeadlineTestCase::DoRun (void)
+{
+  uint32_t values[4] = { 0, 1, 2, 3 };
+  Ipv4Address addresses[4] = { Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2"),
+                               Ipv4Address ("10.0.0.3"), Ipv4Address ("10.0.0.4") };
+  TestTable table;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      table.Insert (addresses[i], &values[i]);
+    }
+
+  Time next;
+  Ipv4Address expired;
+  NS_TEST_EXPECT_MSG_EQ (table.GetNextDeadline (next), false, "No deadline expected");
+
+  table.SetDeadline (addresses[0], Seconds (3));
+  table.SetDeadline (addresses[1], Seconds (1));
+  table.SetDeadline (addresses[2], Seconds (2));
+  table.SetDeadline (addresses[3], Seconds (2));
+  NS_TEST_EXPECT_MSG_EQ (table.GetNextDeadline (next), true, "Deadline expected");
+  NS_TEST_EXPECT_MSG_EQ (next, Seconds (1), "Wrong next deadline");
+
+  // postpone the first deadline, clear one, remove the entry of another one
+  NS_TEST_EXPECT_MSG_EQ (table.SetDeadline (addresses[1], Seconds (4)), false,
+                         "Postponing a deadline should not queue it");
+  table.ClearDeadline (addresses[2]);
+  table.Erase (addresses[3]);
+  NS_TEST_EXPECT_MSG_EQ (table.GetNextDeadline (next), true, "Deadline expected");
+  NS_TEST_EXPECT_MSG_EQ (next, Seconds (3), "Wrong next deadline");
+  NS_TEST_EXPECT_MSG_EQ (table.PopExpired (Seconds (2.5), expired), false, "Nothing should expire");
+
+  // anticipate a deadline
+  NS_TEST_EXPECT_MSG_EQ (table.SetDeadline (addresses[1], Seconds (2.5)), true,
+                         "Anticipating a deadline should queue it");
+  NS_TEST_EXPECT_MSG_EQ (table.PopExpired (Seconds (3), expired), true, "Deadline should expire");
+  NS_TEST_EXPECT_MSG_EQ (expired, addresses[1], "Wrong expired entry");
+  NS_TEST_EXPECT_MSG_EQ (table.PopExpired (Seconds (3), expired), true, "Deadline should expire");
+  NS_TEST_EXPECT_MSG_EQ (expired, addresses[0], "Wrong expired entry");
+  NS_TEST_EXPECT_MSG_EQ (table.PopExpired (Seconds (10), expired), false, "No deadline left");
+
+  // re-arm an expired entry
+  table.SetDeadline (addresses[0], Seconds (5));
+  NS_TEST_EXPECT_MSG_EQ (table.PopExpired (Seconds (5), expired), true, "Deadline should expire");
+  NS_TEST_EXPECT_MSG_EQ (expired, addresses[0], "Wrong expired entry");
+  NS_TEST_EXPECT_MSG_EQ (table.GetNextDeadline (next), false, "No deadline expected");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief NeighborCacheTable TestSuite
+ */
+class NeighborCacheTableTestSuite : public TestSuite
+{
+public:
+  NeighborCacheTableTestSuite ();
+};
+
+NeighborCacheTableTestSuite::NeighborCacheTableTestSuite ()
+  : TestSuite ("neighbor-cache-table", UNIT)
+{
+  AddTestCase (new NeighborCacheTableLookupTestCase (), TestCase::QUICK);
+  AddTestCase (new NeighborCacheTableDeadlineTestCase (), TestCase::QUICK);
+}
+
+static NeighborCacheTableTestSuite g_neighborCacheTableTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,404 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+#include "ns3/tcp-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-receive-coalescer.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpReceiveCoalescingTest");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check receive-side coalescing of TCP segments
+ *
+ * Receive coalescing is enabled on the receiver interface. The segments of
+ * each window are sent back to back by the sender, hence they reach the
+ * receiver at the same time and are merged. The test checks that the
+ * receiver socket gets coalesced segments, that all the data is delivered,
+ * and that the receiver sends the ACKs that the segments would have
+ * triggered without coalescing: one every DelAckCount segments, with
+ * increasing acknowledgment numbers (i.e., no duplicate ACKs). The ACKs
+ * sent for a coalesced segment acknowledge different amounts of data, but
+ * must advertise the same right edge of the receive window.
+ */
+class TcpReceiveCoalescingTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc Test description
+   * \param maxSegments Maximum number of merged segments
+   */
+  TcpReceiveCoalescingTestCase (const std::string &desc, uint32_t maxSegments);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+private:
+  uint32_t m_maxSegments;   //!< Maximum number of merged segments
+  uint32_t m_maxRxSize;     //!< Largest payload received by the receiver
+  uint32_t m_rxBytes;       //!< Payload bytes received by the receiver
+  uint32_t m_acks;          //!< Pure ACKs sent by the receiver
+  uint32_t m_dupAcks;       //!< Pure ACKs sent by the receiver with an already sent ACK number
+  uint32_t m_dataSegments;  //!< Data segments sent by the sender
+  uint32_t m_movedEdges;    //!< ACKs of a received segment advertising different right edges
+  bool m_segmentAcked;      //!< The receiver already sent an ACK for the last received segment
+  SequenceNumber32 m_lastAck; //!< Last ACK number sent by the receiver
+  SequenceNumber32 m_lastRightEdge; //!< Right edge of the window advertised by the last ACK
+  Time m_lastAckTime;       //!< Time of the last ACK sent by the receiver
+};
+
+TcpReceiveCoalescingTestCase::TcpReceiveCoalescingTestCase (const std::string &desc,
+                                                            uint32_t maxSegments)
+  : TcpGeneralTest (desc),
+    m_maxSegments (maxSegments),
+    m_maxRxSize (0),
+    m_rxBytes (0),
+    m_acks (0),
+    m_dupAcks (0),
+    m_dataSegments (0),
+    m_movedEdges (0),
+    m_segmentAcked (false)
+{
+}
+
+void
+TcpReceiveCoalescingTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktSize (500);
+  SetAppPktCount (200);
+  Config::SetDefault ("ns3::Ipv4ReceiveCoalescer::MaxSegments", UintegerValue (m_maxSegments));
+  // Advertised windows are then in bytes, and never clamped
+  Config::SetDefault ("ns3::TcpSocketBase::WindowScaling", BooleanValue (false));
+}
+
+void
+TcpReceiveCoalescingTestCase::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  SetRcvBufSize (RECEIVER, 32000);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpReceiveCoalescingTestCase::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol> ();
+  ipv4->GetInterface (1)->SetAttribute ("ReceiveCoalescing", BooleanValue (true));
+  return TcpGeneralTest::CreateReceiverSocket (node);
+}
+
+void
+TcpReceiveCoalescingTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && p->GetSize () > 0)
+    {
+      ++m_dataSegments;
+    }
+  else if (who == RECEIVER && p->GetSize () == 0 && h.GetFlags () == TcpHeader::ACK)
+    {
+      if (m_acks > 0 && h.GetAckNumber () == m_lastAck)
+        {
+          ++m_dupAcks;
+        }
+      SequenceNumber32 rightEdge = h.GetAckNumber () + h.GetWindowSize ();
+      if (m_segmentAcked && Simulator::Now () == m_lastAckTime && rightEdge != m_lastRightEdge)
+        {
+          ++m_movedEdges;
+        }
+      m_segmentAcked = true;
+      m_lastRightEdge = rightEdge;
+      m_lastAckTime = Simulator::Now ();
+      m_lastAck = h.GetAckNumber ();
+      ++m_acks;
+    }
+}
+
+void
+TcpReceiveCoalescingTestCase::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  NS_UNUSED (h);
+  if (who == RECEIVER)
+    {
+      m_segmentAcked = false;
+      m_maxRxSize = std::max (m_maxRxSize, p->GetSize ());
+      m_rxBytes += p->GetSize ();
+    }
+}
+
+void
+TcpReceiveCoalescingTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_maxRxSize, GetSegSize (SENDER),
+                         "Receiver never got a coalesced segment");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxRxSize, GetSegSize (SENDER) * m_maxSegments,
+                               "Coalesced segment larger than MaxSegments");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, GetPktSize () * GetPktCount (),
+                         "Not all the data has been delivered");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_acks, m_dataSegments / GetDelAckCount (RECEIVER),
+                               "Fewer ACKs than without coalescing");
+  NS_TEST_ASSERT_MSG_EQ (m_dupAcks, 0, "The receiver sent duplicate ACKs");
+  NS_TEST_ASSERT_MSG_EQ (m_movedEdges, 0,
+                         "The ACKs of a coalesced segment advertise different window edges");
+  Config::Reset ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that a router does not coalesce the segments it forwards
+ *
+ * Three nodes are connected in a chain (sender, router, receiver) and
+ * receive coalescing is enabled on the router interface facing the sender.
+ * The sender transmits back-to-back bursts of segments, which the router
+ * has to forward unchanged: the test checks that the datagrams leaving the
+ * router have the size of the ones sent by the sender and do not carry a
+ * TcpCoalescingTag.
+ */
+class TcpReceiveCoalescingForwardTestCase : public TestCase
+{
+public:
+  TcpReceiveCoalescingForwardTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Create a node with one IPv4 interface per address
+   * \param addresses the addresses of the interfaces
+   * \return the node
+   */
+  Ptr<Node> CreateNode (const std::vector<Ipv4Address> &addresses);
+
+  /**
+   * \brief Trace the datagrams sent by the sender
+   * \param packet the packet, with IPv4 header
+   * \param ipv4 the IPv4 object
+   * \param interface the output interface
+   */
+  void SenderTx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  /**
+   * \brief Trace the datagrams sent by the router
+   * \param packet the packet, with IPv4 header
+   * \param ipv4 the IPv4 object
+   * \param interface the output interface
+   */
+  void RouterTx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  /**
+   * \brief Send data
+   * \param socket the sender socket
+   * \param size the amount of data to send
+   */
+  void SendData (Ptr<Socket> socket, uint32_t size);
+
+  /**
+   * \brief Read the data received by the receiver socket
+   * \param socket the socket
+   */
+  void ReceiverRx (Ptr<Socket> socket);
+
+  /**
+   * \brief Accept the connection on the receiver
+   * \param socket the new socket
+   * \param from the address of the sender
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+
+  std::vector<uint32_t> m_senderSizes;  //!< Sizes of the datagrams sent by the sender
+  std::vector<uint32_t> m_routerSizes;  //!< Sizes of the datagrams forwarded towards the receiver
+  uint32_t m_taggedForwarded;           //!< Forwarded datagrams carrying a TcpCoalescingTag
+  uint32_t m_rxBytes;                   //!< Bytes received by the receiver
+};
+
+TcpReceiveCoalescingForwardTestCase::TcpReceiveCoalescingForwardTestCase ()
+  : TestCase ("Receive coalescing does not apply to forwarded segments"),
+    m_taggedForwarded (0),
+    m_rxBytes (0)
+{
+}
+
+Ptr<Node>
+TcpReceiveCoalescingForwardTestCase::CreateNode (const std::vector<Ipv4Address> &addresses)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (node);
+
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (std::vector<Ipv4Address>::const_iterator it = addresses.begin (); it != addresses.end (); it++)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      dev->SetAddress (Mac48Address::ConvertFrom (Mac48Address::Allocate ()));
+      node->AddDevice (dev);
+      uint32_t netdev_idx = ipv4->AddInterface (dev);
+      ipv4->AddAddress (netdev_idx, Ipv4InterfaceAddress (*it, Ipv4Mask (0xffff0000U)));
+      ipv4->SetUp (netdev_idx);
+    }
+  return node;
+}
+
+void
+TcpReceiveCoalescingForwardTestCase::SenderTx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  NS_UNUSED (ipv4);
+  NS_UNUSED (interface);
+  m_senderSizes.push_back (packet->GetSize ());
+}
+
+void
+TcpReceiveCoalescingForwardTestCase::RouterTx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  NS_UNUSED (ipv4);
+  if (interface != 1)
+    {
+      return;
+    }
+  m_routerSizes.push_back (packet->GetSize ());
+  TcpCoalescingTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      ++m_taggedForwarded;
+    }
+}
+
+void
+TcpReceiveCoalescingForwardTestCase::SendData (Ptr<Socket> socket, uint32_t size)
+{
+  NS_TEST_EXPECT_MSG_EQ (socket->Send (Create<Packet> (size)), static_cast<int> (size),
+                         "The data does not fit in the send buffer");
+}
+
+void
+TcpReceiveCoalescingForwardTestCase::ReceiverRx (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_rxBytes += packet->GetSize ();
+    }
+}
+
+void
+TcpReceiveCoalescingForwardTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  NS_UNUSED (from);
+  socket->SetRecvCallback (MakeCallback (&TcpReceiveCoalescingForwardTestCase::ReceiverRx, this));
+}
+
+void
+TcpReceiveCoalescingForwardTestCase::DoRun (void)
+{
+  // Receiver (10.0.0.2) <-> (10.0.0.1) Router (10.1.0.1) <-> (10.1.0.2) Sender
+  Ptr<Node> rxNode = CreateNode (std::vector<Ipv4Address> (1, Ipv4Address ("10.0.0.2")));
+  std::vector<Ipv4Address> fwAddresses;
+  fwAddresses.push_back (Ipv4Address ("10.0.0.1"));
+  fwAddresses.push_back (Ipv4Address ("10.1.0.1"));
+  Ptr<Node> fwNode = CreateNode (fwAddresses);
+  Ptr<Node> txNode = CreateNode (std::vector<Ipv4Address> (1, Ipv4Address ("10.1.0.2")));
+
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  rxNode->GetDevice (1)->GetObject<SimpleNetDevice> ()->SetChannel (channel1);
+  fwNode->GetDevice (1)->GetObject<SimpleNetDevice> ()->SetChannel (channel1);
+  Ptr<SimpleChannel> channel2 = CreateObject<SimpleChannel> ();
+  fwNode->GetDevice (2)->GetObject<SimpleNetDevice> ()->SetChannel (channel2);
+  txNode->GetDevice (1)->GetObject<SimpleNetDevice> ()->SetChannel (channel2);
+
+  Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (rxNode->GetObject<Ipv4> ()->GetRoutingProtocol ())
+    ->SetDefaultRoute (Ipv4Address ("10.0.0.1"), 1);
+  Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (txNode->GetObject<Ipv4> ()->GetRoutingProtocol ())
+    ->SetDefaultRoute (Ipv4Address ("10.1.0.1"), 1);
+
+  Ptr<Ipv4L3Protocol> fwIpv4 = fwNode->GetObject<Ipv4L3Protocol> ();
+  fwIpv4->GetInterface (2)->SetAttribute ("ReceiveCoalescing", BooleanValue (true));
+  fwIpv4->TraceConnectWithoutContext ("Tx", MakeCallback (&TcpReceiveCoalescingForwardTestCase::RouterTx, this));
+  txNode->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&TcpReceiveCoalescingForwardTestCase::SenderTx, this));
+
+  Ptr<Socket> listener = rxNode->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), 50000));
+  listener->Listen ();
+  listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&TcpReceiveCoalescingForwardTestCase::Accept, this));
+
+  const uint32_t dataSize = 20000;
+  Ptr<Socket> sender = txNode->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  sender->Connect (InetSocketAddress (Ipv4Address ("10.0.0.2"), 50000));
+  Simulator::ScheduleWithContext (txNode->GetId (), Seconds (0.1),
+                                  &TcpReceiveCoalescingForwardTestCase::SendData, this, sender, dataSize);
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, dataSize, "Not all the data has been delivered");
+  NS_TEST_ASSERT_MSG_EQ (m_routerSizes.size (), m_senderSizes.size (),
+                         "The router did not forward every datagram of the sender");
+  NS_TEST_ASSERT_MSG_EQ ((m_routerSizes == m_senderSizes), true,
+                         "The router changed the datagrams it forwarded");
+  NS_TEST_ASSERT_MSG_EQ (m_taggedForwarded, 0, "The router forwarded coalesced segments");
+  NS_TEST_ASSERT_MSG_EQ (fwIpv4->GetInterface (2)->GetReceiveCoalescer (), 0,
+                         "The router coalesced segments not destined to it");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite: TCP receive-side coalescing
+ */
+class TcpReceiveCoalescingTestSuite : public TestSuite
+{
+public:
+  TcpReceiveCoalescingTestSuite ()
+    : TestSuite ("tcp-receive-coalescing", UNIT)
+  {
+    AddTestCase (new TcpReceiveCoalescingTestCase ("Receive coalescing, 16 segments", 16), TestCase::QUICK);
+    AddTestCase (new TcpReceiveCoalescingTestCase ("Receive coalescing, 4 segments", 4), TestCase::QUICK);
+    AddTestCase (new TcpReceiveCoalescingForwardTestCase (), TestCase::QUICK);
+  }
+};
+
+static TcpReceiveCoalescingTestSuite g_tcpReceiveCoalescingTestSuite; //!< Static variable for test initialization
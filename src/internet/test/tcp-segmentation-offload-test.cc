@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/tcp-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpSegmentationOffloadTest");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check TCP segmentation offload over a device without offload support
+ *
+ * The sender socket hands super-segments down to IPv4, which splits them
+ * in software because the SimpleNetDevice does not segment them. The test
+ * checks that super-segments are really generated by the sender, that the
+ * receiver only gets segments of at most one MSS (i.e., no IP fragmentation
+ * took place), that all the data is delivered, and that the datagrams sent
+ * by the sender, segments included, have distinct IPv4 identifications.
+ */
+class TcpSegmentationOffloadTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc Test description
+   * \param segmentSize Segment size
+   * \param maxSegments Maximum number of segments in a super-segment
+   */
+  TcpSegmentationOffloadTestCase (const std::string &desc, uint32_t segmentSize,
+                                  uint32_t maxSegments);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+  /**
+   * \brief Record the identification of a datagram sent by the sender
+   * \param p the packet, with its IPv4 header
+   * \param ipv4 the IPv4 object
+   * \param interface the interface index
+   */
+  void IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+private:
+  uint32_t m_segmentSize;   //!< Segment size
+  uint32_t m_maxSegments;   //!< Maximum number of segments in a super-segment
+  uint32_t m_maxTxSize;     //!< Largest payload handed down by the sender
+  uint32_t m_maxRxSize;     //!< Largest payload received by the receiver
+  uint32_t m_rxBytes;       //!< Payload bytes received by the receiver
+  std::set<uint16_t> m_identifications; //!< Identifications sent by the sender
+  uint32_t m_duplicateIds;  //!< Datagrams sent with an identification already used
+};
+
+TcpSegmentationOffloadTestCase::TcpSegmentationOffloadTestCase (const std::string &desc,
+                                                                uint32_t segmentSize,
+                                                                uint32_t maxSegments)
+  : TcpGeneralTest (desc),
+    m_segmentSize (segmentSize),
+    m_maxSegments (maxSegments),
+    m_maxTxSize (0),
+    m_maxRxSize (0),
+    m_rxBytes (0),
+    m_duplicateIds (0)
+{
+}
+
+void
+TcpSegmentationOffloadTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktSize (1000);
+  SetAppPktCount (100);
+}
+
+void
+TcpSegmentationOffloadTestCase::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  SetSegmentSize (SENDER, m_segmentSize);
+  SetSegmentSize (RECEIVER, m_segmentSize);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSegmentationOffloadTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("SegmentationOffload", BooleanValue (true));
+  socket->SetAttribute ("MaxOffloadSegments", UintegerValue (m_maxSegments));
+  node->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext (
+    "Tx", MakeCallback (&TcpSegmentationOffloadTestCase::IpTx, this));
+  return socket;
+}
+
+void
+TcpSegmentationOffloadTestCase::IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  NS_UNUSED (ipv4);
+  NS_UNUSED (interface);
+  Ipv4Header ipHeader;
+  p->PeekHeader (ipHeader);
+  if (!m_identifications.insert (ipHeader.GetIdentification ()).second)
+    {
+      m_duplicateIds++;
+    }
+}
+
+void
+TcpSegmentationOffloadTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  NS_UNUSED (h);
+  if (who == SENDER)
+    {
+      m_maxTxSize = std::max (m_maxTxSize, p->GetSize ());
+    }
+}
+
+void
+TcpSegmentationOffloadTestCase::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  NS_UNUSED (h);
+  if (who == RECEIVER)
+    {
+      m_maxRxSize = std::max (m_maxRxSize, p->GetSize ());
+      m_rxBytes += p->GetSize ();
+    }
+}
+
+void
+TcpSegmentationOffloadTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_maxTxSize, m_segmentSize,
+                         "Sender never handed down a super-segment");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxTxSize, m_segmentSize * m_maxSegments,
+                               "Super-segment larger than MaxOffloadSegments");
+  NS_TEST_ASSERT_MSG_EQ (m_maxRxSize, m_segmentSize,
+                         "Receiver got a segment larger than the MSS");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, GetPktSize () * GetPktCount (),
+                         "Not all the data has been delivered");
+  NS_TEST_ASSERT_MSG_GT (m_identifications.size (), 0, "No datagram sent");
+  NS_TEST_ASSERT_MSG_EQ (m_duplicateIds, 0,
+                         "Datagrams sent with an identification already used");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite: TCP segmentation offload
+ */
+class TcpSegmentationOffloadTestSuite : public TestSuite
+{
+public:
+  TcpSegmentationOffloadTestSuite ()
+    : TestSuite ("tcp-segmentation-offload", UNIT)
+  {
+    AddTestCase (new TcpSegmentationOffloadTestCase ("TSO, MSS 500, 16 segments", 500, 16), TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadTestCase ("TSO, MSS 1000, 4 segments", 1000, 4), TestCase::QUICK);
+    AddTestCase (new TcpSegmentationOffloadTestCase ("TSO, MSS 1400, 2 segments", 1400, 2), TestCase::QUICK);
+  }
+};
+
+static TcpSegmentationOffloadTestSuite g_tcpSegmentationOffloadTestSuite; //!< Static variable for test initialization
@@ -299,7 +299,7 @@ LrWpanHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool pr
     }
 
   Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out,
-                                                     PcapHelper::DLT_IEEE802_15_4);
+                                                     PcapHelper::DLT_IEEE802_15_4, device);
 
   if (promiscuous == true)
     {
@@ -19,6 +19,8 @@
 #include <stdint.h>
 #include <string>
 #include <fstream>
+#include <sstream>
+#include <vector>
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
@@ -28,6 +30,7 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-file.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +38,76 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \ingroup network
+ * Shared pcapng files of the multiplexed pcap output.
+ */
+struct MultiplexedPcapOutput
+{
+  std::string m_filename;                 //!< File name, empty if disabled
+  std::vector<Ptr<PcapNgFile> > m_shards; //!< Files, opened when first used
+};
+
+/**
+ * \ingroup network
+ * \return the multiplexed pcap output
+ */
+static MultiplexedPcapOutput &
+GetMultiplexedPcapOutput (void)
+{
+  static MultiplexedPcapOutput output;
+  return output;
+}
+
+/**
+ * \ingroup network
+ * Create a pcap file wrapper writing into a file of the multiplexed pcap
+ * output, opening the file if needed.
+ *
+ * \param filename name of the file the wrapper would have written
+ * \param dataLinkType data link type of packet data
+ * \param snapLen maximum length of packet data stored in records
+ * \param shard the index of the pcapng file
+ * \param description the description of the interface
+ * \returns a smart pointer to the Pcap file
+ */
+static Ptr<PcapFileWrapper>
+CreateMultiplexedFile (std::string filename, uint32_t dataLinkType, uint32_t snapLen,
+                       uint32_t shard, std::string description)
+{
+  MultiplexedPcapOutput &output = GetMultiplexedPcapOutput ();
+  Ptr<PcapNgFile> ngFile = output.m_shards[shard % output.m_shards.size ()];
+  if (!ngFile->IsOpen ())
+    {
+      std::string name = output.m_filename;
+      if (output.m_shards.size () > 1)
+        {
+          std::string extension = ".pcapng";
+          std::ostringstream oss;
+          if (name.size () > extension.size ()
+              && name.compare (name.size () - extension.size (), extension.size (), extension) == 0)
+            {
+              name.erase (name.size () - extension.size ());
+            }
+          oss << name << "-" << shard % output.m_shards.size () << extension;
+          name = oss.str ();
+        }
+      ngFile->Open (name, 1 << 20, AsyncFileWriter::MAX_BLOCKS_DEFAULT,
+                    BlockCompression::GetTraceCodec ());
+      NS_ABORT_MSG_IF (ngFile->Fail (), "Unable to Open " << name);
+    }
+
+  std::string extension = ".pcap";
+  if (filename.size () > extension.size ()
+      && filename.compare (filename.size () - extension.size (), extension.size (), extension) == 0)
+    {
+      filename.erase (filename.size () - extension.size ());
+    }
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->OpenInterface (ngFile, dataLinkType, filename, description, snapLen);
+  return file;
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -55,7 +128,13 @@ PcapHelper::CreateFile (
 {
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
+  if (!GetMultiplexedPcapOutput ().m_filename.empty () && filemode == std::ios::out)
+    {
+      return CreateMultiplexedFile (filename, dataLinkType, snapLen, 0, "");
+    }
+
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->EnableCompression (BlockCompression::GetTraceCodec ());
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +155,57 @@ PcapHelper::CreateFile (
   return file;
 }
 
+Ptr<PcapFileWrapper>
+PcapHelper::CreateFile (
+  std::string filename,
+  std::ios::openmode filemode,
+  DataLinkType dataLinkType,
+  Ptr<NetDevice> device,
+  uint32_t    snapLen,
+  int32_t     tzCorrection)
+{
+  NS_LOG_FUNCTION (filename << filemode << dataLinkType << device << snapLen << tzCorrection);
+
+  if (GetMultiplexedPcapOutput ().m_filename.empty () || filemode != std::ios::out)
+    {
+      return CreateFile (filename, filemode, dataLinkType, snapLen, tzCorrection);
+    }
+
+  uint32_t nodeId = device->GetNode ()->GetId ();
+  std::ostringstream oss;
+  oss << "node " << nodeId << " device " << device->GetIfIndex ();
+  return CreateMultiplexedFile (filename, dataLinkType, snapLen, nodeId, oss.str ());
+}
+
+void
+PcapHelper::EnableMultiplexedOutput (std::string filename, uint32_t nShards)
+{
+  NS_LOG_FUNCTION (filename << nShards);
+  NS_ABORT_MSG_UNLESS (filename.size () && nShards > 0, "Invalid multiplexed pcap output");
+
+  DisableMultiplexedOutput ();
+  MultiplexedPcapOutput &output = GetMultiplexedPcapOutput ();
+  output.m_filename = filename;
+  for (uint32_t i = 0; i < nShards; i++)
+    {
+      output.m_shards.push_back (Create<PcapNgFile> ());
+    }
+}
+
+void
+PcapHelper::DisableMultiplexedOutput (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  MultiplexedPcapOutput &output = GetMultiplexedPcapOutput ();
+  for (uint32_t i = 0; i < output.m_shards.size (); i++)
+    {
+      output.m_shards[i]->Close ();
+    }
+  output.m_shards.clear ();
+  output.m_filename.clear ();
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -192,7 +322,8 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
 {
   NS_LOG_FUNCTION (filename << filemode);
 
-  Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
+  Ptr<OutputStreamWrapper> StreamWrapper =
+    Create<OutputStreamWrapper> (filename, filemode, BlockCompression::GetTraceCodec ());
 
   //
   // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -109,6 +109,54 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+  /**
+   * @brief Create and initialize a pcap file for the packets of a device.
+   *
+   * When the multiplexed pcap output is enabled, the packets are written as
+   * those of an interface of the shared pcapng file, whose description
+   * gives the node and device ids of the device.
+   *
+   * @param filename file name
+   * @param filemode file mode
+   * @param dataLinkType data link type of packet data
+   * @param device the device whose packets are written
+   * @param snapLen maximum length of packet data stored in records
+   * @param tzCorrection time zone correction to be applied to timestamps of packets
+   * @returns a smart pointer to the Pcap file
+   */
+  Ptr<PcapFileWrapper> CreateFile (std::string filename,
+                                   std::ios::openmode filemode,
+                                   DataLinkType dataLinkType,
+                                   Ptr<NetDevice> device,
+                                   uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
+                                   int32_t tzCorrection = 0);
+
+  /**
+   * @brief Write all the pcap traces created from now on into a single
+   * pcapng file, instead of a file per device.
+   *
+   * Each traced device is described by an Interface Description Block
+   * named after the file it would have been written to.  With several
+   * shards, the devices of node n are written into the file
+   * \<filename\>-\<n % nShards\>.pcapng (the ".pcapng" extension of filename,
+   * if any, is moved after the shard number).
+   *
+   * The files are written on a background thread; they are complete once
+   * DisableMultiplexedOutput () is called or the program exits.
+   *
+   * @param filename name of the pcapng file
+   * @param nShards number of files
+   */
+  static void EnableMultiplexedOutput (std::string filename, uint32_t nShards = 1);
+
+  /**
+   * @brief Close the pcapng files of the multiplexed pcap output, and
+   * create a file per device again.
+   *
+   * The devices still traced stop writing packets.
+   */
+  static void DisableMultiplexedOutput (void);
+
   /**
    * @brief Hook a trace source to the default trace sink
    * 
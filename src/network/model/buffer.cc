@@ -20,6 +20,8 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/simulator.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -49,6 +51,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
+/** The subsystem of the buffers in use, for MemoryAccounting. */
+static const MemoryAccounting::Subsystem g_dataSubsystem =
+  MemoryAccounting::GetSubsystem ("Buffer::Data");
+/** The subsystem of the buffers of the free list, for MemoryAccounting. */
+static const MemoryAccounting::Subsystem g_freeListSubsystem =
+  MemoryAccounting::GetSubsystem ("Buffer::FreeList");
+
 
 uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
@@ -112,6 +121,16 @@ Buffer::Recycle (struct Buffer::Data *data)
     {
       NS_ASSERT (IS_INITIALIZED (g_freeList));
       g_freeList->push_back (data);
+      if (MemoryAccounting::HasBlocks ())
+        {
+          MemoryAccounting::Free (data);
+        }
+      if (MemoryAccounting::IsEnabled ())
+        {
+          MemoryAccounting::Allocate (g_freeListSubsystem, data,
+                                      data->m_size - 1 + sizeof (struct Buffer::Data),
+                                      Simulator::NO_CONTEXT);
+        }
     }
 }
 
@@ -133,6 +152,15 @@ Buffer::Create (uint32_t dataSize)
           if (data->m_size >= dataSize) 
             {
               data->m_count = 1;
+              if (MemoryAccounting::HasBlocks ())
+                {
+                  MemoryAccounting::Free (data);
+                }
+              if (MemoryAccounting::IsEnabled ())
+                {
+                  MemoryAccounting::Allocate (g_dataSubsystem, data,
+                                              data->m_size - 1 + sizeof (struct Buffer::Data));
+                }
               return data;
             }
           Buffer::Deallocate (data);
@@ -173,6 +201,10 @@ Buffer::Allocate (uint32_t reqSize)
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (g_dataSubsystem, data, size);
+    }
   return data;
 }
 
@@ -181,6 +213,10 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  if (MemoryAccounting::HasBlocks ())
+    {
+      MemoryAccounting::Free (data);
+    }
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
   delete [] buf;
 }
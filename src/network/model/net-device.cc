@@ -41,4 +41,10 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SupportsSegmentationOffload (void) const
+{
+  return false;
+}
+
 } // namespace ns3
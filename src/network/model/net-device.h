@@ -359,6 +359,16 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface splits transport super-segments larger
+   * than its MTU itself before transmission, false otherwise.
+   *
+   * The default implementation returns false.
+   *
+   * \see SegmentationOffload
+   */
+  virtual bool SupportsSegmentationOffload (void) const;
+
 };
 
 } // namespace ns3
@@ -22,6 +22,8 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/simulator.h"
 #include "packet-metadata.h"
 #include "buffer.h"
 #include "header.h"
@@ -31,6 +33,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
+/** The subsystem of the metadata in use, for MemoryAccounting. */
+static const MemoryAccounting::Subsystem g_dataSubsystem =
+  MemoryAccounting::GetSubsystem ("PacketMetadata::Data");
+/** The subsystem of the metadata of the free list, for MemoryAccounting. */
+static const MemoryAccounting::Subsystem g_freeListSubsystem =
+  MemoryAccounting::GetSubsystem ("PacketMetadata::FreeList");
+
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
@@ -583,6 +592,15 @@ PacketMetadata::Create (uint32_t size)
         {
           NS_LOG_LOGIC ("create found size="<<data->m_size);
           data->m_count = 1;
+          if (MemoryAccounting::HasBlocks ())
+            {
+              MemoryAccounting::Free (data);
+            }
+          if (MemoryAccounting::IsEnabled ())
+            {
+              MemoryAccounting::Allocate (g_dataSubsystem, data,
+                                          sizeof (struct Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE);
+            }
           return data;
         }
       NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
@@ -611,6 +629,16 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
   else 
     {
       m_freeList.push_back (data);
+      if (MemoryAccounting::HasBlocks ())
+        {
+          MemoryAccounting::Free (data);
+        }
+      if (MemoryAccounting::IsEnabled ())
+        {
+          MemoryAccounting::Allocate (g_freeListSubsystem, data,
+                                      sizeof (struct Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE,
+                                      Simulator::NO_CONTEXT);
+        }
     }
 }
 
@@ -629,12 +657,20 @@ PacketMetadata::Allocate (uint32_t n)
   data->m_size = n;
   data->m_count = 1;
   data->m_dirtyEnd = 0;
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (g_dataSubsystem, data, size);
+    }
   return data;
 }
 void 
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
+  if (MemoryAccounting::HasBlocks ())
+    {
+      MemoryAccounting::Free (data);
+    }
   uint8_t *buf = (uint8_t *)data;
   delete [] buf;
 }
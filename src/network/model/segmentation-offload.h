@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENTATION_OFFLOAD_H
+#define SEGMENTATION_OFFLOAD_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include <list>
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief Object that splits transport super-segments into wire-sized packets.
+ *
+ * Transport protocols that support segmentation offload may hand packets
+ * larger than the device MTU to the network layer. Such super-segments are
+ * carried unmodified through the queueing layers, and a NetDevice that
+ * reports SupportsSegmentationOffload () splits them right before
+ * transmission by means of the SegmentationOffload object aggregated to its
+ * node.
+ *
+ * The protocol stack that generates super-segments is responsible for
+ * subclassing this class, implementing Segment, and aggregating an instance
+ * to the node.
+ */
+class SegmentationOffload : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  SegmentationOffload ();
+  virtual ~SegmentationOffload ();
+
+  /**
+   * \brief Split a super-segment into packets that fit on the wire.
+   *
+   * \param packet the packet to split, starting with its network header
+   * \param segments the list the resulting packets are appended to, each
+   *        one starting with its own network header
+   * \return false if the packet is not a super-segment (in this case
+   *         segments is left untouched), true otherwise
+   */
+  virtual bool Segment (Ptr<const Packet> packet, std::list<Ptr<Packet> > &segments) = 0;
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_H */
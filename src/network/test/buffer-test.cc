@@ -21,6 +21,8 @@
 #include "ns3/buffer.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 
 using namespace ns3;
@@ -389,6 +391,54 @@ BufferTest::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer memory accounting test.
+ */
+class BufferMemoryAccountingTest : public TestCase
+{
+public:
+  BufferMemoryAccountingTest ();
+
+private:
+  virtual void DoRun (void);
+  /** Allocate a buffer in the current context, and check its accounting. */
+  void AllocateBuffer (void);
+};
+
+BufferMemoryAccountingTest::BufferMemoryAccountingTest ()
+  : TestCase ("Buffer memory accounting")
+{
+}
+
+void
+BufferMemoryAccountingTest::AllocateBuffer (void)
+{
+  MemoryAccounting::Subsystem data = MemoryAccounting::GetSubsystem ("Buffer::Data");
+  {
+    Buffer buffer (2000);
+    MemoryAccounting::Usage usage = MemoryAccounting::GetUsage (data, 3);
+    NS_TEST_EXPECT_MSG_EQ (usage.count, 1, "Buffer not accounted in its node");
+    NS_TEST_EXPECT_MSG_GT (usage.bytes, 2000, "Bad size of the buffer");
+  }
+  MemoryAccounting::Usage usage = MemoryAccounting::GetUsage (data, 3);
+  NS_TEST_EXPECT_MSG_EQ (usage.count, 0, "Buffer not released");
+  NS_TEST_EXPECT_MSG_EQ (usage.bytes, 0, "Buffer bytes not released");
+  NS_TEST_EXPECT_MSG_GT (usage.peakBytes, 2000, "Bad peak size of the buffers");
+}
+
+void
+BufferMemoryAccountingTest::DoRun (void)
+{
+  MemoryAccounting::Enable ();
+  Simulator::ScheduleWithContext (3, Seconds (1), &BufferMemoryAccountingTest::AllocateBuffer, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  MemoryAccounting::Disable ();
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -405,6 +455,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferMemoryAccountingTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
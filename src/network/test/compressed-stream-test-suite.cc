@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/compressed-stream.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/pcap-file.h"
+
+using namespace ns3;
+
+/**
+ * \param filename a file name
+ * \return the size of the file
+ */
+static uint64_t
+GetFileSize (std::string const &filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary | std::ios::ate);
+  return file.tellg ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the compression of a frame with each codec
+ */
+class BlockCompressionTestCase : public TestCase
+{
+public:
+  BlockCompressionTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Compress and decompress a block
+   * \param codec the codec
+   * \param data the block
+   * \return the size of the frame
+   */
+  uint32_t RoundTrip (BlockCompression::Codec codec, std::vector<uint8_t> const &data);
+};
+
+BlockCompressionTestCase::BlockCompressionTestCase ()
+  : TestCase ("Check that frames are decompressed into the original data")
+{
+}
+
+uint32_t
+BlockCompressionTestCase::RoundTrip (BlockCompression::Codec codec, std::vector<uint8_t> const &data)
+{
+  std::vector<uint8_t> frame;
+  BlockCompression::Compress (codec, data.data (), data.size (), frame);
+  uint32_t compressedSize, size;
+  std::memcpy (&compressedSize, &frame[0], 4);
+  std::memcpy (&size, &frame[4], 4);
+  NS_TEST_EXPECT_MSG_EQ (size, data.size (), "Wrong original size in the frame header");
+  NS_TEST_EXPECT_MSG_EQ (compressedSize + BlockCompression::FRAME_HEADER_SIZE, frame.size (), "Wrong compressed size");
+
+  std::vector<uint8_t> output (size);
+  bool ok = BlockCompression::Decompress (codec, &frame[BlockCompression::FRAME_HEADER_SIZE],
+                                          compressedSize, output.data (), size);
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "Decompression failed with codec " << codec);
+  NS_TEST_EXPECT_MSG_EQ ((output == data), true, "Wrong data decompressed with codec " << codec);
+  return frame.size ();
+}
+
+void
+BlockCompressionTestCase::DoRun (void)
+{
+  // text-like data, with repetitions
+  std::ostringstream text;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      text << "+ " << i * 0.001 << " /NodeList/" << i % 7 << "/DeviceList/0/TxQueue/Enqueue length: " << 512 + i % 3 << "\n";
+    }
+  std::string s = text.str ();
+  std::vector<uint8_t> repetitive (s.begin (), s.end ());
+
+  // pseudo-random data, which does not compress
+  std::vector<uint8_t> random (10000);
+  uint32_t state = 12345;
+  for (uint32_t i = 0; i < random.size (); i++)
+    {
+      state = state * 1103515245 + 12345;
+      random[i] = state >> 24;
+    }
+
+  std::vector<uint8_t> tiny (3, 'a');
+
+  BlockCompression::Codec codecs[] = { BlockCompression::LZ, BlockCompression::ZLIB };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      if (!BlockCompression::IsAvailable (codecs[i]))
+        {
+          continue;
+        }
+      uint32_t size = RoundTrip (codecs[i], repetitive);
+      NS_TEST_EXPECT_MSG_LT (size, repetitive.size () / 3, "Text not compressed with codec " << codecs[i]);
+      size = RoundTrip (codecs[i], random);
+      NS_TEST_EXPECT_MSG_EQ (size, random.size () + BlockCompression::FRAME_HEADER_SIZE, "Random data not stored");
+      RoundTrip (codecs[i], tiny);
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the compressed streams, appending and seeking
+ */
+class CompressedStreamTestCase : public TestCase
+{
+public:
+  CompressedStreamTestCase ();
+  virtual void DoRun (void);
+};
+
+CompressedStreamTestCase::CompressedStreamTestCase ()
+  : TestCase ("Check that compressed streams are read back, from any offset")
+{
+}
+
+void
+CompressedStreamTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("trace.tr.z");
+  std::string expected;
+  {
+    // small frames, so that the data spans many frames
+    CompressedOutputStreamBuf buffer;
+    NS_TEST_ASSERT_MSG_EQ (buffer.Open (filename, std::ios::out, BlockCompression::LZ, 1000), true,
+                           "Open (" << filename << ") failed");
+    std::ostream os (&buffer);
+    for (uint32_t i = 0; i < 1000; i++)
+      {
+        std::ostringstream line;
+        line << "line " << i << " of the trace\n";
+        os << line.str ();
+        expected += line.str ();
+      }
+    NS_TEST_EXPECT_MSG_EQ (buffer.Close (), true, "Close failed");
+  }
+  {
+    CompressedOutputStream os;
+    os.open (filename, std::ios::out | std::ios::app, BlockCompression::ZLIB);
+    NS_TEST_ASSERT_MSG_EQ (os.is_open (), true, "Append to (" << filename << ") failed");
+    os << "appended line\n";
+    expected += "appended line\n";
+    os.close ();
+  }
+  NS_TEST_EXPECT_MSG_LT (GetFileSize (filename), expected.size (), "File not compressed");
+
+  CompressedInputStream is;
+  is.open (filename);
+  NS_TEST_ASSERT_MSG_EQ (is.fail (), false, "Open (" << filename << ") failed");
+  std::string content ((std::istreambuf_iterator<char> (is)), std::istreambuf_iterator<char> ());
+  NS_TEST_EXPECT_MSG_EQ ((content == expected), true, "Wrong data read back");
+
+  is.clear ();
+  is.seekg (0, std::ios::end);
+  NS_TEST_EXPECT_MSG_EQ (is.tellg (), std::streampos (expected.size ()), "Wrong size of the original data");
+
+  uint32_t offsets[] = { 12345, 999, 0, 1000, 17 };
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      is.seekg (offsets[i]);
+      char data[20];
+      is.read (data, sizeof (data));
+      NS_TEST_EXPECT_MSG_EQ (std::string (data, sizeof (data)), expected.substr (offsets[i], sizeof (data)),
+                             "Wrong data read at offset " << offsets[i]);
+    }
+
+  std::ofstream plain (CreateTempDirFilename ("plain.tr").c_str ());
+  plain << "not compressed\n";
+  plain.close ();
+  CompressedInputStream notCompressed;
+  notCompressed.open (CreateTempDirFilename ("plain.tr"));
+  NS_TEST_EXPECT_MSG_EQ (notCompressed.fail (), true, "Uncompressed file accepted");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the corrupted frames of a compressed file are not read
+ */
+class CompressedCorruptionTestCase : public TestCase
+{
+public:
+  CompressedCorruptionTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Write a frame header
+   * \param os the output stream
+   * \param compressedSize the size of the compressed data
+   * \param size the size of the original data
+   */
+  void WriteFrameHeader (std::ostream &os, uint32_t compressedSize, uint32_t size);
+
+  /**
+   * \brief Write a file made of valid frames followed by a corrupted frame
+   * \param filename the name of the file
+   * \param compressedSize the compressed size in the header of the corrupted frame
+   * \param size the size in the header of the corrupted frame
+   */
+  void WriteFile (std::string filename, uint32_t compressedSize, uint32_t size);
+};
+
+CompressedCorruptionTestCase::CompressedCorruptionTestCase ()
+  : TestCase ("Check that the corrupted frames of compressed files are rejected")
+{
+}
+
+void
+CompressedCorruptionTestCase::WriteFrameHeader (std::ostream &os, uint32_t compressedSize, uint32_t size)
+{
+  uint8_t header[BlockCompression::FRAME_HEADER_SIZE];
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      header[i] = compressedSize >> (8 * i);
+      header[4 + i] = size >> (8 * i);
+    }
+  os.write ((const char *)header, sizeof (header));
+}
+
+void
+CompressedCorruptionTestCase::WriteFile (std::string filename, uint32_t compressedSize, uint32_t size)
+{
+  std::ofstream os (filename.c_str (), std::ios::binary);
+  uint8_t header[BlockCompression::FILE_HEADER_SIZE];
+  BlockCompression::MakeFileHeader (BlockCompression::LZ, header);
+  os.write ((const char *)header, sizeof (header));
+
+  std::string first = "first frame\n";
+  std::vector<uint8_t> frame;
+  BlockCompression::Compress (BlockCompression::LZ, (const uint8_t *)first.data (), first.size (), frame);
+  os.write ((const char *)frame.data (), frame.size ());
+  // an empty frame
+  WriteFrameHeader (os, 0, 0);
+  std::string second = "second frame\n";
+  BlockCompression::Compress (BlockCompression::LZ, (const uint8_t *)second.data (), second.size (), frame);
+  os.write ((const char *)frame.data (), frame.size ());
+
+  WriteFrameHeader (os, compressedSize, size);
+  os << "garbage";
+}
+
+void
+CompressedCorruptionTestCase::DoRun (void)
+{
+  std::string expected = "first frame\nsecond frame\n";
+  // frame sizes too large to be allocated, a compressed size larger than
+  // the size, and data which can not be decompressed
+  uint32_t sizes[][2] = { { 7, 0xffffffff }, { 0xfffffff0, 0xfffffff0 }, { 7, 3 }, { 7, 100 } };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      std::string filename = CreateTempDirFilename ("corrupted.tr.z");
+      WriteFile (filename, sizes[i][0], sizes[i][1]);
+
+      CompressedInputStream is;
+      is.open (filename);
+      NS_TEST_ASSERT_MSG_EQ (is.fail (), false, "Open (" << filename << ") failed");
+      std::string content ((std::istreambuf_iterator<char> (is)), std::istreambuf_iterator<char> ());
+      NS_TEST_EXPECT_MSG_EQ (content, expected, "Wrong data read before corrupted frame " << i);
+
+      // the data read before the corrupted frame is still available
+      is.clear ();
+      is.seekg (expected.size () - 6);
+      char data[6];
+      is.read (data, sizeof (data));
+      NS_TEST_EXPECT_MSG_EQ (std::string (data, sizeof (data)), "frame\n",
+                             "Wrong data read back before corrupted frame " << i);
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the compressed pcap and ascii trace files
+ */
+class CompressedTraceTestCase : public TestCase
+{
+public:
+  CompressedTraceTestCase ();
+  virtual void DoRun (void);
+};
+
+CompressedTraceTestCase::CompressedTraceTestCase ()
+  : TestCase ("Check that compressed pcap files are read like uncompressed ones")
+{
+}
+
+void
+CompressedTraceTestCase::DoRun (void)
+{
+  std::string plainName = CreateTempDirFilename ("plain.pcap");
+  std::string compressedName = CreateTempDirFilename ("compressed.pcap");
+
+  PcapFile plain, compressed;
+  compressed.EnableCompression (BlockCompression::GetTraceCodec () == BlockCompression::NONE ?
+                                BlockCompression::LZ : BlockCompression::GetTraceCodec ());
+  plain.Open (plainName, std::ios::out);
+  compressed.Open (compressedName, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (compressed.Fail (), false, "Open (" << compressedName << ") failed");
+  plain.Init (1, 200);
+  compressed.Init (1, 200);
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (100 + i % 200);
+      plain.Write (i / 1000, i % 1000, p);
+      compressed.Write (i / 1000, i % 1000, p);
+    }
+  plain.Close ();
+  compressed.Close ();
+  NS_TEST_EXPECT_MSG_EQ (compressed.Fail (), false, "Write failed");
+  NS_TEST_EXPECT_MSG_LT (GetFileSize (compressedName), GetFileSize (plainName) / 2, "File not compressed");
+
+  uint32_t sec = 0, usec = 0, packets = 0;
+  bool diff = PcapFile::Diff (plainName, compressedName, sec, usec, packets, 200);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Files differ at packet " << packets << " (" << sec << "s " << usec << "us)");
+  NS_TEST_EXPECT_MSG_EQ (packets, 5000, "Wrong number of packets read");
+
+  compressed.Open (compressedName, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (compressed.Fail (), false, "Open (" << compressedName << ") for reading failed");
+  NS_TEST_EXPECT_MSG_EQ (compressed.GetSnapLen (), 200, "Wrong snap length read");
+  compressed.Close ();
+
+  std::string asciiName = CreateTempDirFilename ("trace.tr");
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (asciiName, std::ios::out, BlockCompression::LZ);
+  *stream->GetStream () << "r 1.5 /NodeList/0/DeviceList/0" << std::endl;
+  stream = 0;
+  CompressedInputStream is;
+  is.open (asciiName);
+  std::string line;
+  std::getline (is, line);
+  NS_TEST_EXPECT_MSG_EQ (line, "r 1.5 /NodeList/0/DeviceList/0", "Wrong ascii trace read back");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compressed stream TestSuite
+ */
+class CompressedStreamTestSuite : public TestSuite
+{
+public:
+  CompressedStreamTestSuite ();
+};
+
+CompressedStreamTestSuite::CompressedStreamTestSuite ()
+  : TestSuite ("compressed-stream", UNIT)
+{
+  AddTestCase (new BlockCompressionTestCase, TestCase::QUICK);
+  AddTestCase (new CompressedStreamTestCase, TestCase::QUICK);
+  AddTestCase (new CompressedCorruptionTestCase, TestCase::QUICK);
+  AddTestCase (new CompressedTraceTestCase, TestCase::QUICK);
+}
+
+static CompressedStreamTestSuite g_compressedStreamTestSuite; //!< Static variable for test initialization
@@ -19,6 +19,7 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/string.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -83,6 +84,97 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((packet == 0), true, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * DropTailQueue batch operations unit tests.
+ */
+class DropTailQueueBatchTestCase : public TestCase
+{
+public:
+  DropTailQueueBatchTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Record an enqueued packet
+   * \param p the packet
+   */
+  void Enqueued (Ptr<const Packet> p);
+  /**
+   * Record a dropped packet
+   * \param p the packet
+   */
+  void Dropped (Ptr<const Packet> p);
+
+  std::vector<uint64_t> m_events;  //!< Uids of the packets enqueued (positive) or dropped (negated)
+};
+
+DropTailQueueBatchTestCase::DropTailQueueBatchTestCase ()
+  : TestCase ("Check the batch operations of the drop tail queue")
+{
+}
+
+void
+DropTailQueueBatchTestCase::Enqueued (Ptr<const Packet> p)
+{
+  m_events.push_back (p->GetUid ());
+}
+
+void
+DropTailQueueBatchTestCase::Dropped (Ptr<const Packet> p)
+{
+  m_events.push_back (-p->GetUid ());
+}
+
+void
+DropTailQueueBatchTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  queue->SetAttribute ("MaxSize", StringValue ("3p"));
+  queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&DropTailQueueBatchTestCase::Enqueued, this));
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&DropTailQueueBatchTestCase::Dropped, this));
+
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      packets.push_back (Create<Packet> (100));
+    }
+
+  // the last two packets do not fit
+  NS_TEST_EXPECT_MSG_EQ (queue->EnqueueBatch (packets), 3, "Three packets should have been enqueued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "There should be three packets in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 300, "There should be 300 bytes in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 2, "Two packets should have been dropped");
+  NS_TEST_ASSERT_MSG_EQ (m_events.size (), 5, "The traces of all the packets should have been fired");
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      uint64_t uid = packets[i]->GetUid ();
+      NS_TEST_EXPECT_MSG_EQ (m_events[i], (i < 3 ? uid : -uid), "Wrong trace for packet " << i);
+    }
+
+  std::vector<Ptr<Packet> > dequeued;
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBatch (dequeued, 2), 2, "Two packets should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 1, "There should be one packet in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBatch (dequeued, 10), 1, "One packet should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "There should be no packets in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+  NS_TEST_ASSERT_MSG_EQ (dequeued.size (), 3, "Three packets should have been dequeued");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (dequeued[i], packets[i], "Packets dequeued out of order");
+    }
+
+  // in byte mode, a smaller packet may fit after a packet was dropped
+  queue->SetAttribute ("MaxSize", StringValue ("250B"));
+  packets[1] = Create<Packet> (200);
+  NS_TEST_EXPECT_MSG_EQ (queue->EnqueueBatch (packets), 2, "Two packets should have been enqueued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 200, "There should be 200 bytes in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), packets[0], "The first packet should be dequeued first");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), packets[2], "The third packet should be dequeued second");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -96,6 +188,7 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueBatchTestCase (), TestCase::QUICK);
   }
 };
 
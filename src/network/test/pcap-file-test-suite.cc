@@ -24,6 +24,7 @@
 
 #include "ns3/log.h"
 #include "ns3/test.h"
+#include "ns3/packet.h"
 #include "ns3/pcap-file.h"
 
 using namespace ns3;
@@ -1144,6 +1145,86 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a pcap file written on a background
+ * thread is identical to the same file written synchronously.
+ */
+class AsyncWriteTestCase : public TestCase
+{
+public:
+  AsyncWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write the known packets, then some larger packets truncated to the
+   * snap length.
+   * \param f the file to write to
+   */
+  void WritePackets (PcapFile &f);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase ()
+  : TestCase ("Check that PcapFile::EnableAsyncWrite writes the same file")
+{
+}
+
+void
+AsyncWriteTestCase::WritePackets (PcapFile &f)
+{
+  f.Init (1, 100);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Init returns error");
+  for (uint32_t round = 0; round < 20; ++round)
+    {
+      for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+          PacketEntry const & p = knownPackets[i];
+          f.Write (round, p.tsUsec, (uint8_t const *)p.data, std::min<uint32_t> (p.origLen, N_PACKET_BYTES));
+        }
+      // larger than the memory blocks, and partly a zero-filled area
+      Ptr<Packet> packet = Create<Packet> (1000 + round);
+      f.Write (round, 999999, packet);
+    }
+}
+
+void
+AsyncWriteTestCase::DoRun (void)
+{
+  std::string syncFilename = CreateTempDirFilename ("sync.pcap");
+  std::string asyncFilename = CreateTempDirFilename ("async.pcap");
+
+  PcapFile syncFile;
+  syncFile.Open (syncFilename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (syncFile.Fail (), false, "Open (" << syncFilename << ") returns error");
+  WritePackets (syncFile);
+  syncFile.Close ();
+
+  // tiny blocks, so that most writes wait for the I/O thread
+  PcapFile asyncFile;
+  asyncFile.EnableAsyncWrite (256, 2);
+  asyncFile.Open (asyncFilename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (asyncFile.Fail (), false, "Open (" << asyncFilename << ") returns error");
+  WritePackets (asyncFile);
+  NS_TEST_EXPECT_MSG_EQ (asyncFile.Fail (), false, "Write must not fail");
+  asyncFile.Close ();
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (syncFilename, asyncFilename, sec, usec, packets, 100);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Files written synchronously and asynchronously differ");
+  NS_TEST_EXPECT_MSG_EQ (packets, 20 * (N_KNOWN_PACKETS + 1), "Wrong number of packets");
+
+  FILE * p = std::fopen (syncFilename.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (p, 0, "Cannot open " << syncFilename);
+  std::fseek (p, 0, SEEK_END);
+  uint64_t size = std::ftell (p);
+  std::fclose (p);
+  NS_TEST_EXPECT_MSG_EQ (CheckFileLength (asyncFilename, size), true, "Files have different lengths");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1248,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/trace-helper.h"
+#include "ns3/pcapng-file.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief A block read back from a pcapng file
+ */
+struct PcapNgBlock
+{
+  uint32_t type;                //!< Block type
+  std::vector<uint8_t> body;    //!< Block body
+};
+
+/**
+ * \brief Read the blocks of a pcapng file
+ * \param filename the file name
+ * \param blocks the blocks read (output)
+ * \return true if the file is well formed
+ */
+static bool
+ReadBlocks (std::string filename, std::vector<PcapNgBlock> &blocks)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary);
+  std::vector<uint8_t> data ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+  uint32_t offset = 0;
+  while (offset + 12 <= data.size ())
+    {
+      uint32_t type, length, trailer;
+      std::memcpy (&type, &data[offset], 4);
+      std::memcpy (&length, &data[offset + 4], 4);
+      if (length < 12 || length % 4 != 0 || offset + length > data.size ())
+        {
+          return false;
+        }
+      std::memcpy (&trailer, &data[offset + length - 4], 4);
+      if (trailer != length)
+        {
+          return false;
+        }
+      PcapNgBlock block;
+      block.type = type;
+      block.body.assign (data.begin () + offset + 8, data.begin () + offset + length - 4);
+      blocks.push_back (block);
+      offset += length;
+    }
+  return offset == data.size ();
+}
+
+/**
+ * \brief Get a string option of an Interface Description Block
+ * \param block the block
+ * \param code the option code
+ * \return the option value, empty if not found
+ */
+static std::string
+GetInterfaceOption (const PcapNgBlock &block, uint16_t code)
+{
+  uint32_t offset = 8;
+  while (offset + 4 <= block.body.size ())
+    {
+      uint16_t optionCode, optionLength;
+      std::memcpy (&optionCode, &block.body[offset], 2);
+      std::memcpy (&optionLength, &block.body[offset + 2], 2);
+      if (optionCode == code)
+        {
+          return std::string ((const char *)&block.body[offset + 4], optionLength);
+        }
+      offset += 4 + ((optionLength + 3) & ~3U);
+    }
+  return "";
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the blocks written by PcapNgFile
+ */
+class PcapNgFileWriteTestCase : public TestCase
+{
+public:
+  PcapNgFileWriteTestCase ();
+  virtual void DoRun (void);
+};
+
+PcapNgFileWriteTestCase::PcapNgFileWriteTestCase ()
+  : TestCase ("Check the blocks of a pcapng file with several interfaces")
+{
+}
+
+void
+PcapNgFileWriteTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("multiplexed.pcapng");
+
+  PcapNgFile file;
+  file.Open (filename, 128, 2);
+  NS_TEST_ASSERT_MSG_EQ (file.Fail (), false, "Open (" << filename << ") returns error");
+  NS_TEST_EXPECT_MSG_EQ (file.AddInterface (PcapHelper::DLT_PPP, 65535, "n0-d1", "node 0 device 1"), 0, "Wrong interface id");
+  NS_TEST_EXPECT_MSG_EQ (file.AddInterface (PcapHelper::DLT_EN10MB, 100, "n1-d0", "node 1 device 0"), 1, "Wrong interface id");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      file.Write (i % 2, 1000000000ULL * i + i, Create<Packet> (50 + i));
+    }
+  file.Close ();
+  NS_TEST_EXPECT_MSG_EQ (file.Fail (), false, "Write must not fail");
+
+  std::vector<PcapNgBlock> blocks;
+  NS_TEST_ASSERT_MSG_EQ (ReadBlocks (filename, blocks), true, "Malformed pcapng file");
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 103, "Wrong number of blocks");
+  NS_TEST_EXPECT_MSG_EQ (blocks[0].type, PcapNgFile::SHB_TYPE, "First block not a Section Header Block");
+  uint32_t magic;
+  std::memcpy (&magic, &blocks[0].body[0], 4);
+  NS_TEST_EXPECT_MSG_EQ (magic, PcapNgFile::BYTE_ORDER_MAGIC, "Wrong byte-order magic");
+
+  NS_TEST_EXPECT_MSG_EQ (blocks[1].type, PcapNgFile::IDB_TYPE, "Interface Description Block missing");
+  NS_TEST_EXPECT_MSG_EQ (GetInterfaceOption (blocks[1], 2), "n0-d1", "Wrong interface name");
+  NS_TEST_EXPECT_MSG_EQ (GetInterfaceOption (blocks[2], 3), "node 1 device 0", "Wrong interface description");
+  NS_TEST_EXPECT_MSG_EQ (GetInterfaceOption (blocks[2], 9), std::string (1, '\x09'), "Timestamps not in nanoseconds");
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      const PcapNgBlock &block = blocks[3 + i];
+      uint32_t fields[5];
+      std::memcpy (fields, &block.body[0], sizeof (fields));
+      uint64_t timestamp = (static_cast<uint64_t> (fields[1]) << 32) | fields[2];
+      NS_TEST_EXPECT_MSG_EQ (block.type, PcapNgFile::EPB_TYPE, "Enhanced Packet Block expected");
+      NS_TEST_EXPECT_MSG_EQ (fields[0], i % 2, "Wrong interface id");
+      NS_TEST_EXPECT_MSG_EQ (timestamp, 1000000000ULL * i + i, "Wrong timestamp");
+      NS_TEST_EXPECT_MSG_EQ (fields[3], (i % 2 ? std::min (100U, 50 + i) : 50 + i), "Wrong captured length");
+      NS_TEST_EXPECT_MSG_EQ (fields[4], 50 + i, "Wrong original length");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the multiplexed pcap output of PcapHelper
+ */
+class MultiplexedPcapTestCase : public TestCase
+{
+public:
+  MultiplexedPcapTestCase ();
+  virtual void DoRun (void);
+};
+
+MultiplexedPcapTestCase::MultiplexedPcapTestCase ()
+  : TestCase ("Check that the devices are written into sharded pcapng files")
+{
+}
+
+void
+MultiplexedPcapTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("all.pcapng");
+  PcapHelper::EnableMultiplexedOutput (filename, 2);
+
+  PcapHelper pcapHelper;
+  std::vector<Ptr<PcapFileWrapper> > files;
+  uint32_t shard0Interfaces = 0;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      node->AddDevice (device);
+      shard0Interfaces += (node->GetId () % 2 == 0);
+      std::string name = pcapHelper.GetFilenameFromDevice ("trace", device);
+      Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (name, std::ios::out, PcapHelper::DLT_EN10MB, device);
+      NS_TEST_EXPECT_MSG_EQ (file->GetDataLinkType (), PcapHelper::DLT_EN10MB, "Wrong data link type");
+      files.push_back (file);
+    }
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      files[i % 3]->Write (MicroSeconds (i), Create<Packet> (100));
+    }
+  PcapHelper::DisableMultiplexedOutput ();
+  // packets written after the files are closed are dropped
+  files[0]->Write (Seconds (1), Create<Packet> (100));
+
+  std::vector<PcapNgBlock> shard0, shard1;
+  NS_TEST_ASSERT_MSG_EQ (ReadBlocks (CreateTempDirFilename ("all-0.pcapng"), shard0), true, "Malformed shard 0");
+  NS_TEST_ASSERT_MSG_EQ (ReadBlocks (CreateTempDirFilename ("all-1.pcapng"), shard1), true, "Malformed shard 1");
+
+  // the nodes are shared between the two shards by node id
+  NS_TEST_EXPECT_MSG_EQ (shard0.size () + shard1.size (), 2 + 3 + 30, "Wrong number of blocks");
+  uint32_t interfaces = 0;
+  for (uint32_t i = 0; i < shard0.size (); i++)
+    {
+      if (shard0[i].type == PcapNgFile::IDB_TYPE)
+        {
+          std::string description = GetInterfaceOption (shard0[i], 3);
+          NS_TEST_EXPECT_MSG_NE (description.find ("device 0"), std::string::npos, "Wrong description " << description);
+          NS_TEST_EXPECT_MSG_EQ (GetInterfaceOption (shard0[i], 2).find ("trace-"), 0, "Wrong interface name");
+          interfaces++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (interfaces, shard0Interfaces, "Wrong number of interfaces in shard 0");
+  for (uint32_t i = 0; i < shard1.size (); i++)
+    {
+      interfaces += shard1[i].type == PcapNgFile::IDB_TYPE;
+    }
+  NS_TEST_EXPECT_MSG_EQ (interfaces, 3, "Wrong number of interfaces");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief pcapng file TestSuite
+ */
+class PcapNgFileTestSuite : public TestSuite
+{
+public:
+  PcapNgFileTestSuite ();
+};
+
+PcapNgFileTestSuite::PcapNgFileTestSuite ()
+  : TestSuite ("pcapng-file", UNIT)
+{
+  AddTestCase (new PcapNgFileWriteTestCase, TestCase::QUICK);
+  AddTestCase (new MultiplexedPcapTestCase, TestCase::QUICK);
+}
+
+static PcapNgFileTestSuite g_pcapNgFileTestSuite; //!< Static variable for test initialization
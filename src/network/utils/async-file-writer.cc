@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <deque>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+
+#include "async-file-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+/**
+ * The I/O thread shared by all the writers, and the blocks waiting for it.
+ * All the fields of the writers used by both threads (m_nQueued, m_free,
+ * m_failed) are protected by m_mutex.
+ */
+struct AsyncFileWriter::Service
+{
+  Service ()
+    : m_stop (false)
+  {
+  }
+  ~Service ()
+  {
+    // close the writers still open at exit, so that no data is lost
+    while (!m_writers.empty ())
+      {
+        (*m_writers.begin ())->Close ();
+      }
+  }
+
+  std::mutex m_mutex;                     //!< Protects the shared state
+  std::condition_variable m_work;         //!< Signaled when a block is queued
+  std::condition_variable m_done;         //!< Signaled when a block is written
+  std::deque<Block *> m_queue;            //!< Blocks to write, in order
+  std::set<AsyncFileWriter *> m_writers;  //!< Open writers
+  bool m_stop;                            //!< True if the I/O thread must exit
+#ifdef HAVE_PTHREAD_H
+  Ptr<SystemThread> m_thread;             //!< The I/O thread
+#endif
+};
+
+AsyncFileWriter::Service &
+AsyncFileWriter::GetService (void)
+{
+  static Service service;
+  return service;
+}
+
+AsyncFileWriter::AsyncFileWriter ()
+  : m_blockSize (BLOCK_SIZE_DEFAULT),
+    m_maxBlocks (MAX_BLOCKS_DEFAULT),
+    m_codec (BlockCompression::NONE),
+    m_nBlocks (0),
+    m_nQueued (0),
+    m_current (0),
+    m_open (false),
+    m_failed (false),
+    m_nStalls (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+AsyncFileWriter::Open (std::string const &filename, uint32_t blockSize, uint32_t maxBlocks,
+                       BlockCompression::Codec codec)
+{
+  NS_LOG_FUNCTION (this << filename << blockSize << maxBlocks << codec);
+  NS_ASSERT_MSG (!m_open, "File already open");
+  NS_ASSERT (blockSize > 0 && maxBlocks > 0);
+
+  m_blockSize = blockSize;
+  m_maxBlocks = maxBlocks;
+  m_codec = codec;
+  m_file.open (filename.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!m_file.is_open ())
+    {
+      m_failed = true;
+      return;
+    }
+  if (m_codec != BlockCompression::NONE)
+    {
+      uint8_t header[BlockCompression::FILE_HEADER_SIZE];
+      BlockCompression::MakeFileHeader (m_codec, header);
+      m_file.write ((const char *)header, sizeof (header));
+    }
+  m_open = true;
+
+  Service &service = GetService ();
+  std::unique_lock<std::mutex> lock (service.m_mutex);
+  service.m_writers.insert (this);
+#ifdef HAVE_PTHREAD_H
+  if (service.m_thread == 0)
+    {
+      NS_LOG_LOGIC ("Starting the I/O thread");
+      service.m_stop = false;
+      service.m_thread = Create<SystemThread> (MakeCallback (&AsyncFileWriter::DrainBlocks));
+      service.m_thread->Start ();
+    }
+#endif
+}
+
+bool
+AsyncFileWriter::IsOpen (void) const
+{
+  return m_open;
+}
+
+bool
+AsyncFileWriter::Fail (void) const
+{
+  std::unique_lock<std::mutex> lock (GetService ().m_mutex);
+  return m_failed;
+}
+
+void
+AsyncFileWriter::Write (const void *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << data << size);
+  NS_ASSERT (m_open);
+
+  const uint8_t *bytes = static_cast<const uint8_t *> (data);
+  while (size > 0)
+    {
+      if (m_current == 0 || m_current->m_size == m_current->m_data.size ())
+        {
+          if (m_current != 0)
+            {
+              Submit ();
+            }
+          GetBlock (m_blockSize);
+        }
+      uint32_t toCopy = std::min<uint32_t> (size, m_current->m_data.size () - m_current->m_size);
+      std::memcpy (&m_current->m_data[m_current->m_size], bytes, toCopy);
+      m_current->m_size += toCopy;
+      bytes += toCopy;
+      size -= toCopy;
+    }
+}
+
+uint8_t *
+AsyncFileWriter::Reserve (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (m_open);
+
+  if (m_current == 0 || m_current->m_data.size () - m_current->m_size < size)
+    {
+      if (m_current != 0)
+        {
+          Submit ();
+        }
+      GetBlock (size);
+    }
+  return &m_current->m_data[m_current->m_size];
+}
+
+void
+AsyncFileWriter::Commit (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (m_current != 0 && m_current->m_size + size <= m_current->m_data.size ());
+  m_current->m_size += size;
+}
+
+void
+AsyncFileWriter::Submit (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Block *block = m_current;
+  m_current = 0;
+  Service &service = GetService ();
+  std::unique_lock<std::mutex> lock (service.m_mutex);
+  if (block->m_size == 0)
+    {
+      m_free.push_back (block);
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  m_nQueued++;
+  service.m_queue.push_back (block);
+  service.m_work.notify_one ();
+#else
+  std::vector<uint8_t> frame;
+  m_failed |= !WriteBlock (block, frame);
+  m_free.push_back (block);
+#endif
+}
+
+bool
+AsyncFileWriter::WriteBlock (Block *block, std::vector<uint8_t> &frame)
+{
+  if (m_codec == BlockCompression::NONE)
+    {
+      m_file.write ((const char *)&block->m_data[0], block->m_size);
+    }
+  else
+    {
+      BlockCompression::Compress (m_codec, &block->m_data[0], block->m_size, frame);
+      m_file.write ((const char *)&frame[0], frame.size ());
+    }
+  return m_file.good ();
+}
+
+void
+AsyncFileWriter::GetBlock (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+
+  Service &service = GetService ();
+  std::unique_lock<std::mutex> lock (service.m_mutex);
+  if (m_free.empty () && m_nBlocks >= m_maxBlocks)
+    {
+      NS_LOG_LOGIC ("All the blocks are being written, waiting");
+      m_nStalls++;
+      while (m_free.empty ())
+        {
+          service.m_done.wait (lock);
+        }
+    }
+  if (m_free.empty ())
+    {
+      m_current = new Block;
+      m_current->m_writer = this;
+      m_nBlocks++;
+    }
+  else
+    {
+      m_current = m_free.back ();
+      m_free.pop_back ();
+    }
+  lock.unlock ();
+
+  if (m_current->m_data.size () < size)
+    {
+      m_current->m_data.resize (std::max (size, m_blockSize));
+    }
+  m_current->m_size = 0;
+}
+
+void
+AsyncFileWriter::DrainBlocks (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  Service &service = GetService ();
+  std::vector<uint8_t> frame;
+  std::unique_lock<std::mutex> lock (service.m_mutex);
+  while (true)
+    {
+      while (service.m_queue.empty () && !service.m_stop)
+        {
+          service.m_work.wait (lock);
+        }
+      if (service.m_queue.empty ())
+        {
+          break;
+        }
+      Block *block = service.m_queue.front ();
+      service.m_queue.pop_front ();
+      AsyncFileWriter *writer = block->m_writer;
+
+      // only this thread touches the file while blocks are queued
+      lock.unlock ();
+      bool failed = !writer->WriteBlock (block, frame);
+      lock.lock ();
+
+      writer->m_failed |= failed;
+      writer->m_nQueued--;
+      writer->m_free.push_back (block);
+      service.m_done.notify_all ();
+    }
+}
+
+void
+AsyncFileWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+  if (m_current != 0)
+    {
+      Submit ();
+    }
+  Service &service = GetService ();
+  std::unique_lock<std::mutex> lock (service.m_mutex);
+  while (m_nQueued > 0)
+    {
+      service.m_done.wait (lock);
+    }
+  lock.unlock ();
+  m_file.flush ();
+}
+
+void
+AsyncFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+  Flush ();
+  m_file.close ();
+  m_open = false;
+
+  Service &service = GetService ();
+  std::unique_lock<std::mutex> lock (service.m_mutex);
+  for (std::vector<Block *>::iterator it = m_free.begin (); it != m_free.end (); it++)
+    {
+      delete *it;
+    }
+  m_free.clear ();
+  m_nBlocks = 0;
+  service.m_writers.erase (this);
+#ifdef HAVE_PTHREAD_H
+  if (service.m_writers.empty () && service.m_thread != 0)
+    {
+      NS_LOG_LOGIC ("Stopping the I/O thread");
+      Ptr<SystemThread> thread = service.m_thread;
+      service.m_thread = 0;
+      service.m_stop = true;
+      service.m_work.notify_one ();
+      lock.unlock ();
+      thread->Join ();
+    }
+#endif
+}
+
+uint64_t
+AsyncFileWriter::GetNStalls (void) const
+{
+  return m_nStalls;
+}
+
+} // namespace ns3
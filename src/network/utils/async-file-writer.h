@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include "compressed-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief A binary output file written on a background thread
+ *
+ * The data is copied into blocks of memory, which are written to disk by
+ * an I/O thread shared by all the open writers once they are full.  The
+ * memory used by each writer is bounded: when all its blocks are waiting
+ * to be written, the caller blocks until one of them has been written
+ * (back-pressure).
+ *
+ * When threads are not available, the blocks are written synchronously
+ * when full.
+ *
+ * The blocks can be compressed on the I/O thread, each block making a
+ * frame of a BlockCompression file.
+ */
+class AsyncFileWriter
+{
+public:
+  static const uint32_t BLOCK_SIZE_DEFAULT = 65536; /**< Default size of a block */
+  static const uint32_t MAX_BLOCKS_DEFAULT = 4;     /**< Default maximum number of blocks */
+
+  AsyncFileWriter ();
+  ~AsyncFileWriter ();
+
+  /**
+   * \brief Create (or truncate) a file
+   * \param filename the name of the file
+   * \param blockSize the size of the memory blocks
+   * \param maxBlocks the maximum number of blocks of this writer
+   * \param codec the codec compressing the blocks
+   */
+  void Open (std::string const &filename,
+             uint32_t blockSize = BLOCK_SIZE_DEFAULT,
+             uint32_t maxBlocks = MAX_BLOCKS_DEFAULT,
+             BlockCompression::Codec codec = BlockCompression::NONE);
+
+  /**
+   * \return true if the file is open
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \return true if the file could not be opened or written
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Write some data
+   * \param data the data
+   * \param size the size of the data
+   */
+  void Write (const void *data, uint32_t size);
+
+  /**
+   * \brief Get some contiguous space to serialize data in place
+   *
+   * The data is written when Commit () is called.
+   *
+   * \param size the size of the space
+   * \return the space
+   */
+  uint8_t *Reserve (uint32_t size);
+
+  /**
+   * \brief Write the data serialized in the space returned by Reserve ()
+   * \param size the size of the data, at most the reserved size
+   */
+  void Commit (uint32_t size);
+
+  /**
+   * \brief Write all the pending data to disk, waiting for it
+   */
+  void Flush (void);
+
+  /**
+   * \brief Write all the pending data and close the file
+   */
+  void Close (void);
+
+  /**
+   * \return the number of times the caller had to wait for a free block
+   */
+  uint64_t GetNStalls (void) const;
+
+private:
+  /**
+   * \brief Copy constructor declared private and not implemented.
+   * \param o object to copy
+   */
+  AsyncFileWriter (const AsyncFileWriter &o);
+  /**
+   * \brief Assignment operator declared private and not implemented.
+   * \param o object to copy
+   * \return the object
+   */
+  AsyncFileWriter &operator = (const AsyncFileWriter &o);
+
+  /// Shared I/O thread and its queue
+  struct Service;
+
+  /**
+   * \brief A block of data
+   */
+  struct Block
+  {
+    AsyncFileWriter *m_writer;    //!< Writer owning the block
+    std::vector<uint8_t> m_data;  //!< Data
+    uint32_t m_size;              //!< Size of the data
+  };
+
+  /**
+   * \return the shared I/O service
+   */
+  static Service &GetService (void);
+
+  /**
+   * \brief Body of the I/O thread
+   */
+  static void DrainBlocks (void);
+
+  /**
+   * \brief Write a block to the file, compressing it if needed
+   * \param block the block
+   * \param frame scratch space for the compressed block
+   * \return true if the block was written
+   */
+  bool WriteBlock (Block *block, std::vector<uint8_t> &frame);
+
+  /**
+   * \brief Queue the current block for writing
+   */
+  void Submit (void);
+
+  /**
+   * \brief Get a block to fill, waiting for one if needed
+   * \param size the minimum size of the block
+   */
+  void GetBlock (uint32_t size);
+
+  std::ofstream m_file;          //!< File
+  uint32_t m_blockSize;          //!< Size of the blocks
+  uint32_t m_maxBlocks;          //!< Maximum number of blocks
+  BlockCompression::Codec m_codec; //!< Codec compressing the blocks
+  uint32_t m_nBlocks;            //!< Number of allocated blocks
+  uint32_t m_nQueued;            //!< Number of blocks waiting to be written
+  Block *m_current;              //!< Block being filled
+  std::vector<Block *> m_free;   //!< Written blocks
+  bool m_open;                   //!< True if the file is open
+  bool m_failed;                 //!< True if an error occurred
+  uint64_t m_nStalls;            //!< Number of waits for a free block
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
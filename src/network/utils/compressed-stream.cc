@@ -0,0 +1,765 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/enum.h"
+
+#include "compressed-stream.h"
+
+#ifdef NS3_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CompressedStream");
+
+/**
+ * \ingroup network
+ * The codec of the trace files written by the trace helpers.
+ */
+static GlobalValue g_traceCompression ("TraceCompression",
+                                       "The codec compressing the ascii and pcap trace files "
+                                       "(None: the files are not compressed)",
+                                       EnumValue (BlockCompression::NONE),
+                                       MakeEnumChecker (BlockCompression::NONE, "None",
+                                                        BlockCompression::LZ, "Lz",
+                                                        BlockCompression::ZLIB, "Zlib"));
+
+/// Magic bytes of a compressed file
+static const char COMPRESSED_MAGIC[4] = { 'N', 'S', '3', 'Z' };
+/// Version of the compressed file format
+static const uint8_t COMPRESSED_VERSION = 1;
+/// Index of the frame in the get area when there is none
+static const uint32_t NO_FRAME = std::numeric_limits<uint32_t>::max ();
+
+/// Minimum length of an LZ match
+static const uint32_t LZ_MIN_MATCH = 4;
+/// Maximum distance of an LZ match
+static const uint32_t LZ_MAX_OFFSET = 65535;
+/// Number of bits of the LZ hash table index
+static const uint32_t LZ_HASH_BITS = 14;
+/// Empty entry of the LZ hash table
+static const uint32_t LZ_NO_POSITION = std::numeric_limits<uint32_t>::max ();
+
+/**
+ * \param p the data
+ * \return the 32-bit little endian integer read
+ */
+static uint32_t
+ReadLe32 (const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t> (p[3]) << 24);
+}
+
+/**
+ * \param p the data (output)
+ * \param v the integer to write in 32-bit little endian
+ */
+static void
+WriteLe32 (uint8_t *p, uint32_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+bool
+BlockCompression::IsAvailable (Codec codec)
+{
+#ifdef NS3_ZLIB
+  return true;
+#else
+  return codec != ZLIB;
+#endif
+}
+
+BlockCompression::Codec
+BlockCompression::GetTraceCodec (void)
+{
+  EnumValue value;
+  g_traceCompression.GetValue (value);
+  Codec codec = static_cast<Codec> (value.Get ());
+  if (!IsAvailable (codec))
+    {
+      NS_LOG_WARN ("zlib not available, using the LZ codec");
+      codec = LZ;
+    }
+  return codec;
+}
+
+void
+BlockCompression::MakeFileHeader (Codec codec, uint8_t *header)
+{
+  std::memcpy (header, COMPRESSED_MAGIC, sizeof (COMPRESSED_MAGIC));
+  header[4] = COMPRESSED_VERSION;
+  header[5] = codec;
+  header[6] = 0;
+  header[7] = 0;
+}
+
+bool
+BlockCompression::ParseFileHeader (const uint8_t *header, Codec &codec)
+{
+  if (std::memcmp (header, COMPRESSED_MAGIC, sizeof (COMPRESSED_MAGIC)) != 0
+      || header[4] != COMPRESSED_VERSION || header[5] > ZLIB)
+    {
+      return false;
+    }
+  codec = static_cast<Codec> (header[5]);
+  return true;
+}
+
+void
+BlockCompression::Compress (Codec codec, const uint8_t *data, uint32_t size, std::vector<uint8_t> &frame)
+{
+  NS_LOG_FUNCTION (codec << size);
+
+  uint32_t compressedSize = 0;
+  if (codec == LZ && size > 0)
+    {
+      frame.resize (FRAME_HEADER_SIZE + size);
+      compressedSize = LzCompress (data, size, &frame[FRAME_HEADER_SIZE], size - 1);
+    }
+#ifdef NS3_ZLIB
+  else if (codec == ZLIB && size > 0)
+    {
+      uLongf destLen = compressBound (size);
+      frame.resize (FRAME_HEADER_SIZE + destLen);
+      if (compress2 (&frame[FRAME_HEADER_SIZE], &destLen, data, size, Z_BEST_SPEED) == Z_OK
+          && destLen < size)
+        {
+          compressedSize = destLen;
+        }
+    }
+#endif
+
+  if (compressedSize == 0)
+    {
+      // incompressible: store the data as is
+      compressedSize = size;
+      frame.resize (FRAME_HEADER_SIZE + size);
+      if (size > 0)
+        {
+          std::memcpy (&frame[FRAME_HEADER_SIZE], data, size);
+        }
+    }
+  frame.resize (FRAME_HEADER_SIZE + compressedSize);
+  WriteLe32 (&frame[0], compressedSize);
+  WriteLe32 (&frame[4], size);
+}
+
+bool
+BlockCompression::Decompress (Codec codec, const uint8_t *payload, uint32_t compressedSize,
+                              uint8_t *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (codec << compressedSize << size);
+
+  if (compressedSize == size)
+    {
+      std::memcpy (data, payload, size);
+      return true;
+    }
+  switch (codec)
+    {
+    case LZ:
+      return LzDecompress (payload, compressedSize, data, size);
+#ifdef NS3_ZLIB
+    case ZLIB:
+      {
+        uLongf destLen = size;
+        return uncompress (data, &destLen, payload, compressedSize) == Z_OK && destLen == size;
+      }
+#endif
+    default:
+      return false;
+    }
+}
+
+//
+// The LZ codec stores sequences made of a token, literals and a match.  The
+// high nibble of the token is the number of literals and its low nibble the
+// length of the match minus LZ_MIN_MATCH; the value 15 means that the
+// length goes on in the following bytes, each adding up to 255.  The
+// literals follow, then the distance of the match on 16 bits.  The last
+// sequence has only literals.
+//
+
+/**
+ * \brief Write a length continued after a token nibble
+ * \param out the output
+ * \param op the position in the output
+ * \param length the length minus 15
+ */
+static void
+LzWriteLength (uint8_t *out, uint32_t &op, uint32_t length)
+{
+  while (length >= 255)
+    {
+      out[op++] = 255;
+      length -= 255;
+    }
+  out[op++] = length;
+}
+
+/**
+ * \brief Write a sequence
+ * \param out the output
+ * \param op the position in the output
+ * \param maxOut the size of the output
+ * \param literals the literals
+ * \param nLiterals the number of literals
+ * \param offset the distance of the match
+ * \param matchLength the length of the match, 0 for the last sequence
+ * \return false if the output is full
+ */
+static bool
+LzWriteSequence (uint8_t *out, uint32_t &op, uint32_t maxOut, const uint8_t *literals,
+                 uint32_t nLiterals, uint32_t offset, uint32_t matchLength)
+{
+  uint32_t needed = 1 + nLiterals / 255 + 1 + nLiterals + 2 + matchLength / 255 + 1;
+  if (op + needed > maxOut)
+    {
+      return false;
+    }
+  uint32_t matchCode = matchLength > 0 ? matchLength - LZ_MIN_MATCH : 0;
+  out[op++] = (std::min (nLiterals, 15U) << 4) | std::min (matchCode, 15U);
+  if (nLiterals >= 15)
+    {
+      LzWriteLength (out, op, nLiterals - 15);
+    }
+  std::memcpy (out + op, literals, nLiterals);
+  op += nLiterals;
+  if (matchLength > 0)
+    {
+      out[op++] = offset;
+      out[op++] = offset >> 8;
+      if (matchCode >= 15)
+        {
+          LzWriteLength (out, op, matchCode - 15);
+        }
+    }
+  return true;
+}
+
+uint32_t
+BlockCompression::LzCompress (const uint8_t *in, uint32_t size, uint8_t *out, uint32_t maxOut)
+{
+  std::vector<uint32_t> table (1 << LZ_HASH_BITS, LZ_NO_POSITION);
+  uint32_t op = 0;
+  uint32_t anchor = 0;
+  uint32_t ip = 0;
+  while (ip + LZ_MIN_MATCH <= size)
+    {
+      uint32_t sequence;
+      std::memcpy (&sequence, in + ip, sizeof (sequence));
+      uint32_t hash = (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+      uint32_t ref = table[hash];
+      table[hash] = ip;
+      if (ref != LZ_NO_POSITION && ip - ref <= LZ_MAX_OFFSET
+          && std::memcmp (in + ref, in + ip, LZ_MIN_MATCH) == 0)
+        {
+          uint32_t length = LZ_MIN_MATCH;
+          while (ip + length < size && in[ref + length] == in[ip + length])
+            {
+              length++;
+            }
+          if (!LzWriteSequence (out, op, maxOut, in + anchor, ip - anchor, ip - ref, length))
+            {
+              return 0;
+            }
+          ip += length;
+          anchor = ip;
+        }
+      else
+        {
+          ip++;
+        }
+    }
+  if (!LzWriteSequence (out, op, maxOut, in + anchor, size - anchor, 0, 0))
+    {
+      return 0;
+    }
+  return op;
+}
+
+/**
+ * \brief Read a length continued after a token nibble
+ * \param in the input
+ * \param ip the position in the input
+ * \param inSize the size of the input
+ * \param length the length (updated)
+ * \return false if the input is truncated
+ */
+static bool
+LzReadLength (const uint8_t *in, uint32_t &ip, uint32_t inSize, uint32_t &length)
+{
+  uint8_t byte;
+  do
+    {
+      if (ip >= inSize)
+        {
+          return false;
+        }
+      byte = in[ip++];
+      length += byte;
+    }
+  while (byte == 255);
+  return true;
+}
+
+bool
+BlockCompression::LzDecompress (const uint8_t *in, uint32_t inSize, uint8_t *out, uint32_t size)
+{
+  uint32_t ip = 0;
+  uint32_t op = 0;
+  while (ip < inSize)
+    {
+      uint8_t token = in[ip++];
+      uint32_t nLiterals = token >> 4;
+      if (nLiterals == 15 && !LzReadLength (in, ip, inSize, nLiterals))
+        {
+          return false;
+        }
+      if (ip + nLiterals > inSize || op + nLiterals > size)
+        {
+          return false;
+        }
+      std::memcpy (out + op, in + ip, nLiterals);
+      ip += nLiterals;
+      op += nLiterals;
+      if (ip == inSize)
+        {
+          break;
+        }
+
+      if (ip + 2 > inSize)
+        {
+          return false;
+        }
+      uint32_t offset = in[ip] | (in[ip + 1] << 8);
+      ip += 2;
+      uint32_t length = token & 0xf;
+      if (length == 15 && !LzReadLength (in, ip, inSize, length))
+        {
+          return false;
+        }
+      length += LZ_MIN_MATCH;
+      if (offset == 0 || offset > op || op + length > size)
+        {
+          return false;
+        }
+      // the match may overlap the bytes it produces
+      for (uint32_t i = 0; i < length; i++, op++)
+        {
+          out[op] = out[op - offset];
+        }
+    }
+  return op == size;
+}
+
+CompressedOutputStreamBuf::CompressedOutputStreamBuf ()
+  : m_codec (BlockCompression::NONE)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CompressedOutputStreamBuf::~CompressedOutputStreamBuf ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+CompressedOutputStreamBuf::Open (std::string const &filename, std::ios::openmode mode,
+                                 BlockCompression::Codec codec, uint32_t frameSize)
+{
+  NS_LOG_FUNCTION (this << filename << mode << codec << frameSize);
+  NS_ASSERT (!m_file.is_open () && frameSize > 0 && frameSize <= BlockCompression::FRAME_SIZE_MAX);
+
+  m_codec = codec;
+  bool append = (mode & std::ios::app) != 0;
+  if (append)
+    {
+      // the frames appended use the codec of the existing file
+      std::ifstream existing (filename.c_str (), std::ios::in | std::ios::binary);
+      uint8_t header[BlockCompression::FILE_HEADER_SIZE];
+      if (existing.read ((char *)header, sizeof (header)))
+        {
+          if (!BlockCompression::ParseFileHeader (header, m_codec))
+            {
+              return false;
+            }
+        }
+      else
+        {
+          append = false;
+        }
+    }
+
+  std::ios::openmode fileMode = std::ios::out | std::ios::binary;
+  fileMode |= append ? std::ios::app : std::ios::trunc;
+  m_file.open (filename.c_str (), fileMode);
+  if (!m_file.is_open ())
+    {
+      return false;
+    }
+  if (!append)
+    {
+      uint8_t header[BlockCompression::FILE_HEADER_SIZE];
+      BlockCompression::MakeFileHeader (m_codec, header);
+      m_file.write ((const char *)header, sizeof (header));
+    }
+
+  m_buffer.resize (frameSize);
+  setp (&m_buffer[0], &m_buffer[0] + m_buffer.size ());
+  return m_file.good ();
+}
+
+bool
+CompressedOutputStreamBuf::IsOpen (void) const
+{
+  return m_file.is_open ();
+}
+
+bool
+CompressedOutputStreamBuf::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return true;
+    }
+  bool ok = WriteFrame ();
+  m_file.close ();
+  setp (0, 0);
+  return ok && !m_file.fail ();
+}
+
+bool
+CompressedOutputStreamBuf::WriteFrame (void)
+{
+  uint32_t size = pptr () - pbase ();
+  if (size == 0)
+    {
+      return m_file.good ();
+    }
+  BlockCompression::Compress (m_codec, (const uint8_t *)pbase (), size, m_frame);
+  m_file.write ((const char *)&m_frame[0], m_frame.size ());
+  setp (&m_buffer[0], &m_buffer[0] + m_buffer.size ());
+  return m_file.good ();
+}
+
+CompressedOutputStreamBuf::int_type
+CompressedOutputStreamBuf::overflow (int_type c)
+{
+  if (!m_file.is_open () || !WriteFrame ())
+    {
+      return traits_type::eof ();
+    }
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  *pptr () = traits_type::to_char_type (c);
+  pbump (1);
+  return c;
+}
+
+int
+CompressedOutputStreamBuf::sync (void)
+{
+  if (!m_file.is_open ())
+    {
+      return 0;
+    }
+  bool ok = WriteFrame ();
+  m_file.flush ();
+  return ok && m_file.good () ? 0 : -1;
+}
+
+CompressedInputStreamBuf::CompressedInputStreamBuf ()
+  : m_source (0),
+    m_codec (BlockCompression::NONE),
+    m_complete (false),
+    m_current (NO_FRAME)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+CompressedInputStreamBuf::Open (std::streambuf *source)
+{
+  NS_LOG_FUNCTION (this << source);
+
+  m_source = source;
+  m_frames.clear ();
+  m_complete = false;
+  m_current = NO_FRAME;
+  setg (0, 0, 0);
+
+  uint8_t header[BlockCompression::FILE_HEADER_SIZE];
+  if (m_source->pubseekpos (0, std::ios::in) != pos_type (0)
+      || m_source->sgetn ((char *)header, sizeof (header)) != sizeof (header)
+      || !BlockCompression::ParseFileHeader (header, m_codec)
+      || !BlockCompression::IsAvailable (m_codec))
+    {
+      m_complete = true;
+      return false;
+    }
+  return true;
+}
+
+bool
+CompressedInputStreamBuf::IndexNextFrame (void)
+{
+  if (m_complete)
+    {
+      return false;
+    }
+
+  Frame frame;
+  frame.m_position = BlockCompression::FILE_HEADER_SIZE;
+  frame.m_start = 0;
+  if (!m_frames.empty ())
+    {
+      const Frame &last = m_frames.back ();
+      frame.m_position = last.m_position + BlockCompression::FRAME_HEADER_SIZE + last.m_compressedSize;
+      frame.m_start = last.m_start + last.m_size;
+    }
+
+  uint8_t header[BlockCompression::FRAME_HEADER_SIZE];
+  if (m_source->pubseekpos (frame.m_position, std::ios::in) != pos_type (frame.m_position)
+      || m_source->sgetn ((char *)header, sizeof (header)) != sizeof (header))
+    {
+      m_complete = true;
+      return false;
+    }
+  frame.m_compressedSize = ReadLe32 (header);
+  frame.m_size = ReadLe32 (header + 4);
+  if (frame.m_size > BlockCompression::FRAME_SIZE_MAX || frame.m_compressedSize > frame.m_size)
+    {
+      // the writers never store such frames: do not allocate their sizes
+      NS_LOG_WARN ("Corrupted header of frame " << m_frames.size ());
+      m_complete = true;
+      return false;
+    }
+  m_frames.push_back (frame);
+  return true;
+}
+
+bool
+CompressedInputStreamBuf::LoadFrame (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+
+  const Frame &frame = m_frames[index];
+  if (frame.m_size == 0)
+    {
+      m_current = index;
+      setg (m_buffer.data (), m_buffer.data (), m_buffer.data ());
+      return true;
+    }
+  // decompress aside, so that the current frame is kept if this one is corrupted
+  m_payload.resize (frame.m_compressedSize);
+  m_spare.resize (frame.m_size);
+  pos_type position = frame.m_position + BlockCompression::FRAME_HEADER_SIZE;
+  if (m_source->pubseekpos (position, std::ios::in) != position
+      || m_source->sgetn ((char *)m_payload.data (), frame.m_compressedSize) != std::streamsize (frame.m_compressedSize)
+      || !BlockCompression::Decompress (m_codec, m_payload.data (), frame.m_compressedSize,
+                                        (uint8_t *)m_spare.data (), frame.m_size))
+    {
+      NS_LOG_WARN ("Corrupted frame " << index);
+      m_complete = true;
+      return false;
+    }
+  m_buffer.swap (m_spare);
+  m_current = index;
+  setg (m_buffer.data (), m_buffer.data (), m_buffer.data () + frame.m_size);
+  return true;
+}
+
+CompressedInputStreamBuf::int_type
+CompressedInputStreamBuf::underflow (void)
+{
+  if (gptr () < egptr ())
+    {
+      return traits_type::to_int_type (*gptr ());
+    }
+  uint32_t next = m_current == NO_FRAME ? 0 : m_current + 1;
+  while (true)
+    {
+      if (next >= m_frames.size () && !IndexNextFrame ())
+        {
+          return traits_type::eof ();
+        }
+      if (!LoadFrame (next))
+        {
+          return traits_type::eof ();
+        }
+      if (gptr () < egptr ())
+        {
+          return traits_type::to_int_type (*gptr ());
+        }
+      next++;
+    }
+}
+
+CompressedInputStreamBuf::pos_type
+CompressedInputStreamBuf::SeekTo (uint64_t offset)
+{
+  NS_LOG_FUNCTION (this << offset);
+
+  while (m_frames.empty () || m_frames.back ().m_start + m_frames.back ().m_size <= offset)
+    {
+      if (!IndexNextFrame ())
+        {
+          break;
+        }
+    }
+  uint64_t end = m_frames.empty () ? 0 : m_frames.back ().m_start + m_frames.back ().m_size;
+  if (offset > end)
+    {
+      return pos_type (off_type (-1));
+    }
+  if (m_frames.empty ())
+    {
+      setg (0, 0, 0);
+      m_current = NO_FRAME;
+      return pos_type (0);
+    }
+
+  // the last frame starting at or before the offset
+  uint32_t index = m_frames.size () - 1;
+  uint32_t low = 0;
+  while (low < index)
+    {
+      uint32_t middle = (low + index + 1) / 2;
+      if (m_frames[middle].m_start <= offset)
+        {
+          low = middle;
+        }
+      else
+        {
+          index = middle - 1;
+        }
+    }
+  if (index != m_current && !LoadFrame (index))
+    {
+      return pos_type (off_type (-1));
+    }
+  setg (eback (), eback () + (offset - m_frames[index].m_start), egptr ());
+  return pos_type (offset);
+}
+
+CompressedInputStreamBuf::pos_type
+CompressedInputStreamBuf::seekoff (off_type off, std::ios_base::seekdir dir,
+                                   std::ios_base::openmode which)
+{
+  if ((which & std::ios::in) == 0 || m_source == 0)
+    {
+      return pos_type (off_type (-1));
+    }
+  off_type base = 0;
+  if (dir == std::ios::cur)
+    {
+      base = m_current == NO_FRAME ? 0 : m_frames[m_current].m_start + (gptr () - eback ());
+    }
+  else if (dir == std::ios::end)
+    {
+      while (IndexNextFrame ())
+        {
+        }
+      base = m_frames.empty () ? 0 : m_frames.back ().m_start + m_frames.back ().m_size;
+    }
+  if (base + off < 0)
+    {
+      return pos_type (off_type (-1));
+    }
+  return SeekTo (base + off);
+}
+
+CompressedInputStreamBuf::pos_type
+CompressedInputStreamBuf::seekpos (pos_type pos, std::ios_base::openmode which)
+{
+  return seekoff (off_type (pos), std::ios::beg, which);
+}
+
+CompressedOutputStream::CompressedOutputStream ()
+  : std::ostream (0)
+{
+  NS_LOG_FUNCTION (this);
+  rdbuf (&m_buffer);
+}
+
+void
+CompressedOutputStream::open (std::string const &filename, std::ios::openmode mode,
+                              BlockCompression::Codec codec)
+{
+  NS_LOG_FUNCTION (this << filename << mode << codec);
+  if (m_buffer.Open (filename, mode, codec))
+    {
+      clear ();
+    }
+  else
+    {
+      setstate (std::ios::failbit);
+    }
+}
+
+bool
+CompressedOutputStream::is_open (void) const
+{
+  return m_buffer.IsOpen ();
+}
+
+void
+CompressedOutputStream::close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_buffer.Close ())
+    {
+      setstate (std::ios::failbit);
+    }
+}
+
+CompressedInputStream::CompressedInputStream ()
+  : std::istream (0)
+{
+  NS_LOG_FUNCTION (this);
+  rdbuf (&m_buffer);
+}
+
+void
+CompressedInputStream::open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (m_file.open (filename.c_str (), std::ios::in | std::ios::binary) == 0
+      || !m_buffer.Open (&m_file))
+    {
+      setstate (std::ios::failbit);
+      return;
+    }
+  clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,324 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COMPRESSED_STREAM_H
+#define COMPRESSED_STREAM_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Block-framed compression of trace files
+ *
+ * A compressed file starts with a header of 8 bytes: the magic "NS3Z", a
+ * format version, the id of the codec and two reserved bytes.  It is then
+ * a sequence of frames, each holding a block of the original data
+ * compressed on its own: the size of the compressed data and the size of
+ * the original data (32-bit little endian), then the compressed data.  A
+ * frame whose two sizes are equal holds the data uncompressed.
+ *
+ * Since the frames are independent, a reader can seek to any offset of
+ * the original data by skipping over the frames before it, and frames can
+ * be appended to an existing file.
+ *
+ * The zlib codec is available when the zlib library was found at
+ * configuration time; the LZ codec, a simple LZ77 variant, is always
+ * available.
+ */
+class BlockCompression
+{
+public:
+  /// The compression codecs
+  enum Codec
+  {
+    NONE = 0,   //!< No compression
+    LZ = 1,     //!< Built-in LZ77 compression
+    ZLIB = 2    //!< zlib (deflate) compression
+  };
+
+  static const uint32_t FRAME_SIZE_DEFAULT = 1 << 18;  /**< Default size of the blocks of original data */
+  static const uint32_t FILE_HEADER_SIZE = 8;          /**< Size of the file header */
+  static const uint32_t FRAME_HEADER_SIZE = 8;         /**< Size of the frame header */
+  static const uint32_t FRAME_SIZE_MAX = 1 << 26;      /**< Largest size of the blocks accepted by the readers */
+
+  /**
+   * \param codec a codec
+   * \return true if the codec can be used
+   */
+  static bool IsAvailable (Codec codec);
+
+  /**
+   * \brief Get the codec of the trace files
+   *
+   * The codec is set by the "TraceCompression" global value.  When zlib is
+   * not available, the LZ codec is used instead.
+   *
+   * \return the codec
+   */
+  static Codec GetTraceCodec (void);
+
+  /**
+   * \brief Write the header of a compressed file
+   * \param codec the codec of the frames
+   * \param header the header (FILE_HEADER_SIZE bytes, output)
+   */
+  static void MakeFileHeader (Codec codec, uint8_t *header);
+
+  /**
+   * \brief Parse the header of a compressed file
+   * \param header the header (FILE_HEADER_SIZE bytes)
+   * \param codec the codec of the frames (output)
+   * \return true if the header is that of a compressed file
+   */
+  static bool ParseFileHeader (const uint8_t *header, Codec &codec);
+
+  /**
+   * \brief Compress a block into a frame
+   * \param codec the codec
+   * \param data the block
+   * \param size the size of the block
+   * \param frame the frame, header included (output)
+   */
+  static void Compress (Codec codec, const uint8_t *data, uint32_t size, std::vector<uint8_t> &frame);
+
+  /**
+   * \brief Decompress the data of a frame
+   * \param codec the codec
+   * \param payload the compressed data
+   * \param compressedSize the size of the compressed data
+   * \param data the original data (output)
+   * \param size the size of the original data
+   * \return true if the data could be decompressed
+   */
+  static bool Decompress (Codec codec, const uint8_t *payload, uint32_t compressedSize,
+                          uint8_t *data, uint32_t size);
+
+private:
+  /**
+   * \brief Compress a block with the LZ codec
+   * \param in the block
+   * \param size the size of the block
+   * \param out the compressed data (output)
+   * \param maxOut the space available for the compressed data
+   * \return the size of the compressed data, 0 if it does not fit
+   */
+  static uint32_t LzCompress (const uint8_t *in, uint32_t size, uint8_t *out, uint32_t maxOut);
+
+  /**
+   * \brief Decompress a block compressed with the LZ codec
+   * \param in the compressed data
+   * \param inSize the size of the compressed data
+   * \param out the original data (output)
+   * \param size the size of the original data
+   * \return true if the data could be decompressed
+   */
+  static bool LzDecompress (const uint8_t *in, uint32_t inSize, uint8_t *out, uint32_t size);
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief A stream buffer compressing the data written into a file
+ *
+ * The data is compressed by blocks when the buffer is full or synced.
+ */
+class CompressedOutputStreamBuf : public std::streambuf
+{
+public:
+  CompressedOutputStreamBuf ();
+  virtual ~CompressedOutputStreamBuf ();
+
+  /**
+   * \brief Open a file
+   * \param filename the name of the file
+   * \param mode std::ios::openmode flags; with std::ios::app, frames are
+   * appended to an existing compressed file
+   * \param codec the codec
+   * \param frameSize the size of the blocks compressed
+   * \return true if the file could be opened
+   */
+  bool Open (std::string const &filename, std::ios::openmode mode,
+             BlockCompression::Codec codec,
+             uint32_t frameSize = BlockCompression::FRAME_SIZE_DEFAULT);
+
+  /**
+   * \return true if the file is open
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Compress the pending data and close the file
+   * \return true if all the data was written
+   */
+  bool Close (void);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual int sync (void);
+
+private:
+  /**
+   * \brief Compress and write the pending data
+   * \return true if the frame was written
+   */
+  bool WriteFrame (void);
+
+  std::ofstream m_file;                //!< File
+  BlockCompression::Codec m_codec;     //!< Codec
+  std::vector<char> m_buffer;          //!< Pending data
+  std::vector<uint8_t> m_frame;        //!< Frame being written
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief A stream buffer reading the original data of a compressed file
+ *
+ * The frames are decompressed one at a time.  Seeking within the original
+ * data only reads the headers of the frames skipped.
+ */
+class CompressedInputStreamBuf : public std::streambuf
+{
+public:
+  CompressedInputStreamBuf ();
+
+  /**
+   * \brief Read the compressed data from a source
+   * \param source the source, holding a compressed file from its start
+   * \return true if the source holds a compressed file
+   */
+  bool Open (std::streambuf *source);
+
+protected:
+  virtual int_type underflow (void);
+  virtual pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                            std::ios_base::openmode which = std::ios_base::in);
+  virtual pos_type seekpos (pos_type pos,
+                            std::ios_base::openmode which = std::ios_base::in);
+
+private:
+  /// A frame found in the source
+  struct Frame
+  {
+    uint64_t m_position;        //!< Position of the frame in the source
+    uint64_t m_start;           //!< Offset of its data in the original data
+    uint32_t m_compressedSize;  //!< Size of the compressed data
+    uint32_t m_size;            //!< Size of the original data
+  };
+
+  /**
+   * \brief Find the header of the frame following the last one known
+   *
+   * Headers with a size larger than BlockCompression::FRAME_SIZE_MAX, or a
+   * compressed size larger than the size, are rejected as corrupted.
+   *
+   * \return true if a frame was found
+   */
+  bool IndexNextFrame (void);
+
+  /**
+   * \brief Decompress a frame into the get area
+   *
+   * If the frame can not be decompressed, the get area is left unchanged.
+   *
+   * \param index the index of the frame
+   * \return true if the frame was decompressed
+   */
+  bool LoadFrame (uint32_t index);
+
+  /**
+   * \brief Move to an offset of the original data
+   * \param offset the offset
+   * \return the new position, -1 if out of range
+   */
+  pos_type SeekTo (uint64_t offset);
+
+  std::streambuf *m_source;            //!< Compressed data
+  BlockCompression::Codec m_codec;     //!< Codec
+  std::vector<Frame> m_frames;         //!< Frames found so far
+  bool m_complete;                     //!< True if all the frames are known
+  uint32_t m_current;                  //!< Index of the frame in the get area
+  std::vector<char> m_buffer;          //!< Data of the current frame
+  std::vector<char> m_spare;           //!< Data of the frame being loaded
+  std::vector<uint8_t> m_payload;      //!< Compressed data of the current frame
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief An output file stream compressing the data written
+ */
+class CompressedOutputStream : public std::ostream
+{
+public:
+  CompressedOutputStream ();
+
+  /**
+   * \brief Open a file
+   * \param filename the name of the file
+   * \param mode std::ios::openmode flags
+   * \param codec the codec
+   */
+  void open (std::string const &filename, std::ios::openmode mode, BlockCompression::Codec codec);
+
+  /**
+   * \return true if the file is open
+   */
+  bool is_open (void) const;
+
+  /**
+   * \brief Write the pending data and close the file
+   */
+  void close (void);
+
+private:
+  CompressedOutputStreamBuf m_buffer;  //!< Compressing buffer
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief An input file stream reading the original data of a compressed file
+ */
+class CompressedInputStream : public std::istream
+{
+public:
+  CompressedInputStream ();
+
+  /**
+   * \brief Open a compressed file; the fail bit is set if the file could
+   * not be opened or is not compressed
+   * \param filename the name of the file
+   */
+  void open (std::string const &filename);
+
+private:
+  std::filebuf m_file;                 //!< Compressed file
+  CompressedInputStreamBuf m_buffer;   //!< Decompressing buffer
+};
+
+} // namespace ns3
+
+#endif /* COMPRESSED_STREAM_H */
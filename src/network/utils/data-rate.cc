@@ -235,15 +235,13 @@ double DataRate::CalculateTxTime (uint32_t bytes) const
 Time DataRate::CalculateBytesTxTime (uint32_t bytes) const
 {
   NS_LOG_FUNCTION (this << bytes);
-  // \todo avoid to use double (if possible).
-  return Seconds (static_cast<double>(bytes)*8/m_bps);
+  return Time::FromRatio (static_cast<uint64_t> (bytes) * 8, m_bps, Time::S);
 }
 
 Time DataRate::CalculateBitsTxTime (uint32_t bits) const
 {
   NS_LOG_FUNCTION (this << bits);
-  // \todo avoid to use double (if possible).
-  return Seconds (static_cast<double>(bits)/m_bps);
+  return Time::FromRatio (bits, m_bps, Time::S);
 }
 
 uint64_t DataRate::GetBitRate () const
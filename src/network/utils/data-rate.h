@@ -165,7 +165,8 @@ public:
    *
    * Calculates the transmission time at this data rate
    * \param bytes The number of bytes (not bits) for which to calculate
-   * \return The transmission time for the number of bytes specified
+   * \return The transmission time for the number of bytes specified,
+   *         rounded down to the resolution of Time
    */
   Time CalculateBytesTxTime (uint32_t bytes) const;
 
@@ -174,7 +175,8 @@ public:
    *
    * Calculates the transmission time at this data rate
    * \param bits The number of bits (not bytes) for which to calculate
-   * \return The transmission time for the number of bits specified
+   * \return The transmission time for the number of bits specified,
+   *         rounded down to the resolution of Time
    */
   Time CalculateBitsTxTime (uint32_t bits) const;
 
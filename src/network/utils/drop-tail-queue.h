@@ -50,6 +50,8 @@ public:
   virtual Ptr<Item> Dequeue (void);
   virtual Ptr<Item> Remove (void);
   virtual Ptr<const Item> Peek (void) const;
+  virtual std::size_t EnqueueBatch (const std::vector<Ptr<Item> > &items);
+  virtual std::size_t DequeueBatch (std::vector<Ptr<Item> > &items, std::size_t maxItems);
 
 private:
   using Queue<Item>::begin;
@@ -58,6 +60,8 @@ private:
   using Queue<Item>::DoDequeue;
   using Queue<Item>::DoRemove;
   using Queue<Item>::DoPeek;
+  using Queue<Item>::DoEnqueueBatch;
+  using Queue<Item>::DoDequeueBatch;
 
   NS_LOG_TEMPLATE_DECLARE;     //!< redefinition of the log component
 };
@@ -137,6 +141,28 @@ DropTailQueue<Item>::Peek (void) const
   return DoPeek (begin ());
 }
 
+template <typename Item>
+std::size_t
+DropTailQueue<Item>::EnqueueBatch (const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  return DoEnqueueBatch (end (), items);
+}
+
+template <typename Item>
+std::size_t
+DropTailQueue<Item>::DequeueBatch (std::vector<Ptr<Item> > &items, std::size_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  std::size_t n = DoDequeueBatch (items, maxItems);
+
+  NS_LOG_LOGIC ("Popped " << n << " items");
+
+  return n;
+}
+
 // The following explicit template instantiation declarations prevent all the
 // translation units including this header file to implicitly instantiate the
 // DropTailQueue<Packet> class and the DropTailQueue<QueueDiscItem> class. The
@@ -24,6 +24,9 @@
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 #include "ns3/queue-item.h"
+#include "ns3/packet.h"
+#include "ns3/hash.h"
+#include <cstring>
 
 namespace ns3 {
 
@@ -43,6 +46,7 @@ NetDeviceQueue::~NetDeviceQueue ()
 
   m_queueLimits = 0;
   m_wakeCallback.Nullify ();
+  m_availablePackets = nullptr;
   m_device = 0;
 }
 
@@ -255,4 +259,58 @@ NetDeviceQueueInterface::GetSelectQueueCallback (void) const
   return m_selectQueueCallback;
 }
 
+uint32_t
+NetDeviceQueue::GetNAvailablePackets (void) const
+{
+  return (m_availablePackets ? m_availablePackets () : 0);
+}
+
+uint32_t
+NetDeviceQueueInterface::GetFlowHash (Ptr<const Packet> packet, uint16_t protocol, uint32_t perturbation)
+{
+  // the network header (with IPv4 options) and the transport ports, at most
+  uint8_t header[64];
+  uint32_t size = packet->CopyData (header, sizeof (header));
+
+  // serialize the 5-tuple and the perturbation in buf, as the queue disc items
+  uint8_t buf[41];
+  uint32_t addrLen;
+  uint8_t prot;
+  uint32_t l4Offset;
+  if (protocol == 0x0800 && size >= 20)
+    {
+      addrLen = 8;
+      std::memcpy (buf, header + 12, addrLen);
+      prot = header[9];
+      // no transport header in the fragments other than the first one
+      bool firstFragment = (header[6] & 0x1f) == 0 && header[7] == 0;
+      l4Offset = firstFragment ? (header[0] & 0x0f) * 4 : size;
+    }
+  else if (protocol == 0x86dd && size >= 40)
+    {
+      addrLen = 32;
+      std::memcpy (buf, header + 8, addrLen);
+      prot = header[6];
+      l4Offset = 40;
+    }
+  else
+    {
+      return 0;
+    }
+
+  // the ports are in network byte order in both the packet and buf
+  std::memset (buf + addrLen + 1, 0, 4);
+  if ((prot == 6 || prot == 17) && l4Offset + 4 <= size)
+    {
+      std::memcpy (buf + addrLen + 1, header + l4Offset, 4);
+    }
+  buf[addrLen] = prot;
+  buf[addrLen + 5] = (perturbation >> 24) & 0xff;
+  buf[addrLen + 6] = (perturbation >> 16) & 0xff;
+  buf[addrLen + 7] = (perturbation >> 8) & 0xff;
+  buf[addrLen + 8] = perturbation & 0xff;
+
+  return Hash32 ((char*) buf, addrLen + 9);
+}
+
 } // namespace ns3
@@ -27,6 +27,7 @@
 #include "ns3/ptr.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
+#include "ns3/queue-size.h"
 
 namespace ns3 {
 
@@ -196,12 +197,34 @@ public:
   template <typename QueueType>
   void ConnectQueueTraces (Ptr<QueueType> queue);
 
+  /**
+   * \brief Get the room left in the device queue
+   * \return the number of packets of the MTU size that can still be stored
+   *         in the queue connected by ConnectQueueTraces (the queue is stopped
+   *         when it is zero), or zero if no queue is connected
+   *
+   * This allows the upper layers to send a batch of packets to the device
+   * without having the queue stopped in the middle of the batch.
+   */
+  uint32_t GetNAvailablePackets (void) const;
+
 private:
+  /**
+   * \brief Compute the room left in a queue
+   * \param queue the queue
+   * \return the number of packets of the MTU size that can still be stored
+   *         in the queue
+   */
+  template <typename QueueType>
+  uint32_t GetNAvailablePackets (const QueueType* queue) const;
+
+
   bool m_stoppedByDevice;         //!< True if the queue has been stopped by the device
   bool m_stoppedByQueueLimits;    //!< True if the queue has been stopped by a queue limits object
   Ptr<QueueLimits> m_queueLimits; //!< Queue limits object
   WakeCallback m_wakeCallback;    //!< Wake callback
   Ptr<NetDevice> m_device;        //!< the netdevice aggregated to the NetDeviceQueueInterface
+  std::function<uint32_t (void)> m_availablePackets;  //!< Room left in the connected queue
 
   NS_LOG_TEMPLATE_DECLARE;        //!< redefinition of the log component
 };
@@ -282,6 +305,23 @@ public:
    */
   SelectQueueCallback GetSelectQueueCallback (void) const;
 
+  /**
+   * \brief Compute the flow hash of a packet handed to a device.
+   * \param packet the packet, starting with its network header.
+   * \param protocol the protocol number of the network header.
+   * \param perturbation the salt added to the hash.
+   * \return the hash of the packet flow, or zero if the packet is not an IPv4
+   *         or IPv6 packet.
+   *
+   * The hash is computed on the same 5-tuple and in the same way as the
+   * Hash method of the IPv4 and IPv6 queue disc items, but from the bytes of
+   * the packet, like the receive side scaling (RSS) hash of network cards.
+   * Thus, a multi-queue device selecting the transmission queue of a packet
+   * from this hash agrees with a select queue callback using the Hash method
+   * of the queue disc item the packet was built from.
+   */
+  static uint32_t GetFlowHash (Ptr<const Packet> packet, uint16_t protocol, uint32_t perturbation);
+
 protected:
   /**
    * \brief Dispose of the object
@@ -317,6 +357,24 @@ NetDeviceQueue::ConnectQueueTraces (Ptr<QueueType> queue)
   queue->TraceConnectWithoutContext ("DropBeforeEnqueue",
                                      MakeCallback (&NetDeviceQueue::PacketDiscarded<QueueType>, this)
                                      .Bind (PeekPointer (queue)));
+  const QueueType* q = PeekPointer (queue);
+  m_availablePackets = [this, q] () { return GetNAvailablePackets (q); };
+}
+
+template <typename QueueType>
+uint32_t
+NetDeviceQueue::GetNAvailablePackets (const QueueType* queue) const
+{
+  NS_ASSERT_MSG (m_device, "Aggregated NetDevice not set");
+
+  QueueSize current = queue->GetCurrentSize ();
+  QueueSize max = queue->GetMaxSize ();
+  if (current.GetValue () >= max.GetValue ())
+    {
+      return 0;
+    }
+  uint32_t room = max.GetValue () - current.GetValue ();
+  return (max.GetUnit () == QueueSizeUnit::PACKETS ? room : room / m_device->GetMtu ());
 }
 
 template <typename QueueType>
@@ -328,13 +386,10 @@ NetDeviceQueue::PacketEnqueued (QueueType* queue, Ptr<const typename QueueType::
   // Inform BQL
   NotifyQueuedBytes (item->GetSize ());
 
-  NS_ASSERT_MSG (m_device, "Aggregated NetDevice not set");
-  Ptr<Packet> p = Create<Packet> (m_device->GetMtu ());
-
   // After enqueuing a packet, we need to check whether the queue is able to
-  // store another packet. If not, we stop the queue
+  // store another packet (of the MTU size). If not, we stop the queue
 
-  if (queue->GetCurrentSize () + p > queue->GetMaxSize ())
+  if (GetNAvailablePackets (queue) == 0)
     {
       NS_LOG_DEBUG ("The device queue is being stopped (" << queue->GetCurrentSize ()
                     << " inside)");
@@ -351,14 +406,11 @@ NetDeviceQueue::PacketDequeued (QueueType* queue, Ptr<const typename QueueType::
   // Inform BQL
   NotifyTransmittedBytes (item->GetSize ());
 
-  NS_ASSERT_MSG (m_device, "Aggregated NetDevice not set");
-  Ptr<Packet> p = Create<Packet> (m_device->GetMtu ());
-
-  // After dequeuing a packet, if there is room for another packet we
-  // call Wake () that ensures that the queue is not stopped and restarts
-  // the queue disc if the queue was stopped
+  // After dequeuing a packet, if there is room for another packet (of the
+  // MTU size) we call Wake () that ensures that the queue is not stopped and
+  // restarts the queue disc if the queue was stopped
 
-  if (queue->GetCurrentSize () + p <= queue->GetMaxSize ())
+  if (GetNAvailablePackets (queue) > 0)
     {
       Wake ();
     }
@@ -38,6 +38,30 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
                        "Unable to Open " << filename << " for mode " << filemode);
 }
 
+OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmode filemode,
+                                          BlockCompression::Codec codec)
+  : m_destroyable (true)
+{
+  NS_LOG_FUNCTION (this << filename << filemode << codec);
+  if (codec == BlockCompression::NONE)
+    {
+      std::ofstream* os = new std::ofstream ();
+      os->open (filename.c_str (), filemode);
+      m_ostream = os;
+      NS_ABORT_MSG_UNLESS (os->is_open (), "AsciiTraceHelper::CreateFileStream():  " <<
+                           "Unable to Open " << filename << " for mode " << filemode);
+    }
+  else
+    {
+      CompressedOutputStream* os = new CompressedOutputStream ();
+      os->open (filename, filemode, codec);
+      m_ostream = os;
+      NS_ABORT_MSG_UNLESS (os->is_open (), "AsciiTraceHelper::CreateFileStream():  " <<
+                           "Unable to Open " << filename << " for mode " << filemode);
+    }
+  FatalImpl::RegisterStream (m_ostream);
+}
+
 OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
   : m_ostream (os), m_destroyable (false)
 {
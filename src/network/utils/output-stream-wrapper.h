@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "compressed-stream.h"
 
 namespace ns3 {
 
@@ -76,6 +77,14 @@ public:
    * \param filemode std::ios::openmode flags
    */
   OutputStreamWrapper (std::string filename, std::ios::openmode filemode);
+  /**
+   * Constructor of a compressed file stream (see BlockCompression)
+   * \param filename file name
+   * \param filemode std::ios::openmode flags
+   * \param codec the codec compressing the file (NONE: plain file)
+   */
+  OutputStreamWrapper (std::string filename, std::ios::openmode filemode,
+                       BlockCompression::Codec codec);
   /**
    * Constructor
    * \param os output stream
@@ -46,12 +46,32 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("AsyncWrite",
+                   "Whether the records are buffered in memory and written to disk "
+                   "on a background thread.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("WriteBlockSize",
+                   "Size in bytes of the memory blocks used when AsyncWrite is set.",
+                   UintegerValue (AsyncFileWriter::BLOCK_SIZE_DEFAULT),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBlockSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxWriteBlocks",
+                   "Maximum number of memory blocks waiting to be written when AsyncWrite "
+                   "is set; further writes wait until a block has been written.",
+                   UintegerValue (AsyncFileWriter::MAX_BLOCKS_DEFAULT),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_maxWriteBlocks),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_ngInterface (0),
+    m_ngDataLinkType (0),
+    m_ngSnapLen (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +86,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -86,6 +110,8 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  // the shared pcapng file is closed by its owner
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -93,9 +119,44 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  if (m_asyncWrite)
+    {
+      m_file.EnableAsyncWrite (m_writeBlockSize, m_maxWriteBlocks);
+    }
   m_file.Open (filename, mode);
 }
 
+void
+PcapFileWrapper::EnableCompression (BlockCompression::Codec codec)
+{
+  NS_LOG_FUNCTION (this << codec);
+  m_file.EnableCompression (codec);
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      m_ngFile->Flush ();
+      return;
+    }
+  m_file.Flush ();
+}
+
+void
+PcapFileWrapper::OpenInterface (Ptr<PcapNgFile> file, uint32_t dataLinkType,
+                                std::string const &name, std::string const &description,
+                                uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << file << dataLinkType << name << description << snapLen);
+  m_ngSnapLen = snapLen != std::numeric_limits<uint32_t>::max () ? snapLen : m_snapLen;
+  m_ngDataLinkType = dataLinkType;
+  m_ngInterface = file->AddInterface (dataLinkType, m_ngSnapLen, name, description);
+  m_ngFile = file;
+}
+
 void
 PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -119,6 +180,11 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +205,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +230,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -246,6 +322,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_ngSnapLen;
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -253,6 +333,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_ngDataLinkType;
+    }
   return m_file.GetDataLinkType ();
 }
 
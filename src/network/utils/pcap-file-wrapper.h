@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -77,11 +78,41 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Compress the file written (see PcapFile::EnableCompression).  This must
+   * be called before Open.
+   *
+   * \param codec the codec
+   */
+  void EnableCompression (BlockCompression::Codec codec);
+
   /**
    * Close the underlying pcap file.
    */
   void Close (void);
 
+  /**
+   * Write all the buffered records to disk (when the "AsyncWrite"
+   * attribute is set).
+   */
+  void Flush (void);
+
+  /**
+   * Write the packets as those of an interface of a pcapng file shared with
+   * other wrappers, instead of a pcap file of their own.  The interface is
+   * described in the file; Init () must not be called.
+   *
+   * \param file the pcapng file, already open
+   * \param dataLinkType the data link type of the interface
+   * \param name the name of the interface
+   * \param description the description of the interface
+   * \param snapLen the maximum size for packets written to the file; the
+   * default means the "CaptureSize" attribute
+   */
+  void OpenInterface (Ptr<PcapNgFile> file, uint32_t dataLinkType,
+                      std::string const &name, std::string const &description,
+                      uint32_t snapLen = std::numeric_limits<uint32_t>::max ());
+
   /**
    * Initialize the pcap file associated with this wrapper.  This file must have
    * been previously opened with write permissions.
@@ -224,6 +255,13 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  bool     m_asyncWrite; //!< Write the file on a background thread
+  uint32_t m_writeBlockSize; //!< Size of the blocks of the background writer
+  uint32_t m_maxWriteBlocks; //!< Maximum number of blocks of the background writer
+  Ptr<PcapNgFile> m_ngFile; //!< Shared pcapng file, if any
+  uint32_t m_ngInterface; //!< Interface id in the pcapng file
+  uint32_t m_ngDataLinkType; //!< Data link type of the pcapng interface
+  uint32_t m_ngSnapLen; //!< Capture size of the pcapng interface
 };
 
 } // namespace ns3
@@ -50,7 +50,13 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_async (false),
+    m_asyncBlockSize (AsyncFileWriter::BLOCK_SIZE_DEFAULT),
+    m_asyncMaxBlocks (AsyncFileWriter::MAX_BLOCKS_DEFAULT),
+    m_writer (0),
+    m_codec (BlockCompression::NONE),
+    m_inflater (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,6 +74,10 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -88,7 +98,66 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
-  m_file.close ();
+  if (m_writer)
+    {
+      m_writer->Close ();
+      delete m_writer;
+      m_writer = 0;
+    }
+  if (m_inflater)
+    {
+      m_file.std::ios::rdbuf (m_file.rdbuf ());
+      delete m_inflater;
+      m_inflater = 0;
+    }
+  // the stream is not opened when the file is written by the writer
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+}
+
+void
+PcapFile::EnableAsyncWrite (uint32_t blockSize, uint32_t maxBlocks)
+{
+  NS_LOG_FUNCTION (this << blockSize << maxBlocks);
+  m_async = true;
+  m_asyncBlockSize = blockSize;
+  m_asyncMaxBlocks = maxBlocks;
+}
+
+void
+PcapFile::EnableCompression (BlockCompression::Codec codec)
+{
+  NS_LOG_FUNCTION (this << codec);
+  m_codec = codec;
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      m_writer->Flush ();
+    }
+  else
+    {
+      m_file.flush ();
+    }
+}
+
+void
+PcapFile::WriteData (const void *data, uint32_t size)
+{
+  if (m_writer)
+    {
+      m_writer->Write (data, size);
+    }
+  else
+    {
+      m_file.write ((const char *)data, size);
+    }
 }
 
 uint32_t
@@ -206,7 +275,10 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (m_writer == 0)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +306,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteData (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteData (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteData (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteData (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteData (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteData (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteData (&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -333,9 +405,32 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   mode |= std::ios::binary;
 
   m_filename=filename;
+  if ((m_async || m_codec != BlockCompression::NONE) && (mode & std::ios::in) == 0)
+    {
+      NS_ASSERT (m_writer == 0);
+      m_writer = new AsyncFileWriter ();
+      m_writer->Open (filename, m_asyncBlockSize, m_asyncMaxBlocks, m_codec);
+      return;
+    }
   m_file.open (filename.c_str (), mode);
   if (mode & std::ios::in)
     {
+      //
+      // A compressed file is read through a decompressing buffer, which
+      // replaces the file buffer of the stream (and reads from it) until
+      // the file is closed.
+      //
+      CompressedInputStreamBuf *inflater = new CompressedInputStreamBuf ();
+      if ((mode & std::ios::out) == 0 && m_file.is_open () && inflater->Open (m_file.rdbuf ()))
+        {
+          NS_LOG_LOGIC ("Reading a compressed file");
+          m_inflater = inflater;
+          m_file.std::ios::rdbuf (m_inflater);
+        }
+      else
+        {
+          delete inflater;
+        }
       // will set the fail bit if file header is invalid.
       ReadAndVerifyFileHeader ();
     }
@@ -400,23 +495,30 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
 }
 
 uint32_t
-PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
+PcapFile::MakePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, PcapRecordHeader *header)
 {
-  NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
-
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
-  PcapRecordHeader header;
-  header.m_tsSec = tsSec;
-  header.m_tsUsec = tsUsec;
-  header.m_inclLen = inclLen;
-  header.m_origLen = totalLen;
+  header->m_tsSec = tsSec;
+  header->m_tsUsec = tsUsec;
+  header->m_inclLen = inclLen;
+  header->m_origLen = totalLen;
 
   if (m_swapMode)
     {
-      Swap (&header, &header);
+      Swap (header, header);
     }
+  return inclLen;
+}
+
+uint32_t
+PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
+  NS_ASSERT (m_file.good ());
+
+  PcapRecordHeader header;
+  uint32_t inclLen = MakePacketHeader (tsSec, tsUsec, totalLen, &header);
 
   //
   // Watch out for memory alignment differences between machines, so write
@@ -434,6 +536,16 @@ void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
+  if (m_writer)
+    {
+      PcapRecordHeader header;
+      uint32_t inclLen = MakePacketHeader (tsSec, tsUsec, totalLen, &header);
+      uint8_t *record = m_writer->Reserve (sizeof (header) + inclLen);
+      std::memcpy (record, &header, sizeof (header));
+      std::memcpy (record + sizeof (header), data, inclLen);
+      m_writer->Commit (sizeof (header) + inclLen);
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -443,6 +555,17 @@ void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
+  if (m_writer)
+    {
+      // serialize the captured bytes only, in place
+      PcapRecordHeader header;
+      uint32_t inclLen = MakePacketHeader (tsSec, tsUsec, p->GetSize (), &header);
+      uint8_t *record = m_writer->Reserve (sizeof (header) + inclLen);
+      std::memcpy (record, &header, sizeof (header));
+      p->CopyData (record + sizeof (header), inclLen);
+      m_writer->Commit (sizeof (header) + inclLen);
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -454,11 +577,25 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &header << p);
   uint32_t headerSize = header.GetSerializedSize ();
   uint32_t totalSize = headerSize + p->GetSize ();
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
 
   Buffer headerBuffer;
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
+
+  if (m_writer)
+    {
+      PcapRecordHeader recordHeader;
+      uint32_t inclLen = MakePacketHeader (tsSec, tsUsec, totalSize, &recordHeader);
+      uint8_t *record = m_writer->Reserve (sizeof (recordHeader) + inclLen);
+      std::memcpy (record, &recordHeader, sizeof (recordHeader));
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      headerBuffer.CopyData (record + sizeof (recordHeader), toCopy);
+      p->CopyData (record + sizeof (recordHeader) + toCopy, inclLen - toCopy);
+      m_writer->Commit (sizeof (recordHeader) + inclLen);
+      return;
+    }
+
+  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
   uint32_t toCopy = std::min (headerSize, inclLen);
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "async-file-writer.h"
 
 namespace ns3 {
 
@@ -85,6 +86,39 @@ public:
    */
   void Close (void);
 
+  /**
+   * \brief Write the file on a background thread
+   *
+   * The records are serialized into memory blocks, written to disk by an
+   * AsyncFileWriter.  Only the first snapLen bytes of each packet are
+   * serialized.  This must be called before Open; it has no effect on
+   * files opened for reading.
+   *
+   * \param blockSize the size of the memory blocks
+   * \param maxBlocks the maximum number of blocks waiting to be written,
+   *        after which Write blocks until one has been written
+   */
+  void EnableAsyncWrite (uint32_t blockSize = AsyncFileWriter::BLOCK_SIZE_DEFAULT,
+                         uint32_t maxBlocks = AsyncFileWriter::MAX_BLOCKS_DEFAULT);
+
+  /**
+   * \brief Compress the file
+   *
+   * The file is written as a BlockCompression file, each block of the
+   * background writer (see EnableAsyncWrite) being compressed on its own
+   * on the I/O thread; compressed files are always written on that thread.
+   * This must be called before Open; compressed files opened for reading
+   * are recognized and decompressed whether or not this is called.
+   *
+   * \param codec the codec
+   */
+  void EnableCompression (BlockCompression::Codec codec);
+
+  /**
+   * \brief Write all the buffered records to disk
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -361,6 +395,23 @@ private:
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
 
+  /**
+   * \brief Build a record header, swapped if needed
+   * \param tsSec Time stamp (seconds part)
+   * \param tsUsec Time stamp (microseconds part)
+   * \param totalLen Total packet length
+   * \param [out] header the record header
+   * \return the length of the packet data to write
+   */
+  uint32_t MakePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, PcapRecordHeader *header);
+
+  /**
+   * \brief Write some data to the file or the background writer
+   * \param data the data
+   * \param size the size of the data
+   */
+  void WriteData (const void *data, uint32_t size);
+
   /**
    * \brief Read and verify a Pcap file header
    */
@@ -371,6 +422,12 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  bool m_async;                 //!< true if the file is written on a background thread
+  uint32_t m_asyncBlockSize;    //!< size of the blocks of the background writer
+  uint32_t m_asyncMaxBlocks;    //!< maximum number of blocks of the background writer
+  AsyncFileWriter *m_writer;    //!< background writer, if the file is written asynchronously
+  BlockCompression::Codec m_codec; //!< codec compressing the file written
+  CompressedInputStreamBuf *m_inflater; //!< buffer decompressing the file read, if compressed
 };
 
 } // namespace ns3
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/buffer.h"
+#include "ns3/header.h"
+#include "ns3/packet.h"
+
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+/// Option codes of the pcapng blocks
+enum PcapNgOption
+{
+  OPT_ENDOFOPT = 0,    //!< End of the options
+  IF_NAME = 2,         //!< Interface name
+  IF_DESCRIPTION = 3,  //!< Interface description
+  IF_TSRESOL = 9       //!< Interface timestamp resolution
+};
+
+/// Size of the fixed part of an Enhanced Packet Block, before the data
+static const uint32_t EPB_HEADER_SIZE = 28;
+/// Size of the block trailer (the repeated block length)
+static const uint32_t BLOCK_TRAILER_SIZE = 4;
+
+/**
+ * \param length a length in bytes
+ * \return the length padded to 32 bits
+ */
+static uint32_t
+Pad (uint32_t length)
+{
+  return (length + 3) & ~3U;
+}
+
+PcapNgFile::PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+PcapNgFile::Open (std::string const &filename, uint32_t blockSize, uint32_t maxBlocks,
+                  BlockCompression::Codec codec)
+{
+  NS_LOG_FUNCTION (this << filename << blockSize << maxBlocks << codec);
+
+  m_snapLen.clear ();
+  m_writer.Open (filename, blockSize, maxBlocks, codec);
+  if (m_writer.Fail ())
+    {
+      return;
+    }
+
+  std::string body;
+  uint32_t magic = BYTE_ORDER_MAGIC;
+  uint16_t major = 1;
+  uint16_t minor = 0;
+  int64_t sectionLength = -1;
+  body.append ((const char *)&magic, sizeof (magic));
+  body.append ((const char *)&major, sizeof (major));
+  body.append ((const char *)&minor, sizeof (minor));
+  body.append ((const char *)&sectionLength, sizeof (sectionLength));
+  WriteBlock (SHB_TYPE, body);
+}
+
+bool
+PcapNgFile::IsOpen (void) const
+{
+  return m_writer.IsOpen ();
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  return m_writer.Fail ();
+}
+
+void
+PcapNgFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Flush ();
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Close ();
+}
+
+void
+PcapNgFile::AppendOption (std::string &block, uint16_t code, const void *value, uint16_t length)
+{
+  block.append ((const char *)&code, sizeof (code));
+  block.append ((const char *)&length, sizeof (length));
+  if (length > 0)
+    {
+      block.append ((const char *)value, length);
+    }
+  block.append (Pad (length) - length, '\0');
+}
+
+void
+PcapNgFile::WriteBlock (uint32_t type, std::string const &body)
+{
+  NS_ASSERT (body.size () % 4 == 0);
+  uint32_t length = 12 + body.size ();
+  m_writer.Write (&type, sizeof (type));
+  m_writer.Write (&length, sizeof (length));
+  m_writer.Write (body.data (), body.size ());
+  m_writer.Write (&length, sizeof (length));
+}
+
+uint32_t
+PcapNgFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen,
+                          std::string const &name, std::string const &description)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name << description);
+  NS_ASSERT_MSG (m_writer.IsOpen (), "File not open");
+
+  std::string body;
+  uint16_t linkType = dataLinkType;
+  uint16_t reserved = 0;
+  body.append ((const char *)&linkType, sizeof (linkType));
+  body.append ((const char *)&reserved, sizeof (reserved));
+  body.append ((const char *)&snapLen, sizeof (snapLen));
+  if (!name.empty ())
+    {
+      AppendOption (body, IF_NAME, name.data (), name.size ());
+    }
+  if (!description.empty ())
+    {
+      AppendOption (body, IF_DESCRIPTION, description.data (), description.size ());
+    }
+  uint8_t resolution = 9; // nanoseconds
+  AppendOption (body, IF_TSRESOL, &resolution, sizeof (resolution));
+  AppendOption (body, OPT_ENDOFOPT, 0, 0);
+  WriteBlock (IDB_TYPE, body);
+
+  m_snapLen.push_back (snapLen);
+  return m_snapLen.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_snapLen.size ();
+}
+
+uint8_t *
+PcapNgFile::BeginPacketBlock (uint32_t interface, uint64_t timestamp, uint32_t totalLen, uint32_t &inclLen)
+{
+  NS_ASSERT_MSG (interface < m_snapLen.size (), "Unknown interface " << interface);
+
+  inclLen = std::min (totalLen, m_snapLen[interface]);
+  uint32_t blockLen = EPB_HEADER_SIZE + Pad (inclLen) + BLOCK_TRAILER_SIZE;
+  uint32_t header[EPB_HEADER_SIZE / 4] = {
+    EPB_TYPE, blockLen, interface,
+    static_cast<uint32_t> (timestamp >> 32), static_cast<uint32_t> (timestamp),
+    inclLen, totalLen
+  };
+  uint8_t *block = m_writer.Reserve (blockLen);
+  std::memcpy (block, header, EPB_HEADER_SIZE);
+  return block + EPB_HEADER_SIZE;
+}
+
+void
+PcapNgFile::EndPacketBlock (uint8_t *data, uint32_t inclLen)
+{
+  uint32_t padded = Pad (inclLen);
+  std::memset (data + inclLen, 0, padded - inclLen);
+  uint32_t blockLen = EPB_HEADER_SIZE + padded + BLOCK_TRAILER_SIZE;
+  std::memcpy (data + padded, &blockLen, sizeof (blockLen));
+  m_writer.Commit (blockLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t timestamp, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << p);
+  if (!m_writer.IsOpen ())
+    {
+      return;
+    }
+  uint32_t inclLen;
+  uint8_t *data = BeginPacketBlock (interface, timestamp, p->GetSize (), inclLen);
+  p->CopyData (data, inclLen);
+  EndPacketBlock (data, inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t timestamp, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << &header << p);
+  if (!m_writer.IsOpen ())
+    {
+      return;
+    }
+  uint32_t headerSize = header.GetSerializedSize ();
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+
+  uint32_t inclLen;
+  uint8_t *data = BeginPacketBlock (interface, timestamp, headerSize + p->GetSize (), inclLen);
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (data, toCopy);
+  p->CopyData (data + toCopy, inclLen - toCopy);
+  EndPacketBlock (data, inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t timestamp, uint8_t const *buffer, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << &buffer << totalLen);
+  if (!m_writer.IsOpen ())
+    {
+      return;
+    }
+  uint32_t inclLen;
+  uint8_t *data = BeginPacketBlock (interface, timestamp, totalLen, inclLen);
+  std::memcpy (data, buffer, inclLen);
+  EndPacketBlock (data, inclLen);
+}
+
+} // namespace ns3
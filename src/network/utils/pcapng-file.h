@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "async-file-writer.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \ingroup network
+ *
+ * \brief A pcapng capture file multiplexing the packets of many interfaces
+ *
+ * Each traced interface is described by an Interface Description Block,
+ * holding its data link type, its capture size, its name and a description
+ * giving its node and device ids.  Each packet is written in an Enhanced
+ * Packet Block referring to its interface, with a timestamp in nanoseconds.
+ * The blocks are written in the host byte order, as allowed by the format.
+ *
+ * The file is written on the background I/O thread of AsyncFileWriter.
+ * The packets written once the file is closed are dropped.
+ *
+ * See https://github.com/pcapng/pcapng for the file format.
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  static const uint32_t SHB_TYPE = 0x0A0D0D0A;       /**< Section Header Block type */
+  static const uint32_t IDB_TYPE = 0x00000001;       /**< Interface Description Block type */
+  static const uint32_t EPB_TYPE = 0x00000006;       /**< Enhanced Packet Block type */
+  static const uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D; /**< Byte-order magic of the Section Header Block */
+
+  PcapNgFile ();
+  ~PcapNgFile ();
+
+  /**
+   * \brief Create (or truncate) a file and write its Section Header Block
+   * \param filename the name of the file
+   * \param blockSize the size of the memory blocks of the writer
+   * \param maxBlocks the maximum number of blocks of the writer
+   * \param codec the codec compressing the file (see BlockCompression)
+   */
+  void Open (std::string const &filename,
+             uint32_t blockSize = AsyncFileWriter::BLOCK_SIZE_DEFAULT,
+             uint32_t maxBlocks = AsyncFileWriter::MAX_BLOCKS_DEFAULT,
+             BlockCompression::Codec codec = BlockCompression::NONE);
+
+  /**
+   * \return true if the file is open
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \return true if the file could not be opened or written
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Write all the pending blocks to disk
+   */
+  void Flush (void);
+
+  /**
+   * \brief Write all the pending blocks and close the file
+   */
+  void Close (void);
+
+  /**
+   * \brief Describe a new interface
+   * \param dataLinkType the data link type of the packets of the interface
+   * \param snapLen the maximum length of the packets stored
+   * \param name the name of the interface (empty: none)
+   * \param description the description of the interface (empty: none)
+   * \return the interface id, used to write its packets
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen,
+                         std::string const &name, std::string const &description);
+
+  /**
+   * \return the number of interfaces described
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \brief Write a packet
+   * \param interface the interface id
+   * \param timestamp the timestamp, in nanoseconds
+   * \param p the packet
+   */
+  void Write (uint32_t interface, uint64_t timestamp, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a header and a packet, without merging them
+   * \param interface the interface id
+   * \param timestamp the timestamp, in nanoseconds
+   * \param header the header, written before the packet
+   * \param p the packet
+   */
+  void Write (uint32_t interface, uint64_t timestamp, const Header &header, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a packet given as a buffer
+   * \param interface the interface id
+   * \param timestamp the timestamp, in nanoseconds
+   * \param data the packet data
+   * \param totalLen the length of the packet
+   */
+  void Write (uint32_t interface, uint64_t timestamp, uint8_t const *data, uint32_t totalLen);
+
+private:
+  /**
+   * \brief Reserve an Enhanced Packet Block and fill its header
+   * \param interface the interface id
+   * \param timestamp the timestamp, in nanoseconds
+   * \param totalLen the length of the packet
+   * \param inclLen the length of the packet stored (output)
+   * \return the space for the packet data, followed by the padding and the
+   * block trailer
+   */
+  uint8_t *BeginPacketBlock (uint32_t interface, uint64_t timestamp, uint32_t totalLen, uint32_t &inclLen);
+
+  /**
+   * \brief Pad and commit the block started by BeginPacketBlock ()
+   * \param data the space returned by BeginPacketBlock ()
+   * \param inclLen the length of the packet stored
+   */
+  void EndPacketBlock (uint8_t *data, uint32_t inclLen);
+
+  /**
+   * \brief Write an option of a block
+   * \param block the block being built
+   * \param code the option code
+   * \param value the option value
+   * \param length the length of the value
+   */
+  static void AppendOption (std::string &block, uint16_t code, const void *value, uint16_t length);
+
+  /**
+   * \brief Write a block
+   * \param type the block type
+   * \param body the block body, padded to 32 bits
+   */
+  void WriteBlock (uint32_t type, std::string const &body);
+
+  AsyncFileWriter m_writer;              //!< Background writer
+  std::vector<uint32_t> m_snapLen;       //!< Capture size of each interface
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
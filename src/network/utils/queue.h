@@ -34,6 +34,8 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <vector>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -290,6 +292,26 @@ public:
    */
   virtual Ptr<const Item> Peek (void) const = 0;
 
+  /**
+   * Place a batch of items into the Queue, as if Enqueue were called for
+   * each of them in turn. Subclasses can override this method to update the
+   * queue state once per batch (see DoEnqueueBatch).
+   * \param items the items to enqueue
+   * \return the number of items enqueued (the other items were dropped)
+   */
+  virtual std::size_t EnqueueBatch (const std::vector<Ptr<Item> > &items);
+
+  /**
+   * Remove at most maxItems items from the Queue, as if Dequeue were called
+   * for each of them in turn, and append them to a vector. Subclasses can
+   * override this method to update the queue state once per batch (see
+   * DoDequeueBatch).
+   * \param items the vector the dequeued items are appended to
+   * \param maxItems the maximum number of items to dequeue
+   * \return the number of items dequeued
+   */
+  virtual std::size_t DequeueBatch (std::vector<Ptr<Item> > &items, std::size_t maxItems);
+
   /**
    * Flush the queue.
    */
@@ -398,6 +420,27 @@ protected:
    */
   Ptr<const Item> DoPeek (ConstIterator pos) const;
 
+  /**
+   * Push a batch of items in the queue, at the same position. The counters
+   * of the queue (and their traces) are updated once for the whole batch;
+   * then, the enqueue trace is fired for each item enqueued and the items
+   * that did not fit in the queue are dropped, in the order of the batch.
+   * \param pos the position where the items are inserted
+   * \param items the items to enqueue
+   * \return the number of items enqueued
+   */
+  std::size_t DoEnqueueBatch (ConstIterator pos, const std::vector<Ptr<Item> > &items);
+
+  /**
+   * Pull a batch of items from the head of the queue. The counters of the
+   * queue (and their traces) are updated once for the whole batch; then, the
+   * dequeue trace is fired for each item.
+   * \param items the vector the dequeued items are appended to
+   * \param maxItems the maximum number of items to dequeue
+   * \return the number of items dequeued
+   */
+  std::size_t DoDequeueBatch (std::vector<Ptr<Item> > &items, std::size_t maxItems);
+
   /**
    * \brief Drop a packet before enqueue
    * \param item item that was dropped
@@ -566,6 +609,126 @@ Queue<Item>::DoRemove (ConstIterator pos)
   return item;
 }
 
+template <typename Item>
+std::size_t
+Queue<Item>::EnqueueBatch (const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  std::size_t n = 0;
+  for (typename std::vector<Ptr<Item> >::const_iterator it = items.begin (); it != items.end (); it++)
+    {
+      n += Enqueue (*it);
+    }
+  return n;
+}
+
+template <typename Item>
+std::size_t
+Queue<Item>::DequeueBatch (std::vector<Ptr<Item> > &items, std::size_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  std::size_t n = 0;
+  for (; n < maxItems; n++)
+    {
+      Ptr<Item> item = Dequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+    }
+  return n;
+}
+
+template <typename Item>
+std::size_t
+Queue<Item>::DoEnqueueBatch (ConstIterator pos, const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  // insert the items that fit in the queue, with the counters kept locally
+  bool packetMode = (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS);
+  uint32_t limit = GetMaxSize ().GetValue ();
+  uint32_t nPackets = m_nPackets.Get ();
+  uint32_t nBytes = m_nBytes.Get ();
+  uint32_t addedBytes = 0;
+  std::size_t n = 0;
+  Iterator first = m_packets.end ();
+  for (typename std::vector<Ptr<Item> >::const_iterator it = items.begin (); it != items.end (); it++)
+    {
+      uint32_t size = (*it)->GetSize ();
+      if (packetMode ? nPackets + n + 1 > limit : nBytes + addedBytes + size > limit)
+        {
+          continue;
+        }
+      Iterator inserted = m_packets.insert (pos, *it);
+      if (n++ == 0)
+        {
+          first = inserted;
+        }
+      addedBytes += size;
+    }
+
+  m_nBytes += addedBytes;
+  m_nTotalReceivedBytes += addedBytes;
+  m_nPackets += static_cast<uint32_t> (n);
+  m_nTotalReceivedPackets += n;
+
+  // the items inserted are consecutive and in the order of the batch: fire
+  // the traces of the items in that order
+  Iterator inserted = first;
+  std::size_t traced = 0;
+  for (typename std::vector<Ptr<Item> >::const_iterator it = items.begin (); it != items.end (); it++)
+    {
+      if (traced < n && *inserted == *it)
+        {
+          NS_LOG_LOGIC ("m_traceEnqueue (p)");
+          m_traceEnqueue (*it);
+          inserted++;
+          traced++;
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Queue full -- dropping pkt");
+          DropBeforeEnqueue (*it);
+        }
+    }
+
+  return n;
+}
+
+template <typename Item>
+std::size_t
+Queue<Item>::DoDequeueBatch (std::vector<Ptr<Item> > &items, std::size_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  std::size_t start = items.size ();
+  std::size_t n = std::min<std::size_t> (maxItems, m_nPackets.Get ());
+  uint32_t bytes = 0;
+  Iterator it = m_packets.begin ();
+  for (std::size_t i = 0; i < n; i++, it++)
+    {
+      bytes += (*it)->GetSize ();
+      items.push_back (*it);
+    }
+  m_packets.erase (m_packets.begin (), it);
+
+  NS_ASSERT (m_nBytes.Get () >= bytes);
+  m_nBytes -= bytes;
+  m_nPackets -= static_cast<uint32_t> (n);
+
+  // the traces may enqueue packets again (e.g., by waking up the queue disc)
+  for (std::size_t i = start; i < items.size (); i++)
+    {
+      NS_LOG_LOGIC ("m_traceDequeue (p)");
+      m_traceDequeue (items[i]);
+    }
+  return n;
+}
+
 template <typename Item>
 void
 Queue<Item>::Flush (void)
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/ipv4-precomputed-routing-helper.h"
+
+/*
+ * Grid of routers, each one with a number of attached hosts:
+ *
+ *  h   h   h
+ *  |   |   |
+ *  r --r --r -- ...
+ *  |   |   |
+ *  r --r --r -- ...
+ *  ...
+ *
+ * All the nodes use precomputed static forwarding. The time needed to
+ * build the forwarding tables is printed, then every host of the first
+ * router sends one echo request to a host of the last router. The grid
+ * provides many equal-cost paths, which are used by the ECMP selection.
+ *
+ * Example: ./waf --run "precomputed-routing-grid --side=100 --hosts=4"
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PrecomputedRoutingGrid");
+
+static uint32_t g_received = 0; //!< Number of echo replies received
+
+/**
+ * Count the echo replies.
+ * \param p the received packet
+ */
+static void
+EchoReceived (Ptr<const Packet> p)
+{
+  g_received++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t side = 10;
+  uint32_t hosts = 2;
+  uint32_t threads = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("side", "Number of routers on a side of the grid", side);
+  cmd.AddValue ("hosts", "Number of hosts attached to each router", hosts);
+  cmd.AddValue ("threads", "Number of threads computing the tables (0: hardware threads)", threads);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (side < 2 || side > 120 || hosts < 1,
+                   "The grid needs 2x2 to 120x120 routers and one host per router");
+
+  // the paths across the grid are longer than the default TTL
+  Config::SetDefault ("ns3::Ipv4L3Protocol::DefaultTtl", UintegerValue (255));
+
+  NodeContainer routers;
+  routers.Create (side * side);
+  NodeContainer hostNodes;
+  hostNodes.Create (side * side * hosts);
+
+  Ipv4PrecomputedRoutingHelper precomputedRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (precomputedRouting);
+  stack.Install (routers);
+  stack.Install (hostNodes);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("10us"));
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  std::vector<Ipv4Address> hostAddresses;
+
+  for (uint32_t r = 0; r < side * side; r++)
+    {
+      uint32_t x = r % side;
+      uint32_t y = r / side;
+      if (x + 1 < side)
+        {
+          address.Assign (pointToPoint.Install (routers.Get (r), routers.Get (r + 1)));
+          address.NewNetwork ();
+        }
+      if (y + 1 < side)
+        {
+          address.Assign (pointToPoint.Install (routers.Get (r), routers.Get (r + side)));
+          address.NewNetwork ();
+        }
+      for (uint32_t h = 0; h < hosts; h++)
+        {
+          Ipv4InterfaceContainer interfaces =
+            address.Assign (pointToPoint.Install (hostNodes.Get (r * hosts + h), routers.Get (r)));
+          address.NewNetwork ();
+          hostAddresses.push_back (interfaces.GetAddress (0));
+        }
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ipv4PrecomputedRoutingHelper::PopulateRoutingTables (threads);
+  int64_t elapsed = clock.End ();
+  std::cout << "Computed the tables of " << NodeList::GetNNodes () << " nodes in "
+            << elapsed << " ms" << std::endl;
+
+  UdpEchoServerHelper echoServer (9);
+  uint32_t last = side * side - 1;
+  ApplicationContainer serverApps = echoServer.Install (hostNodes.Get (last * hosts));
+  serverApps.Start (Seconds (1.0));
+  serverApps.Stop (Seconds (10.0));
+
+  UdpEchoClientHelper echoClient (hostAddresses[last * hosts], 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (1));
+  echoClient.SetAttribute ("PacketSize", UintegerValue (512));
+  for (uint32_t h = 0; h < hosts; h++)
+    {
+      ApplicationContainer clientApps = echoClient.Install (hostNodes.Get (h));
+      clientApps.Start (Seconds (2.0));
+      clientApps.Stop (Seconds (10.0));
+      clientApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&EchoReceived));
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::cout << "Received " << g_received << " of " << hosts << " echo replies" << std::endl;
+  return g_received == hosts ? 0 : 1;
+}
@@ -47,4 +47,10 @@ Ipv4NixVectorHelper::Create (Ptr<Node> node) const
   node->AggregateObject (agent);
   return agent;
 }
+
+void
+Ipv4NixVectorHelper::PrecomputeTrees (NodeContainer sources, uint32_t nThreads)
+{
+  Ipv4NixVectorRouting::PrecomputeTrees (sources, nThreads);
+}
 } // namespace ns3
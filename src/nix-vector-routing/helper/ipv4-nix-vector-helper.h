@@ -23,6 +23,7 @@
 
 #include "ns3/object-factory.h"
 #include "ns3/ipv4-routing-helper.h"
+#include "ns3/node-container.h"
 
 namespace ns3 {
 
@@ -66,6 +67,16 @@ public:
   */
   virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
 
+  /**
+   * \brief Compute in advance the breadth-first search trees used to
+   * build the nix-vectors of some source nodes
+   *
+   * \param sources the source nodes
+   * \param nThreads number of threads computing the trees; 0 selects
+   *        the number of hardware threads
+   */
+  static void PrecomputeTrees (NodeContainer sources, uint32_t nThreads = 0);
+
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
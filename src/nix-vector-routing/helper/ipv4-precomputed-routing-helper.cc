@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-precomputed-routing-helper.h"
+#include "ns3/ipv4-precomputed-routing.h"
+#include "ns3/node.h"
+
+namespace ns3 {
+
+Ipv4PrecomputedRoutingHelper::Ipv4PrecomputedRoutingHelper ()
+{
+  m_agentFactory.SetTypeId ("ns3::Ipv4PrecomputedRouting");
+}
+
+Ipv4PrecomputedRoutingHelper::Ipv4PrecomputedRoutingHelper (const Ipv4PrecomputedRoutingHelper &o)
+  : m_agentFactory (o.m_agentFactory)
+{
+}
+
+Ipv4PrecomputedRoutingHelper*
+Ipv4PrecomputedRoutingHelper::Copy (void) const
+{
+  return new Ipv4PrecomputedRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+Ipv4PrecomputedRoutingHelper::Create (Ptr<Node> node) const
+{
+  Ptr<Ipv4PrecomputedRouting> agent = m_agentFactory.Create<Ipv4PrecomputedRouting> ();
+  agent->SetNode (node);
+  node->AggregateObject (agent);
+  return agent;
+}
+
+void
+Ipv4PrecomputedRoutingHelper::PopulateRoutingTables (uint32_t nThreads)
+{
+  Ipv4PrecomputedRouting::ComputeRoutes (nThreads);
+}
+
+} // namespace ns3
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_PRECOMPUTED_ROUTING_HELPER_H
+#define IPV4_PRECOMPUTED_ROUTING_HELPER_H
+
+#include "ns3/object-factory.h"
+#include "ns3/ipv4-routing-helper.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup nix-vector-routing
+ *
+ * \brief Helper class that adds precomputed routing to nodes.
+ *
+ * This class is expected to be used in conjunction with
+ * ns3::InternetStackHelper::SetRoutingHelper
+ */
+class Ipv4PrecomputedRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /**
+   * Construct an Ipv4PrecomputedRoutingHelper to make life easier while
+   * adding precomputed routing to nodes.
+   */
+  Ipv4PrecomputedRoutingHelper ();
+
+  /**
+   * \brief Construct an Ipv4PrecomputedRoutingHelper from another previously
+   * initialized instance (Copy Constructor).
+   */
+  Ipv4PrecomputedRoutingHelper (const Ipv4PrecomputedRoutingHelper &);
+
+  /**
+   * \returns pointer to clone of this Ipv4PrecomputedRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  Ipv4PrecomputedRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   *
+   * This method will be called by ns3::InternetStackHelper::Install
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * \brief Compute the forwarding tables of all the nodes now
+   *
+   * Tables are otherwise computed when the first packet is routed.
+   *
+   * \param nThreads number of threads computing the tables; 0 selects
+   *        the number of hardware threads
+   */
+  static void PopulateRoutingTables (uint32_t nThreads = 0);
+
+private:
+  /**
+   * \brief Assignment operator declared private and not implemented to disallow
+   * assignment and prevent the compiler from happily inserting its own.
+   * \return Nothing useful.
+   */
+  Ipv4PrecomputedRoutingHelper &operator = (const Ipv4PrecomputedRoutingHelper &);
+
+  ObjectFactory m_agentFactory; //!< Object factory
+};
+} // namespace ns3
+
+#endif /* IPV4_PRECOMPUTED_ROUTING_HELPER_H */
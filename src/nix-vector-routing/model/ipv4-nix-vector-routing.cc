@@ -19,12 +19,21 @@
  */
 
 #include <queue>
+#include <algorithm>
 #include <iomanip>
+#include <limits>
+#include <thread>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 
 #include "ipv4-nix-vector-routing.h"
 
@@ -35,6 +44,22 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4NixVectorRouting");
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
 bool Ipv4NixVectorRouting::g_isCacheDirty = false;
+NixVectorCache Ipv4NixVectorRouting::g_nixCache;
+Ipv4NixVectorRouting::TreeMap Ipv4NixVectorRouting::g_trees;
+
+/**
+ * \ingroup nix-vector-routing
+ * \brief Maximum number of nix-vectors cached for all the nodes.
+ */
+static GlobalValue g_nixVectorCacheSize ("NixVectorCacheSize",
+                                         "The maximum number of nix-vectors kept in the cache shared by "
+                                         "all the nodes, the least recently used being evicted first "
+                                         "(0 for no limit)",
+                                         UintegerValue (100000),
+                                         MakeUintegerChecker<uint32_t> ());
+
+/// Parent of the nodes not reached by a breadth-first search
+static const uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max ();
 
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
@@ -92,6 +117,15 @@ void
 Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
+  FlushAll ();
+}
+
+void
+Ipv4NixVectorRouting::FlushAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_nixCache.Clear ();
+  g_trees.clear ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -102,18 +136,10 @@ Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
           continue;
         }
       NS_LOG_LOGIC ("Flushing Nix caches.");
-      rp->FlushNixCache ();
       rp->FlushIpv4RouteCache ();
     }
 }
 
-void
-Ipv4NixVectorRouting::FlushNixCache (void) const
-{
-  NS_LOG_FUNCTION_NOARGS ();
-  m_nixCache.clear ();
-}
-
 void
 Ipv4NixVectorRouting::FlushIpv4RouteCache (void) const
 {
@@ -122,7 +148,8 @@ Ipv4NixVectorRouting::FlushIpv4RouteCache (void) const
 }
 
 Ptr<NixVector>
-Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetDevice> oif)
+Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetDevice> oif,
+                                    std::vector<uint32_t> &path)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -149,13 +176,30 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
   else
     {
       // otherwise proceed as normal 
-      // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
-
-      BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
+      // and build the nix vector, from the precomputed
+      // tree of the source if any
+      std::vector<uint32_t> parentVector;
+      const std::vector<uint32_t> *tree = &parentVector;
+      TreeMap::const_iterator it = g_trees.find (source->GetId ());
+      if (!oif && it != g_trees.end () && it->second.size () == NodeList::GetNNodes ())
+        {
+          NS_LOG_LOGIC ("Using the precomputed tree of node " << source->GetId ());
+          tree = &it->second;
+        }
+      else
+        {
+          BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
+        }
 
-      if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
+      if (BuildNixVector (*tree, source->GetId (), destNode->GetId (), nixVector))
         {
+          path.clear ();
+          for (uint32_t node = destNode->GetId (); node != source->GetId (); node = tree->at (node))
+            {
+              path.push_back (node);
+            }
+          path.push_back (source->GetId ());
+          std::reverse (path.begin (), path.end ());
           return nixVector;
         }
       else
@@ -173,15 +217,12 @@ Ipv4NixVectorRouting::GetNixVectorInCache (Ipv4Address address)
 
   CheckCacheStateAndFlush ();
 
-  NixMap_t::iterator iter = m_nixCache.find (address);
-  if (iter != m_nixCache.end ())
+  Ptr<NixVector> nixVector = g_nixCache.Lookup (m_node->GetId (), address);
+  if (nixVector)
     {
       NS_LOG_LOGIC ("Found Nix-vector in cache.");
-      return iter->second;
     }
-
-  // not in cache
-  return 0;
+  return nixVector;
 }
 
 Ptr<Ipv4Route>
@@ -230,7 +271,7 @@ Ipv4NixVectorRouting::BuildNixVectorLocal (Ptr<NixVector> nixVector)
 }
 
 bool
-Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
+Ipv4NixVectorRouting::BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -239,12 +280,12 @@ Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVec
       return true;
     }
 
-  if (parentVector.at (dest) == 0)
+  if (parentVector.at (dest) == NO_PARENT)
     {
       return false;
     }
 
-  Ptr<Node> parentNode = parentVector.at (dest);
+  Ptr<Node> parentNode = NodeList::GetNode (parentVector.at (dest));
 
   uint32_t numberOfDevices = parentNode->GetNDevices ();
   uint32_t destId = 0;
@@ -298,7 +339,7 @@ Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVec
 
   // recurse through parent vector, grabbing the path 
   // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
+  BuildNixVector (parentVector, source, parentVector.at (dest), nixVector);
   return true;
 }
 
@@ -402,7 +443,7 @@ Ipv4NixVectorRouting::FindTotalNeighbors (void)
 }
 
 Ptr<BridgeNetDevice>
-Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd) const
+Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd)
 {
   NS_LOG_FUNCTION (nd);
 
@@ -507,10 +548,17 @@ Ipv4NixVectorRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<
       NS_LOG_LOGIC ("Nix-vector not in cache, build: ");
       // Build the nix-vector, given this node and the
       // dest IP address
-      nixVectorInCache = GetNixVector (m_node, header.GetDestination (), oif);
+      std::vector<uint32_t> path;
+      nixVectorInCache = GetNixVector (m_node, header.GetDestination (), oif, path);
 
       // cache it
-      m_nixCache.insert (NixMap_t::value_type (header.GetDestination (), nixVectorInCache));
+      if (nixVectorInCache)
+        {
+          UintegerValue cacheSize;
+          g_nixVectorCacheSize.GetValue (cacheSize);
+          g_nixCache.SetMaxSize (cacheSize.Get ());
+          g_nixCache.Insert (m_node->GetId (), header.GetDestination (), nixVectorInCache, path);
+        }
     }
 
   // path exists
@@ -709,10 +757,11 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::
       << ", Nix Routing" << std::endl;
 
   *os << "NixCache:" << std::endl;
-  if (m_nixCache.size () > 0)
+  NixMap_t nixCache = g_nixCache.GetEntries (m_node->GetId ());
+  if (nixCache.size () > 0)
     {
       *os << "Destination     NixVector" << std::endl;
-      for (NixMap_t::const_iterator it = m_nixCache.begin (); it != m_nixCache.end (); it++)
+      for (NixMap_t::const_iterator it = nixCache.begin (); it != nixCache.end (); it++)
         {
           std::ostringstream dest;
           dest << it->first;
@@ -757,7 +806,9 @@ Ipv4NixVectorRouting::NotifyInterfaceUp (uint32_t i)
 void
 Ipv4NixVectorRouting::NotifyInterfaceDown (uint32_t i)
 {
-  g_isCacheDirty = true;
+  // removing a link does not shorten any path, so the
+  // paths not using it are still shortest paths
+  InvalidateLink (i);
 }
 void
 Ipv4NixVectorRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
@@ -767,12 +818,85 @@ Ipv4NixVectorRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress
 void
 Ipv4NixVectorRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  if (g_isCacheDirty)
+    {
+      return;
+    }
+  // the paths do not depend on the addresses, except for the
+  // destination; the gateways of the routes might though
+  g_nixCache.InvalidateDestination (address.GetLocal ());
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator it = NodeList::Begin (); it != listEnd; it++)
+    {
+      Ptr<Ipv4NixVectorRouting> rp = (*it)->GetObject<Ipv4NixVectorRouting> ();
+      if (rp)
+        {
+          rp->FlushIpv4RouteCache ();
+        }
+    }
+}
+
+void
+Ipv4NixVectorRouting::InvalidateLink (uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << interface);
+
+  if (g_isCacheDirty)
+    {
+      // everything is flushed anyway
+      return;
+    }
+
+  FlushIpv4RouteCache ();
+  Ptr<NetDevice> device = m_ipv4->GetNetDevice (interface);
+  Ptr<Channel> channel = device->GetChannel ();
+  if (channel == 0)
+    {
+      return;
+    }
+
+  NetDeviceContainer netDeviceContainer;
+  GetAdjacentNetDevices (device, channel, netDeviceContainer);
+  std::vector<uint32_t> neighbors;
+  for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+    {
+      Ptr<Node> remoteNode = (*iter)->GetNode ();
+      neighbors.push_back (remoteNode->GetId ());
+      Ptr<Ipv4NixVectorRouting> rp = remoteNode->GetObject<Ipv4NixVectorRouting> ();
+      if (rp)
+        {
+          rp->FlushIpv4RouteCache ();
+        }
+    }
+
+  uint32_t id = m_node->GetId ();
+  g_nixCache.InvalidateLink (id, neighbors);
+
+  TreeMap::iterator it = g_trees.begin ();
+  while (it != g_trees.end ())
+    {
+      const std::vector<uint32_t> &parent = it->second;
+      bool crosses = false;
+      for (std::vector<uint32_t>::const_iterator n = neighbors.begin (); n != neighbors.end () && !crosses; n++)
+        {
+          crosses = (*n < parent.size () && parent[*n] == id)
+            || (id < parent.size () && parent[id] == *n);
+        }
+      if (crosses)
+        {
+          NS_LOG_LOGIC ("Discarding the tree of node " << it->first);
+          it = g_trees.erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
 }
 
 bool
 Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source, 
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
+                           Ptr<Node> dest, std::vector<uint32_t> & parentVector,
                            Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -781,11 +905,11 @@ Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source,
   std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
 
   // reset the parent vector
-  parentVector.assign (numberOfNodes, 0); // initialize to 0
+  parentVector.assign (numberOfNodes, NO_PARENT);
 
   // Add the source node to the queue, set its parent to itself 
   greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
+  parentVector.at (source->GetId ()) = source->GetId ();
 
   // BFS loop
   while (greyNodeList.size () != 0)
@@ -842,9 +966,9 @@ Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source,
               // by checking to see if it has a parent
               // if it doesn't (null or 0), then set its parent and 
               // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
+              if (parentVector.at (remoteNode->GetId ()) == NO_PARENT)
                 {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
+                  parentVector.at (remoteNode->GetId ()) = currNode->GetId ();
                   greyNodeList.push (remoteNode);
                 }
             }
@@ -898,9 +1022,9 @@ Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source,
                   // by checking to see if it has a parent
                   // if it doesn't (null or 0), then set its parent and 
                   // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
+                  if (parentVector.at (remoteNode->GetId ()) == NO_PARENT)
                     {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
+                      parentVector.at (remoteNode->GetId ()) = currNode->GetId ();
                       greyNodeList.push (remoteNode);
                     }
                 }
@@ -916,6 +1040,123 @@ Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source,
   return false;
 }
 
+void
+Ipv4NixVectorRouting::PrecomputeTrees (NodeContainer sources, uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (nThreads);
+
+  if (g_isCacheDirty)
+    {
+      FlushAll ();
+      g_isCacheDirty = false;
+    }
+
+  // Snapshot of the topology, with the same neighbor order as BFS (),
+  // so that the threads do not touch reference-counted objects
+  uint32_t nNodes = NodeList::GetNNodes ();
+  Graph graph;
+  graph.m_offset.reserve (nNodes + 1);
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      graph.m_offset.push_back (graph.m_target.size ());
+      Ptr<Node> node = NodeList::GetNode (n);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          if (ipv4 && !ipv4->IsUp (ipv4->GetInterfaceForDevice (localNetDevice)))
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (!localNetDevice->IsLinkUp () || channel == 0)
+            {
+              continue;
+            }
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              graph.m_target.push_back ((*iter)->GetNode ()->GetId ());
+            }
+        }
+    }
+  graph.m_offset.push_back (graph.m_target.size ());
+
+  TreeComputation computation;
+  computation.m_graph = &graph;
+  for (NodeContainer::Iterator it = sources.Begin (); it != sources.End (); it++)
+    {
+      computation.m_sources.push_back ((*it)->GetId ());
+    }
+  computation.m_trees.resize (computation.m_sources.size ());
+
+  if (nThreads == 0)
+    {
+      nThreads = std::max (std::thread::hardware_concurrency (), 1u);
+    }
+#ifndef HAVE_PTHREAD_H
+  nThreads = 1;
+#endif
+  nThreads = std::max (std::min<uint32_t> (nThreads, computation.m_sources.size ()), 1u);
+  computation.m_nThreads = nThreads;
+  NS_LOG_LOGIC ("Computing " << computation.m_sources.size () << " trees with " << nThreads << " threads");
+
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&ComputeTrees, &computation, t)));
+      threads.back ()->Start ();
+    }
+#endif
+  ComputeTrees (&computation, 0);
+#ifdef HAVE_PTHREAD_H
+  for (uint32_t t = 0; t < threads.size (); t++)
+    {
+      threads[t]->Join ();
+    }
+#endif
+
+  for (uint32_t i = 0; i < computation.m_sources.size (); i++)
+    {
+      g_trees[computation.m_sources[i]].swap (computation.m_trees[i]);
+    }
+}
+
+void
+Ipv4NixVectorRouting::ComputeTrees (TreeComputation *computation, uint32_t thread)
+{
+  const Graph &graph = *computation->m_graph;
+  uint32_t nNodes = graph.m_offset.size () - 1;
+  std::vector<uint32_t> queue (nNodes);
+
+  // Each thread handles its own sources, hence writes to its own trees
+  for (uint32_t i = thread; i < computation->m_sources.size (); i += computation->m_nThreads)
+    {
+      uint32_t source = computation->m_sources[i];
+      std::vector<uint32_t> &parent = computation->m_trees[i];
+      parent.assign (nNodes, NO_PARENT);
+      uint32_t head = 0;
+      uint32_t tail = 0;
+      queue[tail++] = source;
+      parent[source] = source;
+      while (head < tail)
+        {
+          uint32_t v = queue[head++];
+          for (uint32_t e = graph.m_offset[v]; e < graph.m_offset[v + 1]; e++)
+            {
+              uint32_t w = graph.m_target[e];
+              if (parent[w] == NO_PARENT)
+                {
+                  parent[w] = v;
+                  queue[tail++] = w;
+                }
+            }
+        }
+    }
+}
+
 void 
 Ipv4NixVectorRouting::CheckCacheStateAndFlush (void) const
 {
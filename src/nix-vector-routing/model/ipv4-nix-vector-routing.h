@@ -22,6 +22,8 @@
 #define IPV4_NIX_VECTOR_ROUTING_H
 
 #include <map>
+#include <vector>
+#include <unordered_map>
 
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
@@ -32,6 +34,7 @@
 #include "ns3/nix-vector.h"
 #include "ns3/bridge-net-device.h"
 #include "ns3/nstime.h"
+#include "nix-vector-cache.h"
 
 namespace ns3 {
 
@@ -56,6 +59,15 @@ typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
 /**
  * \ingroup nix-vector-routing
  * Nix-vector routing protocol
+ *
+ * The nix-vectors are kept in a cache shared by all the nodes, bounded
+ * by the "NixVectorCacheSize" global value (least recently used entries
+ * are evicted first).  The breadth-first search trees of some source
+ * nodes can be computed in advance, in parallel, with PrecomputeTrees ().
+ *
+ * When an interface goes down, only the nix-vectors and trees crossing
+ * the corresponding link are discarded: the remaining paths are still
+ * shortest paths.  Any other topology change discards all the caches.
  */
 class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
 {
@@ -88,13 +100,31 @@ public:
    */
   void FlushGlobalNixRoutingCache (void) const;
 
+  /**
+   * @brief Compute the breadth-first search trees of some source nodes
+   *
+   * The nix-vectors from these nodes are then built from the trees,
+   * without searching the topology.  The trees are discarded when the
+   * topology changes.
+   *
+   * @param sources the source nodes
+   * @param nThreads number of threads computing the trees; 0 selects
+   *        the number of hardware threads
+   */
+  static void PrecomputeTrees (NodeContainer sources, uint32_t nThreads = 0);
+
 private:
 
   /**
-   * Flushes the cache which stores nix-vector based on
-   * destination IP
+   * Flushes all the caches of all the nodes, and the trees
    */
-  void FlushNixCache (void) const;
+  static void FlushAll (void);
+
+  /**
+   * Discards the nix-vectors, trees and routes using a link
+   * \param interface the interface attached to the link
+   */
+  void InvalidateLink (uint32_t interface);
 
   /**
    * Flushes the cache which stores the Ipv4 route
@@ -114,12 +144,14 @@ private:
    * BFS, accounting for any output interface specified, and finally
    * BuildNixVector to return the built nix-vector
    *
-   * \param source Source node
-   * \param dest Destination node address
-   * \param oif Preferred output interface
+   * \param [in] source Source node
+   * \param [in] dest Destination node address
+   * \param [in] oif Preferred output interface
+   * \param [out] path the ids of the nodes from source to destination
    * \returns The NixVector to be used in routing.
    */
-  Ptr<NixVector> GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetDevice> oif);
+  Ptr<NixVector> GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetDevice> oif,
+                               std::vector<uint32_t> &path);
 
   /**
    * Checks the cache based on dest IP for the nix-vector
@@ -142,7 +174,7 @@ private:
    * \param [in] channel the channel to check
    * \param [out] netDeviceContainer the NetDeviceContainer of the NetDevices in the channel.
    */
-  void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer);
+  static void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer);
 
   /**
    * Iterates through the node list and finds the one
@@ -154,13 +186,13 @@ private:
 
   /**
    * Recurses the parent vector, created by BFS and actually builds the nixvector
-   * \param [in] parentVector Parent vector for retracing routes
+   * \param [in] parentVector Parent node id of each node, for retracing routes
    * \param [in] source Source Node index
    * \param [in] dest Destination Node index
    * \param [out] nixVector the NixVector to be used for routing
    * \returns true on success, false otherwise.
    */
-  bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
+  bool BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
 
   /**
    * Special variation of BuildNixVector for when a node is sending to itself
@@ -181,7 +213,7 @@ private:
    * \param nd the NetDevice to check
    * \returns the bridging NetDevice (or null if the NetDevice is not bridged)
    */
-  Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd) const;
+  static Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd);
 
 
   /**
@@ -198,16 +230,44 @@ private:
    * \param [in] numberOfNodes total number of nodes
    * \param [in] source Source Node
    * \param [in] dest Destination Node
-   * \param [out] parentVector Parent vector for retracing routes
+   * \param [out] parentVector Parent node id of each node, for retracing routes
    * \param [in] oif specific output interface to use from source node, if not null
    * \returns false if dest not found, true o.w.
    */
   bool BFS (uint32_t numberOfNodes,
             Ptr<Node> source,
             Ptr<Node> dest,
-            std::vector< Ptr<Node> > & parentVector,
+            std::vector<uint32_t> & parentVector,
             Ptr<NetDevice> oif);
 
+  /**
+   * \brief Topology snapshot used to compute the trees, in compressed
+   * sparse row format
+   */
+  struct Graph
+  {
+    std::vector<uint32_t> m_offset;  //!< First edge of each node (size: nodes + 1)
+    std::vector<uint32_t> m_target;  //!< Neighbor node id of each edge
+  };
+
+  /**
+   * \brief Data shared by the threads computing the trees
+   */
+  struct TreeComputation
+  {
+    const Graph *m_graph;                          //!< Topology
+    std::vector<uint32_t> m_sources;               //!< Source node ids
+    std::vector<std::vector<uint32_t> > m_trees;   //!< Parent vector of each source
+    uint32_t m_nThreads;                           //!< Number of threads
+  };
+
+  /**
+   * \brief Compute the trees of the sources assigned to a thread
+   * \param computation the shared data
+   * \param thread the thread index
+   */
+  static void ComputeTrees (TreeComputation *computation, uint32_t thread);
+
   void DoDispose (void);
 
   /* From Ipv4RoutingProtocol */
@@ -233,8 +293,14 @@ private:
    */
   static bool g_isCacheDirty;
 
-  /** Cache stores nix-vectors based on destination ip */
-  mutable NixMap_t m_nixCache;
+  /// Map of the source node ids to their parent vector
+  typedef std::unordered_map<uint32_t, std::vector<uint32_t> > TreeMap;
+
+  /** Cache stores nix-vectors based on source node and destination ip */
+  static NixVectorCache g_nixCache;
+
+  /** Precomputed breadth-first search trees */
+  static TreeMap g_trees;
 
   /** Cache stores Ipv4Routes based on destination ip */
   mutable Ipv4RouteMap_t m_ipv4RouteCache;
@@ -0,0 +1,672 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <thread>
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+
+#include "ipv4-precomputed-routing.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4PrecomputedRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (Ipv4PrecomputedRouting);
+
+bool Ipv4PrecomputedRouting::g_isDirty = true;
+Ipv4PrecomputedRouting::AddressMap Ipv4PrecomputedRouting::g_addressMap;
+std::vector<uint32_t> Ipv4PrecomputedRouting::g_component;
+
+TypeId
+Ipv4PrecomputedRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv4PrecomputedRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("NixVectorRouting")
+    .AddConstructor<Ipv4PrecomputedRouting> ()
+  ;
+  return tid;
+}
+
+Ipv4PrecomputedRouting::Ipv4PrecomputedRouting ()
+  : m_computed (false),
+    m_maskSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4PrecomputedRouting::~Ipv4PrecomputedRouting ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+Ipv4PrecomputedRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (ipv4 != 0);
+  NS_ASSERT (m_ipv4 == 0);
+  m_ipv4 = ipv4;
+}
+
+void
+Ipv4PrecomputedRouting::SetNode (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  m_node = node;
+}
+
+void
+Ipv4PrecomputedRouting::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_node = 0;
+  m_ipv4 = 0;
+  m_neighbors.clear ();
+  m_nextHops.clear ();
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+void
+Ipv4PrecomputedRouting::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer &netDeviceContainer)
+{
+  NS_LOG_FUNCTION (netDevice << channel);
+
+  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> remoteDevice = channel->GetDevice (i);
+      if (remoteDevice != netDevice)
+        {
+          Ptr<BridgeNetDevice> bd = NetDeviceIsBridged (remoteDevice);
+          // we have a bridged device, we need to add all
+          // bridged devices
+          if (bd)
+            {
+              for (uint32_t j = 0; j < bd->GetNBridgePorts (); ++j)
+                {
+                  Ptr<NetDevice> ndBridged = bd->GetBridgePort (j);
+                  if (ndBridged == remoteDevice)
+                    {
+                      continue;
+                    }
+                  Ptr<Channel> chBridged = ndBridged->GetChannel ();
+                  if (chBridged == 0)
+                    {
+                      continue;
+                    }
+                  GetAdjacentNetDevices (ndBridged, chBridged, netDeviceContainer);
+                }
+            }
+          else
+            {
+              netDeviceContainer.Add (remoteDevice);
+            }
+        }
+    }
+}
+
+Ptr<BridgeNetDevice>
+Ipv4PrecomputedRouting::NetDeviceIsBridged (Ptr<NetDevice> nd)
+{
+  NS_LOG_FUNCTION (nd);
+
+  Ptr<Node> node = nd->GetNode ();
+  for (uint32_t i = 0; i < node->GetNDevices (); ++i)
+    {
+      Ptr<NetDevice> ndTest = node->GetDevice (i);
+      if (ndTest->IsBridge ())
+        {
+          Ptr<BridgeNetDevice> bnd = ndTest->GetObject<BridgeNetDevice> ();
+          NS_ABORT_MSG_UNLESS (bnd, "Ipv4PrecomputedRouting::NetDeviceIsBridged (): GetObject for <BridgeNetDevice> failed");
+          for (uint32_t j = 0; j < bnd->GetNBridgePorts (); ++j)
+            {
+              if (bnd->GetBridgePort (j) == nd)
+                {
+                  return bnd;
+                }
+            }
+        }
+    }
+  return 0;
+}
+
+void
+Ipv4PrecomputedRouting::ComputeRoutes (uint32_t nThreads)
+{
+  NS_LOG_FUNCTION (nThreads);
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  Graph graph;
+  graph.m_offset.assign (nNodes + 1, 0);
+  Computation computation;
+  computation.m_graph = &graph;
+  computation.m_routing.resize (nNodes);
+  g_addressMap.clear ();
+
+  // Build the graph and the neighbors of each node. Edges are stored in
+  // the same order as the neighbors, so that the edge index of a node is
+  // its neighbor index.
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      graph.m_offset[n] = graph.m_target.size ();
+      Ptr<Node> node = NodeList::GetNode (n);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      if (ipv4 == 0)
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+        {
+          if (!ipv4->IsUp (i))
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+            {
+              Ipv4Address local = ipv4->GetAddress (i, j).GetLocal ();
+              if (!local.IsLocalhost ())
+                {
+                  g_addressMap[local] = n;
+                }
+            }
+        }
+
+      std::vector<Neighbor> neighbors;
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          if (localNetDevice->IsBridge ())
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          int32_t interface = ipv4->GetInterfaceForDevice (localNetDevice);
+          if (channel == 0 || interface == -1 || !ipv4->IsUp (interface)
+              || ipv4->GetNAddresses (interface) == 0 || !localNetDevice->IsLinkUp ())
+            {
+              continue;
+            }
+
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              Ptr<Ipv4> remoteIpv4 = (*iter)->GetNode ()->GetObject<Ipv4> ();
+              if (remoteIpv4 == 0)
+                {
+                  continue;
+                }
+              int32_t remoteInterface = remoteIpv4->GetInterfaceForDevice (*iter);
+              if (remoteInterface == -1 || !remoteIpv4->IsUp (remoteInterface)
+                  || remoteIpv4->GetNAddresses (remoteInterface) == 0 || !(*iter)->IsLinkUp ())
+                {
+                  continue;
+                }
+              Neighbor neighbor;
+              neighbor.m_interface = interface;
+              neighbor.m_source = ipv4->GetAddress (interface, 0).GetLocal ();
+              neighbor.m_gateway = remoteIpv4->GetAddress (remoteInterface, 0).GetLocal ();
+              neighbors.push_back (neighbor);
+              graph.m_target.push_back ((*iter)->GetNode ()->GetId ());
+            }
+        }
+
+      Ptr<Ipv4PrecomputedRouting> routing = node->GetObject<Ipv4PrecomputedRouting> ();
+      if (routing != 0)
+        {
+          uint32_t degree = neighbors.size ();
+          routing->m_neighbors.swap (neighbors);
+          // a node with a single neighbor always uses it
+          routing->m_maskSize = degree > 1 ? (degree + 7) / 8 : 0;
+          routing->m_nextHops.assign (routing->m_maskSize * nNodes, 0);
+          routing->m_computed = true;
+          computation.m_routing[n] = routing;
+        }
+    }
+  graph.m_offset[nNodes] = graph.m_target.size ();
+
+  // Connected components, used by the nodes with a single neighbor
+  g_component.assign (nNodes, nNodes);
+  std::vector<uint32_t> queue (nNodes);
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      if (g_component[n] != nNodes)
+        {
+          continue;
+        }
+      uint32_t head = 0;
+      uint32_t tail = 0;
+      queue[tail++] = n;
+      g_component[n] = n;
+      while (head < tail)
+        {
+          uint32_t v = queue[head++];
+          for (uint32_t e = graph.m_offset[v]; e < graph.m_offset[v + 1]; e++)
+            {
+              uint32_t w = graph.m_target[e];
+              if (g_component[w] == nNodes)
+                {
+                  g_component[w] = n;
+                  queue[tail++] = w;
+                }
+            }
+        }
+    }
+
+  if (nThreads == 0)
+    {
+      nThreads = std::max (std::thread::hardware_concurrency (), 1u);
+    }
+#ifndef HAVE_PTHREAD_H
+  nThreads = 1;
+#endif
+  nThreads = std::max (std::min (nThreads, nNodes), 1u);
+  computation.m_nThreads = nThreads;
+  NS_LOG_LOGIC ("Computing the tables of " << nNodes << " nodes with " << nThreads << " threads");
+
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeBoundCallback (&Ipv4PrecomputedRouting::ComputeDestinations, &computation, t));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+#endif
+  ComputeDestinations (&computation, 0);
+#ifdef HAVE_PTHREAD_H
+  for (std::vector<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); it++)
+    {
+      (*it)->Join ();
+    }
+#endif
+
+  g_isDirty = false;
+}
+
+bool
+Ipv4PrecomputedRouting::IsLeaf (const Graph &graph, uint32_t node)
+{
+  return graph.m_offset[node + 1] - graph.m_offset[node] == 1;
+}
+
+void
+Ipv4PrecomputedRouting::ComputeDestinations (Computation *computation, uint32_t thread)
+{
+  const Graph &graph = *computation->m_graph;
+  uint32_t nNodes = graph.m_offset.size () - 1;
+  const uint32_t unreached = 0xffffffff;
+  std::vector<uint32_t> distance (nNodes);
+  std::vector<uint32_t> queue (nNodes);
+
+  // Each thread handles its own destinations, hence writes to its own
+  // entries of the next hop arrays
+  for (uint32_t d = thread; d < nNodes; d += computation->m_nThreads)
+    {
+      uint32_t degree = graph.m_offset[d + 1] - graph.m_offset[d];
+      if (degree == 0
+          || (degree == 1 && IsLeaf (graph, graph.m_target[graph.m_offset[d]]) == false))
+        {
+          // a leaf (e.g., a host) is reached through its only neighbor,
+          // its tables are filled with the ones of the neighbor below
+          continue;
+        }
+      // links are bidirectional, so the distance from d is the distance to d
+      distance.assign (nNodes, unreached);
+      uint32_t head = 0;
+      uint32_t tail = 0;
+      queue[tail++] = d;
+      distance[d] = 0;
+      while (head < tail)
+        {
+          uint32_t v = queue[head++];
+          for (uint32_t e = graph.m_offset[v]; e < graph.m_offset[v + 1]; e++)
+            {
+              uint32_t w = graph.m_target[e];
+              if (distance[w] == unreached)
+                {
+                  distance[w] = distance[v] + 1;
+                  queue[tail++] = w;
+                }
+            }
+        }
+
+      for (uint32_t q = 1; q < tail; q++)
+        {
+          uint32_t v = queue[q];
+          Ipv4PrecomputedRouting *routing = PeekPointer (computation->m_routing[v]);
+          if (routing == 0 || routing->m_maskSize == 0)
+            {
+              continue;
+            }
+          uint8_t *mask = &routing->m_nextHops[d * routing->m_maskSize];
+          for (uint32_t e = graph.m_offset[v]; e < graph.m_offset[v + 1]; e++)
+            {
+              if (distance[graph.m_target[e]] + 1 == distance[v])
+                {
+                  uint32_t index = e - graph.m_offset[v];
+                  mask[index / 8] |= (1 << (index % 8));
+                }
+            }
+        }
+
+      // The paths toward the leaves attached to d are the paths toward d
+      // followed by the last link
+      if (IsLeaf (graph, d))
+        {
+          continue;
+        }
+      for (uint32_t e = graph.m_offset[d]; e < graph.m_offset[d + 1]; e++)
+        {
+          uint32_t leaf = graph.m_target[e];
+          if (!IsLeaf (graph, leaf))
+            {
+              continue;
+            }
+          Ipv4PrecomputedRouting *routing = PeekPointer (computation->m_routing[d]);
+          if (routing != 0 && routing->m_maskSize != 0)
+            {
+              uint32_t index = e - graph.m_offset[d];
+              routing->m_nextHops[leaf * routing->m_maskSize + index / 8] |= (1 << (index % 8));
+            }
+          for (uint32_t q = 1; q < tail; q++)
+            {
+              uint32_t v = queue[q];
+              routing = PeekPointer (computation->m_routing[v]);
+              if (v == leaf || routing == 0 || routing->m_maskSize == 0)
+                {
+                  continue;
+                }
+              std::copy (&routing->m_nextHops[d * routing->m_maskSize],
+                         &routing->m_nextHops[(d + 1) * routing->m_maskSize],
+                         &routing->m_nextHops[leaf * routing->m_maskSize]);
+            }
+        }
+    }
+}
+
+void
+Ipv4PrecomputedRouting::CheckRoutesAndCompute (void) const
+{
+  if (g_isDirty || !m_computed)
+    {
+      ComputeRoutes ();
+    }
+}
+
+std::vector<uint32_t>
+Ipv4PrecomputedRouting::GetNextHopInterfaces (uint32_t destination)
+{
+  NS_LOG_FUNCTION (this << destination);
+  CheckRoutesAndCompute ();
+
+  std::vector<uint32_t> interfaces;
+  if (destination >= g_component.size () || destination == m_node->GetId ()
+      || g_component[destination] != g_component[m_node->GetId ()])
+    {
+      return interfaces;
+    }
+  for (uint32_t i = 0; i < m_neighbors.size (); i++)
+    {
+      if (m_maskSize == 0 || (m_nextHops[destination * m_maskSize + i / 8] & (1 << (i % 8))))
+        {
+          interfaces.push_back (m_neighbors[i].m_interface);
+        }
+    }
+  return interfaces;
+}
+
+int32_t
+Ipv4PrecomputedRouting::SelectNextHop (uint32_t destination, const Ipv4Header &header,
+                                       Ptr<const Packet> p, Ptr<NetDevice> oif) const
+{
+  uint32_t id = m_node->GetId ();
+  if (m_neighbors.empty () || destination == id || g_component[destination] != g_component[id])
+    {
+      return -1;
+    }
+
+  if (m_maskSize == 0)
+    {
+      if (oif && m_ipv4->GetNetDevice (m_neighbors[0].m_interface) != oif)
+        {
+          return -1;
+        }
+      return 0;
+    }
+
+  const uint8_t *mask = &m_nextHops[destination * m_maskSize];
+  uint32_t candidates = 0;
+  for (uint32_t i = 0; i < m_neighbors.size (); i++)
+    {
+      if ((mask[i / 8] & (1 << (i % 8)))
+          && (!oif || m_ipv4->GetNetDevice (m_neighbors[i].m_interface) == oif))
+        {
+          candidates++;
+        }
+    }
+  if (candidates == 0)
+    {
+      return -1;
+    }
+
+  uint32_t selected = 0;
+  if (candidates > 1)
+    {
+      // ECMP: hash the 5-tuple, and the node id to avoid polarization
+      uint32_t ports = 0;
+      uint8_t protocol = header.GetProtocol ();
+      if (p && (protocol == 6 || protocol == 17) && header.GetFragmentOffset () == 0
+          && p->GetSize () >= 4)
+        {
+          uint8_t buf[4];
+          p->CopyData (buf, 4);
+          ports = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+        }
+      uint32_t words[5] = { header.GetSource ().Get (), header.GetDestination ().Get (),
+                            protocol, ports, id };
+      uint32_t hash = 2166136261u;
+      for (uint32_t i = 0; i < 5; i++)
+        {
+          hash = (hash ^ words[i]) * 16777619u;
+          hash ^= hash >> 15;
+        }
+      selected = hash % candidates;
+    }
+
+  for (uint32_t i = 0; i < m_neighbors.size (); i++)
+    {
+      if ((mask[i / 8] & (1 << (i % 8)))
+          && (!oif || m_ipv4->GetNetDevice (m_neighbors[i].m_interface) == oif))
+        {
+          if (selected == 0)
+            {
+              return i;
+            }
+          selected--;
+        }
+    }
+  NS_ASSERT (false);
+  return -1;
+}
+
+Ptr<Ipv4Route>
+Ipv4PrecomputedRouting::BuildRoute (uint32_t neighbor, Ipv4Address destination) const
+{
+  const Neighbor &n = m_neighbors[neighbor];
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (destination);
+  rtentry->SetSource (n.m_source);
+  rtentry->SetGateway (n.m_gateway);
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (n.m_interface));
+  return rtentry;
+}
+
+Ptr<Ipv4Route>
+Ipv4PrecomputedRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << header << oif);
+
+  CheckRoutesAndCompute ();
+
+  AddressMap::const_iterator it = g_addressMap.find (header.GetDestination ());
+  if (it != g_addressMap.end ())
+    {
+      int32_t neighbor = SelectNextHop (it->second, header, p, oif);
+      if (neighbor >= 0)
+        {
+          NS_LOG_LOGIC ("Route to " << header.GetDestination () << " via " <<
+                        m_neighbors[neighbor].m_gateway);
+          sockerr = Socket::ERROR_NOTERROR;
+          return BuildRoute (neighbor, header.GetDestination ());
+        }
+    }
+  NS_LOG_LOGIC ("No path to the dest: " << header.GetDestination ());
+  sockerr = Socket::ERROR_NOROUTETOHOST;
+  return 0;
+}
+
+bool
+Ipv4PrecomputedRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                                    UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                                    LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev);
+
+  NS_ASSERT (m_ipv4 != 0);
+  // Check if input device supports IP
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+
+  // Local delivery
+  if (m_ipv4->IsDestinationAddress (header.GetDestination (), iif))
+    {
+      if (!lcb.IsNull ())
+        {
+          NS_LOG_LOGIC ("Local delivery to " << header.GetDestination ());
+          lcb (p, header, iif);
+          return true;
+        }
+      else
+        {
+          // The local delivery callback is null.  This may be a multicast
+          // or broadcast packet, so return false so that another
+          // multicast routing protocol can handle it.
+          return false;
+        }
+    }
+
+  CheckRoutesAndCompute ();
+
+  AddressMap::const_iterator it = g_addressMap.find (header.GetDestination ());
+  if (it == g_addressMap.end ())
+    {
+      NS_LOG_LOGIC ("Unknown destination " << header.GetDestination ());
+      return false;
+    }
+  int32_t neighbor = SelectNextHop (it->second, header, p, 0);
+  if (neighbor < 0)
+    {
+      NS_LOG_LOGIC ("No path to the dest: " << header.GetDestination ());
+      return false;
+    }
+  ucb (BuildRoute (neighbor, header.GetDestination ()), p, header);
+  return true;
+}
+
+void
+Ipv4PrecomputedRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  CheckRoutesAndCompute ();
+
+  std::ostream* os = stream->GetStream ();
+
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", Local time: " << GetObject<Node> ()->GetLocalTime ().As (unit)
+      << ", Precomputed Routing" << std::endl;
+
+  *os << "Destination     Gateway         Source            OutputDevice" << std::endl;
+  uint32_t id = m_node->GetId ();
+  for (AddressMap::const_iterator it = g_addressMap.begin (); it != g_addressMap.end (); it++)
+    {
+      uint32_t destination = it->second;
+      if (destination == id || g_component[destination] != g_component[id])
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < m_neighbors.size (); i++)
+        {
+          if (m_maskSize != 0 && !(m_nextHops[destination * m_maskSize + i / 8] & (1 << (i % 8))))
+            {
+              continue;
+            }
+          std::ostringstream dest, gw, src;
+          dest << it->first;
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ();
+          gw << m_neighbors[i].m_gateway;
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << gw.str ();
+          src << m_neighbors[i].m_source;
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << src.str ();
+          *os << "  ";
+          Ptr<NetDevice> device = m_ipv4->GetNetDevice (m_neighbors[i].m_interface);
+          if (Names::FindName (device) != "")
+            {
+              *os << Names::FindName (device);
+            }
+          else
+            {
+              *os << device->GetIfIndex ();
+            }
+          *os << std::endl;
+        }
+    }
+  *os << std::endl;
+}
+
+void
+Ipv4PrecomputedRouting::NotifyInterfaceUp (uint32_t i)
+{
+  g_isDirty = true;
+}
+void
+Ipv4PrecomputedRouting::NotifyInterfaceDown (uint32_t i)
+{
+  g_isDirty = true;
+}
+void
+Ipv4PrecomputedRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  g_isDirty = true;
+}
+void
+Ipv4PrecomputedRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  g_isDirty = true;
+}
+
+} // namespace ns3
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_PRECOMPUTED_ROUTING_H
+#define IPV4_PRECOMPUTED_ROUTING_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "ns3/channel.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup nix-vector-routing
+ *
+ * \brief Precomputed static forwarding for large wired topologies
+ *
+ * The next hops from every node to every other node are computed once,
+ * with one breadth-first search per destination over the Node/Channel
+ * graph (the searches are spread over several threads when threading is
+ * enabled). Nodes with a single neighbor, such as hosts, are not searched
+ * from: their tables are derived from the ones of their neighbor. Each node stores, for every destination node id, the set of
+ * its interfaces lying on a shortest path toward the destination, as a
+ * bit mask over its neighbors. Nodes with a single neighbor store nothing.
+ *
+ * Forwarding a packet is then a lookup of the destination node id by
+ * address plus an array access. When several next hops are available,
+ * one is selected by hashing the packet 5-tuple (the ports are used when
+ * the packet carries a TCP or UDP header), so that the packets of a flow
+ * follow the same path (ECMP).
+ *
+ * Tables are (re)computed lazily on the first lookup after any interface
+ * or address change, or explicitly with ComputeRoutes (). A link is used
+ * only if the interfaces at both ends are up. Any change invalidates the
+ * tables of all the nodes, and the next lookup, even in the middle of a
+ * simulation, computes them all again: this costs O(N (N + E)) time for
+ * N nodes and E links, so frequent topology changes are better handled by
+ * Ipv4NixVectorRouting.
+ *
+ * As for nix-vector routing, all the nodes are expected to use this
+ * protocol, which must be aggregated to them (see
+ * Ipv4PrecomputedRoutingHelper). Only unicast is supported.
+ */
+class Ipv4PrecomputedRouting : public Ipv4RoutingProtocol
+{
+public:
+  Ipv4PrecomputedRouting ();
+  ~Ipv4PrecomputedRouting ();
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Set the node on which the protocol runs
+   * \param node the node
+   */
+  void SetNode (Ptr<Node> node);
+
+  /**
+   * \brief Compute the forwarding tables of all the nodes
+   *
+   * \param nThreads number of threads computing the tables; 0 selects
+   *        the number of hardware threads
+   */
+  static void ComputeRoutes (uint32_t nThreads = 0);
+
+  /**
+   * \brief Get the next hops toward a node
+   *
+   * \param destination the destination node id
+   * \return the interfaces of this node on a shortest path toward the
+   *         destination (empty if unreachable)
+   */
+  std::vector<uint32_t> GetNextHopInterfaces (uint32_t destination);
+
+  // From Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A neighbor of the node
+   */
+  struct Neighbor
+  {
+    uint32_t m_interface;   //!< Interface toward the neighbor
+    Ipv4Address m_source;   //!< Address of the interface
+    Ipv4Address m_gateway;  //!< Address of the neighbor
+  };
+
+  /**
+   * \brief Graph of the topology in compressed sparse row format
+   */
+  struct Graph
+  {
+    std::vector<uint32_t> m_offset;  //!< First edge of each node (size: nodes + 1)
+    std::vector<uint32_t> m_target;  //!< Neighbor node id of each edge
+  };
+
+  /**
+   * \brief Data shared by the threads computing the tables
+   */
+  struct Computation
+  {
+    const Graph *m_graph;                                 //!< Topology
+    std::vector<Ptr<Ipv4PrecomputedRouting> > m_routing;  //!< Routing protocol of each node
+    uint32_t m_nThreads;                                  //!< Number of threads
+  };
+
+  /**
+   * \brief Check if a node has a single neighbor
+   * \param graph the topology
+   * \param node the node id
+   * \return true if the node has a single neighbor
+   */
+  static bool IsLeaf (const Graph &graph, uint32_t node);
+
+  /**
+   * \brief Compute the tables for the destinations assigned to a thread
+   * \param computation the shared data
+   * \param thread the thread index
+   */
+  static void ComputeDestinations (Computation *computation, uint32_t thread);
+
+  /**
+   * \brief Find the devices attached to a channel, crossing bridges
+   * \param [in] netDevice the device attached to the channel
+   * \param [in] channel the channel
+   * \param [out] netDeviceContainer the devices on the channel
+   */
+  static void GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer &netDeviceContainer);
+
+  /**
+   * \brief Find the bridge of a device
+   * \param nd the device
+   * \return the bridge device, or null if the device is not bridged
+   */
+  static Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd);
+
+  /**
+   * \brief Compute the tables if needed
+   *
+   * The tables of all the nodes are computed again after any interface or
+   * address change (see ComputeRoutes).
+   */
+  void CheckRoutesAndCompute (void) const;
+
+  /**
+   * \brief Select the next hop toward a node
+   * \param destination the destination node id
+   * \param header the IPv4 header of the packet
+   * \param p the packet (may be null)
+   * \param oif the output device to use (may be null)
+   * \return the neighbor index, or -1 if there is no next hop
+   */
+  int32_t SelectNextHop (uint32_t destination, const Ipv4Header &header, Ptr<const Packet> p,
+                         Ptr<NetDevice> oif) const;
+
+  /**
+   * \brief Build the route through a neighbor
+   * \param neighbor the neighbor index
+   * \param destination the destination address
+   * \return the route
+   */
+  Ptr<Ipv4Route> BuildRoute (uint32_t neighbor, Ipv4Address destination) const;
+
+  /// Map of the addresses of the nodes to their id
+  typedef std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> AddressMap;
+
+  static bool g_isDirty;                  //!< True if the tables must be computed again
+  static AddressMap g_addressMap;         //!< Node id of each address
+  static std::vector<uint32_t> g_component; //!< Connected component of each node
+
+  Ptr<Ipv4> m_ipv4; //!< IPv4 object
+  Ptr<Node> m_node; //!< Node object
+  bool m_computed;  //!< True if the tables of this node have been computed
+  std::vector<Neighbor> m_neighbors; //!< Neighbors of the node
+  uint32_t m_maskSize;               //!< Size (bytes) of a next hop mask
+  std::vector<uint8_t> m_nextHops;   //!< Next hop masks indexed by destination node id
+};
+
+} // namespace ns3
+
+#endif /* IPV4_PRECOMPUTED_ROUTING_H */
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "ns3/log.h"
+
+#include "nix-vector-cache.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NixVectorCache");
+
+NixVectorCache::NixVectorCache (uint32_t maxSize)
+  : m_maxSize (maxSize)
+{
+  NS_LOG_FUNCTION (this << maxSize);
+}
+
+void
+NixVectorCache::SetMaxSize (uint32_t maxSize)
+{
+  NS_LOG_FUNCTION (this << maxSize);
+  m_maxSize = maxSize;
+  while (m_maxSize != 0 && m_entries.size () > m_maxSize)
+    {
+      Remove (--m_entries.end ());
+    }
+}
+
+uint32_t
+NixVectorCache::GetMaxSize (void) const
+{
+  return m_maxSize;
+}
+
+uint32_t
+NixVectorCache::GetSize (void) const
+{
+  return m_entries.size ();
+}
+
+uint64_t
+NixVectorCache::GetKey (uint32_t source, Ipv4Address dest)
+{
+  return (static_cast<uint64_t> (source) << 32) | dest.Get ();
+}
+
+Ptr<NixVector>
+NixVectorCache::Lookup (uint32_t source, Ipv4Address dest)
+{
+  NS_LOG_FUNCTION (this << source << dest);
+
+  std::unordered_map<uint64_t, EntryList::iterator>::iterator it = m_index.find (GetKey (source, dest));
+  if (it == m_index.end ())
+    {
+      return 0;
+    }
+  m_entries.splice (m_entries.begin (), m_entries, it->second);
+  return it->second->m_nixVector;
+}
+
+void
+NixVectorCache::Insert (uint32_t source, Ipv4Address dest, Ptr<NixVector> nixVector,
+                        const std::vector<uint32_t> &path)
+{
+  NS_LOG_FUNCTION (this << source << dest << nixVector);
+
+  uint64_t key = GetKey (source, dest);
+  std::unordered_map<uint64_t, EntryList::iterator>::iterator it = m_index.find (key);
+  if (it != m_index.end ())
+    {
+      Remove (it->second);
+    }
+  else if (m_maxSize != 0 && m_entries.size () >= m_maxSize)
+    {
+      NS_LOG_LOGIC ("Cache full, evicting the least recently used nix-vector");
+      Remove (--m_entries.end ());
+    }
+
+  Entry entry;
+  entry.m_source = source;
+  entry.m_dest = dest;
+  entry.m_nixVector = nixVector;
+  entry.m_path = path;
+  m_entries.push_front (entry);
+  m_index[key] = m_entries.begin ();
+}
+
+uint32_t
+NixVectorCache::InvalidateLink (uint32_t node, const std::vector<uint32_t> &neighbors)
+{
+  NS_LOG_FUNCTION (this << node);
+
+  uint32_t removed = 0;
+  EntryList::iterator it = m_entries.begin ();
+  while (it != m_entries.end ())
+    {
+      bool crosses = false;
+      const std::vector<uint32_t> &path = it->m_path;
+      for (uint32_t i = 0; i + 1 < path.size () && !crosses; i++)
+        {
+          if (path[i] == node)
+            {
+              crosses = std::find (neighbors.begin (), neighbors.end (), path[i + 1]) != neighbors.end ();
+            }
+          else if (path[i + 1] == node)
+            {
+              crosses = std::find (neighbors.begin (), neighbors.end (), path[i]) != neighbors.end ();
+            }
+        }
+      if (crosses)
+        {
+          it = Remove (it);
+          removed++;
+        }
+      else
+        {
+          it++;
+        }
+    }
+  NS_LOG_LOGIC ("Removed " << removed << " nix-vectors crossing a link of node " << node);
+  return removed;
+}
+
+uint32_t
+NixVectorCache::InvalidateDestination (Ipv4Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  uint32_t removed = 0;
+  EntryList::iterator it = m_entries.begin ();
+  while (it != m_entries.end ())
+    {
+      if (it->m_dest == dest)
+        {
+          it = Remove (it);
+          removed++;
+        }
+      else
+        {
+          it++;
+        }
+    }
+  return removed;
+}
+
+std::map<Ipv4Address, Ptr<NixVector> >
+NixVectorCache::GetEntries (uint32_t source) const
+{
+  std::map<Ipv4Address, Ptr<NixVector> > entries;
+  for (EntryList::const_iterator it = m_entries.begin (); it != m_entries.end (); it++)
+    {
+      if (it->m_source == source)
+        {
+          entries[it->m_dest] = it->m_nixVector;
+        }
+    }
+  return entries;
+}
+
+void
+NixVectorCache::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_entries.clear ();
+  m_index.clear ();
+}
+
+NixVectorCache::EntryList::iterator
+NixVectorCache::Remove (EntryList::iterator entry)
+{
+  m_index.erase (GetKey (entry->m_source, entry->m_dest));
+  return m_entries.erase (entry);
+}
+
+} // namespace ns3
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NIX_VECTOR_CACHE_H
+#define NIX_VECTOR_CACHE_H
+
+#include <list>
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+#include "ns3/ipv4-address.h"
+#include "ns3/nix-vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup nix-vector-routing
+ *
+ * \brief Bounded cache of nix-vectors shared by all the nodes
+ *
+ * The nix-vectors are indexed by source node id and destination address.
+ * When the cache is full, the least recently used entry is evicted.
+ *
+ * Each entry also records the ids of the nodes along its path, so that
+ * only the entries crossing a link can be invalidated when that link
+ * goes down.
+ */
+class NixVectorCache
+{
+public:
+  /**
+   * Create an empty cache
+   * \param maxSize the maximum number of entries (0 for no limit)
+   */
+  NixVectorCache (uint32_t maxSize = 0);
+
+  /**
+   * \brief Set the maximum number of entries, evicting the least
+   * recently used ones if needed
+   * \param maxSize the maximum number of entries (0 for no limit)
+   */
+  void SetMaxSize (uint32_t maxSize);
+
+  /**
+   * \return the maximum number of entries (0 for no limit)
+   */
+  uint32_t GetMaxSize (void) const;
+
+  /**
+   * \return the number of entries
+   */
+  uint32_t GetSize (void) const;
+
+  /**
+   * \brief Find a nix-vector and mark it as the most recently used
+   * \param source the source node id
+   * \param dest the destination address
+   * \return the nix-vector, or 0 if not in cache
+   */
+  Ptr<NixVector> Lookup (uint32_t source, Ipv4Address dest);
+
+  /**
+   * \brief Add (or replace) a nix-vector
+   * \param source the source node id
+   * \param dest the destination address
+   * \param nixVector the nix-vector
+   * \param path the ids of the nodes from the source to the destination
+   */
+  void Insert (uint32_t source, Ipv4Address dest, Ptr<NixVector> nixVector,
+               const std::vector<uint32_t> &path);
+
+  /**
+   * \brief Remove the entries whose path crosses a link
+   * \param node a node at one end of the link
+   * \param neighbors the nodes at the other end(s) of the link
+   * \return the number of entries removed
+   */
+  uint32_t InvalidateLink (uint32_t node, const std::vector<uint32_t> &neighbors);
+
+  /**
+   * \brief Remove the entries toward a destination
+   * \param dest the destination address
+   * \return the number of entries removed
+   */
+  uint32_t InvalidateDestination (Ipv4Address dest);
+
+  /**
+   * \brief Get the entries of a source node
+   * \param source the source node id
+   * \return the nix-vectors of the source, by destination
+   */
+  std::map<Ipv4Address, Ptr<NixVector> > GetEntries (uint32_t source) const;
+
+  /**
+   * \brief Remove all the entries
+   */
+  void Clear (void);
+
+private:
+  /**
+   * \brief A cached nix-vector
+   */
+  struct Entry
+  {
+    uint32_t m_source;              //!< Source node id
+    Ipv4Address m_dest;             //!< Destination address
+    Ptr<NixVector> m_nixVector;     //!< Nix-vector
+    std::vector<uint32_t> m_path;   //!< Nodes along the path
+  };
+
+  /// Entries, most recently used first
+  typedef std::list<Entry> EntryList;
+
+  /**
+   * \param source the source node id
+   * \param dest the destination address
+   * \return the key of the entry
+   */
+  static uint64_t GetKey (uint32_t source, Ipv4Address dest);
+
+  /**
+   * \brief Remove an entry
+   * \param entry the entry
+   * \return the entry following the removed one
+   */
+  EntryList::iterator Remove (EntryList::iterator entry);
+
+  uint32_t m_maxSize;                                           //!< Maximum number of entries
+  EntryList m_entries;                                          //!< Entries in recency order
+  std::unordered_map<uint64_t, EntryList::iterator> m_index;    //!< Entries by key
+};
+
+} // namespace ns3
+
+#endif /* NIX_VECTOR_CACHE_H */
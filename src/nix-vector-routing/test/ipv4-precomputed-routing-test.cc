@@ -0,0 +1,366 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <set>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-precomputed-routing-helper.h"
+#include "ns3/ipv4-precomputed-routing.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Base class of the Ipv4PrecomputedRouting tests
+ *
+ * Builds the following topology, where n0 and n5 are leaves and there are
+ * two shortest paths between n1 and n4:
+ *
+ *           n2
+ *          /  \
+ *  n0 -- n1    n4 -- n5
+ *          \  /
+ *           n3
+ *
+ * optionally with an additional link between n0 and n3.
+ */
+class Ipv4PrecomputedRoutingTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name the test case name
+   */
+  Ipv4PrecomputedRoutingTestCase (std::string name);
+
+protected:
+  /**
+   * \brief Build the topology
+   * \param linkN0N3 true to add the link between n0 and n3
+   */
+  void BuildTopology (bool linkN0N3 = false);
+
+  /**
+   * \brief Get the interface of a node on the link toward another node
+   * \param from the node
+   * \param to the other node
+   * \return the interface of from
+   */
+  uint32_t GetInterface (uint32_t from, uint32_t to) const;
+
+  /**
+   * \brief Get the next hops of a node toward another node
+   * \param from the node
+   * \param to the destination node
+   * \return the interfaces of from toward to
+   */
+  std::vector<uint32_t> GetNextHops (uint32_t from, uint32_t to) const;
+
+  /**
+   * \brief Route a UDP packet from a node
+   * \param from the node
+   * \param to the destination node
+   * \param sourcePort the UDP source port
+   * \return the route, or null if there is none
+   */
+  Ptr<Ipv4Route> Route (uint32_t from, uint32_t to, uint16_t sourcePort) const;
+
+  /**
+   * \brief Set an interface up or down
+   * \param node the node
+   * \param to the node at the other end of the link
+   * \param up true to set the interface up
+   */
+  void SetUp (uint32_t node, uint32_t to, bool up);
+
+  NodeContainer m_nodes;                  //!< Nodes
+  std::vector<Ipv4Address> m_addresses;   //!< Address of each node on its first link
+  std::vector<std::vector<uint32_t> > m_interfaces; //!< Interface of each node toward each other node
+};
+
+Ipv4PrecomputedRoutingTestCase::Ipv4PrecomputedRoutingTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+Ipv4PrecomputedRoutingTestCase::BuildTopology (bool linkN0N3)
+{
+  m_nodes.Create (6);
+
+  Ipv4PrecomputedRoutingHelper precomputedRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (precomputedRouting);
+  stack.Install (m_nodes);
+
+  SimpleNetDeviceHelper simple;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  uint32_t links[7][2] = { { 0, 1 }, { 1, 2 }, { 1, 3 }, { 2, 4 }, { 3, 4 }, { 4, 5 }, { 0, 3 } };
+  m_addresses.resize (6);
+  m_interfaces.assign (6, std::vector<uint32_t> (6, 0));
+  for (uint32_t i = 0; i < (linkN0N3 ? 7 : 6); i++)
+    {
+      uint32_t a = links[i][0];
+      uint32_t b = links[i][1];
+      NetDeviceContainer devices = simple.Install (NodeContainer (m_nodes.Get (a), m_nodes.Get (b)));
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      address.NewNetwork ();
+      if (m_addresses[a] == Ipv4Address ())
+        {
+          m_addresses[a] = interfaces.GetAddress (0);
+        }
+      if (m_addresses[b] == Ipv4Address ())
+        {
+          m_addresses[b] = interfaces.GetAddress (1);
+        }
+      m_interfaces[a][b] = interfaces.Get (0).second;
+      m_interfaces[b][a] = interfaces.Get (1).second;
+    }
+}
+
+uint32_t
+Ipv4PrecomputedRoutingTestCase::GetInterface (uint32_t from, uint32_t to) const
+{
+  return m_interfaces[from][to];
+}
+
+std::vector<uint32_t>
+Ipv4PrecomputedRoutingTestCase::GetNextHops (uint32_t from, uint32_t to) const
+{
+  Ptr<Ipv4PrecomputedRouting> routing = m_nodes.Get (from)->GetObject<Ipv4PrecomputedRouting> ();
+  return routing->GetNextHopInterfaces (m_nodes.Get (to)->GetId ());
+}
+
+Ptr<Ipv4Route>
+Ipv4PrecomputedRoutingTestCase::Route (uint32_t from, uint32_t to, uint16_t sourcePort) const
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (sourcePort);
+  udpHeader.SetDestinationPort (9);
+  p->AddHeader (udpHeader);
+
+  Ipv4Header header;
+  header.SetSource (m_addresses[from]);
+  header.SetDestination (m_addresses[to]);
+  header.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4> ipv4 = m_nodes.Get (from)->GetObject<Ipv4> ();
+  return ipv4->GetRoutingProtocol ()->RouteOutput (p, header, 0, sockerr);
+}
+
+void
+Ipv4PrecomputedRoutingTestCase::SetUp (uint32_t node, uint32_t to, bool up)
+{
+  Ptr<Ipv4> ipv4 = m_nodes.Get (node)->GetObject<Ipv4> ();
+  if (up)
+    {
+      ipv4->SetUp (GetInterface (node, to));
+    }
+  else
+    {
+      ipv4->SetDown (GetInterface (node, to));
+    }
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Next hops and ECMP selection Test
+ */
+class Ipv4PrecomputedRoutingNextHopTestCase : public Ipv4PrecomputedRoutingTestCase
+{
+public:
+  Ipv4PrecomputedRoutingNextHopTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4PrecomputedRoutingNextHopTestCase::Ipv4PrecomputedRoutingNextHopTestCase ()
+  : Ipv4PrecomputedRoutingTestCase ("Check the next hops and the ECMP selection")
+{
+}
+
+void
+Ipv4PrecomputedRoutingNextHopTestCase::DoRun (void)
+{
+  BuildTopology ();
+  Ipv4PrecomputedRoutingHelper::PopulateRoutingTables (2);
+
+  // single next hops, from and toward the leaves
+  std::vector<uint32_t> nextHops = GetNextHops (0, 5);
+  NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Wrong number of next hops of a leaf");
+  NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (0, 1), "Wrong next hop of a leaf");
+  nextHops = GetNextHops (2, 0);
+  NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Wrong number of next hops toward a leaf");
+  NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (2, 1), "Wrong next hop toward a leaf");
+  nextHops = GetNextHops (1, 0);
+  NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Wrong number of next hops toward a neighbor leaf");
+  NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (1, 0), "Wrong next hop toward a neighbor leaf");
+  NS_TEST_EXPECT_MSG_EQ (GetNextHops (0, 0).size (), 0, "Next hops toward the node itself");
+
+  // two shortest paths from n1 toward n4 and n5
+  for (uint32_t to = 4; to <= 5; to++)
+    {
+      nextHops = GetNextHops (1, to);
+      NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 2, "Wrong number of ECMP next hops");
+      NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (1, 2), "Wrong ECMP next hop");
+      NS_TEST_EXPECT_MSG_EQ (nextHops[1], GetInterface (1, 3), "Wrong ECMP next hop");
+    }
+
+  // a flow always follows the same path, and the flows are spread
+  std::set<Ipv4Address> gateways;
+  for (uint16_t port = 1000; port < 1032; port++)
+    {
+      Ptr<Ipv4Route> route = Route (1, 5, port);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route");
+      NS_TEST_EXPECT_MSG_EQ (Route (1, 5, port)->GetGateway (), route->GetGateway (),
+                             "The packets of a flow take different paths");
+      gateways.insert (route->GetGateway ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (gateways.size (), 2, "The flows are not spread over the shortest paths");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Routes after links go down and up Test
+ */
+class Ipv4PrecomputedRoutingLinkDownTestCase : public Ipv4PrecomputedRoutingTestCase
+{
+public:
+  Ipv4PrecomputedRoutingLinkDownTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4PrecomputedRoutingLinkDownTestCase::Ipv4PrecomputedRoutingLinkDownTestCase ()
+  : Ipv4PrecomputedRoutingTestCase ("Check that the routes are computed again when links go down and up")
+{
+}
+
+void
+Ipv4PrecomputedRoutingLinkDownTestCase::DoRun (void)
+{
+  BuildTopology ();
+
+  // the link n1-n2 goes down at n2 only: it can not be used in either direction
+  SetUp (2, 1, false);
+  std::vector<uint32_t> nextHops = GetNextHops (1, 5);
+  NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Route through a link down at one end");
+  NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (1, 3), "Wrong next hop");
+  nextHops = GetNextHops (2, 0);
+  NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Route through a link down at one end");
+  NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (2, 4), "Wrong next hop");
+  NS_TEST_EXPECT_MSG_NE (Route (0, 5, 1000), 0, "No route from a leaf");
+  NS_TEST_EXPECT_MSG_NE (Route (5, 0, 1000), 0, "No route toward a leaf");
+  NS_TEST_EXPECT_MSG_EQ (GetNextHops (5, 2).size (), 1, "No route toward the node with a link down");
+
+  // the link of the leaf n0 goes down at n1 only: n0 is unreachable
+  SetUp (1, 0, false);
+  NS_TEST_EXPECT_MSG_EQ (GetNextHops (0, 5).size (), 0, "Route from an isolated leaf");
+  NS_TEST_EXPECT_MSG_EQ (GetNextHops (5, 0).size (), 0, "Route toward an isolated leaf");
+  NS_TEST_EXPECT_MSG_EQ (Route (5, 0, 1000), 0, "Route toward an isolated leaf");
+
+  // all the links up again
+  SetUp (1, 0, true);
+  SetUp (2, 1, true);
+  NS_TEST_EXPECT_MSG_EQ (GetNextHops (1, 5).size (), 2, "ECMP next hops not restored");
+  NS_TEST_EXPECT_MSG_EQ (GetNextHops (0, 5).size (), 1, "Route from a leaf not restored");
+  NS_TEST_EXPECT_MSG_NE (Route (5, 0, 1000), 0, "Route toward a leaf not restored");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Leaf with a link up on its side only Test
+ *
+ * The link n0-n3 goes down at n3, while n0 keeps its interface up: n0 is
+ * then a leaf, which must use its link toward n1.
+ */
+class Ipv4PrecomputedRoutingAsymmetricLinkTestCase : public Ipv4PrecomputedRoutingTestCase
+{
+public:
+  Ipv4PrecomputedRoutingAsymmetricLinkTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4PrecomputedRoutingAsymmetricLinkTestCase::Ipv4PrecomputedRoutingAsymmetricLinkTestCase ()
+  : Ipv4PrecomputedRoutingTestCase ("Check the routes of a leaf with a link up on its side only")
+{
+}
+
+void
+Ipv4PrecomputedRoutingAsymmetricLinkTestCase::DoRun (void)
+{
+  BuildTopology (true);
+
+  std::vector<uint32_t> nextHops = GetNextHops (0, 5);
+  NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Wrong number of next hops");
+  NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (0, 3), "Wrong next hop");
+
+  SetUp (3, 0, false);
+  for (uint32_t to = 1; to <= 5; to++)
+    {
+      nextHops = GetNextHops (0, to);
+      NS_TEST_ASSERT_MSG_EQ (nextHops.size (), 1, "Wrong number of next hops of the leaf");
+      NS_TEST_EXPECT_MSG_EQ (nextHops[0], GetInterface (0, 1), "Wrong next hop of the leaf");
+      Ptr<Ipv4Route> route = Route (0, to, 1000);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route from the leaf");
+      NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (),
+                             m_nodes.Get (0)->GetObject<Ipv4> ()->GetNetDevice (GetInterface (0, 1)),
+                             "Route from the leaf through the link down");
+      NS_TEST_EXPECT_MSG_NE (Route (to, 0, 1000), 0, "No route toward the leaf");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Ipv4PrecomputedRouting TestSuite
+ */
+class Ipv4PrecomputedRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4PrecomputedRoutingTestSuite ();
+};
+
+Ipv4PrecomputedRoutingTestSuite::Ipv4PrecomputedRoutingTestSuite ()
+  : TestSuite ("ipv4-precomputed-routing", UNIT)
+{
+  AddTestCase (new Ipv4PrecomputedRoutingNextHopTestCase (), TestCase::QUICK);
+  AddTestCase (new Ipv4PrecomputedRoutingLinkDownTestCase (), TestCase::QUICK);
+  AddTestCase (new Ipv4PrecomputedRoutingAsymmetricLinkTestCase (), TestCase::QUICK);
+}
+
+static Ipv4PrecomputedRoutingTestSuite g_ipv4PrecomputedRoutingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/nix-vector-cache.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief NixVectorCache eviction and invalidation Test
+ */
+class NixVectorCacheTestCase : public TestCase
+{
+public:
+  NixVectorCacheTestCase ();
+  virtual void DoRun (void);
+};
+
+NixVectorCacheTestCase::NixVectorCacheTestCase ()
+  : TestCase ("Check the LRU eviction and the invalidation of the nix-vector cache")
+{
+}
+
+void
+NixVectorCacheTestCase::DoRun (void)
+{
+  NixVectorCache cache (3);
+  Ptr<NixVector> nixVector = Create<NixVector> ();
+  Ipv4Address dest ("10.0.0.1");
+
+  // paths 0-1-2, 1-2, 2-3, then 3-2-1 evicting the least recently used
+  cache.Insert (0, dest, nixVector, std::vector<uint32_t> { 0, 1, 2 });
+  cache.Insert (1, dest, nixVector, std::vector<uint32_t> { 1, 2 });
+  cache.Insert (2, dest, nixVector, std::vector<uint32_t> { 2, 3 });
+  NS_TEST_EXPECT_MSG_EQ (cache.Lookup (0, dest), nixVector, "Entry not found");
+  cache.Insert (3, dest, nixVector, std::vector<uint32_t> { 3, 2, 1 });
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 3, "Cache not bounded");
+  NS_TEST_EXPECT_MSG_EQ (cache.Lookup (1, dest), 0, "Least recently used entry not evicted");
+  NS_TEST_EXPECT_MSG_EQ (cache.Lookup (0, dest), nixVector, "Recently used entry evicted");
+
+  // only the paths crossing the link 1-2 are removed
+  NS_TEST_EXPECT_MSG_EQ (cache.InvalidateLink (2, std::vector<uint32_t> { 1 }), 2, "Wrong number of invalidated entries");
+  NS_TEST_EXPECT_MSG_EQ (cache.Lookup (2, dest), nixVector, "Entry not crossing the link removed");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetEntries (2).size (), 1, "Wrong entries of the source");
+
+  NS_TEST_EXPECT_MSG_EQ (cache.InvalidateDestination (Ipv4Address ("10.0.0.2")), 0, "Wrong destination invalidated");
+  NS_TEST_EXPECT_MSG_EQ (cache.InvalidateDestination (dest), 1, "Destination not invalidated");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 0, "Cache not empty");
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Nix-vector routing after a link failure Test
+ *
+ * Diamond topology, with precomputed trees:
+ *
+ *     n1
+ *    /  \
+ *  n0    n3
+ *    \  /
+ *     n2
+ */
+class NixVectorLinkDownTestCase : public TestCase
+{
+public:
+  NixVectorLinkDownTestCase ();
+  virtual void DoRun (void);
+};
+
+NixVectorLinkDownTestCase::NixVectorLinkDownTestCase ()
+  : TestCase ("Check that the routes avoid a link which went down")
+{
+}
+
+void
+NixVectorLinkDownTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  uint32_t links[4][2] = { { 0, 1 }, { 0, 2 }, { 1, 3 }, { 2, 3 } };
+  Ipv4Address n3Address;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ipv4InterfaceContainer interfaces =
+        address.Assign (simple.Install (NodeContainer (nodes.Get (links[i][0]), nodes.Get (links[i][1]))));
+      address.NewNetwork ();
+      n3Address = interfaces.GetAddress (1);
+    }
+
+  Ipv4NixVectorHelper::PrecomputeTrees (nodes);
+
+  Ptr<Ipv4> ipv4 = nodes.Get (0)->GetObject<Ipv4> ();
+  Ipv4Header header;
+  header.SetDestination (n3Address);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, sockerr);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route before the failure");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), nodes.Get (0)->GetDevice (1), "Wrong output device");
+
+  // the first link toward n1 goes down at n0
+  ipv4->SetDown (ipv4->GetInterfaceForDevice (nodes.Get (0)->GetDevice (1)));
+  route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, sockerr);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route after the failure");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), nodes.Get (0)->GetDevice (2), "Route through the failed link");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Nix-vector cache TestSuite
+ */
+class NixVectorCacheTestSuite : public TestSuite
+{
+public:
+  NixVectorCacheTestSuite ();
+};
+
+NixVectorCacheTestSuite::NixVectorCacheTestSuite ()
+  : TestSuite ("nix-vector-cache", UNIT)
+{
+  AddTestCase (new NixVectorCacheTestCase (), TestCase::QUICK);
+  AddTestCase (new NixVectorLinkDownTestCase (), TestCase::QUICK);
+}
+
+static NixVectorCacheTestSuite g_nixVectorCacheTestSuite; //!< Static variable for test initialization
@@ -26,6 +26,7 @@
 #include "ns3/point-to-point-remote-channel.h"
 #include "ns3/queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
 #include "ns3/config.h"
 #include "ns3/packet.h"
 #include "ns3/names.h"
@@ -40,6 +41,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("PointToPointHelper");
 
 PointToPointHelper::PointToPointHelper ()
+  : m_nTxQueues (1)
 {
   m_queueFactory.SetTypeId ("ns3::DropTailQueue<Packet>");
   m_deviceFactory.SetTypeId ("ns3::PointToPointNetDevice");
@@ -76,6 +78,40 @@ PointToPointHelper::SetChannelAttribute (std::string n1, const AttributeValue &v
   m_remoteChannelFactory.Set (n1, v1);
 }
 
+void
+PointToPointHelper::SetNTxQueues (std::size_t nTxQueues)
+{
+  NS_ASSERT_MSG (nTxQueues > 0, "A device needs a transmission queue");
+  m_nTxQueues = nTxQueues;
+}
+
+void
+PointToPointHelper::InstallQueues (Ptr<PointToPointNetDevice> device) const
+{
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObjectWithAttributes<NetDeviceQueueInterface> ("NTxQueues",
+                                                                                           UintegerValue (m_nTxQueues));
+  for (std::size_t i = 0; i < m_nTxQueues; i++)
+    {
+      Ptr<Queue<Packet> > queue = m_queueFactory.Create<Queue<Packet> > ();
+      if (i == 0)
+        {
+          device->SetQueue (queue);
+        }
+      else
+        {
+          device->AddQueue (queue);
+        }
+      ndqi->GetTxQueue (i)->ConnectQueueTraces (queue);
+    }
+  if (m_nTxQueues > 1)
+    {
+      // the ndqi is aggregated to the device, hence it does not outlive it
+      PointToPointNetDevice *dev = PeekPointer (device);
+      ndqi->SetSelectQueueCallback ([dev] (Ptr<QueueItem> item) { return dev->SelectQueue (item); });
+    }
+  device->AggregateObject (ndqi);
+}
+
 void 
 PointToPointHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -104,7 +140,7 @@ PointToPointHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, b
     }
 
   Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, 
-                                                     PcapHelper::DLT_PPP);
+                                                     PcapHelper::DLT_PPP, device);
   pcapHelper.HookDefaultSink<PointToPointNetDevice> (device, "PromiscSniffer", file);
 }
 
@@ -232,20 +268,12 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
   Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice> ();
   devA->SetAddress (Mac48Address::Allocate ());
   a->AddDevice (devA);
-  Ptr<Queue<Packet> > queueA = m_queueFactory.Create<Queue<Packet> > ();
-  devA->SetQueue (queueA);
   Ptr<PointToPointNetDevice> devB = m_deviceFactory.Create<PointToPointNetDevice> ();
   devB->SetAddress (Mac48Address::Allocate ());
   b->AddDevice (devB);
-  Ptr<Queue<Packet> > queueB = m_queueFactory.Create<Queue<Packet> > ();
-  devB->SetQueue (queueB);
-  // Aggregate NetDeviceQueueInterface objects
-  Ptr<NetDeviceQueueInterface> ndqiA = CreateObject<NetDeviceQueueInterface> ();
-  ndqiA->GetTxQueue (0)->ConnectQueueTraces (queueA);
-  devA->AggregateObject (ndqiA);
-  Ptr<NetDeviceQueueInterface> ndqiB = CreateObject<NetDeviceQueueInterface> ();
-  ndqiB->GetTxQueue (0)->ConnectQueueTraces (queueB);
-  devB->AggregateObject (ndqiB);
+  // Create the queues and aggregate NetDeviceQueueInterface objects
+  InstallQueues (devA);
+  InstallQueues (devB);
 
   // If MPI is enabled, we need to see if both nodes have the same system id 
   // (rank), and the rank is the same as this instance.  If both are true, 
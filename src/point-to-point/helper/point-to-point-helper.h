@@ -32,6 +32,7 @@ namespace ns3 {
 
 class NetDevice;
 class Node;
+class PointToPointNetDevice;
 
 /**
  * \brief Build a set of PointToPointNetDevice objects
@@ -99,6 +100,21 @@ public:
    */
   void SetChannelAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * Set the number of transmission queues of each NetDevice created by the
+   * helper.
+   *
+   * \param nTxQueues the number of transmission queues
+   *
+   * Each ns3::PointToPointNetDevice created by PointToPointHelper::Install
+   * gets this number of queues, of the type set by SetQueue, and spreads
+   * the flows over them by hashing (see PointToPointNetDevice::AddQueue).
+   * The NetDeviceQueueInterface aggregated to the device has as many
+   * transmission queues, so that the traffic control layer installs a
+   * multi-queue root queue disc with a child queue disc per queue.
+   */
+  void SetNTxQueues (std::size_t nTxQueues);
+
   /**
    * \param c a set of nodes
    * \return a NetDeviceContainer for nodes
@@ -151,6 +167,14 @@ public:
   NetDeviceContainer Install (std::string aNode, std::string bNode);
 
 private:
+  /**
+   * \brief Create the transmission queues of a device and aggregate a
+   * NetDeviceQueueInterface object to it.
+   *
+   * \param device the device
+   */
+  void InstallQueues (Ptr<PointToPointNetDevice> device) const;
+
   /**
    * \brief Enable pcap output the indicated net device.
    *
@@ -185,6 +209,7 @@ private:
   ObjectFactory m_channelFactory;       //!< Channel Factory
   ObjectFactory m_remoteChannelFactory; //!< Remote Channel Factory
   ObjectFactory m_deviceFactory;        //!< Device Factory
+  std::size_t m_nTxQueues;              //!< Number of transmission queues of the devices
 };
 
 } // namespace ns3
@@ -25,6 +25,10 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/segmentation-offload.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/queue-item.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -62,6 +66,15 @@ PointToPointNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&PointToPointNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("SegmentationOffload",
+                   "If true, super-segments larger than the MTU handed down by "
+                   "transport protocols are split right before transmission. "
+                   "The MacTx and MacTxDrop traces and the queue see the "
+                   "super-segments, while the sniffer and PHY traces see the "
+                   "segments.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointNetDevice::m_segmentationOffload),
+                   MakeBooleanChecker ())
     .AddAttribute ("InterframeGap", 
                    "The time to wait between packet (frame) transmissions",
                    TimeValue (Seconds (0.0)),
@@ -77,6 +90,22 @@ PointToPointNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&PointToPointNetDevice::m_queue),
                    MakePointerChecker<Queue<Packet> > ())
+    .AddAttribute ("FlowHashPerturbation",
+                   "The salt of the flow hash selecting the transmission queue "
+                   "of a packet, when the device has several transmission queues. "
+                   "It should differ from the perturbation of the queue discs "
+                   "hashing the flows, so that the flows of a transmission queue "
+                   "are spread over all their buckets.",
+                   UintegerValue (0x9e3779b9),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_flowHashPerturbation),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("TxBatchSize",
+                   "The maximum number of packets pulled at once from the transmission "
+                   "queue when the device has a single one. The packets of a batch "
+                   "leave the queue (and free room in it) before being transmitted.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_txBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
 
     //
     // Trace sources at the "top" of the net device, where packets transition
@@ -176,8 +205,11 @@ PointToPointNetDevice::PointToPointNetDevice ()
   :
     m_txMachineState (READY),
     m_channel (0),
+    m_nextQueue (0),
+    m_txBatchNext (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_segmentationOffload (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -214,7 +246,12 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_pendingSegments.clear ();
+  m_segmenter = 0;
   m_queue = 0;
+  m_queues.clear ();
+  m_txBatch.clear ();
+  m_txBatchNext = 0;
   NetDevice::DoDispose ();
 }
 
@@ -281,7 +318,7 @@ PointToPointNetDevice::TransmitComplete (void)
   m_phyTxEndTrace (m_currentPkt);
   m_currentPkt = 0;
 
-  Ptr<Packet> p = m_queue->Dequeue ();
+  Ptr<Packet> p = DequeueTxPacket ();
   if (p == 0)
     {
       NS_LOG_LOGIC ("No pending packets in device queue after tx complete");
@@ -296,6 +333,91 @@ PointToPointNetDevice::TransmitComplete (void)
   TransmitStart (p);
 }
 
+Ptr<Packet>
+PointToPointNetDevice::DequeueTxPacket (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_pendingSegments.empty ())
+    {
+      Ptr<Packet> segment = m_pendingSegments.front ();
+      m_pendingSegments.pop_front ();
+      return segment;
+    }
+
+  Ptr<Packet> p = DequeueFromQueues ();
+  if (p == 0 || !m_segmentationOffload)
+    {
+      return p;
+    }
+
+  if (m_segmenter == 0)
+    {
+      m_segmenter = m_node->GetObject<SegmentationOffload> ();
+      if (m_segmenter == 0)
+        {
+          return p;
+        }
+    }
+
+  PppHeader ppp;
+  Ptr<Packet> superSegment = p->Copy ();
+  superSegment->RemoveHeader (ppp);
+  if (!m_segmenter->Segment (superSegment, m_pendingSegments))
+    {
+      return p;
+    }
+  NS_LOG_LOGIC ("Split super-segment of size " << superSegment->GetSize () <<
+                " in " << m_pendingSegments.size () << " segments");
+
+  for (std::list<Ptr<Packet> >::iterator it = m_pendingSegments.begin (); it != m_pendingSegments.end (); it++)
+    {
+      (*it)->AddHeader (ppp);
+    }
+  p = m_pendingSegments.front ();
+  m_pendingSegments.pop_front ();
+  return p;
+}
+
+Ptr<Packet>
+PointToPointNetDevice::DequeueFromQueues (void)
+{
+  if (m_queues.empty ())
+    {
+      if (m_txBatchSize <= 1)
+        {
+          return m_queue->Dequeue ();
+        }
+      if (m_txBatchNext == m_txBatch.size ())
+        {
+          // the previous batch is over, pull a new one
+          m_txBatch.clear ();
+          m_txBatchNext = 0;
+          if (m_queue->DequeueBatch (m_txBatch, m_txBatchSize) == 0)
+            {
+              return 0;
+            }
+          NS_LOG_LOGIC ("Dequeued a batch of " << m_txBatch.size () << " packets");
+        }
+      Ptr<Packet> p = m_txBatch[m_txBatchNext];
+      m_txBatch[m_txBatchNext++] = 0;
+      return p;
+    }
+
+  std::size_t nQueues = m_queues.size () + 1;
+  for (std::size_t k = 0; k < nQueues; k++)
+    {
+      std::size_t i = (m_nextQueue + k) % nQueues;
+      Ptr<Queue<Packet> > queue = (i == 0 ? m_queue : m_queues[i - 1]);
+      if (!queue->IsEmpty ())
+        {
+          m_nextQueue = (i + 1) % nQueues;
+          return queue->Dequeue ();
+        }
+    }
+  return 0;
+}
+
 bool
 PointToPointNetDevice::Attach (Ptr<PointToPointChannel> ch)
 {
@@ -385,6 +507,40 @@ PointToPointNetDevice::GetQueue (void) const
   return m_queue;
 }
 
+std::size_t
+PointToPointNetDevice::AddQueue (Ptr<Queue<Packet> > q)
+{
+  NS_LOG_FUNCTION (this << q);
+  NS_ASSERT_MSG (m_queue != 0, "The first transmission queue is set by SetQueue");
+  m_queues.push_back (q);
+  return m_queues.size ();
+}
+
+std::size_t
+PointToPointNetDevice::GetNQueues (void) const
+{
+  return m_queues.size () + 1;
+}
+
+Ptr<Queue<Packet> >
+PointToPointNetDevice::GetQueue (std::size_t i) const
+{
+  NS_ASSERT_MSG (i <= m_queues.size (), "Invalid transmission queue " << i);
+  return (i == 0 ? m_queue : m_queues[i - 1]);
+}
+
+std::size_t
+PointToPointNetDevice::SelectQueue (Ptr<QueueItem> item) const
+{
+  Ptr<QueueDiscItem> qdItem = DynamicCast<QueueDiscItem> (item);
+  if (m_queues.empty () || qdItem == 0)
+    {
+      return 0;
+    }
+  // same as the selection of the queue of the packet in Send
+  return qdItem->Hash (m_flowHashPerturbation) % (m_queues.size () + 1);
+}
+
 void
 PointToPointNetDevice::NotifyLinkUp (void)
 {
@@ -523,6 +679,18 @@ PointToPointNetDevice::Send (
       return false;
     }
 
+  //
+  // With several transmission queues, select the queue of the packet by
+  // hashing its flow, before the network header is hidden.
+  //
+  Ptr<Queue<Packet> > queue = m_queue;
+  if (!m_queues.empty ())
+    {
+      uint32_t hash = NetDeviceQueueInterface::GetFlowHash (packet, protocolNumber, m_flowHashPerturbation);
+      std::size_t i = hash % (m_queues.size () + 1);
+      queue = (i == 0 ? m_queue : m_queues[i - 1]);
+    }
+
   //
   // Stick a point to point protocol header on the packet in preparation for
   // shoving it out the door.
@@ -534,14 +702,14 @@ PointToPointNetDevice::Send (
   //
   // We should enqueue and dequeue the packet to hit the tracing hooks.
   //
-  if (m_queue->Enqueue (packet))
+  if (queue->Enqueue (packet))
     {
       //
       // If the channel is ready for transition we send the packet right now
       // 
       if (m_txMachineState == READY)
         {
-          packet = m_queue->Dequeue ();
+          packet = DequeueTxPacket ();
           m_snifferTrace (packet);
           m_promiscSnifferTrace (packet);
           bool ret = TransmitStart (packet);
@@ -605,6 +773,13 @@ PointToPointNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentationOffload (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_segmentationOffload;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
@@ -20,6 +20,8 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <list>
+#include <vector>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -34,8 +36,10 @@
 namespace ns3 {
 
 template <typename Item> class Queue;
+class QueueItem;
 class PointToPointChannel;
 class ErrorModel;
+class SegmentationOffload;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -127,6 +131,43 @@ public:
    */
   Ptr<Queue<Packet> > GetQueue (void) const;
 
+  /**
+   * Add a transmission queue to the PointToPointNetDevice.
+   *
+   * The queue set by SetQueue is the first transmission queue. With several
+   * transmission queues, the device selects the queue of each packet by
+   * hashing its flow (see NetDeviceQueueInterface::GetFlowHash), as the
+   * receive side scaling of multi-queue network cards, and the packets of
+   * the queues are transmitted in round robin.
+   *
+   * \param queue Ptr to the new queue.
+   * \returns the index of the queue.
+   */
+  std::size_t AddQueue (Ptr<Queue<Packet> > queue);
+
+  /**
+   * \returns the number of transmission queues.
+   */
+  std::size_t GetNQueues (void) const;
+
+  /**
+   * \param i the index of a transmission queue.
+   * \returns Ptr to the queue.
+   */
+  Ptr<Queue<Packet> > GetQueue (std::size_t i) const;
+
+  /**
+   * Select the transmission queue of a queue disc item.
+   *
+   * This method returns the queue in which the device enqueues the packet
+   * built from the item, and is meant to be the select queue callback of the
+   * NetDeviceQueueInterface aggregated to the device.
+   *
+   * \param item the item.
+   * \returns the index of the transmission queue.
+   */
+  std::size_t SelectQueue (Ptr<QueueItem> item) const;
+
   /**
    * Attach a receive ErrorModel to the PointToPointNetDevice.
    *
@@ -189,6 +230,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentationOffload (void) const;
 
 protected:
   /**
@@ -275,6 +317,30 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * Get the next packet to transmit.
+   *
+   * Pending segments of a super-segment are returned first. Otherwise, a
+   * packet is dequeued from the transmit queue and, if it is a super-segment
+   * and segmentation offload is enabled, it is split by the SegmentationOffload
+   * object aggregated to the node and its first segment is returned.
+   *
+   * \returns the packet to transmit, or 0 if there is nothing to transmit
+   */
+  Ptr<Packet> DequeueTxPacket (void);
+
+  /**
+   * Dequeue a packet from the transmission queues, in round robin.
+   *
+   * With a single transmission queue and a TxBatchSize larger than 1, the
+   * packets are pulled from the queue in batches of up to TxBatchSize
+   * packets (see Queue::DequeueBatch), when the previous batch has been
+   * transmitted, and then returned one at a time.
+   *
+   * \returns the packet dequeued, or 0 if all the queues are empty
+   */
+  Ptr<Packet> DequeueFromQueues (void);
+
   /**
    * \brief Make the link up and running
    *
@@ -321,6 +387,13 @@ private:
    */
   Ptr<Queue<Packet> > m_queue;
 
+  std::vector<Ptr<Queue<Packet> > > m_queues; //!< Additional transmission queues
+  std::size_t m_nextQueue;        //!< Next transmission queue served
+  uint32_t m_flowHashPerturbation; //!< Salt of the flow hash selecting the transmission queue
+  uint32_t m_txBatchSize;         //!< Maximum number of packets dequeued at once
+  std::vector<Ptr<Packet> > m_txBatch; //!< Packets of the current batch
+  std::size_t m_txBatchNext;      //!< Index of the next packet of the batch to send
+
   /**
    * Error model for receive packet events
    */
@@ -329,6 +402,7 @@ private:
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
+   * With segmentation offload, it is fired once per super-segment.
    */
   TracedCallback<Ptr<const Packet> > m_macTxTrace;
 
@@ -457,6 +531,10 @@ private:
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+  bool m_segmentationOffload; //!< Split super-segments before transmission
+  Ptr<SegmentationOffload> m_segmenter; //!< Object splitting super-segments
+  std::list<Ptr<Packet> > m_pendingSegments; //!< Segments of the current super-segment yet to be sent
+
   /**
    * \brief PPP to Ethernet protocol number mapping
    * \param protocol A PPP protocol number
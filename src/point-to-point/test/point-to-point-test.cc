@@ -24,6 +24,9 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -94,6 +97,238 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the PointToPoint devices with several transmission
+ * queues
+ *
+ * It sends the packets of several UDP flows from one NetDevice with four
+ * transmission queues to another, and checks that the flows are spread over
+ * the queues, each flow in a single queue, and that all the packets are
+ * received.
+ */
+class PointToPointMultiQueueTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultiQueueTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a raw IPv4 UDP packet of a flow to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param flow the flow of the packet, which sets its source port
+   */
+  void SendFlowPacket (Ptr<NetDevice> device, uint16_t flow);
+
+  /**
+   * \brief Receive a packet
+   *
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  uint32_t m_received; //!< Number of packets received
+};
+
+PointToPointMultiQueueTest::PointToPointMultiQueueTest ()
+  : TestCase ("PointToPoint with several transmission queues"),
+    m_received (0)
+{
+}
+
+void
+PointToPointMultiQueueTest::SendFlowPacket (Ptr<NetDevice> device, uint16_t flow)
+{
+  // IPv4 header from 10.0.0.1 to 10.0.0.2, then the UDP ports
+  uint8_t buffer[28] = { 0x45, 0, 0, 28, 0, 0, 0, 0, 64, 17, 0, 0,
+                         10, 0, 0, 1, 10, 0, 0, 2 };
+  uint16_t port = 49152 + flow;
+  buffer[20] = port >> 8;
+  buffer[21] = port & 0xff;
+  buffer[23] = 9;
+  Ptr<Packet> p = Create<Packet> (buffer, sizeof (buffer));
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointMultiQueueTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_received++;
+  return true;
+}
+
+void
+PointToPointMultiQueueTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetNTxQueues (4);
+  NetDeviceContainer devices = p2p.Install (nodes);
+  Ptr<PointToPointNetDevice> devA = DynamicCast<PointToPointNetDevice> (devices.Get (0));
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&PointToPointMultiQueueTest::Receive, this));
+
+  NS_TEST_ASSERT_MSG_EQ (devA->GetNQueues (), 4, "Wrong number of transmission queues");
+  Ptr<NetDeviceQueueInterface> ndqi = devA->GetObject<NetDeviceQueueInterface> ();
+  NS_TEST_ASSERT_MSG_NE (ndqi, 0, "No NetDeviceQueueInterface aggregated");
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetNTxQueues (), 4, "Wrong number of device transmission queues");
+  NS_TEST_EXPECT_MSG_EQ (bool (ndqi->GetSelectQueueCallback ()), true, "No select queue callback");
+
+  // 32 flows of 4 packets each, sent in a burst
+  for (uint16_t i = 0; i < 128; i++)
+    {
+      Simulator::Schedule (Seconds (1.0), &PointToPointMultiQueueTest::SendFlowPacket, this, devA, i % 32);
+    }
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 128, "Packets not received");
+  uint32_t total = 0;
+  for (std::size_t i = 0; i < devA->GetNQueues (); i++)
+    {
+      uint32_t n = devA->GetQueue (i)->GetTotalReceivedPackets ();
+      NS_TEST_EXPECT_MSG_GT (n, 0, "No flow in transmission queue " << i);
+      // each flow is in a single queue
+      NS_TEST_EXPECT_MSG_EQ (n % 4, 0, "Flow spread over several queues");
+      total += n;
+    }
+  NS_TEST_EXPECT_MSG_EQ (total, 128, "Wrong number of packets enqueued");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the PointToPoint devices pulling their packets from
+ * the transmission queue in batches
+ *
+ * It sends a burst of packets of increasing sizes from one NetDevice with a
+ * TxBatchSize of 4 to another, and checks that the packets leave the queue in
+ * batches and are all received in order.
+ */
+class PointToPointBatchTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBatchTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a packet of the size specified to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param size the size of the packet
+   */
+  void SendPacket (Ptr<NetDevice> device, uint32_t size);
+
+  /**
+   * \brief Record a packet dequeued from the transmission queue
+   *
+   * \param packet the packet
+   */
+  void Dequeue (Ptr<const Packet> packet);
+
+  /**
+   * \brief Receive a packet
+   *
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<Time> m_dequeueTimes;  //!< Times the packets were dequeued
+  std::vector<uint32_t> m_received;  //!< Sizes of the packets received
+};
+
+PointToPointBatchTest::PointToPointBatchTest ()
+  : TestCase ("PointToPoint with batched dequeues")
+{
+}
+
+void
+PointToPointBatchTest::SendPacket (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointBatchTest::Dequeue (Ptr<const Packet> packet)
+{
+  m_dequeueTimes.push_back (Simulator::Now ());
+}
+
+bool
+PointToPointBatchTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_received.push_back (packet->GetSize ());
+  return true;
+}
+
+void
+PointToPointBatchTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("TxBatchSize", UintegerValue (4));
+  NetDeviceContainer devices = p2p.Install (nodes);
+  Ptr<PointToPointNetDevice> devA = DynamicCast<PointToPointNetDevice> (devices.Get (0));
+  devA->GetQueue ()->TraceConnectWithoutContext ("Dequeue", MakeCallback (&PointToPointBatchTest::Dequeue, this));
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&PointToPointBatchTest::Receive, this));
+
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (Seconds (1.0), &PointToPointBatchTest::SendPacket, this, devA, 100 + i);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 10, "Packets not received");
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], 100 + i, "Packet " << i << " received out of order");
+    }
+
+  // the first packet is sent right away, when the link is idle; the other
+  // ones are pulled in batches of 4, 4 and 1 when the transmissions complete
+  NS_TEST_ASSERT_MSG_EQ (m_dequeueTimes.size (), 10, "Wrong number of packets dequeued");
+  uint32_t batchSizes[] = { 1, 4, 4, 1 };
+  std::size_t k = 0;
+  for (std::size_t b = 0; b < 4; b++)
+    {
+      Time start = m_dequeueTimes[k];
+      for (uint32_t j = 0; j < batchSizes[b]; j++, k++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_dequeueTimes[k], start, "Packet " << k << " not dequeued with its batch");
+        }
+      if (k < m_dequeueTimes.size ())
+        {
+          NS_TEST_EXPECT_MSG_GT (m_dequeueTimes[k], start, "Batch " << b << " larger than expected");
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -110,6 +345,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultiQueueTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBatchTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/ppp-header.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include <algorithm>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpSegmentationOffloadTest");
+
+// ===========================================================================
+// Tests of TCP segmentation offload over a point-to-point link
+// ===========================================================================
+//
+//
+class Ns3TcpSegmentationOffloadTestCase : public TestCase
+{
+public:
+  Ns3TcpSegmentationOffloadTestCase ();
+  virtual ~Ns3TcpSegmentationOffloadTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void MacTx (Ptr<const Packet> p);
+  void Sniffer (Ptr<const Packet> p);
+  void PhyTxBegin (Ptr<const Packet> p);
+  void MacRx (Ptr<const Packet> p);
+
+  uint32_t m_mtu;
+  Ipv4Address m_senderAddress;
+  uint32_t m_maxMacTxSize;
+  uint32_t m_maxSnifferSize;
+  uint32_t m_nSniffed;
+  uint32_t m_nPhyTxBegin;
+  uint32_t m_nMacRx;
+  bool m_firstId;
+  uint16_t m_lastId;
+  uint32_t m_idGaps;
+};
+
+Ns3TcpSegmentationOffloadTestCase::Ns3TcpSegmentationOffloadTestCase ()
+  : TestCase ("Check that a point-to-point device splits TCP super-segments in MTU-sized segments"),
+    m_mtu (1500),
+    m_maxMacTxSize (0),
+    m_maxSnifferSize (0),
+    m_nSniffed (0),
+    m_nPhyTxBegin (0),
+    m_nMacRx (0),
+    m_firstId (true),
+    m_lastId (0),
+    m_idGaps (0)
+{
+}
+
+void
+Ns3TcpSegmentationOffloadTestCase::MacTx (Ptr<const Packet> p)
+{
+  m_maxMacTxSize = std::max (m_maxMacTxSize, p->GetSize ());
+}
+
+void
+Ns3TcpSegmentationOffloadTestCase::Sniffer (Ptr<const Packet> p)
+{
+  Ptr<Packet> copy = p->Copy ();
+  PppHeader ppp;
+  copy->RemoveHeader (ppp);
+  Ipv4Header ipHeader;
+  copy->PeekHeader (ipHeader);
+  // the sniffer also sees the acknowledgments received by the sender
+  if (ipHeader.GetSource () != m_senderAddress)
+    {
+      return;
+    }
+
+  m_nSniffed++;
+  m_maxSnifferSize = std::max (m_maxSnifferSize, p->GetSize ());
+  uint16_t id = ipHeader.GetIdentification ();
+  if (!m_firstId && id != static_cast<uint16_t> (m_lastId + 1))
+    {
+      NS_LOG_DEBUG ("Identification " << id << " sent after " << m_lastId);
+      m_idGaps++;
+    }
+  m_firstId = false;
+  m_lastId = id;
+}
+
+void
+Ns3TcpSegmentationOffloadTestCase::PhyTxBegin (Ptr<const Packet> p)
+{
+  m_nPhyTxBegin++;
+}
+
+void
+Ns3TcpSegmentationOffloadTestCase::MacRx (Ptr<const Packet> p)
+{
+  m_nMacRx++;
+}
+
+void
+Ns3TcpSegmentationOffloadTestCase::DoRun (void)
+{
+  uint16_t sinkPort = 50000;
+  uint32_t maxBytes = 100000;
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentationOffload", BooleanValue (true));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  pointToPoint.SetDeviceAttribute ("Mtu", UintegerValue (m_mtu));
+  pointToPoint.SetDeviceAttribute ("SegmentationOffload", BooleanValue (true));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.252");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  m_senderAddress = interfaces.GetAddress (0);
+
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (interfaces.GetAddress (1), sinkPort));
+  source.SetAttribute ("MaxBytes", UintegerValue (maxBytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.1));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                         InetSocketAddress (Ipv4Address::GetAny (), sinkPort));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+
+  devices.Get (0)->TraceConnectWithoutContext ("MacTx",
+    MakeCallback (&Ns3TcpSegmentationOffloadTestCase::MacTx, this));
+  devices.Get (0)->TraceConnectWithoutContext ("Sniffer",
+    MakeCallback (&Ns3TcpSegmentationOffloadTestCase::Sniffer, this));
+  devices.Get (0)->TraceConnectWithoutContext ("PhyTxBegin",
+    MakeCallback (&Ns3TcpSegmentationOffloadTestCase::PhyTxBegin, this));
+  devices.Get (1)->TraceConnectWithoutContext ("MacRx",
+    MakeCallback (&Ns3TcpSegmentationOffloadTestCase::MacRx, this));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  Ptr<PacketSink> packetSink = DynamicCast<PacketSink> (sinkApps.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (packetSink->GetTotalRx (), maxBytes, "Not all the data has been received");
+
+  // MacTx sees the super-segments, as handed down by IPv4
+  NS_TEST_ASSERT_MSG_GT (m_maxMacTxSize, m_mtu + 2, "No super-segment has been sent to the device");
+
+  // The sniffer, the PHY and the receiver see the segments, as sent on the wire
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxSnifferSize, m_mtu + 2, "A packet larger than the MTU has been sniffed");
+  NS_TEST_ASSERT_MSG_EQ (m_nPhyTxBegin, m_nSniffed, "The PHY and the sniffer did not see the same packets");
+  NS_TEST_ASSERT_MSG_EQ (m_nMacRx, m_nSniffed, "The receiver did not get all the sniffed packets");
+  NS_TEST_ASSERT_MSG_EQ (m_idGaps, 0, "The sniffed IPv4 identifications are not consecutive");
+
+  Simulator::Destroy ();
+}
+
+class Ns3TcpSegmentationOffloadTestSuite : public TestSuite
+{
+public:
+  Ns3TcpSegmentationOffloadTestSuite ();
+};
+
+Ns3TcpSegmentationOffloadTestSuite::Ns3TcpSegmentationOffloadTestSuite ()
+  : TestSuite ("ns3-tcp-segmentation-offload", SYSTEM)
+{
+  AddTestCase (new Ns3TcpSegmentationOffloadTestCase, TestCase::QUICK);
+}
+
+static Ns3TcpSegmentationOffloadTestSuite ns3TcpSegmentationOffloadTestSuite;
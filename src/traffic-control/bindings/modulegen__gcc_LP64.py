@@ -75,6 +75,10 @@ def register_types(module):
     module.add_class('DefaultDeleter', import_from_module='ns.core', template_parameters=['ns3::TraceSourceAccessor'])
     ## event-id.h (module 'core'): ns3::EventId [class]
     module.add_class('EventId', import_from_module='ns.core')
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow [class]
+    module.add_class('FqCoDelFlow')
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FlowStatus [enumeration]
+    module.add_enum('FlowStatus', ['INACTIVE', 'NEW_FLOW', 'OLD_FLOW'], outer_class=root_module['ns3::FqCoDelFlow'])
     ## hash.h (module 'core'): ns3::Hasher [class]
     module.add_class('Hasher', import_from_module='ns.core')
     ## int-to-type.h (module 'core'): ns3::IntToType<0> [struct]
@@ -351,10 +355,6 @@ def register_types(module):
     module.add_class('ExponentialRandomVariable', import_from_module='ns.core', parent=root_module['ns3::RandomVariableStream'])
     ## fifo-queue-disc.h (module 'traffic-control'): ns3::FifoQueueDisc [class]
     module.add_class('FifoQueueDisc', parent=root_module['ns3::QueueDisc'])
-    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow [class]
-    module.add_class('FqCoDelFlow', parent=root_module['ns3::QueueDiscClass'])
-    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FlowStatus [enumeration]
-    module.add_enum('FlowStatus', ['INACTIVE', 'NEW_FLOW', 'OLD_FLOW'], outer_class=root_module['ns3::FqCoDelFlow'])
     ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc [class]
     module.add_class('FqCoDelQueueDisc', parent=root_module['ns3::QueueDisc'])
     ## random-variable-stream.h (module 'core'): ns3::GammaRandomVariable [class]
@@ -625,6 +625,7 @@ def register_methods(root_module):
     register_Ns3DefaultDeleter__Ns3QueueItem_methods(root_module, root_module['ns3::DefaultDeleter< ns3::QueueItem >'])
     register_Ns3DefaultDeleter__Ns3TraceSourceAccessor_methods(root_module, root_module['ns3::DefaultDeleter< ns3::TraceSourceAccessor >'])
     register_Ns3EventId_methods(root_module, root_module['ns3::EventId'])
+    register_Ns3FqCoDelFlow_methods(root_module, root_module['ns3::FqCoDelFlow'])
     register_Ns3Hasher_methods(root_module, root_module['ns3::Hasher'])
     register_Ns3IntToType__0_methods(root_module, root_module['ns3::IntToType< 0 >'])
     register_Ns3IntToType__1_methods(root_module, root_module['ns3::IntToType< 1 >'])
@@ -725,7 +726,6 @@ def register_methods(root_module):
     register_Ns3EventImpl_methods(root_module, root_module['ns3::EventImpl'])
     register_Ns3ExponentialRandomVariable_methods(root_module, root_module['ns3::ExponentialRandomVariable'])
     register_Ns3FifoQueueDisc_methods(root_module, root_module['ns3::FifoQueueDisc'])
-    register_Ns3FqCoDelFlow_methods(root_module, root_module['ns3::FqCoDelFlow'])
     register_Ns3FqCoDelQueueDisc_methods(root_module, root_module['ns3::FqCoDelQueueDisc'])
     register_Ns3GammaRandomVariable_methods(root_module, root_module['ns3::GammaRandomVariable'])
     register_Ns3IntegerValue_methods(root_module, root_module['ns3::IntegerValue'])
@@ -1461,6 +1461,45 @@ def register_Ns3EventId_methods(root_module, cls):
                    is_const=True)
     return
 
+def register_Ns3FqCoDelFlow_methods(root_module, cls):
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FqCoDelFlow(ns3::FqCoDelFlow const & arg0) [constructor]
+    cls.add_constructor([param('ns3::FqCoDelFlow const &', 'arg0')])
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FqCoDelFlow() [constructor]
+    cls.add_constructor([])
+    ## fq-codel-queue-disc.h (module 'traffic-control'): int32_t ns3::FqCoDelFlow::GetDeficit() const [member function]
+    cls.add_method('GetDeficit', 
+                   'int32_t', 
+                   [], 
+                   is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): uint32_t ns3::FqCoDelFlow::GetNBytes() const [member function]
+    cls.add_method('GetNBytes', 
+                   'uint32_t', 
+                   [], 
+                   is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): uint32_t ns3::FqCoDelFlow::GetNPackets() const [member function]
+    cls.add_method('GetNPackets', 
+                   'uint32_t', 
+                   [], 
+                   is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FlowStatus ns3::FqCoDelFlow::GetStatus() const [member function]
+    cls.add_method('GetStatus', 
+                   'ns3::FqCoDelFlow::FlowStatus', 
+                   [], 
+                   is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelFlow::IncreaseDeficit(int32_t deficit) [member function]
+    cls.add_method('IncreaseDeficit', 
+                   'void', 
+                   [param('int32_t', 'deficit')])
+    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelFlow::SetDeficit(uint32_t deficit) [member function]
+    cls.add_method('SetDeficit', 
+                   'void', 
+                   [param('uint32_t', 'deficit')])
+    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelFlow::SetStatus(ns3::FqCoDelFlow::FlowStatus status) [member function]
+    cls.add_method('SetStatus', 
+                   'void', 
+                   [param('ns3::FqCoDelFlow::FlowStatus', 'status')])
+    return
+
 def register_Ns3Hasher_methods(root_module, cls):
     ## hash.h (module 'core'): ns3::Hasher::Hasher(ns3::Hasher const & arg0) [constructor]
     cls.add_constructor([param('ns3::Hasher const &', 'arg0')])
@@ -5417,40 +5456,6 @@ def register_Ns3FifoQueueDisc_methods(root_module, cls):
                    is_virtual=True, visibility='private')
     return
 
-def register_Ns3FqCoDelFlow_methods(root_module, cls):
-    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FqCoDelFlow(ns3::FqCoDelFlow const & arg0) [constructor]
-    cls.add_constructor([param('ns3::FqCoDelFlow const &', 'arg0')])
-    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FqCoDelFlow() [constructor]
-    cls.add_constructor([])
-    ## fq-codel-queue-disc.h (module 'traffic-control'): int32_t ns3::FqCoDelFlow::GetDeficit() const [member function]
-    cls.add_method('GetDeficit', 
-                   'int32_t', 
-                   [], 
-                   is_const=True)
-    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow::FlowStatus ns3::FqCoDelFlow::GetStatus() const [member function]
-    cls.add_method('GetStatus', 
-                   'ns3::FqCoDelFlow::FlowStatus', 
-                   [], 
-                   is_const=True)
-    ## fq-codel-queue-disc.h (module 'traffic-control'): static ns3::TypeId ns3::FqCoDelFlow::GetTypeId() [member function]
-    cls.add_method('GetTypeId', 
-                   'ns3::TypeId', 
-                   [], 
-                   is_static=True)
-    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelFlow::IncreaseDeficit(int32_t deficit) [member function]
-    cls.add_method('IncreaseDeficit', 
-                   'void', 
-                   [param('int32_t', 'deficit')])
-    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelFlow::SetDeficit(uint32_t deficit) [member function]
-    cls.add_method('SetDeficit', 
-                   'void', 
-                   [param('uint32_t', 'deficit')])
-    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelFlow::SetStatus(ns3::FqCoDelFlow::FlowStatus status) [member function]
-    cls.add_method('SetStatus', 
-                   'void', 
-                   [param('ns3::FqCoDelFlow::FlowStatus', 'status')])
-    return
-
 def register_Ns3FqCoDelQueueDisc_methods(root_module, cls):
     ## fq-codel-queue-disc.h (module 'traffic-control'): static ns3::TypeId ns3::FqCoDelQueueDisc::GetTypeId() [member function]
     cls.add_method('GetTypeId', 
@@ -5468,10 +5473,28 @@ def register_Ns3FqCoDelQueueDisc_methods(root_module, cls):
                    'uint32_t', 
                    [], 
                    is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): std::size_t ns3::FqCoDelQueueDisc::GetNFlowQueues() const [member function]
+    cls.add_method('GetNFlowQueues', 
+                   'std::size_t', 
+                   [], 
+                   is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelFlow const & ns3::FqCoDelQueueDisc::GetFlowQueue(std::size_t i) const [member function]
+    cls.add_method('GetFlowQueue', 
+                   'ns3::FqCoDelFlow const &', 
+                   [param('std::size_t', 'i')], 
+                   is_const=True)
     ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc::UNCLASSIFIED_DROP [variable]
     cls.add_static_attribute('UNCLASSIFIED_DROP', 'char const * const', is_const=True)
     ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc::OVERLIMIT_DROP [variable]
     cls.add_static_attribute('OVERLIMIT_DROP', 'char const * const', is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc::TARGET_EXCEEDED_DROP [variable]
+    cls.add_static_attribute('TARGET_EXCEEDED_DROP', 'char const * const', is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc::UNCLASSIFIED_DROP_ID [variable]
+    cls.add_static_attribute('UNCLASSIFIED_DROP_ID', 'uint32_t const', is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc::OVERLIMIT_DROP_ID [variable]
+    cls.add_static_attribute('OVERLIMIT_DROP_ID', 'uint32_t const', is_const=True)
+    ## fq-codel-queue-disc.h (module 'traffic-control'): ns3::FqCoDelQueueDisc::TARGET_EXCEEDED_DROP_ID [variable]
+    cls.add_static_attribute('TARGET_EXCEEDED_DROP_ID', 'uint32_t const', is_const=True)
     ## fq-codel-queue-disc.h (module 'traffic-control'): bool ns3::FqCoDelQueueDisc::DoEnqueue(ns3::Ptr<ns3::QueueDiscItem> item) [member function]
     cls.add_method('DoEnqueue', 
                    'bool', 
@@ -5487,6 +5510,11 @@ def register_Ns3FqCoDelQueueDisc_methods(root_module, cls):
                    'bool', 
                    [], 
                    is_virtual=True, visibility='private')
+    ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelQueueDisc::DoDispose() [member function]
+    cls.add_method('DoDispose', 
+                   'void', 
+                   [], 
+                   is_virtual=True, visibility='protected')
     ## fq-codel-queue-disc.h (module 'traffic-control'): void ns3::FqCoDelQueueDisc::InitializeParams() [member function]
     cls.add_method('InitializeParams', 
                    'void', 
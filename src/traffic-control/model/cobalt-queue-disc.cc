@@ -42,6 +42,10 @@ NS_LOG_COMPONENT_DEFINE ("CobaltQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED (CobaltQueueDisc);
 
+const QueueDisc::ReasonId CobaltQueueDisc::TARGET_EXCEEDED_DROP_ID = QueueDisc::RegisterReason (TARGET_EXCEEDED_DROP);
+const QueueDisc::ReasonId CobaltQueueDisc::OVERLIMIT_DROP_ID = QueueDisc::RegisterReason (OVERLIMIT_DROP);
+const QueueDisc::ReasonId CobaltQueueDisc::FORCED_MARK_ID = QueueDisc::RegisterReason (FORCED_MARK);
+
 TypeId CobaltQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::CobaltQueueDisc")
@@ -335,7 +339,7 @@ CobaltQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       int64_t now = CoDelGetTime ();
       // Call this to update Blue's drop probability
       CobaltQueueFull (now);
-      DropBeforeEnqueue (item, OVERLIMIT_DROP);
+      DropBeforeEnqueue (item, OVERLIMIT_DROP_ID);
       return false;
     }
 
@@ -381,7 +385,7 @@ CobaltQueueDisc::DoDequeue (void)
 
       if (drop)
         {
-          DropAfterDequeue (item, TARGET_EXCEEDED_DROP);
+          DropAfterDequeue (item, TARGET_EXCEEDED_DROP_ID);
         }
       else
         {
@@ -463,7 +467,7 @@ bool CobaltQueueDisc::CobaltShouldDrop (Ptr<QueueDiscItem> item, int64_t now)
     {
       /* Check for marking possibility only if BLUE decides NOT to drop. */
       /* Check if router and packet, both have ECN enabled. Only if this is true, mark the packet. */
-      drop = !(m_useEcn && Mark (item, FORCED_MARK));
+      drop = !(m_useEcn && Mark (item, FORCED_MARK_ID));
 
       m_count = max (m_count, m_count + 1);
 
@@ -103,6 +103,10 @@ public:
   static constexpr const char* TARGET_EXCEEDED_DROP = "Target exceeded drop";  //!< Sojourn time above target
   static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";  //!< Overlimit dropped packet
   static constexpr const char* FORCED_MARK = "forcedMark";  //!< forced marks by Codel on ECN-enabled
+  // Ids of the reasons, registered once for the class
+  static const ReasonId TARGET_EXCEEDED_DROP_ID;  //!< Id of TARGET_EXCEEDED_DROP
+  static const ReasonId OVERLIMIT_DROP_ID;  //!< Id of OVERLIMIT_DROP
+  static const ReasonId FORCED_MARK_ID;  //!< Id of FORCED_MARK
 
   /**
    * \brief Get the drop probability of Blue
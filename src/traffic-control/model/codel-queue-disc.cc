@@ -67,6 +67,9 @@ static uint32_t CoDelGetTime (void)
 
 NS_OBJECT_ENSURE_REGISTERED (CoDelQueueDisc);
 
+const QueueDisc::ReasonId CoDelQueueDisc::TARGET_EXCEEDED_DROP_ID = QueueDisc::RegisterReason (TARGET_EXCEEDED_DROP);
+const QueueDisc::ReasonId CoDelQueueDisc::OVERLIMIT_DROP_ID = QueueDisc::RegisterReason (OVERLIMIT_DROP);
+
 TypeId CoDelQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::CoDelQueueDisc")
@@ -164,7 +167,7 @@ CoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   if (GetCurrentSize () + item > GetMaxSize ())
     {
       NS_LOG_LOGIC ("Queue full -- dropping pkt");
-      DropBeforeEnqueue (item, OVERLIMIT_DROP);
+      DropBeforeEnqueue (item, OVERLIMIT_DROP_ID);
       return false;
     }
 
@@ -265,7 +268,7 @@ CoDelQueueDisc::DoDequeue (void)
               // rates so high that the next drop should happen now,
               // hence the while loop.
               NS_LOG_LOGIC ("Sojourn time is still above target and it's time for next drop; dropping " << item);
-              DropAfterDequeue (item, TARGET_EXCEEDED_DROP);
+              DropAfterDequeue (item, TARGET_EXCEEDED_DROP_ID);
 
               ++m_count;
               NewtonStep ();
@@ -303,7 +306,7 @@ CoDelQueueDisc::DoDequeue (void)
         {
           // Drop the first packet and enter dropping state unless the queue is empty
           NS_LOG_LOGIC ("Sojourn time goes above target, dropping the first packet " << item << " and entering the dropping state");
-          DropAfterDequeue (item, TARGET_EXCEEDED_DROP);
+          DropAfterDequeue (item, TARGET_EXCEEDED_DROP_ID);
 
           item = GetInternalQueue (0)->Dequeue ();
 
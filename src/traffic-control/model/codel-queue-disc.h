@@ -101,6 +101,9 @@ public:
   // Reasons for dropping packets
   static constexpr const char* TARGET_EXCEEDED_DROP = "Target exceeded drop";  //!< Sojourn time above target
   static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";  //!< Overlimit dropped packet
+  // Ids of the reasons, registered once for the class
+  static const ReasonId TARGET_EXCEEDED_DROP_ID;  //!< Id of TARGET_EXCEEDED_DROP
+  static const ReasonId OVERLIMIT_DROP_ID;  //!< Id of OVERLIMIT_DROP
 
 private:
   friend class::CoDelQueueDiscNewtonStepTest;  // Test code
@@ -29,6 +29,8 @@ NS_LOG_COMPONENT_DEFINE ("FifoQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED (FifoQueueDisc);
 
+const QueueDisc::ReasonId FifoQueueDisc::LIMIT_EXCEEDED_DROP_ID = QueueDisc::RegisterReason (LIMIT_EXCEEDED_DROP);
+
 TypeId FifoQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::FifoQueueDisc")
@@ -64,7 +66,7 @@ FifoQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   if (GetCurrentSize () + item > GetMaxSize ())
     {
       NS_LOG_LOGIC ("Queue full -- dropping pkt");
-      DropBeforeEnqueue (item, LIMIT_EXCEEDED_DROP);
+      DropBeforeEnqueue (item, LIMIT_EXCEEDED_DROP_ID);
       return false;
     }
 
@@ -49,6 +49,8 @@ public:
 
   // Reasons for dropping packets
   static constexpr const char* LIMIT_EXCEEDED_DROP = "Queue disc limit exceeded";  //!< Packet dropped due to queue disc limit exceeded
+  // Ids of the reasons, registered once for the class
+  static const ReasonId LIMIT_EXCEEDED_DROP_ID;  //!< Id of LIMIT_EXCEEDED_DROP
 
 private:
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
@@ -21,6 +21,8 @@
 
 #include "ns3/log.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
 #include "ns3/queue.h"
 #include "fq-codel-queue-disc.h"
 #include "codel-queue-disc.h"
@@ -30,68 +32,166 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FqCoDelQueueDisc");
 
-NS_OBJECT_ENSURE_REGISTERED (FqCoDelFlow);
+/// Index of no flow queue or packet slot
+static const uint32_t FQ_CODEL_NONE = ~0U;
+
+/**
+ * Performs a reciprocal divide, similar to the
+ * Linux kernel reciprocal_divide function
+ * \param A numerator
+ * \param R reciprocal of the denominator B
+ * \return the value of A/B
+ */
+static inline uint32_t
+ReciprocalDivide (uint32_t A, uint32_t R)
+{
+  return (uint32_t)(((uint64_t)A * R) >> 32);
+}
 
-TypeId FqCoDelFlow::GetTypeId (void)
+/**
+ * Return the CoDel time representation of a Time
+ * \param t the time
+ * \return the time in CoDel time
+ */
+static inline uint32_t
+Time2CoDel (Time t)
 {
-  static TypeId tid = TypeId ("ns3::FqCoDelFlow")
-    .SetParent<QueueDiscClass> ()
-    .SetGroupName ("TrafficControl")
-    .AddConstructor<FqCoDelFlow> ()
-  ;
-  return tid;
+  return static_cast<uint32_t> (t.GetNanoSeconds () >> CODEL_SHIFT);
 }
 
-FqCoDelFlow::FqCoDelFlow ()
-  : m_deficit (0),
-    m_status (INACTIVE)
+/**
+ * Check if CoDel time a is successive to b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is greater than b
+ */
+static inline bool
+CoDelTimeAfter (uint32_t a, uint32_t b)
 {
-  NS_LOG_FUNCTION (this);
+  return ((int)(a) - (int)(b) > 0);
 }
 
-FqCoDelFlow::~FqCoDelFlow ()
+/**
+ * Check if CoDel time a is successive or equal to b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is greater than or equal to b
+ */
+static inline bool
+CoDelTimeAfterEq (uint32_t a, uint32_t b)
+{
+  return ((int)(a) - (int)(b) >= 0);
+}
+
+/**
+ * Check if CoDel time a is preceding b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is less than to b
+ */
+static inline bool
+CoDelTimeBefore (uint32_t a, uint32_t b)
+{
+  return ((int)(a) - (int)(b) < 0);
+}
+
+/**
+ * Update the reciprocal square root of the count of a flow queue, by
+ * Newton's method (see CoDelQueueDisc::NewtonStep)
+ * \param count the count
+ * \param recInvSqrt the reciprocal square root (updated)
+ */
+static inline void
+NewtonStep (uint32_t count, uint16_t &recInvSqrt)
+{
+  uint32_t invsqrt = ((uint32_t) recInvSqrt) << REC_INV_SQRT_SHIFT;
+  uint32_t invsqrt2 = ((uint64_t) invsqrt * invsqrt) >> 32;
+  uint64_t val = (3ll << 32) - ((uint64_t) count * invsqrt2);
+
+  val >>= 2; /* avoid overflow */
+  val = (val * invsqrt) >> (32 - 2 + 1);
+  recInvSqrt = static_cast<uint16_t> (val >> REC_INV_SQRT_SHIFT);
+}
+
+/**
+ * Determine the time for next drop (see CoDelQueueDisc::ControlLaw)
+ * \param t current next drop time
+ * \param interval the interval, in CoDel time
+ * \param recInvSqrt the reciprocal square root of the count
+ * \return the new next drop time
+ */
+static inline uint32_t
+ControlLaw (uint32_t t, uint32_t interval, uint16_t recInvSqrt)
+{
+  return t + ReciprocalDivide (interval, recInvSqrt << REC_INV_SQRT_SHIFT);
+}
+
+FqCoDelFlow::FqCoDelFlow ()
+  : m_deficit (0),
+    m_status (INACTIVE),
+    m_next (FQ_CODEL_NONE),
+    m_head (FQ_CODEL_NONE),
+    m_tail (FQ_CODEL_NONE),
+    m_nPackets (0),
+    m_nBytes (0),
+    m_count (0),
+    m_lastCount (0),
+    m_dropping (false),
+    m_recInvSqrt (~0U >> REC_INV_SQRT_SHIFT),
+    m_firstAboveTime (0),
+    m_dropNext (0)
 {
-  NS_LOG_FUNCTION (this);
 }
 
 void
 FqCoDelFlow::SetDeficit (uint32_t deficit)
 {
-  NS_LOG_FUNCTION (this << deficit);
   m_deficit = deficit;
 }
 
 int32_t
 FqCoDelFlow::GetDeficit (void) const
 {
-  NS_LOG_FUNCTION (this);
   return m_deficit;
 }
 
 void
 FqCoDelFlow::IncreaseDeficit (int32_t deficit)
 {
-  NS_LOG_FUNCTION (this << deficit);
   m_deficit += deficit;
 }
 
 void
 FqCoDelFlow::SetStatus (FlowStatus status)
 {
-  NS_LOG_FUNCTION (this);
   m_status = status;
 }
 
 FqCoDelFlow::FlowStatus
 FqCoDelFlow::GetStatus (void) const
 {
-  NS_LOG_FUNCTION (this);
   return m_status;
 }
 
+uint32_t
+FqCoDelFlow::GetNPackets (void) const
+{
+  return m_nPackets;
+}
+
+uint32_t
+FqCoDelFlow::GetNBytes (void) const
+{
+  return m_nBytes;
+}
+
 
 NS_OBJECT_ENSURE_REGISTERED (FqCoDelQueueDisc);
 
+const QueueDisc::ReasonId FqCoDelQueueDisc::UNCLASSIFIED_DROP_ID = QueueDisc::RegisterReason (UNCLASSIFIED_DROP);
+const QueueDisc::ReasonId FqCoDelQueueDisc::OVERLIMIT_DROP_ID = QueueDisc::RegisterReason (OVERLIMIT_DROP);
+const QueueDisc::ReasonId FqCoDelQueueDisc::TARGET_EXCEEDED_DROP_ID = QueueDisc::RegisterReason (TARGET_EXCEEDED_DROP);
+
 TypeId FqCoDelQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::FqCoDelQueueDisc")
@@ -108,6 +208,11 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
                    StringValue ("5ms"),
                    MakeStringAccessor (&FqCoDelQueueDisc::m_target),
                    MakeStringChecker ())
+    .AddAttribute ("MinBytes",
+                   "The CoDel algorithm minbytes parameter for each FQCoDel queue",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_minBytes),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("MaxSize",
                    "The maximum number of packets accepted by this queue disc",
                    QueueSizeValue (QueueSize ("10240p")),
@@ -135,9 +240,14 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
 
 FqCoDelQueueDisc::FqCoDelQueueDisc ()
   : QueueDisc (QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
-    m_quantum (0)
+    m_quantum (0),
+    m_codelInterval (0),
+    m_codelTarget (0),
+    m_freePacket (FQ_CODEL_NONE)
 {
   NS_LOG_FUNCTION (this);
+  m_newFlows.head = m_newFlows.tail = FQ_CODEL_NONE;
+  m_oldFlows.head = m_oldFlows.tail = FQ_CODEL_NONE;
 }
 
 FqCoDelQueueDisc::~FqCoDelQueueDisc ()
@@ -145,6 +255,19 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_packets.clear ();
+  m_flowQueues.clear ();
+  m_flowsIndices.clear ();
+  m_freePacket = FQ_CODEL_NONE;
+  m_newFlows.head = m_newFlows.tail = FQ_CODEL_NONE;
+  m_oldFlows.head = m_oldFlows.tail = FQ_CODEL_NONE;
+  QueueDisc::DoDispose ();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum (uint32_t quantum)
 {
@@ -158,6 +281,97 @@ FqCoDelQueueDisc::GetQuantum (void) const
   return m_quantum;
 }
 
+std::size_t
+FqCoDelQueueDisc::GetNFlowQueues (void) const
+{
+  return m_flowQueues.size ();
+}
+
+const FqCoDelFlow &
+FqCoDelQueueDisc::GetFlowQueue (std::size_t i) const
+{
+  NS_ASSERT (i < m_flowQueues.size ());
+  return m_flowQueues[i];
+}
+
+void
+FqCoDelQueueDisc::PushBack (FlowList &list, uint32_t index)
+{
+  m_flowQueues[index].m_next = FQ_CODEL_NONE;
+  if (list.tail == FQ_CODEL_NONE)
+    {
+      list.head = index;
+    }
+  else
+    {
+      m_flowQueues[list.tail].m_next = index;
+    }
+  list.tail = index;
+}
+
+void
+FqCoDelQueueDisc::PopFront (FlowList &list)
+{
+  NS_ASSERT (list.head != FQ_CODEL_NONE);
+  list.head = m_flowQueues[list.head].m_next;
+  if (list.head == FQ_CODEL_NONE)
+    {
+      list.tail = FQ_CODEL_NONE;
+    }
+}
+
+void
+FqCoDelQueueDisc::FlowEnqueue (FqCoDelFlow &flow, Ptr<QueueDiscItem> item)
+{
+  uint32_t slot = m_freePacket;
+  if (slot == FQ_CODEL_NONE)
+    {
+      slot = m_packets.size ();
+      m_packets.push_back (PacketSlot ());
+    }
+  else
+    {
+      m_freePacket = m_packets[slot].next;
+    }
+  m_packets[slot].item = item;
+  m_packets[slot].next = FQ_CODEL_NONE;
+  if (flow.m_tail == FQ_CODEL_NONE)
+    {
+      flow.m_head = slot;
+    }
+  else
+    {
+      m_packets[flow.m_tail].next = slot;
+    }
+  flow.m_tail = slot;
+  flow.m_nPackets++;
+  flow.m_nBytes += item->GetSize ();
+  PacketEnqueued (item);
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::FlowDequeue (FqCoDelFlow &flow)
+{
+  uint32_t slot = flow.m_head;
+  if (slot == FQ_CODEL_NONE)
+    {
+      return 0;
+    }
+  Ptr<QueueDiscItem> item = m_packets[slot].item;
+  m_packets[slot].item = 0;
+  flow.m_head = m_packets[slot].next;
+  if (flow.m_head == FQ_CODEL_NONE)
+    {
+      flow.m_tail = FQ_CODEL_NONE;
+    }
+  m_packets[slot].next = m_freePacket;
+  m_freePacket = slot;
+  flow.m_nPackets--;
+  flow.m_nBytes -= item->GetSize ();
+  PacketDequeued (item);
+  return item;
+}
+
 bool
 FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
@@ -180,38 +394,31 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       else
         {
           NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
-          DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
+          DropBeforeEnqueue (item, UNCLASSIFIED_DROP_ID);
           return false;
         }
     }
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
+  uint32_t index = m_flowsIndices[h];
+  if (index == FQ_CODEL_NONE)
     {
       NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
-      flow = m_flowFactory.Create<FqCoDelFlow> ();
-      Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc> ();
-      qd->Initialize ();
-      flow->SetQueueDisc (qd);
-      AddQueueDiscClass (flow);
-
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
+      index = m_flowQueues.size ();
+      m_flowQueues.push_back (FqCoDelFlow ());
+      m_flowsIndices[h] = index;
     }
+  FqCoDelFlow &flow = m_flowQueues[index];
 
-  if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
+  if (flow.m_status == FqCoDelFlow::INACTIVE)
     {
-      flow->SetStatus (FqCoDelFlow::NEW_FLOW);
-      flow->SetDeficit (m_quantum);
-      m_newFlows.push_back (flow);
+      flow.m_status = FqCoDelFlow::NEW_FLOW;
+      flow.m_deficit = m_quantum;
+      PushBack (m_newFlows, index);
     }
 
-  flow->GetQueueDisc ()->Enqueue (item);
+  FlowEnqueue (flow, item);
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << index);
 
   if (GetCurrentSize () > GetMaxSize ())
     {
@@ -221,28 +428,140 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   return true;
 }
 
+bool
+FqCoDelQueueDisc::OkToDrop (FqCoDelFlow &flow, Ptr<QueueDiscItem> item, uint32_t now)
+{
+  if (!item)
+    {
+      flow.m_firstAboveTime = 0;
+      return false;
+    }
+
+  uint32_t sojournTime = Time2CoDel (Simulator::Now () - item->GetTimeStamp ());
+
+  if (CoDelTimeBefore (sojournTime, m_codelTarget) || flow.m_nBytes < m_minBytes)
+    {
+      // went below so we'll stay below for at least interval
+      flow.m_firstAboveTime = 0;
+      return false;
+    }
+  bool okToDrop = false;
+  if (flow.m_firstAboveTime == 0)
+    {
+      // just went above from below: if we stay above for at least
+      // interval we'll say it's ok to drop
+      flow.m_firstAboveTime = now + m_codelInterval;
+    }
+  else if (CoDelTimeAfter (now, flow.m_firstAboveTime))
+    {
+      okToDrop = true;
+    }
+  return okToDrop;
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::CoDelDequeue (FqCoDelFlow &flow)
+{
+  // this is the CoDel algorithm of CoDelQueueDisc::DoDequeue, applied to
+  // the state of the flow queue
+  Ptr<QueueDiscItem> item = FlowDequeue (flow);
+  if (!item)
+    {
+      // Leave dropping state when queue is empty
+      flow.m_dropping = false;
+      return 0;
+    }
+  uint32_t now = Time2CoDel (Simulator::Now ());
+
+  bool okToDrop = OkToDrop (flow, item, now);
+
+  if (flow.m_dropping)
+    {
+      if (!okToDrop)
+        {
+          // sojourn time fell below target - leave dropping state
+          flow.m_dropping = false;
+        }
+      else if (CoDelTimeAfterEq (now, flow.m_dropNext))
+        {
+          while (flow.m_dropping && CoDelTimeAfterEq (now, flow.m_dropNext))
+            {
+              // It's time for the next drop. Drop the current packet and
+              // dequeue the next. The dequeue might take us out of dropping
+              // state. If not, schedule the next drop.
+              NS_LOG_LOGIC ("Sojourn time is still above target and it's time for next drop; dropping " << item);
+              DropAfterDequeue (item, TARGET_EXCEEDED_DROP_ID);
+
+              ++flow.m_count;
+              NewtonStep (flow.m_count, flow.m_recInvSqrt);
+              item = FlowDequeue (flow);
+
+              if (!OkToDrop (flow, item, now))
+                {
+                  // leave dropping state
+                  flow.m_dropping = false;
+                }
+              else
+                {
+                  // schedule the next drop
+                  flow.m_dropNext = ControlLaw (flow.m_dropNext, m_codelInterval, flow.m_recInvSqrt);
+                }
+            }
+        }
+    }
+  else if (okToDrop)
+    {
+      // Drop the first packet and enter dropping state unless the queue is empty
+      NS_LOG_LOGIC ("Sojourn time goes above target, dropping the first packet " << item << " and entering the dropping state");
+      DropAfterDequeue (item, TARGET_EXCEEDED_DROP_ID);
+
+      item = FlowDequeue (flow);
+
+      OkToDrop (flow, item, now);
+      flow.m_dropping = true;
+      // if min went above target close to when we last went below it
+      // assume that the drop rate that controlled the queue on the
+      // last cycle is a good starting point to control it now.
+      int delta = flow.m_count - flow.m_lastCount;
+      if (delta > 1 && CoDelTimeBefore (now - flow.m_dropNext, 16 * m_codelInterval))
+        {
+          flow.m_count = delta;
+          NewtonStep (flow.m_count, flow.m_recInvSqrt);
+        }
+      else
+        {
+          flow.m_count = 1;
+          flow.m_recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+        }
+      flow.m_lastCount = flow.m_count;
+      flow.m_dropNext = ControlLaw (now, m_codelInterval, flow.m_recInvSqrt);
+    }
+  return item;
+}
+
 Ptr<QueueDiscItem>
 FqCoDelQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  uint32_t index = FQ_CODEL_NONE;
   Ptr<QueueDiscItem> item;
 
   do
     {
       bool found = false;
 
-      while (!found && !m_newFlows.empty ())
+      while (!found && m_newFlows.head != FQ_CODEL_NONE)
         {
-          flow = m_newFlows.front ();
+          index = m_newFlows.head;
+          FqCoDelFlow &flow = m_flowQueues[index];
 
-          if (flow->GetDeficit () <= 0)
+          if (flow.m_deficit <= 0)
             {
-              flow->IncreaseDeficit (m_quantum);
-              flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              flow.m_deficit += m_quantum;
+              flow.m_status = FqCoDelFlow::OLD_FLOW;
+              PopFront (m_newFlows);
+              PushBack (m_oldFlows, index);
             }
           else
             {
@@ -251,15 +570,16 @@ FqCoDelQueueDisc::DoDequeue (void)
             }
         }
 
-      while (!found && !m_oldFlows.empty ())
+      while (!found && m_oldFlows.head != FQ_CODEL_NONE)
         {
-          flow = m_oldFlows.front ();
+          index = m_oldFlows.head;
+          FqCoDelFlow &flow = m_flowQueues[index];
 
-          if (flow->GetDeficit () <= 0)
+          if (flow.m_deficit <= 0)
             {
-              flow->IncreaseDeficit (m_quantum);
-              m_oldFlows.push_back (flow);
-              m_oldFlows.pop_front ();
+              flow.m_deficit += m_quantum;
+              PopFront (m_oldFlows);
+              PushBack (m_oldFlows, index);
             }
           else
             {
@@ -274,21 +594,22 @@ FqCoDelQueueDisc::DoDequeue (void)
           return 0;
         }
 
-      item = flow->GetQueueDisc ()->Dequeue ();
+      FqCoDelFlow &flow = m_flowQueues[index];
+      item = CoDelDequeue (flow);
 
       if (!item)
         {
           NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
-          if (!m_newFlows.empty ())
+          if (m_newFlows.head != FQ_CODEL_NONE)
             {
-              flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              flow.m_status = FqCoDelFlow::OLD_FLOW;
+              PopFront (m_newFlows);
+              PushBack (m_oldFlows, index);
             }
           else
             {
-              flow->SetStatus (FqCoDelFlow::INACTIVE);
-              m_oldFlows.pop_front ();
+              flow.m_status = FqCoDelFlow::INACTIVE;
+              PopFront (m_oldFlows);
             }
         }
       else
@@ -297,7 +618,7 @@ FqCoDelQueueDisc::DoDequeue (void)
         }
     } while (item == 0);
 
-  flow->IncreaseDeficit (item->GetSize () * -1);
+  m_flowQueues[index].m_deficit -= item->GetSize ();
 
   return item;
 }
@@ -339,6 +660,12 @@ FqCoDelQueueDisc::CheckConfig (void)
         }
     }
 
+  if (m_flows == 0)
+    {
+      NS_LOG_ERROR ("FqCoDelQueueDisc needs at least one flow queue");
+      return false;
+    }
+
   return true;
 }
 
@@ -347,12 +674,14 @@ FqCoDelQueueDisc::InitializeParams (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_flowFactory.SetTypeId ("ns3::FqCoDelFlow");
+  m_codelInterval = Time2CoDel (Time (m_interval));
+  m_codelTarget = Time2CoDel (Time (m_target));
 
-  m_queueDiscFactory.SetTypeId ("ns3::CoDelQueueDisc");
-  m_queueDiscFactory.Set ("MaxSize", QueueSizeValue (GetMaxSize ()));
-  m_queueDiscFactory.Set ("Interval", StringValue (m_interval));
-  m_queueDiscFactory.Set ("Target", StringValue (m_target));
+  m_flowsIndices.assign (m_flows, FQ_CODEL_NONE);
+  m_flowQueues.clear ();
+  // the flow queues are never moved, so that the references returned by
+  // GetFlowQueue remain valid
+  m_flowQueues.reserve (m_flows);
 }
 
 uint32_t
@@ -361,13 +690,11 @@ FqCoDelQueueDisc::FqCoDelDrop (void)
   NS_LOG_FUNCTION (this);
 
   uint32_t maxBacklog = 0, index = 0;
-  Ptr<QueueDisc> qd;
 
   /* Queue is full! Find the fat flow and drop packet(s) from it */
-  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
+  for (uint32_t i = 0; i < m_flowQueues.size (); i++)
     {
-      qd = GetQueueDiscClass (i)->GetQueueDisc ();
-      uint32_t bytes = qd->GetNBytes ();
+      uint32_t bytes = m_flowQueues[i].m_nBytes;
       if (bytes > maxBacklog)
         {
           maxBacklog = bytes;
@@ -377,13 +704,13 @@ FqCoDelQueueDisc::FqCoDelDrop (void)
 
   /* Our goal is to drop half of this fat flow backlog */
   uint32_t len = 0, count = 0, threshold = maxBacklog >> 1;
-  qd = GetQueueDiscClass (index)->GetQueueDisc ();
+  FqCoDelFlow &flow = m_flowQueues[index];
   Ptr<QueueDiscItem> item;
 
   do
     {
-      item = qd->GetInternalQueue (0)->Dequeue ();
-      DropAfterDequeue (item, OVERLIMIT_DROP);
+      item = FlowDequeue (flow);
+      DropAfterDequeue (item, OVERLIMIT_DROP_ID);
       len += item->GetSize ();
     } while (++count < m_dropBatchSize && len < threshold);
 
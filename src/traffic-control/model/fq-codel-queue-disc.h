@@ -23,32 +23,29 @@
 #define FQ_CODEL_QUEUE_DISC
 
 #include "ns3/queue-disc.h"
-#include "ns3/object-factory.h"
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
+class FqCoDelQueueDisc;
+
 /**
  * \ingroup traffic-control
  *
  * \brief A flow queue used by the FqCoDel queue disc
+ *
+ * The flow queues are not objects: they are held in an array by the
+ * FqCoDel queue disc, which also holds their packets, and they keep the
+ * state of the scheduler and of the CoDel algorithm for their flow.
  */
 
-class FqCoDelFlow : public QueueDiscClass {
+class FqCoDelFlow {
 public:
-  /**
-   * \brief Get the type ID.
-   * \return the object TypeId
-   */
-  static TypeId GetTypeId (void);
   /**
    * \brief FqCoDelFlow constructor
    */
   FqCoDelFlow ();
 
-  virtual ~FqCoDelFlow ();
-
   /**
    * \enum FlowStatus
    * \brief Used to determine the status of this flow queue
@@ -85,10 +82,35 @@ public:
    * \return the status of this flow
    */
   FlowStatus GetStatus (void) const;
+  /**
+   * \brief Get the number of packets in this flow queue
+   * \return the number of packets
+   */
+  uint32_t GetNPackets (void) const;
+  /**
+   * \brief Get the number of bytes in this flow queue
+   * \return the number of bytes
+   */
+  uint32_t GetNBytes (void) const;
 
 private:
+  friend class FqCoDelQueueDisc;
+
   int32_t m_deficit;    //!< the deficit for this flow
   FlowStatus m_status;  //!< the status of this flow
+  uint32_t m_next;      //!< the next flow in the list of new or old flows
+  uint32_t m_head;      //!< the slot of the first packet
+  uint32_t m_tail;      //!< the slot of the last packet
+  uint32_t m_nPackets;  //!< the number of packets
+  uint32_t m_nBytes;    //!< the number of bytes
+
+  // CoDel state, as in CoDelQueueDisc
+  uint32_t m_count;           //!< Number of packets dropped since entering drop state
+  uint32_t m_lastCount;       //!< Last number of packets dropped since entering drop state
+  bool m_dropping;            //!< True if in dropping state
+  uint16_t m_recInvSqrt;      //!< Reciprocal inverse square root
+  uint32_t m_firstAboveTime;  //!< Time to declare sojourn time above target
+  uint32_t m_dropNext;        //!< Time to drop next packet
 };
 
 
@@ -96,6 +118,13 @@ private:
  * \ingroup traffic-control
  *
  * \brief A FqCoDel packet queue disc
+ *
+ * The flow queues are allocated, when first used, from an array of flow
+ * queues; a table, indexed by the hash of the packets, gives the flow
+ * queue of each bucket.  The lists of new and old flows are linked
+ * through the flow queues, and the packets of all the flow queues are held
+ * in a single pool, so that no memory is allocated to enqueue or dequeue
+ * packets.
  */
 
 class FqCoDelQueueDisc : public QueueDisc {
@@ -126,9 +155,30 @@ public:
     */
    uint32_t GetQuantum (void) const;
 
+  /**
+   * \brief Get the number of flow queues used so far
+   * \return the number of flow queues
+   */
+  std::size_t GetNFlowQueues (void) const;
+
+  /**
+   * \brief Get a flow queue
+   * \param i the index of the flow queue, in the order they were first used
+   * \return the flow queue
+   */
+  const FqCoDelFlow & GetFlowQueue (std::size_t i) const;
+
   // Reasons for dropping packets
   static constexpr const char* UNCLASSIFIED_DROP = "Unclassified drop";  //!< No packet filter able to classify packet
   static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";        //!< Overlimit dropped packets
+  static constexpr const char* TARGET_EXCEEDED_DROP = "Target exceeded drop";  //!< Sojourn time above target
+  // Ids of the reasons, registered once for the class
+  static const ReasonId UNCLASSIFIED_DROP_ID;  //!< Id of UNCLASSIFIED_DROP
+  static const ReasonId OVERLIMIT_DROP_ID;  //!< Id of OVERLIMIT_DROP
+  static const ReasonId TARGET_EXCEEDED_DROP_ID;  //!< Id of TARGET_EXCEEDED_DROP
+
+protected:
+  virtual void DoDispose (void);
 
 private:
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
@@ -142,20 +192,80 @@ private:
    */
   uint32_t FqCoDelDrop (void);
 
+  /// A list of flow queues, linked through the flow queues
+  struct FlowList
+  {
+    uint32_t head;  //!< the first flow queue
+    uint32_t tail;  //!< the last flow queue
+  };
+
+  /// A slot of the pool of packets
+  struct PacketSlot
+  {
+    Ptr<QueueDiscItem> item;  //!< the packet
+    uint32_t next;            //!< the next packet of the flow queue, or the next free slot
+  };
+
+  /**
+   * \brief Add a flow queue at the end of a list
+   * \param list the list
+   * \param index the flow queue
+   */
+  void PushBack (FlowList &list, uint32_t index);
+
+  /**
+   * \brief Remove the flow queue at the head of a list
+   * \param list the list
+   */
+  void PopFront (FlowList &list);
+
+  /**
+   * \brief Add a packet at the tail of a flow queue
+   * \param flow the flow queue
+   * \param item the packet
+   */
+  void FlowEnqueue (FqCoDelFlow &flow, Ptr<QueueDiscItem> item);
+
+  /**
+   * \brief Remove the packet at the head of a flow queue
+   * \param flow the flow queue
+   * \return the packet, or 0 if the flow queue is empty
+   */
+  Ptr<QueueDiscItem> FlowDequeue (FqCoDelFlow &flow);
+
+  /**
+   * \brief Dequeue a packet from a flow queue with the CoDel algorithm
+   * \param flow the flow queue
+   * \return the packet, or 0 if the flow queue is or becomes empty
+   */
+  Ptr<QueueDiscItem> CoDelDequeue (FqCoDelFlow &flow);
+
+  /**
+   * \brief Determine whether a packet is OK to be dropped by CoDel
+   * \param flow the flow queue
+   * \param item the packet
+   * \param now the current time, in CoDel time
+   * \return true if the sojourn time has been above target for at least interval
+   */
+  bool OkToDrop (FqCoDelFlow &flow, Ptr<QueueDiscItem> item, uint32_t now);
+
   std::string m_interval;    //!< CoDel interval attribute
   std::string m_target;      //!< CoDel target attribute
   uint32_t m_quantum;        //!< Deficit assigned to flows at each round
   uint32_t m_flows;          //!< Number of flow queues
   uint32_t m_dropBatchSize;  //!< Max number of packets dropped from the fat flow
   uint32_t m_perturbation;   //!< hash perturbation value
+  uint32_t m_minBytes;       //!< CoDel minbytes parameter
+  uint32_t m_codelInterval;  //!< CoDel interval, in CoDel time
+  uint32_t m_codelTarget;    //!< CoDel target, in CoDel time
 
-  std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
-  std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
-
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
+  FlowList m_newFlows;    //!< The list of new flows
+  FlowList m_oldFlows;    //!< The list of old flows
 
-  ObjectFactory m_flowFactory;         //!< Factory to create a new flow
-  ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
+  std::vector<uint32_t> m_flowsIndices;    //!< Index of the flow queue of each bucket
+  std::vector<FqCoDelFlow> m_flowQueues;   //!< Flow queues, in the order they were first used
+  std::vector<PacketSlot> m_packets;       //!< Pool of packets of the flow queues
+  uint32_t m_freePacket;                   //!< First free slot of the pool
 };
 
 } // namespace ns3
@@ -40,6 +40,9 @@ NS_LOG_COMPONENT_DEFINE ("PieQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED (PieQueueDisc);
 
+const QueueDisc::ReasonId PieQueueDisc::UNFORCED_DROP_ID = QueueDisc::RegisterReason (UNFORCED_DROP);
+const QueueDisc::ReasonId PieQueueDisc::FORCED_DROP_ID = QueueDisc::RegisterReason (FORCED_DROP);
+
 TypeId PieQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::PieQueueDisc")
@@ -144,13 +147,13 @@ PieQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   if (nQueued + item > GetMaxSize ())
     {
       // Drops due to queue limit: reactive
-      DropBeforeEnqueue (item, FORCED_DROP);
+      DropBeforeEnqueue (item, FORCED_DROP_ID);
       return false;
     }
   else if (DropEarly (item, nQueued.GetValue ()))
     {
       // Early probability drop: proactive
-      DropBeforeEnqueue (item, UNFORCED_DROP);
+      DropBeforeEnqueue (item, UNFORCED_DROP_ID);
       return false;
     }
 
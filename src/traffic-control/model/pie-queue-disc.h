@@ -97,6 +97,9 @@ public:
   // Reasons for dropping packets
   static constexpr const char* UNFORCED_DROP = "Unforced drop";  //!< Early probability drops: proactive
   static constexpr const char* FORCED_DROP = "Forced drop";      //!< Drops due to queue limit: reactive
+  // Ids of the reasons, registered once for the class
+  static const ReasonId UNFORCED_DROP_ID;  //!< Id of UNFORCED_DROP
+  static const ReasonId FORCED_DROP_ID;  //!< Id of FORCED_DROP
 
 protected:
   /**
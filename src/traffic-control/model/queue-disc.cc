@@ -29,6 +29,9 @@
 #include "queue-disc.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/queue.h"
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -258,6 +261,54 @@ std::ostream & operator << (std::ostream &os, const QueueDisc::Stats &stats)
   return os;
 }
 
+/// The drop and mark reasons registered by the queue discs
+struct QueueDiscReasons
+{
+  /// Reason ids, indexed by reason (the keys are never moved)
+  std::unordered_map<std::string, QueueDisc::ReasonId> ids;
+  /// Reasons, indexed by id
+  std::vector<const char*> names;
+};
+
+/**
+ * \brief Get the registered reasons
+ * \return the registered reasons
+ */
+static QueueDiscReasons &
+GetQueueDiscReasons (void)
+{
+  static QueueDiscReasons reasons;
+  return reasons;
+}
+
+QueueDisc::ReasonId
+QueueDisc::RegisterReason (std::string reason)
+{
+  // not logged: the queue discs register their reasons during the static
+  // initialization
+  QueueDiscReasons &reasons = GetQueueDiscReasons ();
+  auto it = reasons.ids.find (reason);
+  if (it != reasons.ids.end ())
+    {
+      return it->second;
+    }
+  ReasonId id = reasons.names.size ();
+  it = reasons.ids.insert (std::make_pair (reason, id)).first;
+  reasons.names.push_back (it->first.c_str ());
+  return id;
+}
+
+const char*
+QueueDisc::GetReasonName (ReasonId id)
+{
+  QueueDiscReasons &reasons = GetQueueDiscReasons ();
+  NS_ASSERT_MSG (id < reasons.names.size (), "Unknown reason id " << id);
+  return reasons.names[id];
+}
+
+const QueueDisc::ReasonId QueueDisc::INTERNAL_QUEUE_DROP_ID = QueueDisc::RegisterReason (INTERNAL_QUEUE_DROP);
+const QueueDisc::ReasonId QueueDisc::NO_REASON;
+
 NS_OBJECT_ENSURE_REGISTERED (QueueDisc);
 
 TypeId QueueDisc::GetTypeId (void)
@@ -270,6 +321,14 @@ TypeId QueueDisc::GetTypeId (void)
                    MakeUintegerAccessor (&QueueDisc::SetQuota,
                                          &QueueDisc::GetQuota),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize",
+                   "The maximum number of packets dequeued at once in a qdisc run, "
+                   "before being sent to the device. Larger batches are only "
+                   "dequeued if the device has a single transmission queue.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&QueueDisc::SetBatchSize,
+                                         &QueueDisc::GetBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("InternalQueueList", "The list of internal queues.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&QueueDisc::m_queues),
@@ -323,6 +382,7 @@ QueueDisc::QueueDisc (QueueDiscSizePolicy policy)
   :  m_nPackets (0),
      m_nBytes (0),
      m_maxSize (QueueSize ("1p")),         // to avoid that setting the mode at construction time is ignored
+     m_batchSize (1),
      m_running (false),
      m_peeked (false),
      m_sizePolicy (policy),
@@ -337,28 +397,11 @@ QueueDisc::QueueDisc (QueueDiscSizePolicy policy)
   // why the packet is dropped.
   m_internalQueueDbeFunctor = [this] (Ptr<const QueueDiscItem> item)
     {
-      return DropBeforeEnqueue (item, INTERNAL_QUEUE_DROP);
+      return DropBeforeEnqueue (item, INTERNAL_QUEUE_DROP_ID);
     };
   m_internalQueueDadFunctor = [this] (Ptr<const QueueDiscItem> item)
     {
-      return DropAfterDequeue (item, INTERNAL_QUEUE_DROP);
-    };
-
-  // These lambdas call the DropBeforeEnqueue or DropAfterDequeue methods of this
-  // QueueDisc object. Given that a callback to the operator() of these lambdas
-  // is connected to the DropBeforeEnqueue and DropAfterDequeue traces of the
-  // child queue discs, the concatenation of the CHILD_QUEUE_DISC_DROP constant
-  // and the second argument provided by such traces is passed as the reason why
-  // the packet is dropped.
-  m_childQueueDiscDbeFunctor = [this] (Ptr<const QueueDiscItem> item, const char* r)
-    {
-      return DropBeforeEnqueue (item,
-                                m_childQueueDiscDropMsg.assign (CHILD_QUEUE_DISC_DROP).append (r).data ());
-    };
-  m_childQueueDiscDadFunctor = [this] (Ptr<const QueueDiscItem> item, const char* r)
-    {
-      return DropAfterDequeue (item,
-                               m_childQueueDiscDropMsg.assign (CHILD_QUEUE_DISC_DROP).append (r).data ());
+      return DropAfterDequeue (item, INTERNAL_QUEUE_DROP_ID);
     };
 }
 
@@ -383,11 +426,12 @@ QueueDisc::DoDispose (void)
   m_classes.clear ();
   m_devQueueIface = 0;
   m_send = nullptr;
-  m_requeued = 0;
+  m_requeued.clear ();
+  m_batch.clear ();
   m_internalQueueDbeFunctor = nullptr;
   m_internalQueueDadFunctor = nullptr;
-  m_childQueueDiscDbeFunctor = nullptr;
-  m_childQueueDiscDadFunctor = nullptr;
+  m_parentDbeCallback = MakeNullCallback<void, Ptr<const QueueDiscItem>, ReasonId> ();
+  m_parentDadCallback = MakeNullCallback<void, Ptr<const QueueDiscItem>, ReasonId> ();
   Object::DoDispose ();
 }
 
@@ -423,11 +467,45 @@ QueueDisc::GetStats (void)
   // the total number of sent packets is only updated here to avoid to increase it
   // after a dequeue and then having to decrease it if the packet is dropped after
   // dequeue or requeued
-  m_stats.nTotalSentPackets = m_stats.nTotalDequeuedPackets - (m_requeued ? 1 : 0)
+  uint64_t requeuedBytes = 0;
+  for (std::deque<Ptr<QueueDiscItem> >::const_iterator it = m_requeued.begin (); it != m_requeued.end (); it++)
+    {
+      requeuedBytes += (*it)->GetSize ();
+    }
+  m_stats.nTotalSentPackets = m_stats.nTotalDequeuedPackets - m_requeued.size ()
                               - m_stats.nTotalDroppedPacketsAfterDequeue;
-  m_stats.nTotalSentBytes = m_stats.nTotalDequeuedBytes - (m_requeued ? m_requeued->GetSize () : 0)
+  m_stats.nTotalSentBytes = m_stats.nTotalDequeuedBytes - requeuedBytes
                             - m_stats.nTotalDroppedBytesAfterDequeue;
 
+  // the counters for each reason are kept in a table indexed by reason id:
+  // build the string-keyed view of the table
+  m_stats.nDroppedPacketsBeforeEnqueue.clear ();
+  m_stats.nDroppedBytesBeforeEnqueue.clear ();
+  m_stats.nDroppedPacketsAfterDequeue.clear ();
+  m_stats.nDroppedBytesAfterDequeue.clear ();
+  m_stats.nMarkedPackets.clear ();
+  m_stats.nMarkedBytes.clear ();
+  for (ReasonId id = 0; id < m_reasonStats.size (); id++)
+    {
+      const ReasonStats &counters = m_reasonStats[id];
+      std::string reason = GetReasonName (id);
+      if (counters.nDroppedPacketsBeforeEnqueue)
+        {
+          m_stats.nDroppedPacketsBeforeEnqueue[reason] = counters.nDroppedPacketsBeforeEnqueue;
+          m_stats.nDroppedBytesBeforeEnqueue[reason] = counters.nDroppedBytesBeforeEnqueue;
+        }
+      if (counters.nDroppedPacketsAfterDequeue)
+        {
+          m_stats.nDroppedPacketsAfterDequeue[reason] = counters.nDroppedPacketsAfterDequeue;
+          m_stats.nDroppedBytesAfterDequeue[reason] = counters.nDroppedBytesAfterDequeue;
+        }
+      if (counters.nMarkedPackets)
+        {
+          m_stats.nMarkedPackets[reason] = counters.nMarkedPackets;
+          m_stats.nMarkedBytes[reason] = counters.nMarkedBytes;
+        }
+    }
+
   return m_stats;
 }
 
@@ -572,6 +650,20 @@ QueueDisc::GetQuota (void) const
   return m_quota;
 }
 
+void
+QueueDisc::SetBatchSize (uint32_t batchSize)
+{
+  NS_LOG_FUNCTION (this << batchSize);
+  NS_ASSERT_MSG (batchSize > 0, "The batch size must be at least one packet");
+  m_batchSize = batchSize;
+}
+
+uint32_t
+QueueDisc::GetBatchSize (void) const
+{
+  return m_batchSize;
+}
+
 void
 QueueDisc::AddInternalQueue (Ptr<InternalQueue> queue)
 {
@@ -636,17 +728,14 @@ QueueDisc::AddQueueDiscClass (Ptr<QueueDiscClass> qdClass)
                    "A queue disc with WAKE_CHILD as wake mode can only be a root queue disc");
 
   // set the parent callbacks on the child queue disc, so that it can notify
-  // the parent queue disc of packets enqueued, dequeued or dropped
+  // the parent queue disc of packets enqueued, dequeued or dropped. Drops are
+  // notified with the id of their reason, without going through the traces
   qdClass->GetQueueDisc ()->TraceConnectWithoutContext ("Enqueue",
                                      MakeCallback (&QueueDisc::PacketEnqueued, this));
   qdClass->GetQueueDisc ()->TraceConnectWithoutContext ("Dequeue",
                                      MakeCallback (&QueueDisc::PacketDequeued, this));
-  qdClass->GetQueueDisc ()->TraceConnectWithoutContext ("DropBeforeEnqueue",
-                                     MakeCallback (&ChildQueueDiscDropFunctor::operator(),
-                                                   &m_childQueueDiscDbeFunctor));
-  qdClass->GetQueueDisc ()->TraceConnectWithoutContext ("DropAfterDequeue",
-                                     MakeCallback (&ChildQueueDiscDropFunctor::operator(),
-                                                   &m_childQueueDiscDadFunctor));
+  qdClass->GetQueueDisc ()->m_parentDbeCallback = MakeCallback (&QueueDisc::ChildDropBeforeEnqueue, this);
+  qdClass->GetQueueDisc ()->m_parentDadCallback = MakeCallback (&QueueDisc::ChildDropAfterDequeue, this);
   m_classes.push_back (qdClass);
 }
 
@@ -717,75 +806,113 @@ QueueDisc::PacketDequeued (Ptr<const QueueDiscItem> item)
     }
 }
 
-void
-QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, const char* reason)
+QueueDisc::ReasonId
+QueueDisc::LookupReason (const char* reason)
 {
-  NS_LOG_FUNCTION (this << item << reason);
-
-  m_stats.nTotalDroppedPackets++;
-  m_stats.nTotalDroppedBytes += item->GetSize ();
-  m_stats.nTotalDroppedPacketsBeforeEnqueue++;
-  m_stats.nTotalDroppedBytesBeforeEnqueue += item->GetSize ();
-
-  // update the number of packets dropped for the given reason
-  std::map<std::string, uint32_t>::iterator itp = m_stats.nDroppedPacketsBeforeEnqueue.find (reason);
-  if (itp != m_stats.nDroppedPacketsBeforeEnqueue.end ())
+  // the reasons are usually string constants: look for the same pointer
+  // first, and check that the string has not changed
+  for (auto &entry : m_reasonCache)
     {
-      itp->second++;
+      if (entry.string == reason && std::strcmp (reason, GetReasonName (entry.id)) == 0)
+        {
+          return entry.id;
+        }
     }
-  else
+  ReasonId id = RegisterReason (reason);
+  m_reasonCache.push_back ({reason, id});
+  return id;
+}
+
+QueueDisc::ReasonId
+QueueDisc::GetChildReason (ReasonId reason)
+{
+  if (reason >= m_childReasons.size ())
     {
-      m_stats.nDroppedPacketsBeforeEnqueue[reason] = 1;
+      m_childReasons.resize (reason + 1, NO_REASON);
     }
-  // update the amount of bytes dropped for the given reason
-  std::map<std::string, uint64_t>::iterator itb = m_stats.nDroppedBytesBeforeEnqueue.find (reason);
-  if (itb != m_stats.nDroppedBytesBeforeEnqueue.end ())
+  if (m_childReasons[reason] == NO_REASON)
     {
-      itb->second += item->GetSize ();
+      m_childReasons[reason] = RegisterReason (std::string (CHILD_QUEUE_DISC_DROP)
+                                               + GetReasonName (reason));
     }
-  else
+  return m_childReasons[reason];
+}
+
+void
+QueueDisc::ChildDropBeforeEnqueue (Ptr<const QueueDiscItem> item, ReasonId reason)
+{
+  DropBeforeEnqueue (item, GetChildReason (reason));
+}
+
+void
+QueueDisc::ChildDropAfterDequeue (Ptr<const QueueDiscItem> item, ReasonId reason)
+{
+  DropAfterDequeue (item, GetChildReason (reason));
+}
+
+QueueDisc::ReasonStats&
+QueueDisc::GetReasonStats (ReasonId id)
+{
+  if (id >= m_reasonStats.size ())
     {
-      m_stats.nDroppedBytesBeforeEnqueue[reason] = item->GetSize ();
+      m_reasonStats.resize (id + 1, ReasonStats ());
     }
+  return m_reasonStats[id];
+}
+
+void
+QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, const char* reason)
+{
+  DropBeforeEnqueue (item, LookupReason (reason));
+}
+
+void
+QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, ReasonId reason)
+{
+  NS_LOG_FUNCTION (this << item << GetReasonName (reason));
+
+  m_stats.nTotalDroppedPackets++;
+  m_stats.nTotalDroppedBytes += item->GetSize ();
+  m_stats.nTotalDroppedPacketsBeforeEnqueue++;
+  m_stats.nTotalDroppedBytesBeforeEnqueue += item->GetSize ();
+
+  // update the number of packets and bytes dropped for the given reason
+  ReasonStats &counters = GetReasonStats (reason);
+  counters.nDroppedPacketsBeforeEnqueue++;
+  counters.nDroppedBytesBeforeEnqueue += item->GetSize ();
 
   NS_LOG_DEBUG ("Total packets/bytes dropped before enqueue: "
                 << m_stats.nTotalDroppedPacketsBeforeEnqueue << " / "
                 << m_stats.nTotalDroppedBytesBeforeEnqueue);
+  if (!m_parentDbeCallback.IsNull ())
+    {
+      m_parentDbeCallback (item, reason);
+    }
   NS_LOG_LOGIC ("m_traceDropBeforeEnqueue (p)");
   m_traceDrop (item);
-  m_traceDropBeforeEnqueue (item, reason);
+  m_traceDropBeforeEnqueue (item, GetReasonName (reason));
 }
 
 void
 QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, const char* reason)
 {
-  NS_LOG_FUNCTION (this << item << reason);
+  DropAfterDequeue (item, LookupReason (reason));
+}
+
+void
+QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, ReasonId reason)
+{
+  NS_LOG_FUNCTION (this << item << GetReasonName (reason));
 
   m_stats.nTotalDroppedPackets++;
   m_stats.nTotalDroppedBytes += item->GetSize ();
   m_stats.nTotalDroppedPacketsAfterDequeue++;
   m_stats.nTotalDroppedBytesAfterDequeue += item->GetSize ();
 
-  // update the number of packets dropped for the given reason
-  std::map<std::string, uint32_t>::iterator itp = m_stats.nDroppedPacketsAfterDequeue.find (reason);
-  if (itp != m_stats.nDroppedPacketsAfterDequeue.end ())
-    {
-      itp->second++;
-    }
-  else
-    {
-      m_stats.nDroppedPacketsAfterDequeue[reason] = 1;
-    }
-  // update the amount of bytes dropped for the given reason
-  std::map<std::string, uint64_t>::iterator itb = m_stats.nDroppedBytesAfterDequeue.find (reason);
-  if (itb != m_stats.nDroppedBytesAfterDequeue.end ())
-    {
-      itb->second += item->GetSize ();
-    }
-  else
-    {
-      m_stats.nDroppedBytesAfterDequeue[reason] = item->GetSize ();
-    }
+  // update the number of packets and bytes dropped for the given reason
+  ReasonStats &counters = GetReasonStats (reason);
+  counters.nDroppedPacketsAfterDequeue++;
+  counters.nDroppedBytesAfterDequeue += item->GetSize ();
 
   // if in the context of a peek request a dequeued packet is dropped, we need
   // to update the statistics and fire the dequeue trace before firing the drop
@@ -801,15 +928,25 @@ QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, const char* reason)
   NS_LOG_DEBUG ("Total packets/bytes dropped after dequeue: "
                 << m_stats.nTotalDroppedPacketsAfterDequeue << " / "
                 << m_stats.nTotalDroppedBytesAfterDequeue);
+  if (!m_parentDadCallback.IsNull ())
+    {
+      m_parentDadCallback (item, reason);
+    }
   NS_LOG_LOGIC ("m_traceDropAfterDequeue (p)");
   m_traceDrop (item);
-  m_traceDropAfterDequeue (item, reason);
+  m_traceDropAfterDequeue (item, GetReasonName (reason));
 }
 
 bool
 QueueDisc::Mark (Ptr<QueueDiscItem> item, const char* reason)
 {
-  NS_LOG_FUNCTION (this << item << reason);
+  return Mark (item, LookupReason (reason));
+}
+
+bool
+QueueDisc::Mark (Ptr<QueueDiscItem> item, ReasonId reason)
+{
+  NS_LOG_FUNCTION (this << item << GetReasonName (reason));
 
   bool retval = item->Mark ();
 
@@ -821,31 +958,15 @@ QueueDisc::Mark (Ptr<QueueDiscItem> item, const char* reason)
   m_stats.nTotalMarkedPackets++;
   m_stats.nTotalMarkedBytes += item->GetSize ();
 
-  // update the number of packets marked for the given reason
-  std::map<std::string, uint32_t>::iterator itp = m_stats.nMarkedPackets.find (reason);
-  if (itp != m_stats.nMarkedPackets.end ())
-    {
-      itp->second++;
-    }
-  else
-    {
-      m_stats.nMarkedPackets[reason] = 1;
-    }
-  // update the amount of bytes marked for the given reason
-  std::map<std::string, uint64_t>::iterator itb = m_stats.nMarkedBytes.find (reason);
-  if (itb != m_stats.nMarkedBytes.end ())
-    {
-      itb->second += item->GetSize ();
-    }
-  else
-    {
-      m_stats.nMarkedBytes[reason] = item->GetSize ();
-    }
+  // update the number of packets and bytes marked for the given reason
+  ReasonStats &counters = GetReasonStats (reason);
+  counters.nMarkedPackets++;
+  counters.nMarkedBytes += item->GetSize ();
 
   NS_LOG_DEBUG ("Total packets/bytes marked: "
                 << m_stats.nTotalMarkedPackets << " / "
                 << m_stats.nTotalMarkedBytes);
-  m_traceMark (item, reason);
+  m_traceMark (item, GetReasonName (reason));
   return true;
 }
 
@@ -892,11 +1013,12 @@ QueueDisc::Dequeue (void)
   // The QueueDisc::DoPeek method dequeues a packet and keeps it as a requeued
   // packet. Thus, first check whether a peeked packet exists. Otherwise, call
   // the private DoDequeue method.
-  Ptr<QueueDiscItem> item = m_requeued;
+  Ptr<QueueDiscItem> item;
 
-  if (item)
+  if (!m_requeued.empty ())
     {
-      m_requeued = 0;
+      item = m_requeued.front ();
+      m_requeued.pop_front ();
       if (m_peeked)
         {
           // If the packet was requeued because a peek operation was requested
@@ -918,6 +1040,69 @@ QueueDisc::Dequeue (void)
   return item;
 }
 
+std::size_t
+QueueDisc::EnqueueBatch (const std::vector<Ptr<QueueDiscItem> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  std::size_t n = 0;
+  Time now = Simulator::Now ();
+  for (std::vector<Ptr<QueueDiscItem> >::const_iterator it = items.begin (); it != items.end (); it++)
+    {
+      m_stats.nTotalReceivedPackets++;
+      m_stats.nTotalReceivedBytes += (*it)->GetSize ();
+
+      // see Enqueue about the packets not enqueued
+      if (DoEnqueue (*it))
+        {
+          (*it)->SetTimeStamp (now);
+          n++;
+        }
+    }
+
+  NS_ASSERT (m_stats.nTotalReceivedPackets == m_stats.nTotalDroppedPacketsBeforeEnqueue +
+             m_stats.nTotalEnqueuedPackets);
+  NS_ASSERT (m_stats.nTotalReceivedBytes == m_stats.nTotalDroppedBytesBeforeEnqueue +
+             m_stats.nTotalEnqueuedBytes);
+
+  return n;
+}
+
+std::size_t
+QueueDisc::DequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, std::size_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  std::size_t n = 0;
+  // first the requeued packets, as Dequeue does
+  while (n < maxItems && !m_requeued.empty ())
+    {
+      Ptr<QueueDiscItem> item = m_requeued.front ();
+      m_requeued.pop_front ();
+      if (m_peeked)
+        {
+          m_peeked = false;
+          PacketDequeued (item);
+        }
+      items.push_back (item);
+      n++;
+    }
+  for (; n < maxItems; n++)
+    {
+      Ptr<QueueDiscItem> item = DoDequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+    }
+
+  NS_ASSERT (m_nPackets == m_stats.nTotalEnqueuedPackets - m_stats.nTotalDequeuedPackets);
+  NS_ASSERT (m_nBytes == m_stats.nTotalEnqueuedBytes - m_stats.nTotalDequeuedBytes);
+
+  return n;
+}
+
 Ptr<const QueueDiscItem>
 QueueDisc::Peek (void)
 {
@@ -930,17 +1115,19 @@ QueueDisc::DoPeek (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (!m_requeued)
+  if (m_requeued.empty ())
     {
       m_peeked = true;
-      m_requeued = Dequeue ();
+      Ptr<QueueDiscItem> item = Dequeue ();
       // if no packet is returned, reset the m_peeked flag
-      if (!m_requeued)
+      if (!item)
         {
           m_peeked = false;
+          return 0;
         }
+      m_requeued.push_back (item);
     }
-  return m_requeued;
+  return m_requeued.front ();
 }
 
 void
@@ -951,14 +1138,15 @@ QueueDisc::Run (void)
   if (RunBegin ())
     {
       uint32_t quota = m_quota;
-      while (Restart ())
+      uint32_t packets;
+      while (Restart (packets))
         {
-          quota -= 1;
-          if (quota <= 0)
+          if (packets >= quota)
             {
               /// \todo netif_schedule (q);
               break;
             }
+          quota -= packets;
         }
       RunEnd ();
     }
@@ -985,17 +1173,51 @@ QueueDisc::RunEnd (void)
 }
 
 bool
-QueueDisc::Restart (void)
+QueueDisc::Restart (uint32_t &packets)
 {
   NS_LOG_FUNCTION (this);
+  // requeued packets are never part of a batch
+  bool fresh = m_requeued.empty ();
+  packets = 0;
   Ptr<QueueDiscItem> item = DequeuePacket();
   if (item == 0)
     {
       NS_LOG_LOGIC ("No packet to send");
       return false;
     }
+  packets = 1;
+
+  // DequeuePacket only dequeues a fresh packet if the device queue is not
+  // stopped (or the device is multi-queue, which is excluded here)
+  if (m_batchSize == 1 || !fresh || (m_devQueueIface && m_devQueueIface->GetNTxQueues () > 1))
+    {
+      return Transmit (item);
+    }
+
+  // the batch is bounded by the room left in the device queue (including
+  // the packet already dequeued), so that the device queue is not stopped
+  // in the middle of the batch, as the bulk dequeue of Linux is bounded by
+  // the byte queue limits
+  uint32_t batchSize = m_batchSize;
+  if (m_devQueueIface)
+    {
+      batchSize = std::min (batchSize, m_devQueueIface->GetTxQueue (0)->GetNAvailablePackets ());
+    }
+
+  m_batch.push_back (item);
+  std::size_t start = m_batch.size ();
+  if (batchSize > 1)
+    {
+      DequeueBatch (m_batch, batchSize - 1);
+    }
+  for (std::size_t i = start; i < m_batch.size (); i++)
+    {
+      m_batch[i]->AddHeader ();
+    }
+  packets = m_batch.size ();
+  NS_LOG_LOGIC ("Dequeued a batch of " << packets << " packets");
 
-  return Transmit (item);
+  return TransmitBatch ();
 }
 
 Ptr<QueueDiscItem>
@@ -1006,15 +1228,15 @@ QueueDisc::DequeuePacket ()
   Ptr<QueueDiscItem> item;
 
   // First check if there is a requeued packet
-  if (m_requeued != 0)
+  if (!m_requeued.empty ())
     {
         // If the queue where the requeued packet is destined to is not stopped, return
         // the requeued packet; otherwise, return an empty packet.
         // If the device does not support flow control, the device queue is never stopped
-        if (!m_devQueueIface || !m_devQueueIface->GetTxQueue (m_requeued->GetTxQueueIndex ())->IsStopped ())
+        if (!m_devQueueIface || !m_devQueueIface->GetTxQueue (m_requeued.front ()->GetTxQueueIndex ())->IsStopped ())
           {
-            item = m_requeued;
-            m_requeued = 0;
+            item = m_requeued.front ();
+            m_requeued.pop_front ();
             if (m_peeked)
               {
                 // If the packet was requeued because a peek operation was requested
@@ -1041,7 +1263,7 @@ QueueDisc::DequeuePacket ()
             {
               item->AddHeader ();
             }
-          // Here, Linux tries bulk dequeues
+          // Here, Linux tries bulk dequeues (see Restart)
         }
     }
   return item;
@@ -1051,7 +1273,7 @@ void
 QueueDisc::Requeue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
-  m_requeued = item;
+  m_requeued.push_front (item);
   /// \todo netif_schedule (q);
 
   m_stats.nTotalRequeuedPackets++;
@@ -1075,15 +1297,7 @@ QueueDisc::Transmit (Ptr<QueueDiscItem> item)
       return false;
     }
 
-  // a single queue device makes no use of the priority tag
-  // a device that does not install a device queue interface likely makes no use of it as well
-  if (!m_devQueueIface || m_devQueueIface->GetNTxQueues () == 1)
-    {
-      SocketPriorityTag priorityTag;
-      item->GetPacket ()->RemovePacketTag (priorityTag);
-    }
-  NS_ASSERT_MSG (m_send, "Send callback not set");
-  m_send (item);
+  SendItem (item);
 
   // the behavior here slightly diverges from Linux. In Linux, it is advised that
   // the function called when a packet needs to be transmitted (ndo_start_xmit)
@@ -1110,4 +1324,49 @@ QueueDisc::Transmit (Ptr<QueueDiscItem> item)
   return true;
 }
 
+bool
+QueueDisc::TransmitBatch (void)
+{
+  NS_LOG_FUNCTION (this << m_batch.size ());
+
+  // the device has a single transmission queue, which may be stopped by
+  // any packet sent
+  Ptr<NetDeviceQueue> txq = (m_devQueueIface ? m_devQueueIface->GetTxQueue (0) : 0);
+  for (std::size_t i = 0; i < m_batch.size (); i++)
+    {
+      if (txq && txq->IsStopped ())
+        {
+          // requeue the packets not sent, so that they are sent first and
+          // in order when the device queue is woken up
+          for (std::size_t j = m_batch.size (); j > i; j--)
+            {
+              Requeue (m_batch[j - 1]);
+            }
+          m_batch.clear ();
+          return false;
+        }
+      // as in Transmit, the value returned by the device is ignored
+      SendItem (m_batch[i]);
+    }
+  m_batch.clear ();
+
+  return !(GetNPackets () == 0 || (txq && txq->IsStopped ()));
+}
+
+void
+QueueDisc::SendItem (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  // a single queue device makes no use of the priority tag
+  // a device that does not install a device queue interface likely makes no use of it as well
+  if (!m_devQueueIface || m_devQueueIface->GetNTxQueues () == 1)
+    {
+      SocketPriorityTag priorityTag;
+      item->GetPacket ()->RemovePacketTag (priorityTag);
+    }
+  NS_ASSERT_MSG (m_send, "Send callback not set");
+  m_send (item);
+}
+
 } // namespace ns3
@@ -26,6 +26,7 @@
 #include "ns3/queue-item.h"
 #include "ns3/queue-size.h"
 #include <vector>
+#include <deque>
 #include <map>
 #include <functional>
 #include <string>
@@ -168,6 +169,16 @@ enum QueueDiscSizePolicy
  * queue disc, the reason is "(Dropped by child queue disc) " followed by the
  * reason why the child queue disc dropped the packet.
  *
+ * The reasons are interned: each distinct reason string is registered once
+ * (QueueDisc::RegisterReason) and given an integer id, and the per-reason
+ * counters are kept in a table indexed by id. The queue discs register their
+ * reasons once per class, during the static initialization, and pass the ids
+ * when they drop or mark a packet; a child queue disc passes the id to its
+ * parent, which maps it to the id of its child drop reason. Counting a drop
+ * or a mark then neither looks up nor builds any string. The string-keyed
+ * maps of the Stats structure are a view of these counters, built by
+ * GetStats.
+ *
  * The QueueDisc base class provides the SojournTime trace source, which provides
  * the sojourn time of every packet dequeued from a queue disc, including packets
  * that are dropped or requeued after being dequeued. The sojourn time is taken
@@ -204,21 +215,21 @@ public:
     uint32_t nTotalDroppedPackets;
     /// Total packets dropped before enqueue
     uint32_t nTotalDroppedPacketsBeforeEnqueue;
-    /// Packets dropped before enqueue, for each reason
+    /// Packets dropped before enqueue, for each reason -- call GetStats first
     std::map<std::string, uint32_t> nDroppedPacketsBeforeEnqueue;
     /// Total packets dropped after dequeue
     uint32_t nTotalDroppedPacketsAfterDequeue;
-    /// Packets dropped after dequeue, for each reason
+    /// Packets dropped after dequeue, for each reason -- call GetStats first
     std::map<std::string, uint32_t> nDroppedPacketsAfterDequeue;
     /// Total dropped bytes
     uint64_t nTotalDroppedBytes;
     /// Total bytes dropped before enqueue
     uint64_t nTotalDroppedBytesBeforeEnqueue;
-    /// Bytes dropped before enqueue, for each reason
+    /// Bytes dropped before enqueue, for each reason -- call GetStats first
     std::map<std::string, uint64_t> nDroppedBytesBeforeEnqueue;
     /// Total bytes dropped after dequeue
     uint64_t nTotalDroppedBytesAfterDequeue;
-    /// Bytes dropped after dequeue, for each reason
+    /// Bytes dropped after dequeue, for each reason -- call GetStats first
     std::map<std::string, uint64_t> nDroppedBytesAfterDequeue;
     /// Total requeued packets
     uint32_t nTotalRequeuedPackets;
@@ -226,11 +237,11 @@ public:
     uint64_t nTotalRequeuedBytes;
     /// Total marked packets
     uint32_t nTotalMarkedPackets;
-    /// Marked packets, for each reason
+    /// Marked packets, for each reason -- call GetStats first
     std::map<std::string, uint32_t> nMarkedPackets;
     /// Total marked bytes
     uint32_t nTotalMarkedBytes;
-    /// Marked bytes, for each reason
+    /// Marked bytes, for each reason -- call GetStats first
     std::map<std::string, uint64_t> nMarkedBytes;
 
     /// constructor
@@ -384,6 +395,18 @@ public:
    */
   virtual uint32_t GetQuota (void) const;
 
+  /**
+   * \brief Set the maximum number of packets dequeued at once by a qdisc run
+   * \param batchSize the maximum number of packets dequeued at once
+   */
+  void SetBatchSize (uint32_t batchSize);
+
+  /**
+   * \brief Get the maximum number of packets dequeued at once by a qdisc run
+   * \return the maximum number of packets dequeued at once
+   */
+  uint32_t GetBatchSize (void) const;
+
   /**
    * Pass a packet to store to the queue discipline. This function only updates
    * the statistics and calls the (private) DoEnqueue function, which must be
@@ -402,6 +425,25 @@ public:
    */
   Ptr<QueueDiscItem> Dequeue (void);
 
+  /**
+   * Pass a batch of packets to store to the queue discipline, as if Enqueue
+   * were called for each of them in turn, but checking the consistency of
+   * the statistics once for the whole batch.
+   * \param items the items to enqueue
+   * \return the number of items enqueued (the other items were dropped)
+   */
+  std::size_t EnqueueBatch (const std::vector<Ptr<QueueDiscItem> > &items);
+
+  /**
+   * Extract at most maxItems packets from the queue disc, as if Dequeue were
+   * called for each of them in turn, but checking the consistency of the
+   * statistics once for the whole batch, and append them to a vector.
+   * \param items the vector the dequeued items are appended to
+   * \param maxItems the maximum number of items to dequeue
+   * \return the number of items dequeued
+   */
+  std::size_t DequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, std::size_t maxItems);
+
   /**
    * Get a copy of the next packet the queue discipline will extract. This
    * function only calls the (private) DoPeek function. This base class provides
@@ -512,9 +554,31 @@ public:
    */
   virtual WakeMode GetWakeMode (void) const;
 
+  /// Integer id of an interned drop or mark reason
+  typedef uint32_t ReasonId;
+
+  /**
+   * \brief Register a drop or mark reason
+   *
+   * Registering the same string again returns the same id. The ids are
+   * shared by all the queue discs.
+   *
+   * \param reason the reason
+   * \return the id of the reason
+   */
+  static ReasonId RegisterReason (std::string reason);
+
+  /**
+   * \brief Get the string of a registered reason
+   * \param id the id of the reason
+   * \return the reason, valid until the end of the program
+   */
+  static const char* GetReasonName (ReasonId id);
+
   // Reasons for dropping packets
   static constexpr const char* INTERNAL_QUEUE_DROP = "Dropped by internal queue";    //!< Packet dropped by an internal queue
   static constexpr const char* CHILD_QUEUE_DISC_DROP = "(Dropped by child queue disc) "; //!< Packet dropped by a child queue disc
+  static const ReasonId INTERNAL_QUEUE_DROP_ID;  //!< Id of INTERNAL_QUEUE_DROP
 
 protected:
   /**
@@ -562,6 +626,57 @@ protected:
    */
   bool Mark (Ptr<QueueDiscItem> item, const char* reason);
 
+  /**
+   *  \brief Perform the actions required when the queue disc is notified of
+   *         a packet dropped before enqueue
+   *  \param item item that was dropped
+   *  \param reason the id of the reason why the item was dropped
+   *  Same as the method taking a string, for reasons registered with
+   *  RegisterReason
+   */
+  void DropBeforeEnqueue (Ptr<const QueueDiscItem> item, ReasonId reason);
+
+  /**
+   *  \brief Perform the actions required when the queue disc is notified of
+   *         a packet dropped after dequeue
+   *  \param item item that was dropped
+   *  \param reason the id of the reason why the item was dropped
+   *  Same as the method taking a string, for reasons registered with
+   *  RegisterReason
+   */
+  void DropAfterDequeue (Ptr<const QueueDiscItem> item, ReasonId reason);
+
+  /**
+   *  \brief Marks the given packet and, if successful, updates the counters
+   *         associated with the given reason
+   *  \param item item that has to be marked
+   *  \param reason the id of the reason why the item has to be marked
+   *  \return true if the item was successfully marked, false otherwise
+   *  Same as the method taking a string, for reasons registered with
+   *  RegisterReason
+   */
+  bool Mark (Ptr<QueueDiscItem> item, ReasonId reason);
+
+  /**
+   *  \brief Perform the actions required when the queue disc is notified of
+   *         a packet enqueue
+   *  \param item item that was enqueued
+   *  This method is called by the internal queues and the child queue discs;
+   *  subclasses storing packets by themselves must call it for each packet
+   *  they enqueue
+   */
+  void PacketEnqueued (Ptr<const QueueDiscItem> item);
+
+  /**
+   *  \brief Perform the actions required when the queue disc is notified of
+   *         a packet dequeue
+   *  \param item item that was dequeued
+   *  This method is called by the internal queues and the child queue discs;
+   *  subclasses storing packets by themselves must call it for each packet
+   *  they dequeue (including the packets then dropped after dequeue)
+   */
+  void PacketDequeued (Ptr<const QueueDiscItem> item);
+
 private:
   /**
    * \brief Copy constructor
@@ -650,9 +765,14 @@ private:
   /**
    * Modelled after the Linux function qdisc_restart (net/sched/sch_generic.c)
    * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling Transmit).
-   * \return true if a packet is successfully sent to the device.
+   * If the batch size is larger than one and the device has a single
+   * transmission queue, which is not stopped, further packets are dequeued
+   * at once (as the bulk dequeue of Linux), as many as the device queue can
+   * store, and sent to the device in turn (by calling TransmitBatch).
+   * \param packets set to the number of packets dequeued.
+   * \return true if the packets are successfully sent to the device.
    */
-  bool Restart (void);
+  bool Restart (uint32_t &packets);
 
   /**
    * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
@@ -677,18 +797,20 @@ private:
   bool Transmit (Ptr<QueueDiscItem> item);
 
   /**
-   *  \brief Perform the actions required when the queue disc is notified of
-   *         a packet enqueue
-   *  \param item item that was enqueued
+   * Send the batch of packets dequeued at once to the device, as Transmit
+   * does for a packet. When the device queue is stopped, the packets not
+   * sent yet are requeued, in order, as Linux does with the rest of a bulk
+   * dequeued list.
+   * \return true if the device queue is not stopped and the queue disc is not empty
    */
-  void PacketEnqueued (Ptr<const QueueDiscItem> item);
+  bool TransmitBatch (void);
 
   /**
-   *  \brief Perform the actions required when the queue disc is notified of
-   *         a packet dequeue
-   *  \param item item that was dequeued
+   * Send a packet to the receiving object through the send callback.
+   * \param item the packet to send
    */
-  void PacketDequeued (Ptr<const QueueDiscItem> item);
+  void SendItem (Ptr<QueueDiscItem> item);
+
 
   static const uint32_t DEFAULT_QUOTA = 64; //!< Default quota (as in /proc/sys/net/core/dev_weight)
 
@@ -701,14 +823,78 @@ private:
   TracedCallback<Time> m_sojourn;   //!< Sojourn time of the latest dequeued packet
   QueueSize m_maxSize;              //!< max queue size
 
+  /// Counters kept for each reason
+  struct ReasonStats
+  {
+    uint32_t nDroppedPacketsBeforeEnqueue;  //!< Packets dropped before enqueue
+    uint64_t nDroppedBytesBeforeEnqueue;    //!< Bytes dropped before enqueue
+    uint32_t nDroppedPacketsAfterDequeue;   //!< Packets dropped after dequeue
+    uint64_t nDroppedBytesAfterDequeue;     //!< Bytes dropped after dequeue
+    uint32_t nMarkedPackets;                //!< Marked packets
+    uint64_t nMarkedBytes;                  //!< Marked bytes
+  };
+
+  /// A reason string given to this queue disc, and its id
+  struct ReasonCacheEntry
+  {
+    const char* string;  //!< The string given
+    ReasonId id;         //!< The id of the string
+  };
+
+  /// Marks the child reasons whose id is not known yet
+  static const ReasonId NO_REASON = 0xffffffff;
+
+  /**
+   * \brief Get the id of a reason string given to this queue disc
+   *
+   * Only used by the methods taking a string, which the queue discs of this
+   * module do not call: they pass the ids of their reasons.
+   *
+   * \param reason the reason
+   * \return the id of the reason
+   */
+  ReasonId LookupReason (const char* reason);
+
+  /**
+   * \brief Get the id of the reason of a packet dropped by a child queue disc
+   * \param reason the id of the reason why the child queue disc dropped the packet
+   * \return the id of the child queue disc drop reason
+   */
+  ReasonId GetChildReason (ReasonId reason);
+
+  /**
+   * \brief Count a packet dropped by a child queue disc before enqueue
+   * \param item the dropped item
+   * \param reason the id of the reason why the child queue disc dropped the packet
+   */
+  void ChildDropBeforeEnqueue (Ptr<const QueueDiscItem> item, ReasonId reason);
+
+  /**
+   * \brief Count a packet dropped by a child queue disc after dequeue
+   * \param item the dropped item
+   * \param reason the id of the reason why the child queue disc dropped the packet
+   */
+  void ChildDropAfterDequeue (Ptr<const QueueDiscItem> item, ReasonId reason);
+
+  /**
+   * \brief Get the counters of a reason
+   * \param id the id of the reason
+   * \return the counters of the reason
+   */
+  ReasonStats& GetReasonStats (ReasonId id);
+
   Stats m_stats;                    //!< The collected statistics
+  std::vector<ReasonStats> m_reasonStats;         //!< Counters, indexed by reason id
+  std::vector<ReasonCacheEntry> m_reasonCache;    //!< Ids of the reasons given to this queue disc
+  std::vector<ReasonId> m_childReasons;           //!< Child queue disc drop reason ids, indexed by the child reason id
   uint32_t m_quota;                 //!< Maximum number of packets dequeued in a qdisc run
+  uint32_t m_batchSize;             //!< Maximum number of packets dequeued at once in a qdisc run
+  std::vector<Ptr<QueueDiscItem> > m_batch;  //!< The packets dequeued at once, being sent
   Ptr<NetDeviceQueueInterface> m_devQueueIface;   //!< NetDevice queue interface
   SendCallback m_send;              //!< Callback used to send a packet to the receiving object
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
-  Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
+  std::deque<Ptr<QueueDiscItem> > m_requeued;  //!< The packets that failed to be transmitted, in order
   bool m_peeked;                    //!< A packet was dequeued because Peek was called
-  std::string m_childQueueDiscDropMsg;  //!< Reason why a packet was dropped by a child queue disc
   QueueDiscSizePolicy m_sizePolicy;     //!< The queue disc size policy
   bool m_prohibitChangeMode;            //!< True if changing mode is prohibited
 
@@ -729,17 +915,15 @@ private:
 
   /// Type for the function objects notifying that a packet has been dropped by an internal queue
   typedef std::function<void (Ptr<const QueueDiscItem>)> InternalQueueDropFunctor;
-  /// Type for the function objects notifying that a packet has been dropped by a child queue disc
-  typedef std::function<void (Ptr<const QueueDiscItem>, const char*)> ChildQueueDiscDropFunctor;
 
   /// Function object called when an internal queue dropped a packet before enqueue
   InternalQueueDropFunctor m_internalQueueDbeFunctor;
   /// Function object called when an internal queue dropped a packet after dequeue
   InternalQueueDropFunctor m_internalQueueDadFunctor;
-  /// Function object called when a child queue disc dropped a packet before enqueue
-  ChildQueueDiscDropFunctor m_childQueueDiscDbeFunctor;
-  /// Function object called when a child queue disc dropped a packet after dequeue
-  ChildQueueDiscDropFunctor m_childQueueDiscDadFunctor;
+  /// Callback of the parent queue disc, called when this queue disc dropped a packet before enqueue
+  Callback<void, Ptr<const QueueDiscItem>, ReasonId> m_parentDbeCallback;
+  /// Callback of the parent queue disc, called when this queue disc dropped a packet after dequeue
+  Callback<void, Ptr<const QueueDiscItem>, ReasonId> m_parentDadCallback;
 };
 
 /**
@@ -71,6 +71,11 @@ NS_LOG_COMPONENT_DEFINE ("RedQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED (RedQueueDisc);
 
+const QueueDisc::ReasonId RedQueueDisc::UNFORCED_DROP_ID = QueueDisc::RegisterReason (UNFORCED_DROP);
+const QueueDisc::ReasonId RedQueueDisc::FORCED_DROP_ID = QueueDisc::RegisterReason (FORCED_DROP);
+const QueueDisc::ReasonId RedQueueDisc::UNFORCED_MARK_ID = QueueDisc::RegisterReason (UNFORCED_MARK);
+const QueueDisc::ReasonId RedQueueDisc::FORCED_MARK_ID = QueueDisc::RegisterReason (FORCED_MARK);
+
 TypeId RedQueueDisc::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::RedQueueDisc")
@@ -408,20 +413,20 @@ RedQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 
   if (dropType == DTYPE_UNFORCED)
     {
-      if (!m_useEcn || !Mark (item, UNFORCED_MARK))
+      if (!m_useEcn || !Mark (item, UNFORCED_MARK_ID))
         {
           NS_LOG_DEBUG ("\t Dropping due to Prob Mark " << m_qAvg);
-          DropBeforeEnqueue (item, UNFORCED_DROP);
+          DropBeforeEnqueue (item, UNFORCED_DROP_ID);
           return false;
         }
       NS_LOG_DEBUG ("\t Marking due to Prob Mark " << m_qAvg);
     }
   else if (dropType == DTYPE_FORCED)
     {
-      if (m_useHardDrop || !m_useEcn || !Mark (item, FORCED_MARK))
+      if (m_useHardDrop || !m_useEcn || !Mark (item, FORCED_MARK_ID))
         {
           NS_LOG_DEBUG ("\t Dropping due to Hard Mark " << m_qAvg);
-          DropBeforeEnqueue (item, FORCED_DROP);
+          DropBeforeEnqueue (item, FORCED_DROP_ID);
           if (m_isNs1Compat)
             {
               m_count = 0;
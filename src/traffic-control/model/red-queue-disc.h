@@ -198,6 +198,11 @@ public:
   // Reasons for marking packets
   static constexpr const char* UNFORCED_MARK = "Unforced mark";  //!< Early probability marks
   static constexpr const char* FORCED_MARK = "Forced mark";      //!< Forced marks, m_qAvg > m_maxTh
+  // Ids of the reasons, registered once for the class
+  static const ReasonId UNFORCED_DROP_ID;  //!< Id of UNFORCED_DROP
+  static const ReasonId FORCED_DROP_ID;  //!< Id of FORCED_DROP
+  static const ReasonId UNFORCED_MARK_ID;  //!< Id of UNFORCED_MARK
+  static const ReasonId FORCED_MARK_ID;  //!< Id of FORCED_MARK
 
 protected:
   /**
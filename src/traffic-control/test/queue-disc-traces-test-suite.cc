@@ -555,6 +555,37 @@ QueueDiscTracesTestCase::DoRun (void)
   CheckDroppedBeforeEnqueue (child, 1, pktSizeUnit * 5);
   CheckDroppedAfterDequeue (child, 2, pktSizeUnit * 3);
 
+  // Check the counters kept for each reason
+  std::string childDbe = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::BEFORE_ENQUEUE;
+  std::string childDad = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::AFTER_DEQUEUE;
+  QueueDisc::Stats stats = child->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (TestChildQueueDisc::BEFORE_ENQUEUE), 1,
+                         "Verify the number of packets dropped before enqueue by the child");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (TestChildQueueDisc::AFTER_DEQUEUE), 2,
+                         "Verify the number of packets dropped after dequeue by the child");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (TestChildQueueDisc::AFTER_DEQUEUE), pktSizeUnit * 3,
+                         "Verify the number of bytes dropped after dequeue by the child");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childDbe), 0,
+                         "Verify that the child has not counted drops by a child queue disc");
+  stats = root->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childDbe), 1,
+                         "Verify the number of packets dropped before enqueue by the child queue disc");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (childDbe), pktSizeUnit * 5,
+                         "Verify the number of bytes dropped before enqueue by the child queue disc");
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsAfterDequeue.size (), 1,
+                         "Verify the number of reasons of the drops after dequeue");
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsAfterDequeue[childDad], 2,
+                         "Verify the number of packets dropped after dequeue by the child queue disc");
+
+  // The reasons are interned
+  QueueDisc::ReasonId id = QueueDisc::RegisterReason (TestChildQueueDisc::BEFORE_ENQUEUE);
+  NS_TEST_EXPECT_MSG_EQ (QueueDisc::RegisterReason (std::string ("Before ") + "enqueue"), id,
+                         "Verify that a reason registered twice keeps its id");
+  NS_TEST_EXPECT_MSG_EQ (std::string (QueueDisc::GetReasonName (id)), TestChildQueueDisc::BEFORE_ENQUEUE,
+                         "Verify the name of a registered reason");
+  NS_TEST_EXPECT_MSG_NE (QueueDisc::RegisterReason (childDbe), id,
+                         "Verify that distinct reasons have distinct ids");
+
   Simulator::Destroy ();
 }
 
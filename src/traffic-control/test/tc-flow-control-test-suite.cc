@@ -103,8 +103,9 @@ public:
    * Constructor
    *
    * \param tt the test type
+   * \param batchSize the batch size of the queue disc
    */
-  TcFlowControlTestCase (QueueSizeUnit tt);
+  TcFlowControlTestCase (QueueSizeUnit tt, uint32_t batchSize = 1);
   virtual ~TcFlowControlTestCase ();
 private:
   virtual void DoRun (void);
@@ -136,11 +137,14 @@ private:
    */
   void CheckPacketsInQueueDisc (Ptr<NetDevice> dev, uint16_t nPackets, const char* msg);
   QueueSizeUnit m_type;       //!< the test type
+  uint32_t m_batchSize;       //!< the batch size of the queue disc
 };
 
-TcFlowControlTestCase::TcFlowControlTestCase (QueueSizeUnit tt)
-  : TestCase ("Test the operation of the flow control mechanism"),
-    m_type (tt)
+TcFlowControlTestCase::TcFlowControlTestCase (QueueSizeUnit tt, uint32_t batchSize)
+  : TestCase ("Test the operation of the flow control mechanism"
+              + std::string (batchSize > 1 ? " with batched dequeues" : "")),
+    m_type (tt),
+    m_batchSize (batchSize)
 {
 }
 
@@ -152,6 +156,19 @@ void
 TcFlowControlTestCase::SendPackets (Ptr<Node> n, uint16_t nPackets)
 {
   Ptr<TrafficControlLayer> tc = n->GetObject<TrafficControlLayer> ();
+  if (m_batchSize > 1)
+    {
+      // enqueue all the packets before dequeuing them in batches
+      Ptr<QueueDisc> qdisc = tc->GetRootQueueDiscOnDevice (n->GetDevice (0));
+      std::vector<Ptr<QueueDiscItem> > items;
+      for (uint16_t i = 0; i < nPackets; i++)
+        {
+          items.push_back (Create<QueueDiscTestItem> (Create<Packet> (1000)));
+        }
+      NS_TEST_EXPECT_MSG_EQ (qdisc->EnqueueBatch (items), nPackets, "All the packets should have been enqueued");
+      qdisc->Run ();
+      return;
+    }
   for (uint16_t i = 0; i < nPackets; i++)
     {
       tc->Send (n->GetDevice (0), Create<QueueDiscTestItem> (Create<Packet> (1000)));
@@ -207,6 +224,11 @@ TcFlowControlTestCase::DoRun (void)
 
   TrafficControlHelper tch = TrafficControlHelper::Default ();
   tch.Install (txDev);
+  // the packets dequeued at once are bounded by the room in the device queue,
+  // hence batched dequeues do not change the packets in the queues, even if
+  // all the packets are enqueued before the queue disc is run
+  Ptr<QueueDisc> qdisc = n.Get (0)->GetObject<TrafficControlLayer> ()->GetRootQueueDiscOnDevice (txDev);
+  qdisc->SetBatchSize (m_batchSize);
 
   // transmit 10 packets at time 0
   Simulator::Schedule (Time (Seconds (0)), &TcFlowControlTestCase::SendPackets,
@@ -360,6 +382,11 @@ TcFlowControlTestCase::DoRun (void)
     }
 
   Simulator::Run ();
+
+  // no packet was sent to a stopped device queue
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetStats ().nTotalRequeuedPackets, 0, "No packet should have been requeued");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetStats ().nTotalSentPackets, 10, "All the packets should have been sent");
+
   Simulator::Destroy ();
 }
 
@@ -377,5 +404,7 @@ public:
   {
     AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::PACKETS), TestCase::QUICK);
     AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::BYTES), TestCase::QUICK);
+    AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::PACKETS, 4), TestCase::QUICK);
+    AddTestCase (new TcFlowControlTestCase (QueueSizeUnit::BYTES, 4), TestCase::QUICK);
   }
 } g_tcFlowControlTestSuite; ///< the test suite
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the construction of objects
+// with many Attributes: single objects created with CreateObject and
+// through an ObjectFactory with some Attributes set, and whole nodes
+// with an internet stack and point-to-point devices installed by the
+// helpers. A Config::SetDefault is done halfway, so that the cost of
+// a change of the defaults is measured too.
+// Sample usage:  ./waf --run 'bench-construction --nodes=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * Print the elapsed time of a construction step.
+ *
+ * \param name the name of the step
+ * \param elapsed the elapsed time, in milliseconds
+ * \param n the number of constructions of the step
+ */
+static void
+Report (std::string name, int64_t elapsed, uint32_t n)
+{
+  std::cout << name << ": " << elapsed << " ms, "
+            << (elapsed > 0 ? n * 1000.0 / elapsed : 0) << " constructions/s" << std::endl;
+}
+
+/**
+ * Create objects of a type and print the construction rate.
+ *
+ * \param name the name of the step
+ * \param n the number of objects
+ */
+template <typename T>
+static void
+RunCreateObject (std::string name, uint32_t n)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      CreateObject<T> ();
+    }
+  Report (name, clock.End (), n);
+}
+
+/**
+ * Create TcpSocketBase objects through a factory which sets some of
+ * their Attributes, and print the construction rate.
+ *
+ * \param n the number of objects
+ */
+static void
+RunFactory (uint32_t n)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (TcpSocketBase::GetTypeId ());
+  factory.Set ("SndBufSize", UintegerValue (262144));
+  factory.Set ("RcvBufSize", UintegerValue (262144));
+  factory.Set ("SegmentSize", UintegerValue (1448));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      factory.Create ();
+    }
+  Report ("TcpSocketBase from an ObjectFactory", clock.End (), n);
+}
+
+/**
+ * Create nodes with an internet stack and a point-to-point link to
+ * the next node, and print the construction rate of the nodes.
+ *
+ * \param nNodes the number of nodes
+ */
+static void
+RunTopology (uint32_t nNodes)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  for (uint32_t i = 0; i + 1 < nNodes; i++)
+    {
+      p2p.Install (nodes.Get (i), nodes.Get (i + 1));
+    }
+  Report ("nodes with internet stack and point-to-point devices", clock.End (), nNodes);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 1000;
+  uint32_t nObjects = 100000;
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("objects", "number of single objects of each type", nObjects);
+  cmd.Parse (argc, argv);
+
+  RunCreateObject<TcpSocketBase> ("TcpSocketBase", nObjects);
+  RunCreateObject<Ipv4L3Protocol> ("Ipv4L3Protocol", nObjects);
+  RunFactory (nObjects);
+  RunTopology (nNodes);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  std::cout << "after Config::SetDefault:" << std::endl;
+  RunCreateObject<TcpSocketBase> ("TcpSocketBase", nObjects);
+  RunTopology (nNodes);
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the cost of flow monitoring with
+// many concurrent flows: the packets of the flows, interleaved, are
+// classified and reported to a FlowMonitor as they would be by the probes
+// of the nodes along their path (first transmission, forwarding at each
+// hop, reception), with a window of packets in flight.  The packets can be
+// sampled and the per-flow statistics replaced by sketches.
+// Sample usage:  ./waf --run 'bench-flow-monitor --flows=100000 --packets=2000000'
+//                ./waf --run 'bench-flow-monitor --sampling=100 --sketches=1'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A probe reporting the packets handed to it by the benchmark.
+ */
+class BenchFlowProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor
+   */
+  BenchFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/// A packet in flight
+struct InFlight
+{
+  FlowId flowId;          //!< Flow id
+  FlowPacketId packetId;  //!< Packet id
+  uint32_t size;          //!< Packet size
+};
+
+/**
+ * Hand the packets of the flows to the monitor, as the probes would.
+ *
+ * \param monitor the FlowMonitor
+ * \param classifier the flow classifier
+ * \param probes the probes along the path of the packets
+ * \param nFlows the number of flows
+ * \param nPackets the number of packets
+ * \param window the number of packets in flight
+ */
+static void
+RunPackets (Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier,
+            std::vector<Ptr<FlowProbe> > &probes, uint32_t nFlows, uint32_t nPackets, uint32_t window)
+{
+  uint32_t nHops = probes.size () - 2;
+
+  // one UDP payload per flow, with the flow ports
+  std::vector<Ipv4Header> headers (nFlows);
+  std::vector<Ptr<Packet> > payloads (nFlows);
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      headers[i].SetSource (Ipv4Address (0x0a000000 + i / 1000));
+      headers[i].SetDestination (Ipv4Address (0x0b000000 + i % 1000));
+      headers[i].SetProtocol (17);
+      headers[i].SetPayloadSize (1000);
+      UdpHeader udp;
+      udp.SetSourcePort (49152 + i % 10000);
+      udp.SetDestinationPort (9);
+      payloads[i] = Create<Packet> (1000 - udp.GetSerializedSize ());
+      payloads[i]->AddHeader (udp);
+    }
+
+  std::vector<InFlight> inFlight (window);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nPackets + window; i++)
+    {
+      InFlight &slot = inFlight[i % window];
+      if (i >= window)
+        {
+          // the packet sent window packets ago reaches its destination
+          for (uint32_t hop = 1; hop <= nHops; hop++)
+            {
+              monitor->ReportForwarding (probes[hop], slot.flowId, slot.packetId, slot.size);
+            }
+          monitor->ReportLastRx (probes[nHops + 1], slot.flowId, slot.packetId, slot.size);
+        }
+      if (i < nPackets)
+        {
+          uint32_t flow = i % nFlows;
+          classifier->Classify (headers[flow], payloads[flow], &slot.flowId, &slot.packetId);
+          slot.size = 1020;
+          monitor->ReportFirstTx (probes[0], slot.flowId, slot.packetId, slot.size);
+        }
+    }
+  int64_t elapsed = clock.End ();
+
+  uint64_t rxPackets = monitor->GetSketchTotals ().rxPackets;
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI it = stats.begin (); it != stats.end (); it++)
+    {
+      rxPackets += it->second.rxPackets;
+    }
+
+  std::cout << nFlows << " flows, " << nPackets << " packets, " << nHops << " hops: "
+            << elapsed << " ms, " << (elapsed > 0 ? nPackets * 1000.0 / elapsed : 0) << " packets/s ("
+            << stats.size () << " flows, " << rxPackets << " packets received)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFlows = 100000;
+  uint32_t nPackets = 1000000;
+  uint32_t nHops = 3;
+  uint32_t window = 0;
+  uint32_t sampling = 1;
+  bool sketches = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("flows", "number of concurrent flows", nFlows);
+  cmd.AddValue ("packets", "number of packets", nPackets);
+  cmd.AddValue ("hops", "number of forwarding hops of the packets", nHops);
+  cmd.AddValue ("window", "number of packets in flight (0: one per flow)", window);
+  cmd.AddValue ("sampling", "monitor one packet in this many", sampling);
+  cmd.AddValue ("sketches", "replace the per-flow statistics by sketches", sketches);
+  cmd.Parse (argc, argv);
+  if (window == 0)
+    {
+      window = nFlows;
+    }
+
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("SamplingMode", EnumValue (FlowMonitor::SAMPLE_PACKETS));
+  monitor->SetAttribute ("SamplingRate", UintegerValue (sampling));
+  monitor->SetAttribute ("EnableSketches", BooleanValue (sketches));
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  monitor->AddFlowClassifier (classifier);
+  std::vector<Ptr<FlowProbe> > probes;
+  for (uint32_t i = 0; i < nHops + 2; i++)
+    {
+      probes.push_back (Create<BenchFlowProbe> (monitor));
+    }
+  monitor->StartRightNow ();
+
+  // the packets are handed from within an event, as in a simulation
+  Simulator::ScheduleNow (&RunPackets, monitor, classifier, probes, nFlows, nPackets, window);
+  Simulator::Stop (Seconds (0));
+  Simulator::Run ();
+
+  monitor = 0;
+  probes.clear ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the enqueue and dequeue operations
+// of the FqCoDel queue disc with many active flows: the packets of the
+// flows, interleaved, are enqueued and dequeued with a constant backlog,
+// so that flows keep becoming active and inactive.
+// With a service percentage below 100, the queue disc is overloaded and the
+// packets beyond its limit are dropped, which measures the cost of the drop
+// path.
+// Sample usage:  ./waf --run 'bench-fq-codel --flows=10000 --packets=2000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Enqueue and dequeue the packets of the flows.
+ *
+ * \param queueDisc the queue disc
+ * \param nFlows the number of flows
+ * \param nPackets the number of packets
+ * \param backlog the number of packets kept in the queue disc
+ * \param service the percentage of enqueues followed by a dequeue
+ */
+static void
+RunPackets (Ptr<QueueDisc> queueDisc, uint32_t nFlows, uint32_t nPackets, uint32_t backlog, uint32_t service)
+{
+  // one UDP payload per flow, with the flow ports
+  std::vector<Ipv4Header> headers (nFlows);
+  std::vector<Ptr<Packet> > payloads (nFlows);
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      headers[i].SetSource (Ipv4Address (0x0a000000 + i / 1000));
+      headers[i].SetDestination (Ipv4Address (0x0b000000 + i % 1000));
+      headers[i].SetProtocol (17);
+      headers[i].SetPayloadSize (1000);
+      UdpHeader udp;
+      udp.SetSourcePort (49152 + i % 10000);
+      udp.SetDestinationPort (9);
+      payloads[i] = Create<Packet> (1000 - udp.GetSerializedSize ());
+      payloads[i]->AddHeader (udp);
+    }
+
+  Address dest;
+  uint32_t dequeued = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      uint32_t flow = i % nFlows;
+      queueDisc->Enqueue (Create<Ipv4QueueDiscItem> (payloads[flow], dest, 0, headers[flow]));
+      if (i >= backlog && i % 100 < service && queueDisc->Dequeue ())
+        {
+          dequeued++;
+        }
+    }
+  while (queueDisc->Dequeue ())
+    {
+      dequeued++;
+    }
+  int64_t elapsed = clock.End ();
+
+  QueueDisc::Stats stats = queueDisc->GetStats ();
+  std::cout << nFlows << " flows, " << nPackets << " packets, backlog " << backlog << ": "
+            << elapsed << " ms, " << (elapsed > 0 ? nPackets * 1000.0 / elapsed : 0) << " packets/s ("
+            << dequeued << " dequeued, " << stats.nTotalDroppedPackets << " dropped)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFlows = 10000;
+  uint32_t nPackets = 1000000;
+  uint32_t backlog = 5000;
+  uint32_t buckets = 16384;
+  uint32_t limit = 10240;
+  uint32_t service = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("flows", "number of active flows", nFlows);
+  cmd.AddValue ("packets", "number of packets", nPackets);
+  cmd.AddValue ("backlog", "number of packets kept in the queue disc", backlog);
+  cmd.AddValue ("buckets", "number of flow queues of the queue disc", buckets);
+  cmd.AddValue ("limit", "maximum number of packets in the queue disc", limit);
+  cmd.AddValue ("service", "percentage of the enqueues followed by a dequeue", service);
+  cmd.Parse (argc, argv);
+
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("Flows", UintegerValue (buckets),
+                                                                                 "MaxSize", QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, limit)));
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  // the packets are handled from within an event, as in a simulation
+  Simulator::ScheduleNow (&RunPackets, queueDisc, nFlows, nPackets, backlog, service);
+  Simulator::Stop (Seconds (0));
+  Simulator::Run ();
+
+  queueDisc = 0;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the logging statements: the
+// cost of NS_LOG and NS_LOG_RECORD statements when their log component
+// is disabled, and when it is enabled, with the output discarded.  The
+// NS_LOG statements are compiled only in debug builds.
+// Sample usage:  ./waf --run 'bench-log --statements=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/log.h"
+#include "ns3/log-record.h"
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BenchLog");
+
+/**
+ * A stream buffer which discards its output.
+ */
+class NullBuffer : public std::streambuf
+{
+protected:
+  virtual int overflow (int c)
+  {
+    return c;
+  }
+  virtual std::streamsize xsputn (const char *s, std::streamsize n)
+  {
+    return n;
+  }
+};
+
+/**
+ * Print the elapsed time of a series of statements.
+ *
+ * \param name the name of the series
+ * \param elapsed the elapsed time, in milliseconds
+ * \param n the number of statements
+ */
+static void
+Report (std::string name, int64_t elapsed, uint32_t n)
+{
+  std::cout << name << ": " << elapsed << " ms, "
+            << elapsed * 1e6 / n << " ns/statement" << std::endl;
+}
+
+/**
+ * Run NS_LOG statements, and print their cost.
+ *
+ * \param name the name of the series
+ * \param n the number of statements
+ */
+static void
+RunLog (std::string name, uint32_t n)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_LOG_DEBUG ("packet " << i << " of " << n / 2 << " bytes, ratio " << i * 0.5);
+    }
+  Report (name, clock.End (), n);
+}
+
+/**
+ * Run NS_LOG_RECORD statements, and print their cost, including the
+ * formatting of the records.
+ *
+ * \param name the name of the series
+ * \param n the number of statements
+ */
+static void
+RunRecord (std::string name, uint32_t n)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_LOG_RECORD_DEBUG ("packet {} of {} bytes, ratio {}", i, n / 2, i * 0.5);
+    }
+  LogRecorder::Flush ();
+  Report (name, clock.End (), n);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("statements", "number of statements of each series", n);
+  cmd.Parse (argc, argv);
+
+  NullBuffer null;
+  std::ostream nullStream (&null);
+  std::streambuf *clog = std::clog.rdbuf (&null);
+  LogRecorder::SetOutput (&nullStream);
+
+  RunLog ("NS_LOG, disabled", n);
+  RunRecord ("NS_LOG_RECORD, disabled", n);
+
+  g_log.Enable (LOG_LEVEL_DEBUG);
+  RunLog ("NS_LOG, enabled", n);
+  RunRecord ("NS_LOG_RECORD, enabled", n);
+  LogRecorder::SetMode (LogRecorder::KEEP_LAST);
+  RunRecord ("NS_LOG_RECORD, enabled, last records kept", n);
+
+  LogRecorder::SetOutput (0);
+  std::clog.rdbuf (clog);
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the transmission of many UDP flows
+// over a fast point-to-point link whose devices have one or several
+// transmission queues: with several queues, the flows are spread over the
+// queues by hashing, and the traffic control layer installs a multi-queue
+// root queue disc with an FqCoDel child queue disc per queue.  The packets
+// of the flows, interleaved, are sent faster than the link rate, so that
+// the queue discs are backlogged.
+// Sample usage:  ./waf --run 'bench-multiqueue --flows=1000 --txQueues=8'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Send a packet of a flow, and schedule the next packet.
+ *
+ * \param sockets the sockets of the flows
+ * \param next the index of the packet sent
+ * \param nPackets the number of packets
+ * \param interval the interval between two packets
+ */
+static void
+SendPacket (std::vector<Ptr<Socket> > *sockets, uint32_t next, uint32_t nPackets, Time interval)
+{
+  (*sockets)[next % sockets->size ()]->Send (Create<Packet> (1000));
+  if (++next < nPackets)
+    {
+      Simulator::Schedule (interval, &SendPacket, sockets, next, nPackets, interval);
+    }
+}
+
+/**
+ * Count the packets received.
+ *
+ * \param received the counter
+ * \param socket the receiving socket
+ */
+static void
+ReceivePackets (uint64_t *received, Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      (*received)++;
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFlows = 1000;
+  uint32_t nPackets = 1000000;
+  uint32_t nTxQueues = 1;
+  std::string dataRate = "100Gbps";
+
+  CommandLine cmd;
+  cmd.AddValue ("flows", "number of UDP flows", nFlows);
+  cmd.AddValue ("packets", "number of packets", nPackets);
+  cmd.AddValue ("txQueues", "number of transmission queues of the devices", nTxQueues);
+  cmd.AddValue ("dataRate", "data rate of the link", dataRate);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  p2p.SetChannelAttribute ("Delay", StringValue ("10us"));
+  p2p.SetNTxQueues (nTxQueues);
+  NetDeviceContainer devices = p2p.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint64_t received = 0;
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  sink->SetRecvCallback (MakeBoundCallback (&ReceivePackets, &received));
+  std::vector<Ptr<Socket> > sockets;
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      Ptr<Socket> socket = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+      socket->Bind ();
+      socket->Connect (InetSocketAddress (interfaces.GetAddress (1), 9));
+      sockets.push_back (socket);
+    }
+
+  // the packets are sent 10% faster than the link rate
+  Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice> (devices.Get (0));
+  Time interval = Seconds (DataRate (dataRate).CalculateBytesTxTime (1028).GetSeconds () * 0.9);
+  Simulator::Schedule (Seconds (1), &SendPacket, &sockets, 0, nPackets, interval);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  uint32_t minQueue = nPackets;
+  uint32_t maxQueue = 0;
+  for (std::size_t i = 0; i < device->GetNQueues (); i++)
+    {
+      uint32_t n = device->GetQueue (i)->GetTotalReceivedPackets ();
+      minQueue = std::min (minQueue, n);
+      maxQueue = std::max (maxQueue, n);
+    }
+  std::cout << nFlows << " flows, " << nPackets << " packets, " << device->GetNQueues () << " tx queues: "
+            << elapsed << " ms, " << (elapsed > 0 ? nPackets * 1000.0 / elapsed : 0) << " packets/s ("
+            << received << " received, " << minQueue << "-" << maxQueue << " packets per tx queue)"
+            << std::endl;
+
+  sockets.clear ();
+  sink = 0;
+  Simulator::Destroy ();
+  return 0;
+}
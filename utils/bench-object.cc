@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the GetObject lookups on the
+// aggregates of typical nodes: a node with an IPv4 (and optionally IPv6)
+// internet stack and a mobility model. The lookups are those done on the
+// hot paths of the models: the node and the stack from the protocols,
+// the mobility model from the channels, and a lookup of a type which is
+// not aggregated, and several of these lookups in turn.
+// Sample usage:  ./waf --run 'bench-object --nodes=100 --lookups=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Look a type up on the aggregates of the nodes and print the lookup rate.
+ *
+ * \param name the name of the lookup
+ * \param nodes the nodes
+ * \param nLookups the number of lookups
+ * \param from the aggregate of each node the lookups are done on
+ */
+template <typename T>
+static void
+RunLookups (std::string name, NodeContainer nodes, uint32_t nLookups, TypeId from)
+{
+  uint32_t n = nodes.GetN ();
+  std::vector<Ptr<Object> > objects;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      objects.push_back (nodes.Get (i)->GetObject<Object> (from));
+    }
+
+  uint32_t found = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      if (objects[i % n]->GetObject<T> () != 0)
+        {
+          found++;
+        }
+    }
+  int64_t elapsed = clock.End ();
+
+  std::cout << name << ": " << elapsed << " ms, "
+            << (elapsed > 0 ? nLookups / 1000.0 / elapsed : 0) << " Mlookups/s ("
+            << found << " found)" << std::endl;
+}
+
+/**
+ * Look several types up in turn on the nodes, as the models of a
+ * simulation do, and print the lookup rate.
+ *
+ * \param nodes the nodes
+ * \param nLookups the number of lookups
+ */
+static void
+RunMixedLookups (NodeContainer nodes, uint32_t nLookups)
+{
+  uint32_t n = nodes.GetN ();
+  uint32_t found = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nLookups / 4; i++)
+    {
+      Ptr<Node> node = nodes.Get (i % n);
+      found += (node->GetObject<Ipv4> () != 0);
+      found += (node->GetObject<MobilityModel> () != 0);
+      found += (node->GetObject<UdpL4Protocol> () != 0);
+      found += (node->GetObject<TrafficControlLayer> () != 0);
+    }
+  int64_t elapsed = clock.End ();
+
+  std::cout << "mixed from Node: " << elapsed << " ms, "
+            << (elapsed > 0 ? nLookups / 1000.0 / elapsed : 0) << " Mlookups/s ("
+            << found << " found)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 100;
+  uint32_t nLookups = 10000000;
+  bool ipv6 = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("lookups", "number of lookups of each kind", nLookups);
+  cmd.AddValue ("ipv6", "install the IPv6 stack too", ipv6);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (ipv6);
+  internet.Install (nodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      nodes.Get (i)->AggregateObject (CreateObject<ConstantPositionMobilityModel> ());
+    }
+
+  RunLookups<Node> ("Node from Ipv4L3Protocol", nodes, nLookups, Ipv4L3Protocol::GetTypeId ());
+  RunLookups<Ipv4> ("Ipv4 from Node", nodes, nLookups, Node::GetTypeId ());
+  RunLookups<Ipv4L3Protocol> ("Ipv4L3Protocol from UdpL4Protocol", nodes, nLookups, UdpL4Protocol::GetTypeId ());
+  RunLookups<TcpL4Protocol> ("TcpL4Protocol from Node", nodes, nLookups, Node::GetTypeId ());
+  RunLookups<TrafficControlLayer> ("TrafficControlLayer from Ipv4L3Protocol", nodes, nLookups, Ipv4L3Protocol::GetTypeId ());
+  RunLookups<MobilityModel> ("MobilityModel from Node", nodes, nLookups, Node::GetTypeId ());
+  RunLookups<Ipv6> ("Ipv6 from Node", nodes, nLookups, Node::GetTypeId ());
+  RunMixedLookups (nodes, nLookups);
+
+  nodes = NodeContainer ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the cost of pcap tracing: the same
+// packets are handed to a number of capture files (as if traced on as many
+// devices) without tracing, with synchronous writes, with writes done
+// on the background I/O thread, into a single multiplexed pcapng file, and
+// into compressed files.
+// Sample usage:  ./waf --run 'bench-pcap --files=1000 --packets=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/trace-helper.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Hand packets to the capture files, round robin.
+ *
+ * \param files the capture files (empty: no tracing)
+ * \param nPackets the number of packets
+ * \param size the size of the packets
+ * \returns the number of bytes handled, to keep the loop from being optimized out
+ */
+static uint64_t
+RunPackets (std::vector<Ptr<PcapFileWrapper> > &files, uint32_t nPackets, uint32_t size)
+{
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (size);
+      bytes += p->GetSize ();
+      if (!files.empty ())
+        {
+          files[i % files.size ()]->Write (MicroSeconds (i), p);
+        }
+    }
+  return bytes;
+}
+
+/**
+ * Run one configuration and print its throughput.
+ *
+ * \param name the configuration name
+ * \param nFiles the number of capture files (0: no tracing)
+ * \param async whether the files are written on the background thread
+ * \param multiplexed whether the packets are written into a single pcapng file
+ * \param compression the value of the "TraceCompression" global value
+ * \param nPackets the number of packets
+ * \param size the size of the packets
+ * \param snapLen the capture size
+ * \param prefix the prefix of the file names
+ */
+static void
+Bench (std::string name, uint32_t nFiles, bool async, bool multiplexed, std::string compression,
+       uint32_t nPackets, uint32_t size, uint32_t snapLen, std::string prefix)
+{
+  std::vector<Ptr<PcapFileWrapper> > files;
+  std::vector<std::string> filenames;
+
+  Config::SetGlobal ("TraceCompression", StringValue (compression));
+  SystemWallClockMs clock;
+  clock.Start ();
+  if (multiplexed)
+    {
+      PcapHelper::EnableMultiplexedOutput (prefix + ".pcapng");
+      filenames.push_back (prefix + ".pcapng");
+    }
+  PcapHelper pcapHelper;
+  for (uint32_t i = 0; i < nFiles; i++)
+    {
+      std::ostringstream oss;
+      oss << prefix << "-" << i << ".pcap";
+      Config::SetDefault ("ns3::PcapFileWrapper::AsyncWrite", BooleanValue (async));
+      files.push_back (pcapHelper.CreateFile (oss.str (), std::ios::out, PcapHelper::DLT_EN10MB, snapLen));
+      if (!multiplexed)
+        {
+          filenames.push_back (oss.str ());
+        }
+    }
+  uint64_t bytes = RunPackets (files, nPackets, size);
+  for (uint32_t i = 0; i < nFiles; i++)
+    {
+      files[i]->Close ();
+    }
+  PcapHelper::DisableMultiplexedOutput ();
+  int64_t elapsed = clock.End ();
+
+  uint64_t written = 0;
+  for (uint32_t i = 0; i < filenames.size (); i++)
+    {
+      std::ifstream file (filenames[i].c_str (), std::ios::binary | std::ios::ate);
+      written += file.tellg ();
+      file.close ();
+      std::remove (filenames[i].c_str ());
+    }
+
+  std::cout << name << ": " << elapsed << " ms, "
+            << (elapsed > 0 ? nPackets * 1000.0 / elapsed : 0) << " packets/s ("
+            << bytes / 1000000 << " MB, " << written / 1000000 << " MB written)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFiles = 100;
+  uint32_t nPackets = 1000000;
+  uint32_t size = 1500;
+  uint32_t snapLen = 65535;
+  std::string prefix = "bench-pcap";
+
+  CommandLine cmd;
+  cmd.AddValue ("files", "number of capture files", nFiles);
+  cmd.AddValue ("packets", "number of packets", nPackets);
+  cmd.AddValue ("size", "size of the packets", size);
+  cmd.AddValue ("snaplen", "capture size", snapLen);
+  cmd.AddValue ("prefix", "prefix of the capture files", prefix);
+  cmd.Parse (argc, argv);
+
+  Bench ("untraced", 0, false, false, "None", nPackets, size, snapLen, prefix);
+  Bench ("pcap", nFiles, false, false, "None", nPackets, size, snapLen, prefix);
+  Bench ("pcap-async", nFiles, true, false, "None", nPackets, size, snapLen, prefix);
+  Bench ("pcapng-multiplexed", nFiles, true, true, "None", nPackets, size, snapLen, prefix);
+  Bench ("pcap-lz", nFiles, true, false, "Lz", nPackets, size, snapLen, prefix);
+  Bench ("pcap-zlib", nFiles, true, false, "Zlib", nPackets, size, snapLen, prefix);
+  Bench ("pcapng-multiplexed-lz", nFiles, true, true, "Lz", nPackets, size, snapLen, prefix);
+
+  return 0;
+}
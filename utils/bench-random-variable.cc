@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the random variables: the
+// values drawn one at a time with GetValue, and in batches with
+// GetValues, from the uniform, exponential, Pareto and normal
+// distributions, with the MRG32k3a and the Philox generators.
+// Sample usage:  ./waf --run 'bench-random-variable --values=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/object-factory.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Draw values from a random variable, one at a time and in batches,
+ * and print the elapsed times.
+ *
+ * \param name the name of the series
+ * \param factory the factory of the random variable
+ * \param n the number of values
+ * \param batch the size of the batches
+ */
+static void
+Bench (std::string name, ObjectFactory factory, uint32_t n, uint32_t batch)
+{
+  Ptr<RandomVariableStream> variable = factory.Create<RandomVariableStream> ();
+  SystemWallClockMs clock;
+  double sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += variable->GetValue ();
+    }
+  int64_t single = clock.End ();
+
+  std::vector<double> values (batch);
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i += batch)
+    {
+      variable->GetValues (&values[0], batch);
+      for (uint32_t j = 0; j < batch; j++)
+        {
+          sum += values[j];
+        }
+    }
+  int64_t batched = clock.End ();
+
+  std::cout << name << ": GetValue " << single * 1e6 / n << " ns/value, "
+            << "GetValues " << batched * 1e6 / n << " ns/value"
+            << " (sum " << sum << ")" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+  uint32_t batch = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("values", "number of values of each series", n);
+  cmd.AddValue ("batch", "number of values of each call to GetValues", batch);
+  cmd.Parse (argc, argv);
+
+  RngStream::Generator generators[2] = { RngStream::MRG32K3A, RngStream::PHILOX };
+  std::string names[2] = { "MRG32k3a", "Philox" };
+  for (uint32_t g = 0; g < 2; g++)
+    {
+      RngSeedManager::SetGenerator (generators[g]);
+
+      ObjectFactory factory;
+      factory.SetTypeId ("ns3::UniformRandomVariable");
+      Bench (names[g] + " uniform", factory, n, batch);
+      factory.SetTypeId ("ns3::ExponentialRandomVariable");
+      Bench (names[g] + " exponential", factory, n, batch);
+      factory.SetTypeId ("ns3::ParetoRandomVariable");
+      Bench (names[g] + " Pareto", factory, n, batch);
+      factory.SetTypeId ("ns3::NormalRandomVariable");
+      Bench (names[g] + " normal", factory, n, batch);
+    }
+  return 0;
+}
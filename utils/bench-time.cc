@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the Time arithmetic done for
+// each packet: the construction of Times from values in seconds and
+// milliseconds, their conversion back to numbers, the scaling of Times,
+// and the computation of the transmission time of a packet by DataRate.
+// The operations run in an event, as in a simulation: before
+// Simulator::Run, the Times are recorded in case the resolution changes.
+// Sample usage:  ./waf --run 'bench-time --operations=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/data-rate.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * Print the elapsed time of a series of operations.
+ *
+ * \param name the name of the series
+ * \param elapsed the elapsed time, in milliseconds
+ * \param n the number of operations
+ * \param sum the sum of the results, to keep them alive
+ */
+static void
+Report (std::string name, int64_t elapsed, uint32_t n, int64_t sum)
+{
+  std::cout << name << ": " << elapsed << " ms, "
+            << elapsed * 1e6 / n << " ns/operation"
+            << " (sum " << sum << ")" << std::endl;
+}
+
+/**
+ * Run the series of operations.
+ *
+ * \param n the number of operations of each series
+ */
+static void
+RunAll (uint32_t n)
+{
+  SystemWallClockMs clock;
+  int64_t sum;
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += Seconds (i * 1e-6).GetTimeStep ();
+    }
+  Report ("Seconds (fractional double)", clock.End (), n, sum);
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += Seconds (static_cast<double> (i % 100)).GetTimeStep ();
+    }
+  Report ("Seconds (integer double)", clock.End (), n, sum);
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += MilliSeconds (i).GetTimeStep ();
+    }
+  Report ("MilliSeconds (integer)", clock.End (), n, sum);
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += Seconds (int64x64_t (i % 100)).GetTimeStep ();
+    }
+  Report ("Seconds (integer int64x64_t)", clock.End (), n, sum);
+
+  Time t = MicroSeconds (1234);
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += (t * int64x64_t (i % 8)).GetTimeStep ();
+    }
+  Report ("Time * int64x64_t (integer)", clock.End (), n, sum);
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += (t / int64x64_t (i % 8 + 1)).GetTimeStep ();
+    }
+  Report ("Time / int64x64_t (integer)", clock.End (), n, sum);
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += static_cast<int64_t> (NanoSeconds (i).GetSeconds () * 1e6);
+    }
+  Report ("Time::GetSeconds", clock.End (), n, sum);
+
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += NanoSeconds (i).GetMicroSeconds ();
+    }
+  Report ("Time::GetMicroSeconds", clock.End (), n, sum);
+
+  DataRate rate ("5Mbps");
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += rate.CalculateBytesTxTime (40 + i % 1460).GetTimeStep ();
+    }
+  Report ("DataRate::CalculateBytesTxTime", clock.End (), n, sum);
+
+  // the arithmetic of a point-to-point transmission: transmission time,
+  // arrival time, and conversion of the delay for statistics
+  Time delay = MilliSeconds (2);
+  Time now;
+  sum = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Time txTime = rate.CalculateBytesTxTime (40 + i % 1460);
+      Time arrival = now + txTime + delay;
+      sum += static_cast<int64_t> ((arrival - now).GetSeconds () * 1e9);
+      now += txTime;
+    }
+  Report ("per packet", clock.End (), n, sum);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("operations", "number of operations of each series", n);
+  cmd.Parse (argc, argv);
+
+  Simulator::ScheduleNow (&RunAll, n);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}
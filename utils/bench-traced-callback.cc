@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the trace sources.  It first
+// measures the cost of firing a TracedCallback with no, one and several
+// sinks connected.  It then runs a chain of point-to-point links carrying
+// UDP flows twice: without any sink, and with a counting sink connected to
+// every packet trace source of the devices, queues and IPv4 stacks, to
+// report how many trace sources fire per second of simulation and what
+// tracing them costs.
+// Sample usage:  ./waf --run 'bench-traced-callback --nodes=10 --packets=100000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/traced-callback.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/point-to-point-helper.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** The number of firings of the connected trace sources. */
+static uint64_t g_firings = 0;
+
+/**
+ * Count a firing of a trace source with no argument.
+ */
+static void
+CountVoid (void)
+{
+  g_firings++;
+}
+
+/**
+ * Count a firing of a trace source with two arguments.
+ *
+ * \param a the first argument
+ * \param b the second argument
+ */
+static void
+CountUint32Double (uint32_t a, double b)
+{
+  g_firings++;
+}
+
+/**
+ * Count a firing of a packet trace source.
+ *
+ * \param packet the packet
+ */
+static void
+CountPacket (Ptr<const Packet> packet)
+{
+  g_firings++;
+}
+
+/**
+ * Count a firing of an IPv4 transmission or reception trace source.
+ *
+ * \param packet the packet
+ * \param ipv4 the IPv4 stack
+ * \param interface the interface
+ */
+static void
+CountIpv4 (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  g_firings++;
+}
+
+/**
+ * Fire a TracedCallback with some sinks connected, and print the
+ * firing rate.
+ *
+ * \param nSinks the number of sinks
+ * \param n the number of firings
+ */
+static void
+RunFirings (uint32_t nSinks, uint32_t n)
+{
+  TracedCallback<uint32_t, double> trace;
+  for (uint32_t i = 0; i < nSinks; i++)
+    {
+      trace.ConnectWithoutContext (MakeCallback (&CountUint32Double));
+    }
+  TracedCallback<> voidTrace;
+  for (uint32_t i = 0; i < nSinks; i++)
+    {
+      voidTrace.ConnectWithoutContext (MakeCallback (&CountVoid));
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      trace (i, 1.0);
+      voidTrace ();
+    }
+  int64_t elapsed = clock.End ();
+  std::cout << "fire with " << nSinks << " sinks: " << elapsed << " ms, "
+            << (elapsed > 0 ? 2 * n / 1000.0 / elapsed : 0) << " Mfirings/s" << std::endl;
+}
+
+/**
+ * Connect the counting sinks to the packet trace sources of the objects
+ * matching a path.
+ *
+ * \param path the path of the objects
+ * \returns the number of trace sources connected
+ */
+static uint32_t
+ConnectSinks (std::string path)
+{
+  uint32_t n = 0;
+  Config::MatchContainer matches = Config::LookupMatches (path);
+  for (Config::MatchContainer::Iterator i = matches.Begin (); i != matches.End (); i++)
+    {
+      Ptr<Object> object = *i;
+      for (TypeId tid = object->GetInstanceTypeId (); ; tid = tid.GetParent ())
+        {
+          for (std::size_t j = 0; j < tid.GetTraceSourceN (); j++)
+            {
+              struct TypeId::TraceSourceInformation info = tid.GetTraceSource (j);
+              if (info.callback == "ns3::Packet::TracedCallback")
+                {
+                  n += object->TraceConnectWithoutContext (info.name, MakeCallback (&CountPacket));
+                }
+              else if (info.callback == "ns3::Ipv4L3Protocol::TxRxTracedCallback")
+                {
+                  n += object->TraceConnectWithoutContext (info.name, MakeCallback (&CountIpv4));
+                }
+            }
+          if (tid.GetParent () == tid)
+            {
+              break;
+            }
+        }
+    }
+  return n;
+}
+
+/**
+ * Send a packet of a flow, and schedule the next packet.
+ *
+ * \param sockets the sockets of the flows
+ * \param next the index of the packet sent
+ * \param nPackets the number of packets
+ * \param interval the interval between two packets
+ */
+static void
+SendPacket (std::vector<Ptr<Socket> > *sockets, uint32_t next, uint32_t nPackets, Time interval)
+{
+  (*sockets)[next % sockets->size ()]->Send (Create<Packet> (1000));
+  if (++next < nPackets)
+    {
+      Simulator::Schedule (interval, &SendPacket, sockets, next, nPackets, interval);
+    }
+}
+
+/**
+ * Run UDP flows over a chain of point-to-point links and print the
+ * run time, with the trace sources connected or not.
+ *
+ * \param nNodes the number of nodes of the chain
+ * \param nFlows the number of flows
+ * \param nPackets the number of packets sent
+ * \param trace whether to connect the sinks
+ */
+static void
+RunChain (uint32_t nNodes, uint32_t nFlows, uint32_t nPackets, bool trace)
+{
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("10us"));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer last;
+  for (uint32_t i = 0; i + 1 < nNodes; i++)
+    {
+      last = address.Assign (p2p.Install (nodes.Get (i), nodes.Get (i + 1)));
+      address.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  std::vector<Ptr<Socket> > sockets;
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (nNodes - 1), UdpSocketFactory::GetTypeId ());
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  for (uint32_t i = 0; i < nFlows; i++)
+    {
+      Ptr<Socket> socket = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+      socket->Bind ();
+      socket->Connect (InetSocketAddress (last.GetAddress (1), 9));
+      sockets.push_back (socket);
+    }
+
+  uint32_t nSources = 0;
+  if (trace)
+    {
+      nSources += ConnectSinks ("/NodeList/*/DeviceList/*");
+      nSources += ConnectSinks ("/NodeList/*/DeviceList/*/TxQueue");
+      nSources += ConnectSinks ("/NodeList/*/$ns3::Ipv4L3Protocol");
+    }
+
+  Time interval = MicroSeconds (2);
+  Simulator::Schedule (Seconds (0), &SendPacket, &sockets, 0, nPackets, interval);
+  g_firings = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  std::cout << (trace ? "traced" : "untraced") << " run: " << elapsed << " ms, "
+            << Simulator::GetEventCount () << " events";
+  if (trace)
+    {
+      std::cout << ", " << nSources << " trace sources connected, "
+                << g_firings << " firings, "
+                << (elapsed > 0 ? g_firings * 1000.0 / elapsed : 0) << " firings/s, "
+                << (elapsed > 0 ? g_firings * 1.0 / Simulator::GetEventCount () : 0) << " firings/event";
+    }
+  std::cout << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFirings = 10000000;
+  uint32_t nNodes = 10;
+  uint32_t nFlows = 10;
+  uint32_t nPackets = 100000;
+
+  CommandLine cmd;
+  cmd.AddValue ("firings", "number of firings of each TracedCallback", nFirings);
+  cmd.AddValue ("nodes", "number of nodes of the chain", nNodes);
+  cmd.AddValue ("flows", "number of UDP flows", nFlows);
+  cmd.AddValue ("packets", "number of packets sent", nPackets);
+  cmd.Parse (argc, argv);
+
+  RunFirings (0, nFirings);
+  RunFirings (1, nFirings);
+  RunFirings (4, nFirings);
+  RunChain (nNodes, nFlows, nPackets, false);
+  RunChain (nNodes, nFlows, nPackets, true);
+  return 0;
+}